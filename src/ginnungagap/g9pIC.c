@@ -149,6 +149,56 @@ local_calcVelFromDeltaActual(const int               direction,
                              const double            waveNumToFreq,
                              fpvComplex_t *restrict  data);
 
+/**
+ * @brief  Helper function to find the largest squared integer wave
+ *         number that occurs in the local patch.
+ *
+ * @param[in]  dimsGrid
+ *                The dimensions of the grid.
+ * @param[in]  dimsPatch
+ *                The dimensions of the local patch.
+ * @param[in]  idxLo
+ *                The lower corner of the patch.
+ * @param[in]  kMaxGrid
+ *                The largest wave-numbers in each dimension.
+ *
+ * @return  Returns the largest value of k0^2 + k1^2 + k2^2.
+ */
+static uint64_t
+local_getMaxK2(const gridPointUint32_t dimsGrid,
+               const gridPointUint32_t dimsPatch,
+               const gridPointUint32_t idxLo,
+               const gridPointUint32_t kMaxGrid);
+
+/**
+ * @brief  Helper function to tabulate the amplitude of the power
+ *         spectrum on the shells of constant squared integer wave
+ *         number.
+ *
+ * The table is filled serially, as the interpolation accelerator of the
+ * power spectrum must not be shared between threads.  Reading from the
+ * table is then thread-safe.
+ *
+ * @param[in]  pk
+ *                The power spectrum.
+ * @param[in]  maxK2
+ *                The largest squared integer wave number.
+ * @param[in]  wavenumToFreq
+ *                The conversion from integer wave numbers to physical
+ *                frequencies.
+ * @param[in]  norm
+ *                The normalisation to apply to the amplitudes.
+ *
+ * @return  Returns a new array of length @c maxK2 + 1 that holds the
+ *          normalised amplitude for every squared integer wave number.
+ *          The caller must free it.
+ */
+static fpv_t *
+local_getAmplitudeTable(cosmoPk_t pk,
+                        uint64_t  maxK2,
+                        double    wavenumToFreq,
+                        double    norm);
+
 
 /*--- Implementations of exported functios ------------------------------*/
 extern void
@@ -159,6 +209,7 @@ g9pIC_calcDeltaFromWN(gridRegularFFT_t gridFFT,
 {
 	gridPointUint32_t dimsGrid, dimsPatch, idxLo, kMaxGrid;
 	fpvComplex_t      *data;
+	fpv_t             *amplitude;
 	double            wavenumToFreq, norm;
 //	double            maxFreq;
 
@@ -171,11 +222,16 @@ g9pIC_calcDeltaFromWN(gridRegularFFT_t gridFFT,
 	norm          = sqrt(gridRegularFFT_getNorm(gridFFT));
 	norm         *= pow(1. / (boxsizeInMpch), 1.5);
 //	maxFreq       = 0.5 * dim1D * wavenumToFreq;
+	amplitude     = local_getAmplitudeTable(pk, local_getMaxK2(dimsGrid,
+	                                                           dimsPatch,
+	                                                           idxLo,
+	                                                           kMaxGrid),
+	                                        wavenumToFreq, norm);
 
 // maxFreq needs to be added to shared when used again
 #ifdef _OPENMP
 #  pragma omp parallel for shared(dimsPatch, idxLo, kMaxGrid, \
-	dimsGrid, data, pk, norm)
+	dimsGrid, data, amplitude)
 #endif
 	for (uint64_t k = 0; k < dimsPatch[2]; k++) {
 		int64_t k2 = k + idxLo[2];
@@ -186,25 +242,21 @@ g9pIC_calcDeltaFromWN(gridRegularFFT_t gridFFT,
 			for (uint64_t i = 0; i < dimsPatch[0]; i++) {
 				int64_t  k0 = i + idxLo[0];
 				uint64_t idx;
-				double   kCell;
 				k0     = (k0 > kMaxGrid[0]) ? k0 - dimsGrid[0] : k0;
 				idx    = i + (j + k * dimsPatch[1]) * dimsPatch[0];
-				kCell  = sqrt((double)(k0 * k0 + k1 * k1 + k2 * k2));
-				kCell *= wavenumToFreq;
 
 				if ((k0 == 0) && (k1 == 0) && (k2 == 0)) {
 					data[idx] = 0.0;
 //				} else if (kCell > maxFreq) {
 //					data[idx] = 0.0 + 0.0I;
 				} else {
-					double tmp;
-					tmp        = sqrt(cosmoPk_eval(pk, kCell));
-//					tmp       *= cos(0.5 * M_PI * kCell / maxFreq);
-					data[idx] *= (fpv_t)(tmp * norm);
+					data[idx] *= amplitude[k0 * k0 + k1 * k1 + k2 * k2];
 				}
 			}
 		}
 	}
+
+	xfree(amplitude);
 } /* ginnungagapIC_calcDeltaFromWN */
 
 extern void
@@ -415,6 +467,48 @@ local_getGridStuff(gridRegularFFT_t  gridFFT,
 	                                                // dimension
 }
 
+static uint64_t
+local_getMaxK2(const gridPointUint32_t dimsGrid,
+               const gridPointUint32_t dimsPatch,
+               const gridPointUint32_t idxLo,
+               const gridPointUint32_t kMaxGrid)
+{
+	uint64_t maxK2 = 0;
+
+	for (int d = 0; d < NDIM; d++) {
+		int64_t maxAbsK = 0;
+		for (uint64_t i = 0; i < dimsPatch[d]; i++) {
+			int64_t kd = i + idxLo[d];
+			kd = (kd > kMaxGrid[d]) ? kd - dimsGrid[d] : kd;
+			kd = (kd < 0) ? -kd : kd;
+			if (kd > maxAbsK)
+				maxAbsK = kd;
+		}
+		maxK2 += maxAbsK * maxAbsK;
+	}
+
+	return maxK2;
+}
+
+static fpv_t *
+local_getAmplitudeTable(cosmoPk_t pk,
+                        uint64_t  maxK2,
+                        double    wavenumToFreq,
+                        double    norm)
+{
+	fpv_t *amplitude = xmalloc(sizeof(fpv_t) * (maxK2 + 1));
+
+	amplitude[0] = 0.0;
+	for (uint64_t k2 = 1; k2 <= maxK2; k2++) {
+		double kCell = sqrt((double)k2) * wavenumToFreq;
+		double tmp   = sqrt(cosmoPk_eval(pk, kCell));
+//		tmp         *= cos(0.5 * M_PI * kCell / maxFreq);
+		amplitude[k2] = (fpv_t)(tmp * norm);
+	}
+
+	return amplitude;
+}
+
 #ifdef WITH_MPI
 static void
 local_reducePk(double *pK, double *k, uint32_t *nums, uint32_t kMaxGrid)
@@ -129,6 +129,19 @@ static g9pNorm_mode_t
 local_getNormModeFromIni(parse_ini_t ini);
 
 
+/**
+ * @brief  Retrieves the FFT planner effort from an ini file.
+ *
+ * @param[in,out]  ini
+ *                    The ini file to read from.
+ *
+ * @return  Returns the effort, #GRIDREGULARFFT_EFFORT_ESTIMATE if the
+ *          key is not set.
+ */
+static gridRegularFFT_effort_t
+local_getFFTPlannerEffortFromIni(parse_ini_t ini);
+
+
 #ifdef WITH_MPI
 
 /**
@@ -170,6 +183,8 @@ g9pSetup_del(g9pSetup_t *setup)
 {
 	assert(setup != NULL && *setup != NULL);
 
+	if ((*setup)->profileReport != NULL)
+		xfree((*setup)->profileReport);
 	xfree((*setup)->nameHistogramVelz);
 	xfree((*setup)->nameHistogramVely);
 	xfree((*setup)->nameHistogramVelx);
@@ -180,6 +195,10 @@ g9pSetup_del(g9pSetup_t *setup)
 	xfree((*setup)->namePkInput);
 	xfree((*setup)->namePkInputZinit);
 	xfree((*setup)->namePkInputZ0);
+	if ((*setup)->deltaKScratchFile != NULL)
+		xfree((*setup)->deltaKScratchFile);
+	if ((*setup)->fftWisdomFile != NULL)
+		xfree((*setup)->fftWisdomFile);
 	xfree((*setup)->gridName);
 
 	xfree(*setup);
@@ -210,9 +229,36 @@ local_parseOptional(g9pSetup_t s, parse_ini_t ini)
 	if (!(parse_ini_get_bool(ini, "writeDensityField", "Ginnungagap",
 	                         &(s->writeDensityField))))
 		s->writeDensityField = true;
+	if (!(parse_ini_get_bool(ini, "reuseDeltaK", "Ginnungagap",
+	                         &(s->reuseDeltaK))))
+		s->reuseDeltaK = false;
+	if (!(parse_ini_get_string(ini, "deltaKScratchFile", "Ginnungagap",
+	                           &(s->deltaKScratchFile))))
+		s->deltaKScratchFile = NULL;
+	s->fftPlannerEffort = local_getFFTPlannerEffortFromIni(ini);
+	if (!(parse_ini_get_string(ini, "fftWisdomFile", "Ginnungagap",
+	                           &(s->fftWisdomFile))))
+		s->fftWisdomFile = NULL;
+	if (!(parse_ini_get_int32(ini, "fftNumThreads", "Ginnungagap",
+	                          &(s->fftNumThreads))))
+		s->fftNumThreads = 0;
+	if (s->fftNumThreads < 0) {
+		fprintf(stderr, "fftNumThreads must not be negative\n");
+		diediedie(EXIT_FAILURE);
+	}
+	if (!(parse_ini_get_int32(ini, "fftNumChunks", "Ginnungagap",
+	                          &(s->fftNumChunks))))
+		s->fftNumChunks = 0;
+	if (s->fftNumChunks < 0) {
+		fprintf(stderr, "fftNumChunks must not be negative\n");
+		diediedie(EXIT_FAILURE);
+	}
 
 	local_parseOptionalPk(s, ini);
 	local_parseOptionalHistogram(s, ini);
+	if (!(parse_ini_get_string(ini, "profileReport", "Ginnungagap",
+	                           &(s->profileReport))))
+		s->profileReport = NULL;
 }
 
 static void
@@ -287,6 +333,27 @@ local_getNormModeFromIni(parse_ini_t ini)
 	return mode;
 }
 
+static gridRegularFFT_effort_t
+local_getFFTPlannerEffortFromIni(parse_ini_t ini)
+{
+	char                    *name;
+	gridRegularFFT_effort_t effort;
+
+	if (!(parse_ini_get_string(ini, "fftPlannerEffort", "Ginnungagap",
+	                           &name)))
+		return GRIDREGULARFFT_EFFORT_ESTIMATE;
+
+	effort = gridRegularFFT_getEffortFromName(name);
+	if (effort == GRIDREGULARFFT_EFFORT_UNKNOWN) {
+		fprintf(stderr, "FFT planner effort %s unknown\n", name);
+		diediedie(EXIT_FAILURE);
+	}
+
+	xfree(name);
+
+	return effort;
+}
+
 #ifdef WITH_MPI
 static void
 local_parseMPIStuff(g9pSetup_t setup, parse_ini_t ini)
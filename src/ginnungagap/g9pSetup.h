@@ -18,6 +18,7 @@
 /*--- Includes ----------------------------------------------------------*/
 #include "g9pConfig.h"
 #include "g9pNorm.h"
+#include "../libgrid/gridRegularFFT.h"
 #include <stdint.h>
 #include <stdbool.h>
 #include "../libutil/parse_ini.h"
@@ -51,6 +52,19 @@ struct g9pSetup_struct {
 #endif
 	/** @brief  Flags whether the density field should be written. */
 	bool     writeDensityField; ///< Defaults to @c true.
+	/** @brief  Flags whether delta(k) is kept for the velocities. */
+	bool     reuseDeltaK; ///< Defaults to @c false.
+	/** @brief  File to hold delta(k), if @c NULL it is kept in memory. */
+	char     *deltaKScratchFile; ///< Defaults to @c NULL.
+	/** @brief  The effort FFTW spends on finding good plans. */
+	gridRegularFFT_effort_t fftPlannerEffort; ///< Defaults to estimate.
+	/** @brief  The FFTW wisdom file, if @c NULL no wisdom is used. */
+	char     *fftWisdomFile; ///< Defaults to @c NULL.
+	/** @brief  The number of threads used per FFT, 0 selects all. */
+	int32_t  fftNumThreads; ///< Defaults to @c 0.
+	/** @brief  The number of chunks per pipelined FFT stage, 0 selects
+	 *          the default of the FFT. */
+	int32_t  fftNumChunks; ///< Defaults to @c 0.
 	/** @brief  Gives the name of the P(k) of the white noise. */
 	char     *namePkWN; ///< Defaults to #local_namePkWN.
 	/** @brief  Gives the name of the P(k) of the overdensity field. */
@@ -81,6 +95,8 @@ struct g9pSetup_struct {
 	double   histogramExtremeDens;
 	/** @brief  The extreme value for the velocity histograms. */
 	double   histogramExtremeVel;
+	/** @brief  The profiling report, if @c NULL none is written. */
+	char     *profileReport; ///< Defaults to @c NULL.
 };
 
 
@@ -167,6 +183,43 @@ g9pSetup_del(g9pSetup_t *setup);
  * # the names delta, velx, and vely, respectively.
  * writeDensityField = <true|false>
  * #
+ * # If this is switched on, the white noise is only generated once and
+ * # the resulting delta(k) is kept to derive the velocity fields from,
+ * # instead of regenerating the white noise and delta(k) for every
+ * # velocity component.  This saves three passes of the random number
+ * # generator and three forward FFTs at the expense of one extra field
+ * # in memory.  Default is false.
+ * reuseDeltaK = <true|false>
+ * #
+ * # Only evaluated if reuseDeltaK is true.  If given, delta(k) is not
+ * # kept in memory but written to this file (with the MPI rank appended
+ * # for parallel runs) and read back for every velocity component.  Use
+ * # a fast local scratch file system when memory is tight.  The file is
+ * # removed once all velocities are generated.
+ * deltaKScratchFile = <string>
+ * #
+ * # Selects how hard FFTW tries to find a fast plan for the transforms.
+ * # The plans are made once and reused for all FFTs of the run, but
+ * # measure and patient can still take considerable time for large grids
+ * # unless matching wisdom is available.  Default is estimate.
+ * fftPlannerEffort = <estimate|measure|patient>
+ * #
+ * # If given, FFTW wisdom is read from this file at start-up (a missing
+ * # file is not an error) and the accumulated wisdom is written back to
+ * # it at the end of the run.
+ * fftWisdomFile = <string>
+ * #
+ * # The number of OpenMP threads each MPI task uses for the FFTs.  This
+ * # is only relevant for OpenMP-enabled builds; if not given (or 0), all
+ * # threads available to the task are used.
+ * fftNumThreads = <non-negative integer>
+ * #
+ * # In MPI runs, each stage of the FFT is done in this many chunks, such
+ * # that the following transposition can already send the finished
+ * # chunks while the next one is transformed.  If not given (or 0), the
+ * # default of the FFT module is used.
+ * fftNumChunks = <non-negative integer>
+ * #
  * # The name of the text file that will contain the P(k) of the white
  * # noise field.
  * namePkWN = <string>
@@ -224,6 +277,14 @@ g9pSetup_del(g9pSetup_t *setup);
  * # z-component of the velocity.
  * nameHistogramVelz = <string>
  * #
+ * # If given, the time spent in the phases of the run (white noise,
+ * # FFTs, MPI transpositions, writing, ...), the number of calls and the
+ * # bytes moved are written to this file at the end of the run.  The
+ * # times are given as minimum, maximum and mean over all MPI tasks.  The
+ * # file is in CSV format if the name ends in .csv and in JSON format
+ * # otherwise.
+ * profileReport = <string>
+ * #
  * @endcode
  *
  *
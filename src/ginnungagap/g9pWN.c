@@ -19,6 +19,7 @@
 #include "../libutil/parse_ini.h"
 #include "../libutil/xmem.h"
 #include "../libutil/diediedie.h"
+#include "../libutil/lIdx.h"
 #include "../libgrid/gridRegular.h"
 #include "../libgrid/gridReader.h"
 #include "../libgrid/gridReaderFactory.h"
@@ -50,6 +51,12 @@ local_setupFromRNG(g9pWN_t     wn,
                    gridPatch_t patch,
                    int         idxOfDensVar);
 
+static void
+local_setupFromCounterRNG(g9pWN_t       wn,
+                          gridRegular_t grid,
+                          gridPatch_t   patch,
+                          int           idxOfDensVar);
+
 
 /*--- Implementations of exported functios ------------------------------*/
 extern g9pWN_t
@@ -105,6 +112,8 @@ g9pWN_setup(g9pWN_t       wn,
 
 	if (wn->useFile)
 		gridReader_readIntoPatchForVar(wn->reader, patch, idxOfDensVar);
+	else if (rng_isCounterBased(wn->rng))
+		local_setupFromCounterRNG(wn, grid, patch, idxOfDensVar);
 	else
 		local_setupFromRNG(wn, patch, idxOfDensVar);
 }
@@ -141,15 +150,17 @@ local_newGetInput(g9pWN_t     wn,
 		xfree(secName);
 	} else {
 		char *rngSectionName;
-#ifndef WITH_SPRNG
-		fprintf(stderr,
-		        "WITH_SPRNG must be defined to use random numbers.\n");
-		diediedie(EXIT_FAILURE);
-#endif
 		getFromIni(&rngSectionName, parse_ini_get_string,
 		           ini, "rngSectionName", sectionName);
 		wn->rng = rng_newFromIni(ini, rngSectionName);
 		xfree(rngSectionName);
+#ifndef WITH_SPRNG
+		if (!rng_isCounterBased(wn->rng)) {
+			fprintf(stderr,
+			        "WITH_SPRNG must be defined to use SPRNG generators.\n");
+			diediedie(EXIT_FAILURE);
+		}
+#endif
 	}
 }
 
@@ -193,9 +204,51 @@ local_setupFromRNG(g9pWN_t     wn,
 		uint64_t start = i * cps;
 		uint64_t stop  = (i == numStreams - 1) ? numCells : (start
 		                                                     + cps);
-		for (uint64_t j = start; j < stop; j++) {
-			assert(j < numCells);
-			data[j] = (fpv_t)rng_getGaussUnit(wn->rng, i);
-		}
+		assert(stop <= numCells);
+		rng_fillGaussUnit(wn->rng, i, data + start, stop - start);
+	}
+
+	// The streams fill the cells linearly, move the rows into place.
+	gridPatch_insertFFTWPadding(patch, idxOfDensVar);
+}
+
+/*
+ * Every cell draws the number belonging to its global index, hence the
+ * field does not depend on the domain decomposition or the number of
+ * threads.  The cells of a row along the first dimension have
+ * consecutive global indices and are filled in one go, the rows are
+ * placed with the actual extent of the first dimension to respect the
+ * FFTW padding.
+ */
+static void
+local_setupFromCounterRNG(g9pWN_t       wn,
+                          gridRegular_t grid,
+                          gridPatch_t   patch,
+                          int           idxOfDensVar)
+{
+	fpv_t             *data;
+	uint64_t          numRows;
+	uint32_t          strideRow;
+	gridPointUint32_t dims, dimsGlobal, idxLo;
+
+	data = gridPatch_getVarDataHandle(patch, idxOfDensVar);
+	gridPatch_getDims(patch, dims);
+	gridPatch_getIdxLo(patch, idxLo);
+	gridRegular_getDims(grid, dimsGlobal);
+	numRows   = gridPatch_getNumCells(patch) / dims[0];
+	strideRow = gridPatch_getDimActual1D(patch, idxOfDensVar, 0);
+
+#ifdef _OPENMP
+#  pragma omp parallel for shared(data, numRows, strideRow, dims, \
+	dimsGlobal, idxLo)
+#endif
+	for (uint64_t i = 0; i < numRows; i++) {
+		uint32_t coords[NDIM];
+		lIdx_toCoordNd(i * dims[0], dims, NDIM, coords);
+		for (int j = 0; j < NDIM; j++)
+			coords[j] += idxLo[j];
+		rng_fillGaussUnitAt(wn->rng,
+		                    lIdx_fromCoordNd(coords, dimsGlobal, NDIM),
+		                    data + i * strideRow, dims[0]);
 	}
 }
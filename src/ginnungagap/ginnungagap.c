@@ -34,6 +34,7 @@
 #include "../libutil/xstring.h"
 #include "../libutil/xfile.h"
 #include "../libutil/timer.h"
+#include "../libutil/profile.h"
 #include "../libutil/filename.h"
 #include "../libutil/utilMath.h"
 #include "../libcosmo/cosmo.h"
@@ -82,6 +83,12 @@ local_doDeltaK(ginnungagap_t g9p);
 static void
 local_doDeltaKPk(ginnungagap_t g9p);
 
+static void
+local_storeDeltaK(ginnungagap_t g9p);
+
+static void
+local_getDeltaK(ginnungagap_t g9p);
+
 static void
 local_doDeltaX(ginnungagap_t g9p);
 
@@ -89,7 +96,10 @@ static void
 local_doVelocities(ginnungagap_t g9p, g9pICMode_t mode);
 
 static void
-local_doStatistics(ginnungagap_t g9p, int idxOfVar);
+local_doStatistics(ginnungagap_t   g9p,
+                   int             idxOfVar,
+                   gridHistogram_t histo,
+                   const char      *histoName);
 
 static void
 local_doHistogram(ginnungagap_t         g9p,
@@ -103,6 +113,15 @@ local_doRenames(dataVar_t var, gridWriter_t writer, const char *newName);
 static void
 local_do2LPTCorrections(ginnungagap_t g9p);
 
+static uint64_t
+local_getNumBytesLocal(ginnungagap_t g9p);
+
+#ifdef ENABLE_WRITING
+static void
+local_writeGrid(ginnungagap_t g9p);
+
+#endif
+
 
 /*--- Implementations of exported functios ------------------------------*/
 extern ginnungagap_t
@@ -144,8 +163,12 @@ ginnungagap_init(ginnungagap_t g9p)
 {
 	assert(g9p != NULL);
 
-	if (g9p->rank == 0)
+	if (g9p->rank == 0) {
 		printf("\nInitialising:\n");
+		printf("  Using %i threads per task for the FFTs\n",
+		       gridRegularFFT_getNumThreads(g9p->gridFFT));
+	}
+	profile_begin("init");
 	g9pInit_init(g9p->setup->boxsizeInMpch,
 	             g9p->setup->dim1D,
 	             g9p->setup->zInit,
@@ -155,6 +178,7 @@ ginnungagap_init(ginnungagap_t g9p)
 	             g9p->setup->namePkInput,
 	             g9p->setup->namePkInputZ0,
 	             g9p->setup->namePkInputZinit);
+	profile_end("init");
 	if (g9p->rank == 0)
 		printf("\n");
 }
@@ -167,53 +191,53 @@ ginnungagap_run(ginnungagap_t g9p)
 	if (g9p->rank == 0)
 		printf("\nGenerating IC:\n\n");
 
+	profile_begin("run");
 	local_doWhiteNoise(g9p, true);
 	local_doWhiteNoisePk(g9p);
 	local_doDeltaK(g9p);
 	local_doDeltaKPk(g9p);
+	if (g9p->setup->reuseDeltaK)
+		local_storeDeltaK(g9p);
 	local_doDeltaX(g9p);
-	local_doStatistics(g9p, 0);
-	if (g9p->setup->doHistograms)
-		local_doHistogram(g9p, 0, g9p->histoDens,
-		                  g9p->setup->nameHistogramDens);
+	local_doStatistics(g9p, 0, g9p->histoDens,
+	                   g9p->setup->nameHistogramDens);
 	if (g9p->rank == 0)
 		printf("\n");
 
-	g9pWN_reset(g9p->whiteNoise);
-	local_doWhiteNoise(g9p, false);
-	local_doDeltaK(g9p);
+	local_getDeltaK(g9p);
 	local_doVelocities(g9p, G9PIC_MODE_VX);
-	local_doStatistics(g9p, 0);
-	if (g9p->setup->doHistograms)
-		local_doHistogram(g9p, 0, g9p->histoVel,
-		                  g9p->setup->nameHistogramVelx);
+	local_doStatistics(g9p, 0, g9p->histoVel,
+	                   g9p->setup->nameHistogramVelx);
 	if (g9p->rank == 0)
 		printf("\n");
 
-	g9pWN_reset(g9p->whiteNoise);
-	local_doWhiteNoise(g9p, false);
-	local_doDeltaK(g9p);
+	local_getDeltaK(g9p);
 	local_doVelocities(g9p, G9PIC_MODE_VY);
-	local_doStatistics(g9p, 0);
-	if (g9p->setup->doHistograms)
-		local_doHistogram(g9p, 0, g9p->histoVel,
-		                  g9p->setup->nameHistogramVely);
+	local_doStatistics(g9p, 0, g9p->histoVel,
+	                   g9p->setup->nameHistogramVely);
 	if (g9p->rank == 0)
 		printf("\n");
 
-	g9pWN_reset(g9p->whiteNoise);
-	local_doWhiteNoise(g9p, false);
-	local_doDeltaK(g9p);
+	local_getDeltaK(g9p);
 	local_doVelocities(g9p, G9PIC_MODE_VZ);
-	local_doStatistics(g9p, 0);
-	if (g9p->setup->doHistograms)
-		local_doHistogram(g9p, 0, g9p->histoVel,
-		                  g9p->setup->nameHistogramVelz);
+	local_doStatistics(g9p, 0, g9p->histoVel,
+	                   g9p->setup->nameHistogramVelz);
 	if (g9p->rank == 0)
 		printf("\n");
 
+	if (g9p->setup->reuseDeltaK)
+		gridRegularFFT_discardKSpace(g9p->gridFFT);
+
 	if (g9p->setup->do2LPTCorrections)
 		local_do2LPTCorrections(g9p);
+	profile_end("run");
+
+	if (g9p->setup->profileReport != NULL) {
+		profile_writeReport(g9p->setup->profileReport);
+		if (g9p->rank == 0)
+			printf("Profile written to %s.\n",
+			       g9p->setup->profileReport);
+	}
 } /* ginnungagap_run */
 
 extern void
@@ -231,11 +255,17 @@ ginnungagap_del(ginnungagap_t *g9p)
 	cosmoPk_del(&((*g9p)->pk));
 	cosmoModel_del(&((*g9p)->model));
 	g9pWN_del(&((*g9p)->whiteNoise));
+	if (((*g9p)->setup->fftWisdomFile != NULL) && ((*g9p)->rank == 0)) {
+		if (!gridRegularFFT_exportWisdom((*g9p)->setup->fftWisdomFile))
+			fprintf(stderr, "Could not write FFTW wisdom to %s\n",
+			        (*g9p)->setup->fftWisdomFile);
+	}
 	gridRegularFFT_del(&((*g9p)->gridFFT));
 	gridRegularDistrib_del(&((*g9p)->gridDistrib));
 	gridRegular_del(&((*g9p)->grid));
 	gridWriter_del(&((*g9p)->finalWriter));
 	g9pSetup_del(&((*g9p)->setup));
+	profile_reset();
 	xfree(*g9p);
 	*g9p = NULL;
 }
@@ -292,6 +322,8 @@ local_initGrid(gridRegular_t grid, gridRegularDistrib_t distrib)
 
 	dens = dataVar_new("wn", DATAVARTYPE_FPV, 1);
 #ifdef WITH_FFT_FFTW3
+	// Lets the real-to-complex transforms work in place.
+	dataVar_setFFTWPadded(dens);
 #  ifdef ENABLE_DOUBLE
 	dataVar_setMemFuncs(dens, &fftw_malloc, &fftw_free);
 #  else
@@ -309,6 +341,13 @@ local_getFFT(ginnungagap_t g9p)
 	fft = gridRegularFFT_new(g9p->grid,
 	                         g9p->gridDistrib,
 	                         g9p->posOfDens);
+	gridRegularFFT_setPlannerEffort(fft, g9p->setup->fftPlannerEffort);
+	if (g9p->setup->fftNumThreads > 0)
+		gridRegularFFT_setNumThreads(fft, g9p->setup->fftNumThreads);
+	if (g9p->setup->fftNumChunks > 0)
+		gridRegularFFT_setNumChunks(fft, g9p->setup->fftNumChunks);
+	if (g9p->setup->fftWisdomFile != NULL)
+		(void)gridRegularFFT_importWisdom(g9p->setup->fftWisdomFile);
 
 	return fft;
 }
@@ -336,15 +375,21 @@ local_doWhiteNoise(ginnungagap_t g9p, bool doDumpOfWhiteNoise)
 {
 	double timing;
 
+	profile_begin("wn");
 	timing = timer_start_text("  Setting up white noise... ");
+	profile_begin("setup");
 	g9pWN_setup(g9p->whiteNoise,
 	            g9p->grid,
 	            g9p->posOfDens);
+	profile_end("setup");
 	timing = timer_stop_text(timing, "took %.5fs\n");
 
 	if (doDumpOfWhiteNoise) {
 		timing = timer_start_text("  Writing white noise to file... ");
+		profile_begin("write");
 		g9pWN_dump(g9p->whiteNoise, g9p->grid);
+		profile_addBytes(local_getNumBytesLocal(g9p));
+		profile_end("write");
 		timing = timer_stop_text(timing, "took %.5fs\n");
 		if (g9p->setup->doHistograms)
 			local_doHistogram(g9p, 0, g9p->histoWN,
@@ -354,6 +399,7 @@ local_doWhiteNoise(ginnungagap_t g9p, bool doDumpOfWhiteNoise)
 	timing = timer_start_text("  Going to k-space... ");
 	gridRegularFFT_execute(g9p->gridFFT, GRIDREGULARFFT_FORWARD);
 	timing = timer_stop_text(timing, "took %.5fs\n");
+	profile_end("wn");
 }
 
 static void
@@ -364,11 +410,13 @@ local_doWhiteNoisePk(ginnungagap_t g9p)
 
 	if (g9p->setup->dim1D >= G9P_MINGRIDSIZE_FOR_PS) {
 		timing = timer_start_text("  Calculating P(k) for white noise... ");
+		profile_begin("pk.wn");
 		pk     = g9pIC_calcPkFromDelta(g9p->gridFFT,
 		                               g9p->setup->dim1D,
 		                               g9p->setup->boxsizeInMpch);
 		cosmoPk_dumpToFile(pk, g9p->setup->namePkWN, 1);
 		cosmoPk_del(&pk);
+		profile_end("pk.wn");
 		timing = timer_stop_text(timing, "took %.5fs\n");
 	}
 }
@@ -379,10 +427,12 @@ local_doDeltaK(ginnungagap_t g9p)
 	double timing;
 
 	timing = timer_start_text("  Generating delta(k)... ");
+	profile_begin("deltak");
 	g9pIC_calcDeltaFromWN(g9p->gridFFT,
 	                      g9p->setup->dim1D,
 	                      g9p->setup->boxsizeInMpch,
 	                      g9p->pk);
+	profile_end("deltak");
 	timing = timer_stop_text(timing, "took %.5fs\n");
 }
 
@@ -394,12 +444,48 @@ local_doDeltaKPk(ginnungagap_t g9p)
 
 	if (g9p->setup->dim1D >= G9P_MINGRIDSIZE_FOR_PS) {
 		timing = timer_start_text("  Calculating P(k) for delta(k)... ");
+		profile_begin("pk.deltak");
 		pk     = g9pIC_calcPkFromDelta(g9p->gridFFT,
 		                               g9p->setup->dim1D,
 		                               g9p->setup->boxsizeInMpch);
 		cosmoPk_dumpToFile(pk, g9p->setup->namePkDeltak, 1);
 		cosmoPk_del(&pk);
+		profile_end("pk.deltak");
+		timing = timer_stop_text(timing, "took %.5fs\n");
+	}
+}
+
+static void
+local_storeDeltaK(ginnungagap_t g9p)
+{
+	double timing;
+
+	if (g9p->setup->deltaKScratchFile == NULL) {
+		timing = timer_start_text("  Keeping delta(k) in memory... ");
+	} else {
+		timing = timer_start_text("  Writing delta(k) to scratch file... ");
+	}
+	profile_begin("deltak.store");
+	gridRegularFFT_storeKSpace(g9p->gridFFT, g9p->setup->deltaKScratchFile);
+	profile_end("deltak.store");
+	timing = timer_stop_text(timing, "took %.5fs\n");
+}
+
+static void
+local_getDeltaK(ginnungagap_t g9p)
+{
+	double timing;
+
+	if (g9p->setup->reuseDeltaK) {
+		timing = timer_start_text("  Restoring delta(k)... ");
+		profile_begin("deltak.restore");
+		gridRegularFFT_restoreKSpace(g9p->gridFFT);
+		profile_end("deltak.restore");
 		timing = timer_stop_text(timing, "took %.5fs\n");
+	} else {
+		g9pWN_reset(g9p->whiteNoise);
+		local_doWhiteNoise(g9p, false);
+		local_doDeltaK(g9p);
 	}
 }
 
@@ -411,6 +497,7 @@ local_doDeltaX(ginnungagap_t g9p)
 	dataVar_t var;
 #endif
 
+	profile_begin("deltax");
 	timing = timer_start_text("  Going back to real space... ");
 	gridRegularFFT_execute(g9p->gridFFT, GRIDREGULARFFT_BACKWARD);
 	timing = timer_stop_text(timing, "took %.5fs\n");
@@ -420,14 +507,12 @@ local_doDeltaX(ginnungagap_t g9p)
 	if (g9p->setup->writeDensityField) {
 		timing = timer_start_text("  Writing delta(x) to file... ");
 		local_doRenames(var, g9p->finalWriter, "delta");
-		gridWriter_activate(g9p->finalWriter);
-		gridWriter_writeGridRegular(g9p->finalWriter,
-		                            g9p->grid);
-		gridWriter_deactivate(g9p->finalWriter);
+		local_writeGrid(g9p);
 		dataVar_rename(var, "wn");
 		timing = timer_stop_text(timing, "took %.5fs\n");
 	}
 #endif
+	profile_end("deltax");
 }
 
 static void
@@ -441,13 +526,16 @@ local_doVelocities(ginnungagap_t g9p, g9pICMode_t mode)
 
 	msg    = xstrmerge("  Generating ", g9pIC_getModeStr(mode));
 	msg2   = xstrmerge(msg, "(k)... ");
+	profile_begin("velocity");
 	timing = timer_start_text(msg2);
+	profile_begin("calc");
 	g9pIC_calcVelFromDelta(g9p->gridFFT,
 	                       g9p->setup->dim1D,
 	                       g9p->setup->boxsizeInMpch,
 	                       g9p->model,
 	                       cosmo_z2a(g9p->setup->zInit),
 	                       mode);
+	profile_end("calc");
 	timing = timer_stop_text(timing, "took %.5fs\n");
 	xfree(msg2);
 	xfree(msg);
@@ -463,30 +551,40 @@ local_doVelocities(ginnungagap_t g9p, g9pICMode_t mode)
 	var    = gridRegular_getVarHandle(g9p->grid,
 	                                  g9p->posOfDens);
 	local_doRenames(var, g9p->finalWriter, g9pIC_getModeStr(mode));
-	gridWriter_activate(g9p->finalWriter);
-	gridWriter_writeGridRegular(g9p->finalWriter,
-	                            g9p->grid);
-	gridWriter_deactivate(g9p->finalWriter);
+	local_writeGrid(g9p);
 	dataVar_rename(var, "wn");
 	timing = timer_stop_text(timing, "took %.5fs\n");
 	xfree(msg2);
 	xfree(msg);
 #endif
+	profile_end("velocity");
 } /* local_doVelocities */
 
 static void
-local_doStatistics(ginnungagap_t g9p, int idxOfVar)
+local_doStatistics(ginnungagap_t   g9p,
+                   int             idxOfVar,
+                   gridHistogram_t histo,
+                   const char      *histoName)
 {
 	double           timing;
 	gridStatistics_t stat;
 
 	timing = timer_start_text("  Calculating statistics... ");
+	profile_begin("statistics");
 	stat   = gridStatistics_new();
+	if (histo != NULL)
+		gridStatistics_attachHistogram(stat, histo);
 	gridStatistics_calcGridRegularDistrib(stat, g9p->gridDistrib,
 	                                      idxOfVar);
+	profile_end("statistics");
 	timing = timer_stop_text(timing, "took %.5fs\n");
-	if (g9p->rank == 0)
+	if (g9p->rank == 0) {
 		gridStatistics_printPretty(stat, stdout, "  ");
+		if (histo != NULL) {
+			gridHistogram_printPrettyFile(histo, histoName, false, "");
+			printf("    Histogram written to %s.\n", histoName);
+		}
+	}
 	gridStatistics_del(&stat);
 }
 
@@ -499,7 +597,9 @@ local_doHistogram(ginnungagap_t         g9p,
 	double timing;
 
 	timing = timer_start_text("  Calculating histogram... ");
+	profile_begin("histogram");
 	gridHistogram_calcGridRegularDistrib(histo, g9p->gridDistrib, idxOfVar);
+	profile_end("histogram");
 	timing = timer_stop_text(timing, "took %.5fs\n");
 
 	if (g9p->rank == 0) {
@@ -527,3 +627,26 @@ static void
 local_do2LPTCorrections(ginnungagap_t g9p)
 {
 }
+
+static uint64_t
+local_getNumBytesLocal(ginnungagap_t g9p)
+{
+	gridPatch_t patch = gridRegular_getPatchHandle(g9p->grid, 0);
+	dataVar_t   var   = gridPatch_getVarHandle(patch, g9p->posOfDens);
+
+	return gridPatch_getNumCells(patch) * dataVar_getSizePerElement(var);
+}
+
+#ifdef ENABLE_WRITING
+static void
+local_writeGrid(ginnungagap_t g9p)
+{
+	profile_begin("write");
+	gridWriter_activate(g9p->finalWriter);
+	gridWriter_writeGridRegular(g9p->finalWriter, g9p->grid);
+	gridWriter_deactivate(g9p->finalWriter);
+	profile_addBytes(local_getNumBytesLocal(g9p));
+	profile_end("write");
+}
+
+#endif
@@ -25,7 +25,6 @@
 #  include <mpi.h>
 #endif
 #if (defined _OPENMP && WITH_FFT_FFTW3)
-#  include <omp.h>
 #  include <fftw3.h>
 #endif
 #include "../libutil/xmem.h"
@@ -60,12 +59,6 @@ static void
 local_initEnvironment(int *argc, char ***argv);
 
 
-#if (defined _OPENMP && WITH_FFT_FFTW3)
-static void
-local_setThreadedFFTW(void);
-
-#endif
-
 static void
 local_registerCleanUpFunctions(void);
 
@@ -129,9 +122,6 @@ local_initEnvironment(int *argc, char ***argv)
 #ifdef WITH_MPI
 	MPI_Init(argc, argv);
 #endif
-#if (defined _OPENMP && WITH_FFT_FFTW3)
-	local_setThreadedFFTW();
-#endif
 
 	cmdline = local_cmdlineSetup();
 	cmdline_parse(cmdline, *argc, *argv);
@@ -142,25 +132,6 @@ local_initEnvironment(int *argc, char ***argv)
 	cmdline_del(&cmdline);
 }
 
-#if (defined _OPENMP && WITH_FFT_FFTW3)
-static void
-local_setThreadedFFTW(void)
-{
-	int rank = 0;
-
-#  ifdef WITH_MPI
-	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
-#  endif
-
-	fftw_init_threads();
-	fftw_plan_with_nthreads(omp_get_max_threads());
-
-	if (rank == 0)
-		printf("Using %i threads\n", omp_get_max_threads());
-}
-
-#endif
-
 static void
 local_registerCleanUpFunctions(void)
 {
@@ -182,6 +153,7 @@ local_finalMessage(void)
 	int rank = 0;
 #if (defined _OPENMP && WITH_FFT_FFTW3)
 	fftw_cleanup_threads();
+	fftwf_cleanup_threads();
 #endif
 #ifdef WITH_MPI
 	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
@@ -134,6 +134,22 @@ g9pICMap_getNumCellsPerLevelInFile(const g9pICMap_t map,
 	return map->numCells + (file * g9pMask_getNumLevel(map->mask));
 }
 
+extern uint64_t
+g9pICMap_getNumParticlesInFile(const g9pICMap_t map, const uint32_t file)
+{
+	const uint8_t  minLevel = g9pMask_getMinLevel(map->mask);
+	const int      numLevel = g9pMask_getNumLevel(map->mask);
+	const uint64_t *cells   = g9pICMap_getNumCellsPerLevelInFile(map, file);
+	uint64_t       np       = UINT64_C(0);
+
+	for (int k = 0; k < numLevel; k++)
+		np += cells[k];
+	for (uint32_t i = 0; i < map->numGasLevel; i++)
+		np += cells[map->gasLevel[i] - minLevel];
+
+	return np;
+}
+
 /*--- Implementations of local functions --------------------------------*/
 static void
 local_calcIdx(g9pICMap_t map)
@@ -67,6 +67,23 @@ extern const uint64_t *
 g9pICMap_getNumCellsPerLevelInFile(const g9pICMap_t map,
                                    const uint32_t   file);
 
+/**
+ * @brief  Returns the number of particles in a file.
+ *
+ * This counts one particle per cell on every level and one gas particle
+ * per cell on each of the gas levels.
+ *
+ * @param[in]  map
+ *                The map to query.  Must be a valid map.
+ * @param[in]  file
+ *                The file number.  Must be smaller than the number of
+ *                files.
+ *
+ * @return  Returns the total number of particles in the file.
+ */
+extern uint64_t
+g9pICMap_getNumParticlesInFile(const g9pICMap_t map, const uint32_t file);
+
 
 /*--- Doxygen group definitions -----------------------------------------*/
 
@@ -94,4 +94,52 @@ g9pICMap_verifySimpleMapCreation(void)
 	return hasPassed ? true : false;
 } /* g9pICMap_verifySimpleMapCreation */
 
+extern bool
+g9pICMap_verifyNumParticlesWithGas(void)
+{
+	bool       hasPassed = true;
+	int        rank      = 0;
+	g9pICMap_t map;
+	int8_t     gasLevel  = 3;
+	uint64_t   np        = UINT64_C(0);
+#ifdef XMEM_TRACK_MEM
+	size_t     allocatedBytes = global_allocated_bytes;
+#endif
+#ifdef WITH_MPI
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+#endif
+
+	if (rank == 0)
+		printf("Testing %s... ", __func__);
+
+	// 2 4 8 16 32 64 128
+	g9pHierarchy_t h = g9pHierarchy_newWithSimpleFactor(7, 2, 2);
+	// All cells are on the minLevel (16^3), the maxLevel (128^3) is empty,
+	// hence the gas lives on the minLevel.
+	g9pMask_t      m = g9pMask_newMinMaxTiledMask(h, 4, 3, 6, 0);
+
+	map = g9pICMap_new(3, 1, &gasLevel, m);
+
+	for (uint32_t i = 0; i < 3; i++) {
+		uint32_t firstTile = g9pICMap_getFirstTileInFile(map, i);
+		uint32_t lastTile  = g9pICMap_getLastTileInFile(map, i);
+		uint64_t npFile    = g9pICMap_getNumParticlesInFile(map, i);
+
+		if (npFile != 2 * 512 * (lastTile - firstTile + 1))
+			hasPassed = false;
+		np += npFile;
+	}
+	if (np != 2 * 16 * 16 * 16)
+		hasPassed = false;
+
+	g9pICMap_del(&map);
+
+#ifdef XMEM_TRACK_MEM
+	if (allocatedBytes != global_allocated_bytes)
+		hasPassed = false;
+#endif
+
+	return hasPassed ? true : false;
+} /* g9pICMap_verifyNumParticlesWithGas */
+
 /*--- Implementations of local functions --------------------------------*/
@@ -29,6 +29,15 @@
 
 /*--- Local defines -----------------------------------------------------*/
 
+/** @brief  The maximum length of a single run in a mixed tile. */
+#define LOCAL_MAX_RUN_LENGTH UINT32_C(0xffffff)
+
+/** @brief  Extracts the level from a run. */
+#define LOCAL_RUN_LEVEL(run) ((int8_t)((run) & UINT32_C(0xff)))
+
+/** @brief  Extracts the length from a run. */
+#define LOCAL_RUN_LENGTH(run) ((run) >> 8)
+
 
 /*--- Prototypes of local functions -------------------------------------*/
 static g9pMask_t
@@ -40,6 +49,16 @@ local_setTilingFromHierarchy(g9pMask_t mask);
 static void
 local_allocateTilePointer(g9pMask_t mask);
 
+static void
+local_clearTile(g9pMask_t mask, uint32_t tile);
+
+static struct g9pMaskMixedTile_struct *
+local_newMixedTile(const g9pMask_t mask, const int8_t *data);
+
+static void
+local_calcNumCellsOfMixedTile(const g9pMask_t                mask,
+                              struct g9pMaskMixedTile_struct *mixed);
+
 static uint64_t *
 local_initNumCellVector(const g9pMask_t mask, uint64_t *numCells);
 
@@ -88,9 +107,9 @@ g9pMask_del(g9pMask_t *mask)
 
 	if ( refCounter_deref( &( (*mask)->refCounter ) ) ) {
 		for (uint32_t i = 0; i < (*mask)->totalNumTiles; i++)
-			if ( (*mask)->maskTiles[i] != NULL )
-				xfree( (*mask)->maskTiles[i] );
-		xfree( (*mask)->maskTiles );
+			local_clearTile(*mask, i);
+		xfree( (*mask)->mixedTiles );
+		xfree( (*mask)->tileLevels );
 		g9pHierarchy_del( &( (*mask)->hierarchy ) );
 
 		xfree(*mask);
@@ -149,28 +168,67 @@ g9pMask_getNumTiles(const g9pMask_t mask)
 }
 
 extern int8_t *
-g9pMask_getTileData(g9pMask_t mask, uint32_t tile)
+g9pMask_getTileData(const g9pMask_t mask, uint32_t tile, int8_t *data)
 {
 	assert(mask != NULL);
 	assert(tile < mask->totalNumTiles);
 
-	return mask->maskTiles[tile];
+	const uint64_t numCells = g9pMask_getNumCellsInMaskTile(mask);
+
+	if (data == NULL)
+		data = xmalloc(sizeof(int8_t) * numCells);
+
+	if (mask->mixedTiles[tile] == NULL) {
+		memset(data, mask->tileLevels[tile], numCells);
+	} else {
+		const struct g9pMaskMixedTile_struct *mixed;
+		uint64_t                             pos = 0;
+
+		mixed = mask->mixedTiles[tile];
+		for (uint32_t i = 0; i < mixed->numRuns; i++) {
+			uint32_t len = LOCAL_RUN_LENGTH(mixed->runs[i]);
+			memset(data + pos, LOCAL_RUN_LEVEL(mixed->runs[i]), len);
+			pos += len;
+		}
+		assert(pos == numCells);
+	}
+
+	return data;
 }
 
-extern int8_t *
+extern void
 g9pMask_setTileData(g9pMask_t mask, uint32_t tile, int8_t *data)
 {
 	assert(mask != NULL);
 	assert(tile < mask->totalNumTiles);
+	assert(data != NULL);
+
+	const uint64_t numCells = g9pMask_getNumCellsInMaskTile(mask);
+	uint64_t       i        = 1;
 
-	int8_t *oldData = NULL;
+	local_clearTile(mask, tile);
 
-	if (mask->maskTiles[tile] != data) {
-		oldData               = mask->maskTiles[tile];
-		mask->maskTiles[tile] = data;
+	while (i < numCells && data[i] == data[0])
+		i++;
+
+	if (i == numCells) {
+		assert(data[0] >= mask->minLevel && data[0] <= mask->maxLevel);
+		mask->tileLevels[tile] = data[0];
+	} else {
+		mask->tileLevels[tile] = G9PMASK_TILE_IS_MIXED;
+		mask->mixedTiles[tile] = local_newMixedTile(mask, data);
 	}
 
-	return oldData;
+	xfree(data);
+}
+
+extern int8_t
+g9pMask_getUniformLevelOfTile(const g9pMask_t mask, uint32_t tile)
+{
+	assert(mask != NULL);
+	assert(tile < mask->totalNumTiles);
+
+	return mask->tileLevels[tile];
 }
 
 extern g9pHierarchy_t
@@ -262,35 +320,14 @@ g9pMask_getNumCellsInTileForLevel(const g9pMask_t mask,
 	assert(tile < mask->totalNumTiles);
 	assert(level >= mask->minLevel && level <= mask->maxLevel);
 
-	uint64_t numCells = UINT64_C(0);
+	if (mask->mixedTiles[tile] != NULL)
+		return mask->mixedTiles[tile]->numCells[level - mask->minLevel];
 
-	if (mask->maskTiles[tile] == NULL) {
-		if (level == mask->minLevel)
-			numCells = g9pMask_getMaxNumCellsInTileForLevel(mask, level);
-		return numCells;
-	}
-
-	const int8_t   *thisTileData = mask->maskTiles[tile];
+	if (mask->tileLevels[tile] != level)
+		return UINT64_C(0);
 
-	const uint64_t nCTL          = g9pMask_getMaxNumCellsInTileForLevel(mask,
-	                                                                    level);
-	const uint64_t nCTM          = g9pMask_getNumCellsInMaskTile(mask);
-	const uint64_t nCFac         = nCTL < nCTM ? nCTM / nCTL : nCTL / nCTM;
-
-	for (uint64_t i = 0; i < nCTL; i++) {
-		if (thisTileData[i] == level)
-			numCells++;
-	}
-
-	if (nCTL < nCTM) {
-		assert(numCells % nCFac == 0);
-		numCells /= nCFac;
-	} else {
-		numCells *= nCFac;
-	}
-
-	return numCells;
-} // g9pMask_getNumCellsInTileForLevel
+	return g9pMask_getMaxNumCellsInTileForLevel(mask, level);
+}
 
 extern uint64_t *
 g9pMask_getNumCellsInTile(const g9pMask_t mask,
@@ -302,36 +339,17 @@ g9pMask_getNumCellsInTile(const g9pMask_t mask,
 
 	numCells = local_initNumCellVector(mask, numCells);
 
-	if (mask->maskTiles[tile] == NULL) {
-		numCells[0] = g9pMask_getMaxNumCellsInTileForLevel(mask,
-		                                                   mask->minLevel);
-		return numCells;
-	}
-
-	uint64_t     numCellsInTile = g9pMask_getNumCellsInMaskTile(mask);
-	const int8_t *thisTileData  = mask->maskTiles[tile];
-	for (uint64_t i = 0; i < numCellsInTile; i++) {
-		numCells[thisTileData[i] - mask->minLevel]++;
-	}
-
-	for (uint8_t i = mask->minLevel; i < mask->maskLevel; i++) {
-		uint64_t factor = g9pHierarchy_getFactorBetweenLevel(mask->hierarchy,
-		                                                     i,
-		                                                     mask->maskLevel);
-		factor                        = POW_NDIM(factor);
-		assert(numCells[i - mask->minLevel] % factor == 0);
-		numCells[i - mask->minLevel] /= factor;
-	}
-	for (uint8_t i = mask->maskLevel + 1; i <= mask->maxLevel; i++) {
-		uint64_t factor = g9pHierarchy_getFactorBetweenLevel(mask->hierarchy,
-		                                                     i,
-		                                                     mask->maskLevel);
-		factor                        = POW_NDIM(factor);
-		numCells[i - mask->minLevel] *= factor;
+	if (mask->mixedTiles[tile] != NULL) {
+		memcpy(numCells, mask->mixedTiles[tile]->numCells,
+		       sizeof(uint64_t) * g9pMask_getNumLevel(mask));
+	} else {
+		uint8_t level = (uint8_t)(mask->tileLevels[tile]);
+		numCells[level - mask->minLevel]
+		    = g9pMask_getMaxNumCellsInTileForLevel(mask, level);
 	}
 
 	return numCells;
-} // g9pMask_getNumCellsInTile
+}
 
 extern uint64_t *
 g9pMask_getNumCellsTotal(const g9pMask_t mask, uint64_t *numCells)
@@ -339,8 +357,8 @@ g9pMask_getNumCellsTotal(const g9pMask_t mask, uint64_t *numCells)
 	assert(mask != NULL);
 
 	numCells = local_initNumCellVector(mask, numCells);
-	uint64_t      *numCellsLocal;
-	const uint8_t numLevel = g9pMask_getNumLevel(mask);
+	uint64_t      *numCellsLocal = NULL;
+	const uint8_t numLevel       = g9pMask_getNumLevel(mask);
 
 	for (uint32_t i = 0; i < mask->totalNumTiles; i++) {
 		numCellsLocal = g9pMask_getNumCellsInTile(mask, i, numCellsLocal);
@@ -387,6 +405,24 @@ g9pMask_getEmptyPatchForTile(const g9pMask_t mask, const uint32_t tile)
 	return local_getEmptyPatchForTile_impl(mask, tile, dims);
 }
 
+extern gridPatch_t
+g9pMask_getEmptyPatchForTileOnLevel(const g9pMask_t mask,
+                                    const uint32_t  tile,
+                                    const uint8_t   level)
+{
+	gridPointUint32_t dims;
+
+	assert(mask != NULL);
+	assert(level >= mask->tileLevel);
+	assert(level < g9pHierarchy_getNumLevels(mask->hierarchy));
+
+	dims[0] = g9pHierarchy_getDim1DAtLevel(mask->hierarchy, level);
+	for (int i = 1; i < NDIM; i++)
+		dims[i] = dims[0];
+
+	return local_getEmptyPatchForTile_impl(mask, tile, dims);
+}
+
 /*--- Implementations of local functions --------------------------------*/
 
 static g9pMask_t
@@ -396,7 +432,8 @@ local_allocateEmptyMask()
 
 	refCounter_init( &(mask->refCounter) );
 	mask->totalNumTiles = 0;
-	mask->maskTiles     = NULL;
+	mask->tileLevels    = NULL;
+	mask->mixedTiles    = NULL;
 
 	return mask;
 }
@@ -419,15 +456,101 @@ static void
 local_allocateTilePointer(g9pMask_t mask)
 {
 	assert(mask->totalNumTiles > 0);
-	assert(mask->maskTiles == NULL);
+	assert(mask->tileLevels == NULL && mask->mixedTiles == NULL);
 
-	mask->maskTiles = xmalloc(sizeof(int8_t *) * mask->totalNumTiles);
+	mask->tileLevels = xmalloc(sizeof(int8_t) * mask->totalNumTiles);
+	mask->mixedTiles = xmalloc(sizeof(struct g9pMaskMixedTile_struct *)
+	                           * mask->totalNumTiles);
 	for (size_t i = 0; i < mask->totalNumTiles; i++) {
-		mask->maskTiles[i] = NULL;
+		mask->tileLevels[i] = (int8_t)(mask->minLevel);
+		mask->mixedTiles[i] = NULL;
+	}
+}
+
+static void
+local_clearTile(g9pMask_t mask, uint32_t tile)
+{
+	struct g9pMaskMixedTile_struct *mixed = mask->mixedTiles[tile];
+
+	if (mixed != NULL) {
+		xfree(mixed->runs);
+		xfree(mixed->numCells);
+		xfree(mixed);
+		mask->mixedTiles[tile] = NULL;
 	}
-	mask->isEmpty = true;
+	mask->tileLevels[tile] = (int8_t)(mask->minLevel);
 }
 
+static struct g9pMaskMixedTile_struct *
+local_newMixedTile(const g9pMask_t mask, const int8_t *data)
+{
+	struct g9pMaskMixedTile_struct *mixed;
+	const uint64_t                 numCells = g9pMask_getNumCellsInMaskTile(
+	    mask);
+	uint64_t                       runStart;
+	uint32_t                       run = 0;
+
+	mixed          = xmalloc(sizeof(struct g9pMaskMixedTile_struct));
+	mixed->numRuns = 0;
+	for (int pass = 0; pass < 2; pass++) {
+		runStart = 0;
+		run      = 0;
+		while (runStart < numCells) {
+			uint64_t runEnd = runStart + 1;
+			while (runEnd < numCells && data[runEnd] == data[runStart]
+			       && runEnd - runStart < LOCAL_MAX_RUN_LENGTH)
+				runEnd++;
+			if (pass == 1) {
+				assert(data[runStart] >= mask->minLevel
+				       && data[runStart] <= mask->maxLevel);
+				mixed->runs[run] = ((uint32_t)(runEnd - runStart) << 8)
+				                   | (uint8_t)(data[runStart]);
+			}
+			run++;
+			runStart = runEnd;
+		}
+		if (pass == 0) {
+			mixed->numRuns = run;
+			mixed->runs    = xmalloc(sizeof(uint32_t) * run);
+		}
+	}
+
+	local_calcNumCellsOfMixedTile(mask, mixed);
+
+	return mixed;
+} // local_newMixedTile
+
+static void
+local_calcNumCellsOfMixedTile(const g9pMask_t                mask,
+                              struct g9pMaskMixedTile_struct *mixed)
+{
+	uint64_t *numCells;
+
+	numCells = local_initNumCellVector(mask, NULL);
+	for (uint32_t i = 0; i < mixed->numRuns; i++) {
+		uint8_t level = (uint8_t)LOCAL_RUN_LEVEL(mixed->runs[i]);
+		numCells[level - mask->minLevel] += LOCAL_RUN_LENGTH(mixed->runs[i]);
+	}
+
+	for (uint8_t i = mask->minLevel; i < mask->maskLevel; i++) {
+		uint64_t factor = g9pHierarchy_getFactorBetweenLevel(mask->hierarchy,
+		                                                     i,
+		                                                     mask->maskLevel);
+		factor                        = POW_NDIM(factor);
+		assert(numCells[i - mask->minLevel] % factor == 0);
+		numCells[i - mask->minLevel] /= factor;
+	}
+	for (uint8_t i = mask->maskLevel + 1; i <= mask->maxLevel; i++) {
+		uint64_t factor = g9pHierarchy_getFactorBetweenLevel(mask->hierarchy,
+		                                                     i,
+		                                                     mask->maskLevel);
+		factor                        = POW_NDIM(factor);
+		numCells[i - mask->minLevel] *= factor;
+	}
+
+	mixed->numCells = numCells;
+} // local_calcNumCellsOfMixedTile
+
 static uint64_t *
 local_initNumCellVector(const g9pMask_t mask, uint64_t *numCells)
 {
@@ -33,6 +33,7 @@ typedef struct g9pMask_struct *g9pMask_t;
 #define G9PMASK_NO_TILING    NULL
 #define G9PMASK_IS_EMPTY     true
 #define G9PMASK_IS_NOT_EMPTY false
+#define G9PMASK_TILE_IS_MIXED -1
 
 
 /*--- Prototypes of exported functions ----------------------------------*/
@@ -82,11 +83,14 @@ extern const uint32_t *
 g9pMask_getNumTiles(const g9pMask_t mask);
 
 extern int8_t *
-g9pMask_getTileData(g9pMask_t mask, uint32_t tile);
+g9pMask_getTileData(const g9pMask_t mask, uint32_t tile, int8_t *data);
 
-extern int8_t *
+extern void
 g9pMask_setTileData(g9pMask_t mask, uint32_t tile, int8_t *data);
 
+extern int8_t
+g9pMask_getUniformLevelOfTile(const g9pMask_t mask, uint32_t tile);
+
 extern g9pHierarchy_t
 g9pMask_getHierarchyRef(g9pMask_t mask);
 
@@ -160,6 +164,11 @@ g9pMask_getEmptyGridStructure(const g9pMask_t mask);
 extern gridPatch_t
 g9pMask_getEmptyPatchForTile(const g9pMask_t mask, const uint32_t tile);
 
+extern gridPatch_t
+g9pMask_getEmptyPatchForTileOnLevel(const g9pMask_t mask,
+                                    const uint32_t  tile,
+                                    const uint8_t   level);
+
 
 /** @} */
 
@@ -17,7 +17,12 @@
 #include "g9pMaskCreator.h"
 #include "g9pMaskShapelet.h"
 #include <assert.h>
+#ifdef WITH_OPENMP
+#  include <omp.h>
+#endif
 #include "../libutil/xmem.h"
+#include "../libutil/lIdx.h"
+#include "../libutil/tile.h"
 
 
 /*--- Local defines -----------------------------------------------------*/
@@ -30,13 +35,78 @@ local_initPatchData(gridPatch_t patch, uint8_t minLevel);
 static void
 local_tagCellsInPatch(gridPatch_t             patch,
                       uint64_t                numCells,
+                      const uint64_t          *cellIdxs,
                       const gridPointUint32_t *cells,
                       const g9pMaskShapelet_t sl,
                       gridPointUint32_t       dimsGrid);
 
-static bool
-local_isCellAffectingPatch(const gridPointInt64_t dist,
-                           int8_t                 extent);
+
+/**
+ * @brief  Helper function that sorts the cells into buckets, one for
+ *         every tile the shapelet thrown on the cell will touch.
+ *
+ * This is a counting sort: the cells are counted per tile, the counts
+ * are turned into offsets and then the cell indices are placed.  Each
+ * thread works on a contiguous range of cells and places them at its
+ * own offsets, hence the order within a bucket is the input order.
+ *
+ * @param[in]   mask
+ *                 The mask, required for the tiling.
+ * @param[in]   numCells
+ *                 The number of cells.
+ * @param[in]   *cells
+ *                 The cells in grid coordinates.
+ * @param[in]   shapeExtent
+ *                 The extent of the shapelet around the cell.
+ * @param[in]   dimsGrid
+ *                 The extent of the grid.
+ * @param[out]  **bucketStart
+ *                 Will receive a new array of length numTiles + 1, the
+ *                 indices of the cells touching tile @c i are stored in
+ *                 @c bucketStart[i] to @c bucketStart[i + 1] - 1 of
+ *                 @c cellIdxs.
+ * @param[out]  **cellIdxs
+ *                 Will receive a new array holding the indices of the
+ *                 cells, sorted by tile.
+ *
+ * @return  Returns nothing.
+ */
+static void
+local_binCellsToTiles(const g9pMask_t         mask,
+                      uint64_t                numCells,
+                      const gridPointUint32_t *cells,
+                      uint32_t                shapeExtent,
+                      const gridPointUint32_t dimsGrid,
+                      uint64_t                **bucketStart,
+                      uint64_t                **cellIdxs);
+
+/**
+ * @brief  Helper function to find the tiles a shapelet thrown on a cell
+ *         touches.
+ *
+ * @param[in]   cell
+ *                 The cell in grid coordinates.
+ * @param[in]   shapeExtent
+ *                 The extent of the shapelet around the cell.
+ * @param[in]   dimsGrid
+ *                 The extent of the grid.
+ * @param[in]   numTiles
+ *                 The number of tiles in each dimension.
+ * @param[out]  *tiles
+ *                 Receives the (linear) tile numbers, this must be able
+ *                 to hold the total number of tiles.
+ *
+ * @return  Returns the number of tiles written to @c tiles.
+ */
+static uint32_t
+local_getTilesForCell(const gridPointUint32_t cell,
+                      uint32_t                shapeExtent,
+                      const gridPointUint32_t dimsGrid,
+                      const uint32_t          *numTiles,
+                      uint32_t                *tiles);
+
+inline static uint32_t
+local_getTileForIdx(uint32_t numGridCells, uint32_t numTiles, uint32_t idx);
 
 
 /**
@@ -107,17 +177,26 @@ g9pMaskCreator_fromCells(g9pMask_t               mask,
 	gridPointUint32_t gridDims;
 	gridRegular_getDims(grid, gridDims);
 
+	uint64_t *bucketStart, *cellIdxs;
+	local_binCellsToTiles(mask, numCells, cells,
+	                      g9pMaskShapelet_getDim1D(sl) / 2, gridDims,
+	                      &bucketStart, &cellIdxs);
+
 	const uint32_t totalNumTiles = g9pMask_getTotalNumTiles(mask);
 #ifdef WITH_OPENMP
-#  pragma omp parallel for
+#  pragma omp parallel for schedule(dynamic)
 #endif
 	for (uint32_t i = 0; i < totalNumTiles; i++) {
 		gridPatch_t patch = gridRegular_getPatchHandle(grid, i);
 		local_initPatchData(patch, g9pMask_getMinLevel(mask));
-		local_tagCellsInPatch(patch, numCells, cells, sl, gridDims);
+		local_tagCellsInPatch(patch, bucketStart[i + 1] - bucketStart[i],
+		                      cellIdxs + bucketStart[i], cells, sl,
+		                      gridDims);
 		local_fixTaintedLowLevelCells(patch, mask);
 		g9pMask_setTileData(mask, i, gridPatch_popVarData(patch, 0));
 	}
+	xfree(cellIdxs);
+	xfree(bucketStart);
 	g9pMaskShapelet_del(&sl);
 	gridRegular_del(&grid);
 }
@@ -136,6 +215,7 @@ local_initPatchData(gridPatch_t patch, uint8_t minLevel)
 static void
 local_tagCellsInPatch(gridPatch_t             patch,
                       uint64_t                numCells,
+                      const uint64_t          *cellIdxs,
                       const gridPointUint32_t *cells,
                       const g9pMaskShapelet_t sl,
                       gridPointUint32_t       dimsGrid)
@@ -146,34 +226,157 @@ local_tagCellsInPatch(gridPatch_t             patch,
 	gridPatch_getIdxLo(patch, idxLo);
 	gridPatch_getDims(patch, dims);
 
-	int8_t       extent  = g9pMaskShapelet_getExtent(sl);
 	int8_t       slDim1D = g9pMaskShapelet_getDim1D(sl);
 	const int8_t *slData = g9pMaskShapelet_getData(sl);
 
+	// Only cells that touch the patch have been binned to it.
 	for (uint64_t i = 0; i < numCells; i++) {
-		gridPointInt64_t dist;
-		(void)gridPatch_calcDistanceVector(patch, cells[i], dimsGrid, dist);
-		if (!local_isCellAffectingPatch(dist, extent))
-			continue;
-		local_throwShapeOnMask(data, cells[i], slData, slDim1D,
+		local_throwShapeOnMask(data, cells[cellIdxs[i]], slData, slDim1D,
 		                       idxLo, dims, dimsGrid);
 	}
 }
 
-static bool
-local_isCellAffectingPatch(const gridPointInt64_t dist,
-                           int8_t                 extent)
+static void
+local_binCellsToTiles(const g9pMask_t         mask,
+                      uint64_t                numCells,
+                      const gridPointUint32_t *cells,
+                      uint32_t                shapeExtent,
+                      const gridPointUint32_t dimsGrid,
+                      uint64_t                **bucketStart,
+                      uint64_t                **cellIdxs)
 {
-	bool isAffecting = false;
+	const uint32_t totalNumTiles = g9pMask_getTotalNumTiles(mask);
+	const uint32_t *numTiles     = g9pMask_getNumTiles(mask);
+	int            numThreads    = 1;
+	uint64_t       *counts       = NULL;
+
+	*bucketStart = xmalloc(sizeof(uint64_t) * (totalNumTiles + 1));
+
+#ifdef WITH_OPENMP
+#  pragma omp parallel shared(numThreads, counts)
+#endif
+	{
+		int      t      = 0;
+		uint32_t *tiles = xmalloc(sizeof(uint32_t) * totalNumTiles);
+		uint64_t *myCounts, cellLo, cellHi;
+
+		// One row of counts per thread, later turned into write offsets.
+#ifdef WITH_OPENMP
+#  pragma omp single
+#endif
+		{
+#ifdef WITH_OPENMP
+			numThreads = omp_get_num_threads();
+#endif
+			counts = xmalloc(sizeof(uint64_t) * totalNumTiles * numThreads);
+			for (uint64_t i = 0; i < (uint64_t)totalNumTiles * numThreads;
+			     i++)
+				counts[i] = 0;
+		}
+#ifdef WITH_OPENMP
+		t = omp_get_thread_num();
+#endif
+		myCounts = counts + (uint64_t)t * totalNumTiles;
+		cellLo   = numCells * t / numThreads;
+		cellHi   = numCells * (t + 1) / numThreads;
+
+		for (uint64_t i = cellLo; i < cellHi; i++) {
+			uint32_t n = local_getTilesForCell(cells[i], shapeExtent,
+			                                   dimsGrid, numTiles, tiles);
+			for (uint32_t j = 0; j < n; j++)
+				myCounts[tiles[j]]++;
+		}
+#ifdef WITH_OPENMP
+#  pragma omp barrier
+#  pragma omp single
+#endif
+		{
+			uint64_t numEntries = 0;
+			for (uint32_t tile = 0; tile < totalNumTiles; tile++) {
+				(*bucketStart)[tile] = numEntries;
+				for (int k = 0; k < numThreads; k++) {
+					uint64_t *c = counts + (uint64_t)k * totalNumTiles + tile;
+					uint64_t num = *c;
+					*c          = numEntries;
+					numEntries += num;
+				}
+			}
+			(*bucketStart)[totalNumTiles] = numEntries;
+			*cellIdxs = xmalloc(sizeof(uint64_t) * (numEntries + 1));
+		}
 
-	for (int i = 0; i < NDIM; i++) {
-		if (((dist[i] < 0) && (-dist[i] < extent)) || (dist[i] < extent))
-			isAffecting = true;
+		for (uint64_t i = cellLo; i < cellHi; i++) {
+			uint32_t n = local_getTilesForCell(cells[i], shapeExtent,
+			                                   dimsGrid, numTiles, tiles);
+			for (uint32_t j = 0; j < n; j++)
+				(*cellIdxs)[myCounts[tiles[j]]++] = i;
+		}
+		xfree(tiles);
 	}
 
-	return isAffecting;
+	xfree(counts);
+} /* local_binCellsToTiles */
+
+inline static uint32_t
+local_getTileForIdx(uint32_t numGridCells, uint32_t numTiles, uint32_t idx)
+{
+	// The tiling does not handle tiles of a single cell.
+	if (numTiles == numGridCells)
+		return idx;
+
+	return tile_calcTileNumberForIdxELAE(numGridCells, numTiles, idx);
 }
 
+/*
+ * Along each dimension the shapelet covers a periodic range of cells,
+ * the tiles touched by it are hence a cyclic sequence starting at the
+ * tile of the first cell of the range.
+ */
+static uint32_t
+local_getTilesForCell(const gridPointUint32_t cell,
+                      uint32_t                shapeExtent,
+                      const gridPointUint32_t dimsGrid,
+                      const uint32_t          *numTiles,
+                      uint32_t                *tiles)
+{
+	uint32_t firstTile[NDIM], numTilesDim[NDIM];
+	uint32_t numTilesCell = 1;
+
+	for (int d = 0; d < NDIM; d++) {
+		uint32_t numPos = 2 * shapeExtent + 1;
+		uint32_t pos    = (cell[d] + dimsGrid[d] - shapeExtent % dimsGrid[d])
+		                  % dimsGrid[d];
+		uint32_t tile   = local_getTileForIdx(dimsGrid[d], numTiles[d], pos);
+
+		numPos         = (numPos > dimsGrid[d]) ? dimsGrid[d] : numPos;
+		firstTile[d]   = tile;
+		numTilesDim[d] = 1;
+		for (uint32_t i = 1; i < numPos; i++) {
+			uint32_t tileNext;
+			pos      = (pos + 1) % dimsGrid[d];
+			tileNext = local_getTileForIdx(dimsGrid[d], numTiles[d], pos);
+			if (tileNext != tile)
+				numTilesDim[d]++;
+			tile = tileNext;
+		}
+		if (numTilesDim[d] > numTiles[d])
+			numTilesDim[d] = numTiles[d];
+		numTilesCell *= numTilesDim[d];
+	}
+
+	for (uint32_t i = 0; i < numTilesCell; i++) {
+		uint32_t tilePos[NDIM];
+		uint32_t rest = i;
+		for (int d = 0; d < NDIM; d++) {
+			tilePos[d] = (firstTile[d] + rest % numTilesDim[d]) % numTiles[d];
+			rest      /= numTilesDim[d];
+		}
+		tiles[i] = (uint32_t)lIdx_fromCoordNd(tilePos, numTiles, NDIM);
+	}
+
+	return numTilesCell;
+} /* local_getTilesForCell */
+
 inline static void
 local_throwShapeOnMask(int8_t *restrict        maskData,
                        const gridPointUint32_t hiResCellIdxG,
@@ -21,15 +21,17 @@
 #ifdef WITH_MPI
 #  include <mpi.h>
 #endif
-#ifdef XMEM_TRACK_MEM
-#  include "../libutil/xmem.h"
-#endif
+#include "../libutil/xmem.h"
+#include "../libutil/lIdx.h"
+#include "../libgrid/gridPatch.h"
 
 
 /*--- Local defines -----------------------------------------------------*/
 
 
 /*--- Prototypes of local functions -------------------------------------*/
+static int8_t *
+local_getFullMask(g9pMask_t mask);
 
 
 /*--- Implementations of exported functions -----------------------------*/
@@ -509,4 +511,97 @@ g9pMaskCreator_verifyMaskIfTwoCellsAreTaggedSlightOverlap(void)
 	return hasPassed ? true : false;
 }
 
+extern bool
+g9pMaskCreator_verifyMaskIsIndependentOfTiling(void)
+{
+	bool     hasPassed      = true;
+	int      rank           = 0;
+	uint32_t seed           = 4223;
+	uint64_t numCells       = 200;
+#ifdef XMEM_TRACK_MEM
+	size_t   allocatedBytes = global_allocated_bytes;
+#endif
+#ifdef WITH_MPI
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+#endif
+
+	if (rank == 0)
+		printf("Testing %s... ", __func__);
+
+	// level: 0   1   2   3   4   5   6
+	// resol: 2   4   8  16  32  64 128
+	g9pHierarchy_t    h     = g9pHierarchy_newWithSimpleFactor(7, 2, 2);
+	// Mask at 32^3, minLevel at 16^3, maxLevel at 128^3
+	g9pMask_t         m0    = g9pMask_newMinMaxTiledMask(h, 4, 3, 6, 0);
+	g9pMask_t         m3    = g9pMask_newMinMaxTiledMask(h, 4, 3, 6, 3);
+	gridPointUint32_t *cell = xmalloc(sizeof(gridPointUint32_t) * numCells);
+	uint64_t          numCellsMask;
+
+	// Scattered cells, many of them touch several tiles of the fine
+	// tiling, some wrap around the box.
+	for (uint64_t i = 0; i < numCells; i++) {
+		for (int j = 0; j < NDIM; j++) {
+			seed       = seed * 1103515245 + 12345;
+			cell[i][j] = (seed >> 16) % 32;
+		}
+	}
+
+	g9pMaskCreator_fromCells(m0, numCells, cell);
+	g9pMaskCreator_fromCells(m3, numCells, cell);
+
+	int8_t *full0 = local_getFullMask(m0);
+	int8_t *full3 = local_getFullMask(m3);
+	numCellsMask  = POW_NDIM((uint64_t)g9pMask_getDim1D(m0));
+	if (memcmp(full0, full3, numCellsMask) != 0)
+		hasPassed = false;
+
+	xfree(full3);
+	xfree(full0);
+	xfree(cell);
+	g9pMask_del(&m3);
+	g9pMask_del(&m0);
+
+#ifdef XMEM_TRACK_MEM
+	if (allocatedBytes != global_allocated_bytes)
+		hasPassed = false;
+#endif
+
+	return hasPassed ? true : false;
+} /* g9pMaskCreator_verifyMaskIsIndependentOfTiling */
+
 /*--- Implementations of local functions --------------------------------*/
+static int8_t *
+local_getFullMask(g9pMask_t mask)
+{
+	gridPointUint32_t dims;
+	uint64_t          numCells = 1;
+	int8_t            *full;
+
+	for (int i = 0; i < NDIM; i++) {
+		dims[i]   = g9pMask_getDim1D(mask);
+		numCells *= dims[i];
+	}
+	full = xmalloc(numCells);
+
+	for (uint32_t t = 0; t < g9pMask_getTotalNumTiles(mask); t++) {
+		gridPatch_t       patch = g9pMask_getEmptyPatchForTile(mask, t);
+		int8_t            *data = g9pMask_getTileData(mask, t, NULL);
+		gridPointUint32_t idxLo, dimsTile, coord;
+		uint64_t          numCellsTile;
+
+		gridPatch_getIdxLo(patch, idxLo);
+		gridPatch_getDims(patch, dimsTile);
+		numCellsTile = gridPatch_getNumCells(patch);
+		for (uint64_t i = 0; i < numCellsTile; i++) {
+			lIdx_toCoordNd(i, dimsTile, NDIM, coord);
+			for (int j = 0; j < NDIM; j++)
+				coord[j] += idxLo[j];
+			full[lIdx_fromCoordNd(coord, dims, NDIM)] = data[i];
+		}
+		xfree(data);
+		gridPatch_del(&patch);
+	}
+
+	return full;
+}
+
@@ -39,6 +39,9 @@ g9pMaskCreator_verifyMaskIfThreeCellsAreTaggedInOneTile(void);
 extern bool
 g9pMaskCreator_verifyMaskIfTwoCellsAreTaggedSlightOverlap(void);
 
+extern bool
+g9pMaskCreator_verifyMaskIsIndependentOfTiling(void);
+
 
 /*--- Doxygen group definitions -----------------------------------------*/
 
@@ -18,7 +18,6 @@
 #include "g9pHierarchyIO.h"
 #include <assert.h>
 #include "../libutil/xmem.h"
-#include "../libutil/diediedie.h"
 #include "../libgrid/gridWriter.h"
 #include "../libgrid/gridReader.h"
 
@@ -51,7 +50,7 @@ local_verifyLevels(uint8_t              maskLevel,
                    const g9pHierarchy_t h);
 
 static void
-local_mvDataMask2Grid(g9pMask_t mask, gridRegular_t grid);
+local_cpDataMask2Grid(g9pMask_t mask, gridRegular_t grid);
 
 static void
 local_mvDataGrid2Mask(g9pMask_t mask, gridRegular_t grid);
@@ -85,14 +84,12 @@ g9pMaskIO_write(g9pMask_t mask, gridWriter_t writer)
 {
 	gridRegular_t grid = g9pMask_getEmptyGridStructure(mask);
 
-	local_mvDataMask2Grid(mask, grid);
+	local_cpDataMask2Grid(mask, grid);
 
 	gridWriter_activate(writer);
 	gridWriter_writeGridRegular(writer, grid);
 	gridWriter_deactivate(writer);
 
-	local_mvDataGrid2Mask(mask, grid);
-
 	gridRegular_del(&grid);
 }
 
@@ -232,13 +229,14 @@ local_verifyLevels(uint8_t              maskLevel,
 }
 
 static void
-local_mvDataMask2Grid(g9pMask_t mask, gridRegular_t grid)
+local_cpDataMask2Grid(g9pMask_t mask, gridRegular_t grid)
 {
 	const uint32_t numTiles = g9pMask_getTotalNumTiles(mask);
 	for (uint32_t i = 0; i < numTiles; i++) {
 		gridPatch_t patch = gridRegular_getPatchHandle(grid, i);
 
-		gridPatch_replaceVarData(patch, 0, g9pMask_getTileData(mask, i));
+		gridPatch_replaceVarData(patch, 0,
+		                         g9pMask_getTileData(mask, i, NULL));
 	}
 }
 
@@ -247,12 +245,8 @@ local_mvDataGrid2Mask(g9pMask_t mask, gridRegular_t grid)
 {
 	const uint32_t numTiles = g9pMask_getTotalNumTiles(mask);
 	for (uint32_t i = 0; i < numTiles; i++) {
-		int8_t      *d;
 		gridPatch_t patch = gridRegular_getPatchHandle(grid, i);
 
-		d = g9pMask_setTileData(mask, i, gridPatch_popVarData(patch, 0));
-
-		if (d != NULL)
-			diediedie(EXIT_FAILURE);
+		g9pMask_setTileData(mask, i, gridPatch_popVarData(patch, 0));
 	}
 }
@@ -219,13 +219,18 @@ local_checkMasksAreEqual(g9pMask_t m1, g9pMask_t m2)
 		return false;
 
 	for (int i = 0; i < g9pMask_getTotalNumTiles(m1); i++) {
-		const int8_t *d1 = g9pMask_getTileData(m1, i);
-		const int8_t *d2 = g9pMask_getTileData(m2, i);
+		int8_t *d1     = g9pMask_getTileData(m1, i, NULL);
+		int8_t *d2     = g9pMask_getTileData(m2, i, NULL);
+		bool   isEqual = true;
 
 		for (uint64_t i = 0; i < g9pMask_getNumCellsInMaskTile(m1); i++) {
 			if (d1[i] != d2[i])
-				return false;
+				isEqual = false;
 		}
+		xfree(d2);
+		xfree(d1);
+		if (!isEqual)
+			return false;
 	}
 
 	return true;
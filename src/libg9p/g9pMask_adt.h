@@ -23,6 +23,17 @@
 
 
 /*--- ADT implementation ------------------------------------------------*/
+
+/** @brief  The run-length encoded data of a tile holding several levels. */
+struct g9pMaskMixedTile_struct {
+	/// @brief  The number of cells per level (from the minimum level on).
+	uint64_t *numCells;
+	/// @brief  The number of runs.
+	uint32_t numRuns;
+	/// @brief  The runs, the lowest byte is the level, the rest the length.
+	uint32_t *runs;
+};
+
 struct g9pMask_struct {
 	/// @brief The reference counter.
 	refCounter_t refCounter;
@@ -34,8 +45,10 @@ struct g9pMask_struct {
 
 	uint32_t          totalNumTiles;
 	gridPointUint32_t numTiles;
-	int8_t            **maskTiles;
-	bool              isEmpty;
+	/// @brief  The level of each uniform tile or G9PMASK_TILE_IS_MIXED.
+	int8_t                         *tileLevels;
+	/// @brief  The data of the mixed tiles, NULL for uniform tiles.
+	struct g9pMaskMixedTile_struct **mixedTiles;
 };
 
 
@@ -260,6 +260,22 @@ g9pMask_verifyCreationOfPatch(void)
 				hasPassed = false;
 		}
 		gridPatch_del(&p);
+
+		p = g9pMask_getEmptyPatchForTileOnLevel(mask, i, 5);
+		if ( gridPatch_getNumCells(p) != gridPatch_getNumCells(pG) )
+			hasPassed = false;
+		gridPatch_del(&p);
+
+		p = g9pMask_getEmptyPatchForTileOnLevel(mask, i, 7);
+		gridPatch_getIdxLo(p, idxLo);
+		gridPatch_getDims(p, dims);
+		for (int i = 0; i < NDIM; i++) {
+			if (idxLo[i] != idxLoG[i] * (g_dims[7] / g_dims[5]))
+				hasPassed = false;
+			if (dims[i] != dimsG[i] * (g_dims[7] / g_dims[5]))
+				hasPassed = false;
+		}
+		gridPatch_del(&p);
 	}
 
 
@@ -314,6 +330,82 @@ g9pMask_verifyDelete(void)
 	return hasPassed ? true : false;
 } // g9pMask_verifyDelete
 
+extern bool
+g9pMask_verifyTileData(void)
+{
+	bool   hasPassed      = true;
+	int    rank           = 0;
+#ifdef XMEM_TRACK_MEM
+	size_t allocatedBytes = global_allocated_bytes;
+#endif
+#ifdef WITH_MPI
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+#endif
+
+	if (rank == 0)
+		printf("Testing %s... ", __func__);
+
+	g9pHierarchy_t h        = local_getHierarchy();
+	g9pMask_t      mask     = g9pMask_newMinMaxTiledMask(h, 5, 3, 9, 2);
+	uint64_t       numCells = g9pMask_getNumCellsInMaskTile(mask);
+	uint64_t       *counts  = NULL;
+	int8_t         *data;
+
+	// Tile 0 is uniform at the mask level.
+	data = xmalloc(numCells);
+	memset(data, 5, numCells);
+	g9pMask_setTileData(mask, 0, data);
+	if (g9pMask_getUniformLevelOfTile(mask, 0) != 5)
+		hasPassed = false;
+	counts = g9pMask_getNumCellsInTile(mask, 0, counts);
+	for (uint8_t i = 0; i < g9pMask_getNumLevel(mask); i++) {
+		if (counts[i] != (i == 2 ? numCells : 0))
+			hasPassed = false;
+	}
+
+	// Tile 1 has one half at level 4 and the other half at level 6.
+	data = xmalloc(numCells);
+	for (uint64_t i = 0; i < numCells; i++)
+		data[i] = (i % 24 < 12) ? 4 : 6;
+	g9pMask_setTileData(mask, 1, g9pMask_getTileData(mask, 0, NULL));
+	g9pMask_setTileData(mask, 1, data);
+	if (g9pMask_getUniformLevelOfTile(mask, 1) != G9PMASK_TILE_IS_MIXED)
+		hasPassed = false;
+	data = g9pMask_getTileData(mask, 1, NULL);
+	for (uint64_t i = 0; i < numCells; i++) {
+		if (data[i] != ((i % 24 < 12) ? 4 : 6))
+			hasPassed = false;
+	}
+	xfree(data);
+	counts = g9pMask_getNumCellsInTile(mask, 1, counts);
+	if ((counts[1] != 864) || (counts[3] != 186624))
+		hasPassed = false;
+	if (g9pMask_getNumCellsInTileForLevel(mask, 1, 4) != 864)
+		hasPassed = false;
+	if (g9pMask_getNumCellsInTileForLevel(mask, 1, 6) != 186624)
+		hasPassed = false;
+	if (g9pMask_getNumCellsInTileForLevel(mask, 1, 5) != 0)
+		hasPassed = false;
+
+	// All other tiles are still at the minimum level.
+	if (g9pMask_getUniformLevelOfTile(mask, 2) != 3)
+		hasPassed = false;
+	counts = g9pMask_getNumCellsTotal(mask, counts);
+	if ((counts[0] != 510 * 64) || (counts[1] != 864)
+	    || (counts[2] != numCells) || (counts[3] != 186624)
+	    || (counts[4] != 0))
+		hasPassed = false;
+
+	xfree(counts);
+	g9pMask_del(&mask);
+#ifdef XMEM_TRACK_MEM
+	if (allocatedBytes != global_allocated_bytes)
+		hasPassed = false;
+#endif
+
+	return hasPassed ? true : false;
+} // g9pMask_verifyTileData
+
 /*--- Implementations of local functions --------------------------------*/
 static g9pHierarchy_t
 local_getHierarchy(void)
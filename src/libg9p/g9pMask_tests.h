@@ -44,6 +44,15 @@ g9pMask_verifyCreationOfPatch(void);
 extern bool
 g9pMask_verifyDelete(void);
 
+/**
+ * @brief  Verifies that tile data survives the compact storage and that
+ *         the cached cell counts are correct.
+ *
+ * @return  Returns @c true if the test passed and @c false otherwise.
+ */
+extern bool
+g9pMask_verifyTileData(void);
+
 
 /*--- Doxygen group definitions -----------------------------------------*/
 
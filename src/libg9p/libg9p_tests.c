@@ -108,6 +108,7 @@ main(int argc, char **argv)
 	RUNTEST(&g9pMask_verifyCreationOfGridStructure, hasFailed);
 	RUNTEST(&g9pMask_verifyCreationOfPatch, hasFailed);
 	RUNTEST(&g9pMask_verifyDelete, hasFailed);
+	RUNTEST(&g9pMask_verifyTileData, hasFailed);
 #ifdef XMEM_TRACK_MEM
 	if (rank == 0)
 		xmem_info(stdout);
@@ -154,6 +155,8 @@ main(int argc, char **argv)
 	        hasFailed);
 	RUNTEST(&g9pMaskCreator_verifyMaskIfTwoCellsAreTaggedSlightOverlap,
 	        hasFailed);
+	RUNTEST(&g9pMaskCreator_verifyMaskIsIndependentOfTiling,
+	        hasFailed);
 #ifdef XMEM_TRACK_MEM
 	if (rank == 0)
 		xmem_info(stdout);
@@ -164,6 +167,7 @@ main(int argc, char **argv)
 		printf("\nRunning tests for g9pICMap:\n");
 	}
 	RUNTEST(&g9pICMap_verifySimpleMapCreation, hasFailed);
+	RUNTEST(&g9pICMap_verifyNumParticlesWithGas, hasFailed);
 #ifdef XMEM_TRACK_MEM
 	if (rank == 0)
 		xmem_info(stdout);
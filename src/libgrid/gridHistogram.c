@@ -61,9 +61,6 @@ local_count(void *data, dataVar_t var, uint64_t len, gridHistogram_t histo);
 static void
 local_countValue(double value, gridHistogram_t histo);
 
-static int
-local_cmpFunc(const void *val, const void *bins);
-
 
 #ifdef WITH_MPI
 static void
@@ -86,6 +83,7 @@ gridHistogram_new(uint32_t numBins, double min, double max)
 	histo               = local_mallocHistogram(numBins);
 
 	delta               = (max - min) / numBins;
+	histo->invBinWidth  = 1. / delta;
 	histo->binLimits[0] = -HUGE_VAL;
 	for (int i = 1; i < histo->numBins - 1; i++)
 		histo->binLimits[i] = min + (i - 1) * delta;
@@ -149,6 +147,54 @@ gridHistogram_calcGridRegularDistrib(gridHistogram_t            histo,
 	                      NULL, idxOfVar);
 }
 
+extern uint32_t
+gridHistogram_getNumBins(const gridHistogram_t histo)
+{
+	assert(histo != NULL);
+
+	return histo->numBins;
+}
+
+extern uint32_t
+gridHistogram_calcBin(const gridHistogram_t histo, double value)
+{
+	const uint32_t lastBin = histo->numBins - 1;
+	uint32_t       bin;
+
+	assert(histo != NULL);
+
+	if (!(value >= histo->binLimits[1]))
+		return 0;
+	if (value >= histo->binLimits[lastBin])
+		return lastBin;
+
+	// Guess the bin from the bin width and correct for rounding.
+	bin = 1 + (uint32_t)((value - histo->binLimits[1]) * histo->invBinWidth);
+	if (bin > lastBin - 1)
+		bin = lastBin - 1;
+	while (value < histo->binLimits[bin])
+		bin--;
+	while (value >= histo->binLimits[bin + 1])
+		bin++;
+
+	return bin;
+}
+
+extern void
+gridHistogram_setCounts(gridHistogram_t histo, const uint64_t *counts)
+{
+	assert(histo != NULL);
+	assert(counts != NULL);
+
+	local_nullHistogram(histo);
+	for (uint32_t i = 0; i < histo->numBins; i++) {
+		histo->binCounts[i] = (uint32_t)counts[i];
+		histo->totalCounts += counts[i];
+		if ((i > 0) && (i < histo->numBins - 1))
+			histo->totalCountsInRange += counts[i];
+	}
+}
+
 extern uint32_t
 gridHistogram_getCountInBin(const gridHistogram_t histo, uint32_t bin)
 {
@@ -278,8 +324,10 @@ local_calcRegularCore(gridHistogram_t            histo,
 	for (int i = 0; i < numPatches; i++) {
 		gridPatch_t myPatch;
 		dataVar_t   dataVar;
-		void        *data;
-		uint64_t    len;
+		char        *data;
+		uint64_t    numRows;
+		uint32_t    dim0, dimActual0;
+		size_t      size;
 		if (grid != NULL)
 			myPatch = gridRegular_getPatchHandle(grid, i);
 		else
@@ -287,9 +335,14 @@ local_calcRegularCore(gridHistogram_t            histo,
 
 		dataVar = gridPatch_getVarHandle(myPatch, idxOfVar);
 		data    = gridPatch_getVarDataHandle(myPatch, idxOfVar);
-		len     = gridPatch_getNumCells(myPatch);
-
-		local_count(data, dataVar, len, histo);
+		size    = dataVar_getSizePerElement(dataVar);
+
+		// Count row by row, the rows may be followed by FFTW padding.
+		dim0       = gridPatch_getOneDim(myPatch, 0);
+		dimActual0 = gridPatch_getDimActual1D(myPatch, idxOfVar, 0);
+		numRows    = gridPatch_getNumCells(myPatch) / dim0;
+		for (uint64_t j = 0; j < numRows; j++)
+			local_count(data + j * dimActual0 * size, dataVar, dim0, histo);
 	}
 
 	if (distrib != NULL) {
@@ -356,13 +409,9 @@ local_count(void *data, dataVar_t var, uint64_t len, gridHistogram_t histo)
 static void
 local_countValue(double value, gridHistogram_t histo)
 {
-	double   *leftBinEdge;
 	uint32_t binNumber;
 
-	leftBinEdge = bsearch(&value, histo->binLimits,
-	                      (size_t)(histo->numBins),
-	                      sizeof(double), &local_cmpFunc);
-	binNumber = leftBinEdge - histo->binLimits;
+	binNumber = gridHistogram_calcBin(histo, value);
 	assert(binNumber < histo->numBins);
 	histo->binCounts[binNumber]++;
 	histo->totalCounts++;
@@ -371,21 +420,6 @@ local_countValue(double value, gridHistogram_t histo)
 	}
 }
 
-static int
-local_cmpFunc(const void *val, const void *bins)
-{
-	double *value        = (double *)val;
-	double *leftBinLimit = (double *)bins;
-
-	if ((value[0] >= leftBinLimit[0]) && (value[0] < leftBinLimit[1]))
-		return 0;
-
-	if (value[0] < leftBinLimit[0])
-		return -1;
-
-	return 1;
-}
-
 #ifdef WITH_MPI
 static void
 local_mpiReduceHisto(gridHistogram_t histo, MPI_Comm comm)
@@ -51,6 +51,15 @@ gridHistogram_calcGridRegularDistrib(gridHistogram_t            histo,
                                      const gridRegularDistrib_t distrib,
                                      int                        idxOfVar);
 
+extern uint32_t
+gridHistogram_getNumBins(const gridHistogram_t histo);
+
+extern uint32_t
+gridHistogram_calcBin(const gridHistogram_t histo, double value);
+
+extern void
+gridHistogram_setCounts(gridHistogram_t histo, const uint64_t *counts);
+
 extern uint32_t
 gridHistogram_getCountInBin(const gridHistogram_t histo, uint32_t bin);
 
@@ -29,6 +29,8 @@ struct gridHistogram_struct {
 	uint32_t numBinsReal;
 	/** @brief  Stores the corners of the bins. */
 	double   *binLimits;
+	/** @brief  The inverse of the width of the bins within the range. */
+	double   invBinWidth;
 	/** @brief  Stores the number of counts in each bin. */
 	uint32_t *binCounts;
 	/** @brief  Stores the total number of counts. */
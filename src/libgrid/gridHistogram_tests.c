@@ -47,6 +47,12 @@ local_getFakeGrid(void);
 static gridRegularDistrib_t
 local_getFakeDistrib(void);
 
+static gridPatch_t
+local_getPaddedPatch(void);
+
+static bool
+local_checkPaddedPatch(const gridPatch_t patch);
+
 
 /*--- Implementations of exported functios ------------------------------*/
 extern bool
@@ -226,6 +232,95 @@ gridHistogram_calcGridRegularDistrib_test(void)
 	return hasPassed ? true : false;
 } /* gridHistogram_calcGridRegularDistrib_test */
 
+extern bool
+gridHistogram_calcBin_test(void)
+{
+	bool            hasPassed = true;
+	int             rank      = 0;
+	gridHistogram_t gridHistogram;
+	uint32_t        numBins;
+#ifdef XMEM_TRACK_MEM
+	size_t          allocatedBytes = global_allocated_bytes;
+#endif
+#ifdef WITH_MPI
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+#endif
+
+	if (rank == 0)
+		printf("Testing %s... ", __func__);
+
+	gridHistogram = gridHistogram_new(7, -3.0, 3.0);
+	numBins       = gridHistogram_getNumBins(gridHistogram);
+	if (numBins != 9)
+		hasPassed = false;
+
+	if (gridHistogram_calcBin(gridHistogram, -1e10) != 0)
+		hasPassed = false;
+	if (gridHistogram_calcBin(gridHistogram, 3.0) != numBins - 1)
+		hasPassed = false;
+	if (gridHistogram_calcBin(gridHistogram, 1e10) != numBins - 1)
+		hasPassed = false;
+	for (uint32_t i = 1; i < numBins - 1; i++) {
+		double left  = gridHistogram->binLimits[i];
+		double right = gridHistogram->binLimits[i + 1];
+		if (gridHistogram_calcBin(gridHistogram, left) != i)
+			hasPassed = false;
+		if (gridHistogram_calcBin(gridHistogram, nextafter(right, left)) != i)
+			hasPassed = false;
+		if (gridHistogram_calcBin(gridHistogram, .5 * (left + right)) != i)
+			hasPassed = false;
+	}
+
+	gridHistogram_del(&gridHistogram);
+#ifdef XMEM_TRACK_MEM
+	if (allocatedBytes != global_allocated_bytes)
+		hasPassed = false;
+#endif
+
+	return hasPassed ? true : false;
+} /* gridHistogram_calcBin_test */
+
+extern bool
+gridHistogram_calcGridPatchPadded_test(void)
+{
+	bool            hasPassed = true;
+	int             rank      = 0;
+	gridHistogram_t gridHistogram;
+	gridPatch_t     patch;
+#ifdef XMEM_TRACK_MEM
+	size_t          allocatedBytes = global_allocated_bytes;
+#endif
+#ifdef WITH_MPI
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+#endif
+
+	if (rank == 0)
+		printf("Testing %s... ", __func__);
+
+	patch         = local_getPaddedPatch();
+	gridHistogram = gridHistogram_new(4, -0.5, 3.5);
+	gridHistogram_calcGridPatch(gridHistogram, patch, 0);
+
+	// The padding would end up in the overflow bin.
+	if (gridHistogram->binCounts[gridHistogram->numBins - 1] != 0)
+		hasPassed = false;
+	for (uint32_t i = 1; i < gridHistogram->numBins - 1; i++) {
+		if (gridHistogram->binCounts[i] != 18)
+			hasPassed = false;
+	}
+	if (!local_checkPaddedPatch(patch))
+		hasPassed = false;
+
+	gridHistogram_del(&gridHistogram);
+	gridPatch_del(&patch);
+#ifdef XMEM_TRACK_MEM
+	if (allocatedBytes != global_allocated_bytes)
+		hasPassed = false;
+#endif
+
+	return hasPassed ? true : false;
+} /* gridHistogram_calcGridPatchPadded_test */
+
 /*--- Implementations of local functions --------------------------------*/
 static gridPatch_t
 local_getFakePatch(void)
@@ -323,3 +418,52 @@ local_getFakeDistrib(void)
 
 	return distrib;
 } /* local_getFakeDistrib */
+
+static gridPatch_t
+local_getPaddedPatch(void)
+{
+	gridPatch_t       patch;
+	dataVar_t         var;
+	gridPointUint32_t idxLo = { 0, 0, 0 };
+	gridPointUint32_t idxHi = { 5, 3, 2 };
+	uint64_t          numCellsActual;
+	uint32_t          dim0, dim0Actual;
+	fpv_t             *data;
+
+	var   = dataVar_new("Padded", DATAVARTYPE_FPV, 1);
+	dataVar_setFFTWPadded(var);
+	patch = gridPatch_new(idxLo, idxHi);
+	gridPatch_attachVar(patch, var);
+
+	// The cells hold 0, 1, 2, 3, ..., the padding a value far off.
+	numCellsActual = gridPatch_getNumCellsActual(patch, 0);
+	dim0           = gridPatch_getOneDim(patch, 0);
+	dim0Actual     = gridPatch_getDimActual1D(patch, 0, 0);
+	data           = gridPatch_getVarDataHandle(patch, 0);
+	for (uint64_t i = 0; i < numCellsActual; i++) {
+		uint64_t row = i / dim0Actual;
+		uint32_t col = (uint32_t)(i % dim0Actual);
+		data[i] = (col < dim0) ? (fpv_t)((row * dim0 + col) % 4) : 1e3;
+	}
+
+	return patch;
+}
+
+static bool
+local_checkPaddedPatch(const gridPatch_t patch)
+{
+	uint64_t    numCellsActual = gridPatch_getNumCellsActual(patch, 0);
+	uint32_t    dim0           = gridPatch_getOneDim(patch, 0);
+	uint32_t    dim0Actual     = gridPatch_getDimActual1D(patch, 0, 0);
+	const fpv_t *data          = gridPatch_getVarDataHandle(patch, 0);
+
+	for (uint64_t i = 0; i < numCellsActual; i++) {
+		uint64_t row = i / dim0Actual;
+		uint32_t col = (uint32_t)(i % dim0Actual);
+		fpv_t    exp = (col < dim0) ? (fpv_t)((row * dim0 + col) % 4) : 1e3;
+		if (data[i] != exp)
+			return false;
+	}
+
+	return true;
+}
@@ -36,5 +36,11 @@ gridHistogram_calcGridRegular_test(void);
 extern bool
 gridHistogram_calcGridRegularDistrib_test(void);
 
+extern bool
+gridHistogram_calcBin_test(void);
+
+extern bool
+gridHistogram_calcGridPatchPadded_test(void);
+
 
 #endif
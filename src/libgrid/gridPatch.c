@@ -18,6 +18,7 @@
 #include "gridPoint.h"
 #include <assert.h>
 #include <stdint.h>
+#include <stdbool.h>
 #include <string.h>
 #include "../libutil/xmem.h"
 #include "../libutil/varArr.h"
@@ -30,9 +31,40 @@
 
 /*--- Local defines -----------------------------------------------------*/
 
+/** @brief  The edge length (in elements) of the tiles used for transposing. */
+#define LOCAL_TRANSPOSE_TILE 32
+
+/** @brief  The largest element size handled without a byte-wise loop. */
+#define LOCAL_MAX_ELEMENT_SIZE 16
+
 
 /*--- Prototypes of local functions -------------------------------------*/
 
+/**
+ * @brief  Gives the layout of the rows along the first dimension.
+ *
+ * @param[in]   patch
+ *                 The patch to use.
+ * @param[in]   idxOfVar
+ *                 The variable to look at.
+ * @param[out]  *sizeRow
+ *                 Receives the size of the cells of a row in bytes.
+ * @param[out]  *strideRow
+ *                 Receives the distance between two rows in bytes,
+ *                 including the padding.
+ * @param[out]  *numRows
+ *                 Receives the number of rows.
+ *
+ * @return  Returns nothing.
+ */
+static void
+local_getRowLayout(const gridPatch_t patch,
+                   int               idxOfVar,
+                   size_t            *sizeRow,
+                   size_t            *strideRow,
+                   uint64_t          *numRows);
+
+
 /**
  * @brief  Implements the tranpose operation for a given variable.
  *
@@ -62,7 +94,9 @@ local_transposeVar(gridPatch_t patch,
  * @param[in]      *data
  *                    The original array to read from.
  * @param[in,out]  *dataT
- *                    The array to write the transposed array to.
+ *                    The array to write the transposed array to.  If
+ *                    this is @c data, the transposition is done in
+ *                    place, which requires a square array.
  * @param[in]      size
  *                    The size of one element in the array.
  * @param[in]      dimsT
@@ -71,7 +105,7 @@ local_transposeVar(gridPatch_t patch,
  * @return  Returns nothing.
  */
 static void
-local_transposeVar_2d(const void              *data,
+local_transposeVar_2d(void                    *data,
                       void                    *dataT,
                       const int               size,
                       const gridPointUint32_t dimsT);
@@ -85,7 +119,10 @@ local_transposeVar_2d(const void              *data,
  * @param[in]      *data
  *                    The original array to read from.
  * @param[in,out]  *dataT
- *                    The array to write the transposed array to.
+ *                    The array to write the transposed array to.  If
+ *                    this is @c data, the transposition is done in
+ *                    place, which requires the two dimensions to be
+ *                    equal.
  * @param[in]      size
  *                    The size of one element in the array.
  * @param[in]      dimsT
@@ -94,7 +131,7 @@ local_transposeVar_2d(const void              *data,
  * @return  Returns nothing.
  */
 static void
-local_transposeVar102_3d(const void              *data,
+local_transposeVar102_3d(void                    *data,
                          void                    *dataT,
                          const int               size,
                          const gridPointUint32_t dimsT);
@@ -106,7 +143,10 @@ local_transposeVar102_3d(const void              *data,
  * @param[in]      *data
  *                    The original array to read from.
  * @param[in,out]  *dataT
- *                    The array to write the transposed array to.
+ *                    The array to write the transposed array to.  If
+ *                    this is @c data, the transposition is done in
+ *                    place, which requires the two dimensions to be
+ *                    equal.
  * @param[in]      size
  *                    The size of one element in the array.
  * @param[in]      dimsT
@@ -115,7 +155,7 @@ local_transposeVar102_3d(const void              *data,
  * @return  Returns nothing.
  */
 static void
-local_transposeVar210_3d(const void              *data,
+local_transposeVar210_3d(void                    *data,
                          void                    *dataT,
                          const int               size,
                          const gridPointUint32_t dimsT);
@@ -127,7 +167,10 @@ local_transposeVar210_3d(const void              *data,
  * @param[in]      *data
  *                    The original array to read from.
  * @param[in,out]  *dataT
- *                    The array to write the transposed array to.
+ *                    The array to write the transposed array to.  If
+ *                    this is @c data, the transposition is done in
+ *                    place, which requires the two dimensions to be
+ *                    equal.
  * @param[in]      size
  *                    The size of one element in the array.
  * @param[in]      dimsT
@@ -136,13 +179,96 @@ local_transposeVar210_3d(const void              *data,
  * @return  Returns nothing.
  */
 static void
-local_transposeVar021_3d(const void              *data,
+local_transposeVar021_3d(void                    *data,
                          void                    *dataT,
                          const int               size,
                          const gridPointUint32_t dimsT);
 
 #endif
 
+/**
+ * @brief  Transposes a stack of 2d planes tile by tile.
+ *
+ * Element @c (a, b) of plane @c p is read from
+ * <tt>data[p * planeStride + b + a * stride]</tt> and written to
+ * <tt>dataT[p * planeStrideT + a + b * strideT]</tt>.  If @c dataT
+ * equals @c data, the elements are swapped in place instead, which
+ * requires <tt>na == nb</tt> and identical strides.
+ *
+ * @param[in]      *data
+ *                    The original array to read from.
+ * @param[in,out]  *dataT
+ *                    The array to write to.
+ * @param[in]      size
+ *                    The size of one element in the array.
+ * @param[in]      numPlanes
+ *                    The number of planes to transpose.
+ * @param[in]      planeStride
+ *                    The distance (in elements) between two planes of
+ *                    @c data.
+ * @param[in]      planeStrideT
+ *                    The distance (in elements) between two planes of
+ *                    @c dataT.
+ * @param[in]      na
+ *                    The extent of the first index.
+ * @param[in]      nb
+ *                    The extent of the second index.
+ * @param[in]      stride
+ *                    The stride of the first index in @c data.
+ * @param[in]      strideT
+ *                    The stride of the second index in @c dataT.
+ *
+ * @return  Returns nothing.
+ */
+static void
+local_transposePlanes(void           *data,
+                      void           *dataT,
+                      const size_t   size,
+                      const uint64_t numPlanes,
+                      const uint64_t planeStride,
+                      const uint64_t planeStrideT,
+                      const uint64_t na,
+                      const uint64_t nb,
+                      const uint64_t stride,
+                      const uint64_t strideT);
+
+/**
+ * @brief  Copies one tile for local_transposePlanes().
+ *
+ * This is inlined for the common element sizes, such that the copy of
+ * one element becomes a plain load and store.
+ */
+static inline void
+local_copyTile(const char *restrict data,
+               char *restrict       dataT,
+               const size_t         size,
+               const uint64_t       na,
+               const uint64_t       nb,
+               const uint64_t       stride,
+               const uint64_t       strideT);
+
+/**
+ * @brief  Swaps a tile with its mirror tile for local_transposePlanes().
+ *
+ * For a tile on the diagonal, @c isDiagonal must be @c true, then only
+ * the elements above the diagonal are swapped.
+ */
+static inline void
+local_swapTile(char           *data,
+               const size_t   size,
+               const uint64_t aLo,
+               const uint64_t bLo,
+               const uint64_t na,
+               const uint64_t nb,
+               const uint64_t stride,
+               const bool     isDiagonal);
+
+/**
+ * @brief  Swaps two memory regions of @c size bytes.
+ */
+static inline void
+local_swapBytes(char *restrict a, char *restrict b, const size_t size);
+
 /**
  * @brief  Translate the lower and upper corners into a size.
  *
@@ -466,6 +592,46 @@ gridPatch_transpose(gridPatch_t patch,
 	patch->dims[dimB]  = tmp;
 }
 
+extern void
+gridPatch_removeFFTWPadding(gridPatch_t patch, int idxOfVar)
+{
+	char     *data;
+	size_t   sizeRow, strideRow;
+	uint64_t numRows;
+
+	assert(patch != NULL);
+	assert(idxOfVar >= 0 && idxOfVar < varArr_getLength(patch->vars));
+
+	data = varArr_getElementHandle(patch->varData, idxOfVar);
+	if (!dataVar_isFFTWPadded(gridPatch_getVarHandle(patch, idxOfVar))
+	    || (data == NULL) || (patch->numCells == 0))
+		return;
+
+	local_getRowLayout(patch, idxOfVar, &sizeRow, &strideRow, &numRows);
+	for (uint64_t i = 1; i < numRows; i++)
+		memmove(data + i * sizeRow, data + i * strideRow, sizeRow);
+}
+
+extern void
+gridPatch_insertFFTWPadding(gridPatch_t patch, int idxOfVar)
+{
+	char     *data;
+	size_t   sizeRow, strideRow;
+	uint64_t numRows;
+
+	assert(patch != NULL);
+	assert(idxOfVar >= 0 && idxOfVar < varArr_getLength(patch->vars));
+
+	data = varArr_getElementHandle(patch->varData, idxOfVar);
+	if (!dataVar_isFFTWPadded(gridPatch_getVarHandle(patch, idxOfVar))
+	    || (data == NULL) || (patch->numCells == 0))
+		return;
+
+	local_getRowLayout(patch, idxOfVar, &sizeRow, &strideRow, &numRows);
+	for (uint64_t i = numRows - 1; i > 0; i--)
+		memmove(data + i * strideRow, data + i * sizeRow, sizeRow);
+}
+
 extern void *
 gridPatch_getWindowedDataCopy(const gridPatch_t patch,
                               int               idxVar,
@@ -639,6 +805,21 @@ gridPatch_calcDistanceVector(const gridPatch_t       patch,
 
 /*--- Implementations of local functions --------------------------------*/
 
+static void
+local_getRowLayout(const gridPatch_t patch,
+                   int               idxOfVar,
+                   size_t            *sizeRow,
+                   size_t            *strideRow,
+                   uint64_t          *numRows)
+{
+	dataVar_t var  = gridPatch_getVarHandle(patch, idxOfVar);
+	size_t    size = (size_t)dataVar_getSizePerElement(var);
+
+	*sizeRow   = size * patch->dims[0];
+	*strideRow = size * gridPatch_getDimActual1D(patch, idxOfVar, 0);
+	*numRows   = patch->numCells / patch->dims[0];
+}
+
 static void
 local_transposeVar(gridPatch_t patch,
                    int         idxOfVarData,
@@ -661,118 +842,243 @@ local_transposeVar(gridPatch_t patch,
 	dimsT[dimA]    = dimsT[dimB];
 	dimsT[dimB]    = tmp;
 	numCellsActual = gridPatch_getNumCellsActual(patch, idxOfVarData);
-	dataT          = dataVar_getMemory(var, numCellsActual);
 
-	switch (size) {
-	default:
+	// Exchanging two dimensions of equal extent does not change the
+	// shape, so the data can be transposed in place.
+	if (dimsT[dimA] == dimsT[dimB])
+		dataT = data;
+	else
+		dataT = dataVar_getMemory(var, numCellsActual);
+
 #if (NDIM == 2)
-		local_transposeVar_2d(data, dataT, size, dimsT);
+	local_transposeVar_2d(data, dataT, size, dimsT);
 #elif (NDIM == 3)
-		if (((dimA == 0) && (dimB == 1)) || ((dimA == 1) && (dimB == 0)))
-			local_transposeVar102_3d(data, dataT, size, dimsT);
-		else if (((dimA == 0) && (dimB == 2)) || ((dimA == 2) && (dimB == 0)))
-			local_transposeVar210_3d(data, dataT, size, dimsT);
-		else if (((dimA == 1) && (dimB == 2)) || ((dimA == 2) && (dimB == 1)))
-			local_transposeVar021_3d(data, dataT, size, dimsT);
+	if (((dimA == 0) && (dimB == 1)) || ((dimA == 1) && (dimB == 0)))
+		local_transposeVar102_3d(data, dataT, size, dimsT);
+	else if (((dimA == 0) && (dimB == 2)) || ((dimA == 2) && (dimB == 0)))
+		local_transposeVar210_3d(data, dataT, size, dimsT);
+	else if (((dimA == 1) && (dimB == 2)) || ((dimA == 2) && (dimB == 1)))
+		local_transposeVar021_3d(data, dataT, size, dimsT);
 #endif
-		break;
-	}
-	gridPatch_replaceVarData(patch, idxOfVarData, dataT);
+
+	if (dataT != data)
+		gridPatch_replaceVarData(patch, idxOfVarData, dataT);
 } /* local_transposeVar */
 
 #if (NDIM == 2)
 static void
-local_transposeVar_2d(const void              *data,
+local_transposeVar_2d(void                    *data,
                       void                    *dataT,
                       const int               size,
                       const gridPointUint32_t dimsT)
 {
-	// Write contiguous, read random
-#  ifdef _OPENMP
-#    pragma omp parallel for shared(data, dataT)
-#  endif
-	for (int k1 = 0; k1 < dimsT[1]; k1++) {
-		for (int k0 = 0; k0 < dimsT[0]; k0++) {
-			size_t posT = (k0 + k1 * dimsT[0]) * size;
-			size_t pos  = (k1 + k0 * dimsT[1]) * size;
-			memcpy(((char *)dataT) + posT, ((const char *)data) + pos, size);
-		}
-	}
+	local_transposePlanes(data, dataT, (size_t)size, 1, 0, 0,
+	                      dimsT[0], dimsT[1], dimsT[1], dimsT[0]);
 }
 
 #elif (NDIM == 3)
 static void
-local_transposeVar102_3d(const void              *data,
+local_transposeVar102_3d(void                    *data,
                          void                    *dataT,
                          const int               size,
                          const gridPointUint32_t dimsT)
 {
-	size_t pos, posT;
+	uint64_t planeSize = (uint64_t)dimsT[0] * dimsT[1];
 
-#  ifdef _OPENMP
-#    pragma omp parallel for shared(data, dataT) private(pos, posT)
-#  endif
-	for (uint64_t k2 = 0; k2 < dimsT[2]; k2++) {
-		for (uint64_t k1 = 0; k1 < dimsT[1]; k1++) {
-			for (uint64_t k0 = 0; k0 < dimsT[0]; k0++) {
-				posT = (k0 + (k1 + k2 * dimsT[1]) * dimsT[0]) * size;
-				pos  = (k1 + (k0 + k2 * dimsT[0]) * dimsT[1]) * size;
-				memcpy(((char *)dataT) + posT,
-				       ((const char *)data) + pos,
-				       size);
-			}
-		}
-	}
+	local_transposePlanes(data, dataT, (size_t)size, dimsT[2],
+	                      planeSize, planeSize,
+	                      dimsT[0], dimsT[1], dimsT[1], dimsT[0]);
 }
 
 static void
-local_transposeVar210_3d(const void              *data,
+local_transposeVar210_3d(void                    *data,
                          void                    *dataT,
                          const int               size,
                          const gridPointUint32_t dimsT)
 {
-	size_t pos, posT;
-
-#  ifdef _OPENMP
-#    pragma omp parallel for shared(data, dataT) private(pos, posT)
-#  endif
-	for (uint64_t k2 = 0; k2 < dimsT[2]; k2++) {
-		for (uint64_t k1 = 0; k1 < dimsT[1]; k1++) {
-			for (uint64_t k0 = 0; k0 < dimsT[0]; k0++) {
-				posT = (k0 + (k1 + k2 * dimsT[1]) * dimsT[0]) * size;
-				pos  = (k2 + (k1 + k0 * dimsT[1]) * dimsT[2]) * size;
-				memcpy(((char *)dataT) + posT,
-				       ((const char *)data) + pos,
-				       size);
-			}
-		}
-	}
+	// The planes are the slices of constant k1, with k0 and k2 being
+	// exchanged within them.
+	local_transposePlanes(data, dataT, (size_t)size, dimsT[1],
+	                      dimsT[2], dimsT[0],
+	                      dimsT[0], dimsT[2],
+	                      (uint64_t)dimsT[1] * dimsT[2],
+	                      (uint64_t)dimsT[0] * dimsT[1]);
 }
 
 static void
-local_transposeVar021_3d(const void              *data,
+local_transposeVar021_3d(void                    *data,
                          void                    *dataT,
                          const int               size,
                          const gridPointUint32_t dimsT)
 {
-	size_t pos, posT;
+	size_t rowSize = (size_t)size * dimsT[0];
 
+	// Whole rows along the first dimension are moved.
+	if (dataT == data) {
 #  ifdef _OPENMP
-#    pragma omp parallel for shared(data, dataT) private(pos, posT)
+#    pragma omp parallel for shared(data) schedule(dynamic)
+#  endif
+		for (uint64_t k2 = 0; k2 < dimsT[2]; k2++) {
+			for (uint64_t k1 = k2 + 1; k1 < dimsT[1]; k1++) {
+				local_swapBytes((char *)data + (k1 + k2 * dimsT[1]) * rowSize,
+				                (char *)data + (k2 + k1 * dimsT[2]) * rowSize,
+				                rowSize);
+			}
+		}
+		return;
+	}
+
+#  ifdef _OPENMP
+#    pragma omp parallel for shared(data, dataT)
 #  endif
 	for (uint64_t k2 = 0; k2 < dimsT[2]; k2++) {
 		for (uint64_t k1 = 0; k1 < dimsT[1]; k1++) {
-			posT = ((k1 + k2 * dimsT[1]) * dimsT[0]) * size;
-			pos  = ((k2 + k1 * dimsT[2]) * dimsT[0]) * size;
-			memcpy(((char *)dataT) + posT,
-			       ((const char *)data) + pos,
-			       size * dimsT[0]);
+			memcpy((char *)dataT + (k1 + k2 * dimsT[1]) * rowSize,
+			       (const char *)data + (k2 + k1 * dimsT[2]) * rowSize,
+			       rowSize);
 		}
 	}
 }
 
 #endif
 
+static void
+local_transposePlanes(void           *data,
+                      void           *dataT,
+                      const size_t   size,
+                      const uint64_t numPlanes,
+                      const uint64_t planeStride,
+                      const uint64_t planeStrideT,
+                      const uint64_t na,
+                      const uint64_t nb,
+                      const uint64_t stride,
+                      const uint64_t strideT)
+{
+	const uint64_t numTilesA = (na + LOCAL_TRANSPOSE_TILE - 1)
+	                           / LOCAL_TRANSPOSE_TILE;
+	const uint64_t numTilesB = (nb + LOCAL_TRANSPOSE_TILE - 1)
+	                           / LOCAL_TRANSPOSE_TILE;
+	const uint64_t numTiles  = numPlanes * numTilesA * numTilesB;
+	const bool     inPlace   = (data == dataT) ? true : false;
+
+	assert(!inPlace || ((na == nb) && (stride == strideT)
+	                    && (planeStride == planeStrideT)));
+
+#ifdef _OPENMP
+#  pragma omp parallel for shared(data, dataT)
+#endif
+	for (uint64_t t = 0; t < numTiles; t++) {
+		uint64_t tileA = t % numTilesA;
+		uint64_t tileB = (t / numTilesA) % numTilesB;
+		uint64_t plane = t / (numTilesA * numTilesB);
+		uint64_t aLo   = tileA * LOCAL_TRANSPOSE_TILE;
+		uint64_t bLo   = tileB * LOCAL_TRANSPOSE_TILE;
+		uint64_t lenA  = (na - aLo < LOCAL_TRANSPOSE_TILE)
+		                 ? na - aLo : LOCAL_TRANSPOSE_TILE;
+		uint64_t lenB  = (nb - bLo < LOCAL_TRANSPOSE_TILE)
+		                 ? nb - bLo : LOCAL_TRANSPOSE_TILE;
+
+		if (inPlace) {
+			char *p = (char *)data + plane * planeStride * size;
+			// Every pair of mirrored tiles is handled once.
+			if (tileB < tileA)
+				continue;
+			switch (size) {
+			case 4:
+				local_swapTile(p, 4, aLo, bLo, lenA, lenB, stride,
+				               tileA == tileB);
+				break;
+			case 8:
+				local_swapTile(p, 8, aLo, bLo, lenA, lenB, stride,
+				               tileA == tileB);
+				break;
+			case 16:
+				local_swapTile(p, 16, aLo, bLo, lenA, lenB, stride,
+				               tileA == tileB);
+				break;
+			default:
+				local_swapTile(p, size, aLo, bLo, lenA, lenB, stride,
+				               tileA == tileB);
+				break;
+			}
+		} else {
+			const char *src = (const char *)data
+			                  + (plane * planeStride + bLo + aLo * stride)
+			                  * size;
+			char       *dst = (char *)dataT
+			                  + (plane * planeStrideT + aLo + bLo * strideT)
+			                  * size;
+			switch (size) {
+			case 4:
+				local_copyTile(src, dst, 4, lenA, lenB, stride, strideT);
+				break;
+			case 8:
+				local_copyTile(src, dst, 8, lenA, lenB, stride, strideT);
+				break;
+			case 16:
+				local_copyTile(src, dst, 16, lenA, lenB, stride, strideT);
+				break;
+			default:
+				local_copyTile(src, dst, size, lenA, lenB, stride, strideT);
+				break;
+			}
+		}
+	}
+} /* local_transposePlanes */
+
+static inline void
+local_copyTile(const char *restrict data,
+               char *restrict       dataT,
+               const size_t         size,
+               const uint64_t       na,
+               const uint64_t       nb,
+               const uint64_t       stride,
+               const uint64_t       strideT)
+{
+	// Write contiguous, read from the (cached) rows of the tile.
+	for (uint64_t b = 0; b < nb; b++) {
+		for (uint64_t a = 0; a < na; a++) {
+			memcpy(dataT + (a + b * strideT) * size,
+			       data + (b + a * stride) * size,
+			       size);
+		}
+	}
+}
+
+static inline void
+local_swapTile(char           *data,
+               const size_t   size,
+               const uint64_t aLo,
+               const uint64_t bLo,
+               const uint64_t na,
+               const uint64_t nb,
+               const uint64_t stride,
+               const bool     isDiagonal)
+{
+	for (uint64_t b = bLo; b < bLo + nb; b++) {
+		uint64_t aHi = (isDiagonal && (b < aLo + na)) ? b : aLo + na;
+		for (uint64_t a = aLo; a < aHi; a++) {
+			local_swapBytes(data + (a + b * stride) * size,
+			                data + (b + a * stride) * size,
+			                size);
+		}
+	}
+}
+
+static inline void
+local_swapBytes(char *restrict a, char *restrict b, const size_t size)
+{
+	char tmp[LOCAL_MAX_ELEMENT_SIZE];
+
+	for (size_t i = 0; i < size; i += LOCAL_MAX_ELEMENT_SIZE) {
+		size_t len = (size - i < LOCAL_MAX_ELEMENT_SIZE)
+		             ? size - i : LOCAL_MAX_ELEMENT_SIZE;
+		memcpy(tmp, a + i, len);
+		memcpy(a + i, b + i, len);
+		memcpy(b + i, tmp, len);
+	}
+}
+
 static inline void
 local_getWindowDims(gridPointUint32_t idxLo,
                     gridPointUint32_t idxHi,
@@ -387,6 +387,44 @@ gridPatch_transpose(gridPatch_t patch,
                     int         dimB);
 
 
+/**
+ * @brief  Removes the FFTW padding from the data of a variable.
+ *
+ * The rows along the first dimension are moved together in place, such
+ * that the cells are stored contiguously, as for a variable without
+ * padding.  This is meant for code that is not aware of the padding,
+ * e.g. the readers.  The variable itself stays padded,
+ * gridPatch_insertFFTWPadding() restores the layout.  Nothing is done if
+ * the variable is not padded or its data is not allocated.
+ *
+ * @param[in,out]  patch
+ *                    The patch to work with.
+ * @param[in]      idxOfVar
+ *                    The variable whose data should be compacted.
+ *
+ * @return  Returns nothing.
+ */
+extern void
+gridPatch_removeFFTWPadding(gridPatch_t patch, int idxOfVar);
+
+
+/**
+ * @brief  Reverses gridPatch_removeFFTWPadding().
+ *
+ * The rows along the first dimension are moved apart in place, the
+ * padding cells are left undefined.
+ *
+ * @param[in,out]  patch
+ *                    The patch to work with.
+ * @param[in]      idxOfVar
+ *                    The variable whose data should be padded.
+ *
+ * @return  Returns nothing.
+ */
+extern void
+gridPatch_insertFFTWPadding(gridPatch_t patch, int idxOfVar);
+
+
 /**
  * @brief  Performs a copy of the variable data in a subset of the patch.
  *
@@ -37,30 +37,42 @@
 /**
  * @brief  Helper function for a 2d transpose test.
  *
+ * @param[in]  isCubic
+ *                Whether the test patch should be square.
+ *
  * @return  Returns @c true if the test succeeded and @c false otherwise.
  */
 static bool
-local_tranposeVar_test_2d(void);
+local_tranposeVar_test_2d(bool isCubic);
 
 
 #elif (NDIM == 3)
 /**
  * @brief  Helper function for a 3d transpose test.
  *
+ * @param[in]  isCubic
+ *                Whether the test patch should be cubic.
+ *
  * @return  Returns @c true if the test succeeded and @c false otherwise.
  */
 static bool
-local_tranposeVar_test_3d(void);
+local_tranposeVar_test_3d(bool isCubic);
 
 #endif
 
 /**
  * @brief  Helper function for create a fake patch for testing.
  *
+ * The patch carries an integer variable and a two-component double
+ * variable, both holding the linear index of each cell.
+ *
+ * @param[in]  isCubic
+ *                Whether all dimensions of the patch should be equal.
+ *
  * @return  Returns a new patch usable for testing.
  */
 static gridPatch_t
-local_getFakePatch(void);
+local_getFakePatch(bool isCubic);
 
 /**
  * @brief Helper function to check if a patch is correctly transpose.
@@ -905,10 +917,14 @@ gridPatch_transpose_test(void)
 		printf("Testing %s... ", __func__);
 
 #if (NDIM == 2)
-	if (!local_tranposeVar_test_2d())
+	if (!local_tranposeVar_test_2d(true))
+		hasPassed = false;
+	if (!local_tranposeVar_test_2d(false))
 		hasPassed = false;
 #elif (NDIM == 3)
-	if (!local_tranposeVar_test_3d())
+	if (!local_tranposeVar_test_3d(true))
+		hasPassed = false;
+	if (!local_tranposeVar_test_3d(false))
 		hasPassed = false;
 #endif
 #ifdef XMEM_TRACK_MEM
@@ -984,6 +1000,64 @@ gridPatch_getWindowedDataCopy_test(void)
 	return hasPassed ? true : false;
 } /* gridPatch_getWindowedDataCopy_test */
 
+extern bool
+gridPatch_removeFFTWPadding_test(void)
+{
+	bool              hasPassed = true;
+	int               rank      = 0;
+	gridPatch_t       patch;
+	dataVar_t         var;
+	gridPointUint32_t idxLo;
+	gridPointUint32_t idxHi;
+	uint64_t          numCells;
+	uint32_t          dim0, dim0Actual;
+	int               *data;
+#ifdef XMEM_TRACK_MEM
+	size_t            allocatedBytes = global_allocated_bytes;
+#endif
+#ifdef WITH_MPI
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+#endif
+
+	if (rank == 0)
+		printf("Testing %s... ", __func__);
+
+	for (int i = 0; i < NDIM; i++) {
+		idxLo[i] = 2;
+		idxHi[i] = 6 + i;
+	}
+	var   = dataVar_new("Var", DATAVARTYPE_INT, 1);
+	dataVar_setFFTWPadded(var);
+	patch = gridPatch_new(idxLo, idxHi);
+	gridPatch_attachVar(patch, var);
+	numCells   = gridPatch_getNumCells(patch);
+	dim0       = gridPatch_getOneDim(patch, 0);
+	dim0Actual = gridPatch_getDimActual1D(patch, 0, 0);
+	data       = gridPatch_getVarDataHandle(patch, 0);
+	for (uint64_t i = 0; i < numCells; i++)
+		data[(i / dim0) * dim0Actual + i % dim0] = (int)i;
+
+	gridPatch_removeFFTWPadding(patch, 0);
+	for (uint64_t i = 0; i < numCells; i++) {
+		if (data[i] != (int)i)
+			hasPassed = false;
+	}
+
+	gridPatch_insertFFTWPadding(patch, 0);
+	for (uint64_t i = 0; i < numCells; i++) {
+		if (data[(i / dim0) * dim0Actual + i % dim0] != (int)i)
+			hasPassed = false;
+	}
+
+	gridPatch_del(&patch);
+#ifdef XMEM_TRACK_MEM
+	if (allocatedBytes != global_allocated_bytes)
+		hasPassed = false;
+#endif
+
+	return hasPassed ? true : false;
+} /* gridPatch_removeFFTWPadding_test */
+
 extern bool
 gridPatch_putWindowedData_test(void)
 {
@@ -1163,13 +1237,13 @@ gridPatch_calcDistanceVector_test(void)
 /*--- Implementations of local functions --------------------------------*/
 #if (NDIM == 2)
 static bool
-local_tranposeVar_test_2d(void)
+local_tranposeVar_test_2d(bool isCubic)
 {
 	bool           hasPassed = true;
 	gridPatch_t    patch;
 	gridPointInt_t s;
 
-	patch = local_getFakePatch();
+	patch = local_getFakePatch(isCubic);
 
 	gridPatch_transpose(patch, 0, 1);
 	s[0] = 1;
@@ -1190,13 +1264,13 @@ local_tranposeVar_test_2d(void)
 
 #elif (NDIM == 3)
 static bool
-local_tranposeVar_test_3d(void)
+local_tranposeVar_test_3d(bool isCubic)
 {
 	bool           hasPassed = true;
 	gridPatch_t    patch;
 	gridPointInt_t s;
 
-	patch = local_getFakePatch();
+	patch = local_getFakePatch(isCubic);
 
 	gridPatch_transpose(patch, 0, 1);
 	s[0] = 1;
@@ -1245,16 +1319,16 @@ local_tranposeVar_test_3d(void)
 #endif
 
 static gridPatch_t
-local_getFakePatch(void)
+local_getFakePatch(bool isCubic)
 {
 	gridPatch_t       patch;
 	dataVar_t         var;
 	gridPointUint32_t idxLo;
 	gridPointUint32_t idxHi;
 	int               *data;
+	double            *dataDbl;
 	int               offset = 0;
 
-	var      = dataVar_new("TEST", DATAVARTYPE_INT, 1);
 	idxLo[0] = 0;
 #ifdef WITH_MPI
 	idxHi[0] = 32;
@@ -1263,25 +1337,33 @@ local_getFakePatch(void)
 #endif
 	idxLo[1] = 0;
 #ifdef WITH_MPI
-	idxHi[1] = 33;
+	idxHi[1] = isCubic ? 32 : 33;
 #else
-	idxHi[1] = 150;
+	idxHi[1] = isCubic ? 150 : 70;
 #endif
 #if (NDIM > 2)
 	idxLo[2] = 0;
 #  ifdef WITH_MPI
-	idxHi[2] = 34;
+	idxHi[2] = isCubic ? 32 : 34;
 #  else
-	idxHi[2] = 150;
+	idxHi[2] = isCubic ? 150 : 40;
 #  endif
 #endif
 	patch = gridPatch_new(idxLo, idxHi);
+	var   = dataVar_new("TEST", DATAVARTYPE_INT, 1);
 	gridPatch_attachVar(patch, var);
-	data  = gridPatch_getVarDataHandle(patch, 0);
+	dataVar_del(&var);
+	var   = dataVar_new("TESTDBL", DATAVARTYPE_DOUBLE, 2);
+	gridPatch_attachVar(patch, var);
+	dataVar_del(&var);
+	data    = gridPatch_getVarDataHandle(patch, 0);
+	dataDbl = gridPatch_getVarDataHandle(patch, 1);
 #if (NDIM == 2)
 	for (int j = 0; j < patch->dims[1]; j++) {
 		for (int i = 0; i < patch->dims[0]; i++) {
-			data[offset] = offset;
+			data[offset]            = offset;
+			dataDbl[2 * offset]     = offset;
+			dataDbl[2 * offset + 1] = -offset;
 			offset++;
 		}
 	}
@@ -1289,13 +1371,14 @@ local_getFakePatch(void)
 	for (int k = 0; k < patch->dims[2]; k++) {
 		for (int j = 0; j < patch->dims[1]; j++) {
 			for (int i = 0; i < patch->dims[0]; i++) {
-				data[offset] = offset;
+				data[offset]            = offset;
+				dataDbl[2 * offset]     = offset;
+				dataDbl[2 * offset + 1] = -offset;
 				offset++;
 			}
 		}
 	}
 #endif
-	dataVar_del(&var);
 
 	return patch;
 } /* local_getFakePatch */
@@ -1304,11 +1387,13 @@ static bool
 local_verifyFakePatchTransposed(gridPatch_t patch, gridPointInt_t s)
 {
 	int            *data;
+	double         *dataDbl;
 	gridPointInt_t k;
 	int            expected;
 	int            offset = 0;
 
-	data = gridPatch_getVarDataHandle(patch, 0);
+	data    = gridPatch_getVarDataHandle(patch, 0);
+	dataDbl = gridPatch_getVarDataHandle(patch, 1);
 
 #if (NDIM == 2)
 	for (k[1] = 0; k[1] < patch->dims[1]; k[1]++) {
@@ -1316,6 +1401,9 @@ local_verifyFakePatchTransposed(gridPatch_t patch, gridPointInt_t s)
 			expected = k[s[0]] + k[s[1]] * patch->dims[s[0]];
 			if (data[offset] != expected)
 				return false;
+			if ((dataDbl[2 * offset] != expected)
+			    || (dataDbl[2 * offset + 1] != -expected))
+				return false;
 
 			offset++;
 		}
@@ -1329,6 +1417,9 @@ local_verifyFakePatchTransposed(gridPatch_t patch, gridPointInt_t s)
 				           * patch->dims[s[1]];
 				if (data[offset] != expected)
 					return false;
+				if ((dataDbl[2 * offset] != expected)
+				    || (dataDbl[2 * offset + 1] != -expected))
+					return false;
 
 				offset++;
 			}
@@ -211,6 +211,16 @@ gridPatch_transpose_test(void);
 extern bool
 gridPatch_getWindowedDataCopy_test(void);
 
+/**
+ * @brief  This will test gridPatch_removeFFTWPadding() and
+ *         gridPatch_insertFFTWPadding().
+ *
+ * @return  Returns @c true if the test succeeded and @c false
+ *          otherwise.
+ */
+extern bool
+gridPatch_removeFFTWPadding_test(void);
+
 /**
  * @brief  This will test gridPatch_putWindowedData().
  *
@@ -61,7 +61,9 @@ gridReader_readIntoPatchForVar(gridReader_t reader,
 	assert(patch != NULL);
 	assert(idxOfVar >= 0 && idxOfVar < gridPatch_getNumVars(patch));
 
+	// The readers fill contiguous rows.
 	reader->func->readIntoPatchForVar(reader, patch, idxOfVar);
+	gridPatch_insertFFTWPadding(patch, idxOfVar);
 }
 
 /*--- Implementations of final functions --------------------------------*/
@@ -40,6 +40,9 @@
  *                    The section from which to read the extended
  *                    information (file format specific information).  This
  *                    may be the same as @c base.
+ * @param[in]      fn
+ *                    The file name to use, this is taken over by the
+ *                    reader.
  *
  * @return  Returns a new grid reader constructed from the information in
  *          the ini file.
@@ -47,25 +50,44 @@
 static gridReader_t
 local_newFromIniWrapper(parse_ini_t ini,
                         const char  *base,
-                        const char  *extended);
+                        const char  *extended,
+                        filename_t  fn);
 
 
 /*--- Implementations of exported functions -----------------------------*/
 extern gridReader_t
 gridReaderFactory_newReaderFromIni(parse_ini_t ini, const char *sectionName)
+{
+	assert(ini != NULL);
+	assert(sectionName != NULL);
+
+	return gridReaderFactory_newReaderFromIniWithFileName(ini, sectionName,
+	                                                      filename_new());
+}
+
+extern gridReader_t
+gridReaderFactory_newReaderFromIniWithFileName(parse_ini_t ini,
+                                               const char  *sectionName,
+                                               filename_t  fn)
 {
 	gridReader_t reader;
 	char         *extended;
+	filename_t   fnIni;
 
 	assert(ini != NULL);
 	assert(sectionName != NULL);
+	assert(fn != NULL);
+
+	fnIni = gridIOCommon_getFileName(ini, sectionName, true);
+	filename_copySetFields(fn, fnIni);
+	filename_del(&fnIni);
 
 	if (parse_ini_get_string(ini, "readerSection", sectionName,
 	                         &extended)) {
-		reader = local_newFromIniWrapper(ini, sectionName, extended);
+		reader = local_newFromIniWrapper(ini, sectionName, extended, fn);
 		xfree(extended);
 	} else {
-		reader = local_newFromIniWrapper(ini, sectionName, sectionName);
+		reader = local_newFromIniWrapper(ini, sectionName, sectionName, fn);
 	}
 
 	return reader;
@@ -146,13 +168,12 @@ gridReaderFactory_newFromIniHDF5(parse_ini_t ini,
 static gridReader_t
 local_newFromIniWrapper(parse_ini_t ini,
                         const char  *base,
-                        const char  *extended)
+                        const char  *extended,
+                        filename_t  fn)
 {
 	gridReader_t  r;
 	gridIO_type_t type;
-	filename_t    fn;
 
-	fn   = gridIOCommon_getFileName(ini, base, true);
 	type = gridIOCommon_getType(ini, base);
 
 	if (type == GRIDIO_TYPE_BOV) {
@@ -49,6 +49,32 @@ extern gridReader_t
 gridReaderFactory_newReaderFromIni(parse_ini_t ini, const char *sectionName);
 
 
+/**
+ * @brief  Creates a new reader object from an ini file using a given file
+ *         name.
+ *
+ * This works like gridReaderFactory_newReaderFromIni(), but the file name
+ * is provided by the caller.  File name fields that are set in the ini
+ * file take precedence over the ones in @c fn.
+ *
+ * @param[in,out]  ini
+ *                    The ini file in which to look for the construction
+ *                    information for this reader.
+ * @param[in]      *sectionName
+ *                    The section name within the ini file that holds
+ *                    the construction information.
+ * @param[in]      fn
+ *                    The file name to use.  Passing @c NULL is undefined.
+ *                    The caller relinquishes control over the object.
+ *
+ * @return  Returns a new reader object.
+ */
+extern gridReader_t
+gridReaderFactory_newReaderFromIniWithFileName(parse_ini_t ini,
+                                               const char  *sectionName,
+                                               filename_t  fn);
+
+
 /*--- Doxygen group definitions -----------------------------------------*/
 
 /**
@@ -15,6 +15,7 @@
 #  include <mpi.h>
 #endif
 #include "../libutil/xmem.h"
+#include "../libutil/profile.h"
 #ifdef WITH_MPITRACE
 #  include <mpitrace_user_events.h>
 #endif
@@ -39,6 +40,7 @@ struct local_transposeLayout_struct {
 	gridPointUint32_t  idxHi;
 	gridPointInt_t     processCoord;
 	commSchemeBuffer_t buffer;
+	MPI_Datatype       type;
 };
 #endif
 
@@ -48,6 +50,9 @@ local_calcProcCoords(gridRegularDistrib_t distrib,
                      int                  rank,
                      gridPointInt_t       procCoords);
 
+static int
+local_calcNumChunks(uint32_t numSlabs, int numChunks);
+
 
 #ifdef WITH_MPI
 static void
@@ -96,27 +101,210 @@ local_transposeAllVarsAtPatch(gridPatch_t    patch,
                               const varArr_t recvLayout);
 
 static void
-local_transposeGetFullSendBuffers(commScheme_t      scheme,
-                                  const varArr_t    layout,
-                                  const gridPatch_t patch,
-                                  const dataVar_t   var,
-                                  MPI_Comm          comm);
+local_transposeAddBuffers(commScheme_t   scheme,
+                          const varArr_t layout,
+                          gridPatch_t    patch,
+                          const int      idxOfVar,
+                          MPI_Datatype   elementType,
+                          MPI_Comm       comm,
+                          int            type);
+
+static void
+local_transposeFreeTypes(const varArr_t layout);
+
+static MPI_Datatype
+local_getWindowType(const gridPatch_t       patch,
+                    int                     idxOfVar,
+                    const gridPointUint32_t idxLo,
+                    const gridPointUint32_t idxHi,
+                    MPI_Datatype            elementType);
 
 static void
-local_transposeGetRecvBuffers(commScheme_t    scheme,
-                              const varArr_t  layout,
-                              const dataVar_t var,
-                              MPI_Comm        comm);
+local_transposeMPIPipelined(gridRegularDistrib_t          distrib,
+                            int                           dimA,
+                            int                           dimB,
+                            int                           numChunks,
+                            gridRegularDistribChunkFunc_t chunkFunc,
+                            void                          *data);
 
 static void
-local_transposeDelSendBuffers(const varArr_t  layout,
-                              const dataVar_t var);
+local_transposeAddChunkBuffers(commScheme_t   scheme,
+                               const varArr_t layout,
+                               gridPatch_t    patch,
+                               MPI_Datatype   *elementTypes,
+                               MPI_Comm       comm,
+                               int            type,
+                               uint32_t       chunkLo,
+                               uint32_t       chunkHi,
+                               varArr_t       types);
+
+/*
+ * Every window is split along the last dimension at the chunk borders
+ * of the sending process.  Both sides can calculate these, so the
+ * receiver posts its receives in the same order in which the sender
+ * sends them, which is all MPI needs to match them.
+ */
+static void
+local_transposeMPIPipelined(gridRegularDistrib_t          distrib,
+                            int                           dimA,
+                            int                           dimB,
+                            int                           numChunks,
+                            gridRegularDistribChunkFunc_t chunkFunc,
+                            void                          *data)
+{
+	gridPatch_t       patch, patchT;
+	varArr_t          sendLayout, recvLayout, types;
+	gridPointUint32_t dims, idxLoPatch, dimsPatch;
+	int               numVars, numChunksLocal, numChunksMax = 1;
+	MPI_Datatype      *elementTypes;
+	commScheme_t      schemeRecv, *schemesSend;
+	const int         d = NDIM - 1;
+
+	local_transposeMPIInit(distrib, dimA, dimB,
+	                       &patch, &patchT, &sendLayout, &recvLayout);
+	gridRegular_getDims(distrib->grid, dims);
+	gridPatch_getIdxLo(patch, idxLoPatch);
+	gridPatch_getDims(patch, dimsPatch);
+	numVars        = gridPatch_getNumVars(patch);
+	numChunksLocal = local_calcNumChunks(dimsPatch[d], numChunks);
+	types          = varArr_new(0);
+
+	elementTypes = xmalloc(sizeof(MPI_Datatype) * numVars);
+	for (int i = 0; i < numVars; i++) {
+		dataVar_t var = gridPatch_getVarHandle(patch, i);
+		MPI_Type_contiguous(dataVar_getSizePerElement(var), MPI_BYTE,
+		                    elementTypes + i);
+		MPI_Type_commit(elementTypes + i);
+		(void)gridPatch_attachVar(patchT, var);
+	}
+
+	for (int j = 0; j < varArr_getLength(recvLayout); j++) {
+		local_layoutElement_t le = varArr_getElementHandle(recvLayout, j);
+		uint32_t              lo, hi;
+		gridRegularDistrib_calcIdxsForRank1D(dims[d], distrib->nProcs[d],
+		                                     le->processCoord[d], &lo, &hi);
+		if (local_calcNumChunks(hi - lo + 1, numChunks) > numChunksMax)
+			numChunksMax = local_calcNumChunks(hi - lo + 1, numChunks);
+	}
+
+	schemeRecv = commScheme_new(distrib->commCart, 4224);
+	for (int c = 0; c < numChunksMax; c++) {
+		// Receives are added per sender, as the chunking depends on it.
+		for (int j = 0; j < varArr_getLength(recvLayout); j++) {
+			local_layoutElement_t le;
+			uint32_t              lo, hi, chunkLo, chunkHi;
+			int                   n;
+			varArr_t              single = varArr_new(1);
+
+			le = varArr_getElementHandle(recvLayout, j);
+			gridRegularDistrib_calcIdxsForRank1D(dims[d],
+			                                     distrib->nProcs[d],
+			                                     le->processCoord[d],
+			                                     &lo, &hi);
+			n = local_calcNumChunks(hi - lo + 1, numChunks);
+			if (c < n) {
+				gridRegularDistrib_calcIdxsForRank1D(hi - lo + 1, n, c,
+				                                     &chunkLo, &chunkHi);
+				(void)varArr_insert(single, le);
+				local_transposeAddChunkBuffers(schemeRecv, single, patchT,
+				                               elementTypes,
+				                               distrib->commCart,
+				                               COMMSCHEME_TYPE_RECV,
+				                               lo + chunkLo, lo + chunkHi,
+				                               types);
+				(void)varArr_remove(single, 0);
+			}
+			varArr_del(&single);
+		}
+	}
+	commScheme_fire(schemeRecv);
+
+	schemesSend = xmalloc(sizeof(commScheme_t) * numChunksLocal);
+	for (int c = 0; c < numChunksLocal; c++) {
+		uint32_t chunkLo, chunkHi;
+
+		gridRegularDistrib_calcIdxsForRank1D(dimsPatch[d], numChunksLocal,
+		                                     c, &chunkLo, &chunkHi);
+		chunkFunc(chunkLo, chunkHi - chunkLo + 1, data);
+		schemesSend[c] = commScheme_new(distrib->commCart, 4224);
+		local_transposeAddChunkBuffers(schemesSend[c], sendLayout, patch,
+		                               elementTypes, distrib->commCart,
+		                               COMMSCHEME_TYPE_SEND,
+		                               idxLoPatch[d] + chunkLo,
+		                               idxLoPatch[d] + chunkHi, types);
+		commScheme_fire(schemesSend[c]);
+	}
+
+	commScheme_wait(schemeRecv);
+	commScheme_del(&schemeRecv);
+	for (int c = 0; c < numChunksLocal; c++)
+		commScheme_del(schemesSend + c);
+	xfree(schemesSend);
+
+	while (varArr_getLength(types) > 0) {
+		MPI_Datatype *type = varArr_remove(types, 0);
+		MPI_Type_free(type);
+		xfree(type);
+	}
+	varArr_del(&types);
+	for (int i = 0; i < numVars; i++) {
+		dataVar_t var = gridPatch_detachVar(patch, 0);
+		dataVar_del(&var);
+		MPI_Type_free(elementTypes + i);
+	}
+	xfree(elementTypes);
+
+	gridRegular_replacePatch(distrib->grid, 0, patchT);
+
+	local_transposeMPIClean(sendLayout, recvLayout);
+} /* local_transposeMPIPipelined */
 
 static void
-local_transposeMoveRecvBuffersToPatch(const varArr_t  layout,
-                                      gridPatch_t     patchT,
-                                      const int       idxOfVar,
-                                      const dataVar_t var);
+local_transposeAddChunkBuffers(commScheme_t   scheme,
+                               const varArr_t layout,
+                               gridPatch_t    patch,
+                               MPI_Datatype   *elementTypes,
+                               MPI_Comm       comm,
+                               int            type,
+                               uint32_t       chunkLo,
+                               uint32_t       chunkHi,
+                               varArr_t       types)
+{
+	const int d = NDIM - 1;
+
+	for (int j = 0; j < varArr_getLength(layout); j++) {
+		local_layoutElement_t le = varArr_getElementHandle(layout, j);
+		gridPointUint32_t     lo, hi;
+		int                   rank;
+
+		for (int i = 0; i < NDIM; i++) {
+			lo[i] = le->idxLo[i];
+			hi[i] = le->idxHi[i];
+		}
+		lo[d] = (chunkLo > lo[d]) ? chunkLo : lo[d];
+		hi[d] = (chunkHi < hi[d]) ? chunkHi : hi[d];
+		if (lo[d] > hi[d])
+			continue;
+
+		MPI_Cart_rank(comm, le->processCoord, &rank);
+		for (int i = 0; i < gridPatch_getNumVars(patch); i++) {
+			MPI_Datatype       *windowType = xmalloc(sizeof(MPI_Datatype));
+			commSchemeBuffer_t buf;
+
+			*windowType = local_getWindowType(patch, i, lo, hi,
+			                                  elementTypes[i]);
+			(void)varArr_insert(types, windowType);
+			if (type == COMMSCHEME_TYPE_SEND) {
+				MPI_Count size;
+				MPI_Type_size_x(*windowType, &size);
+				profile_addBytes((uint64_t)size);
+			}
+			buf = commSchemeBuffer_new(gridPatch_getVarDataHandle(patch, i),
+			                           1, *windowType, rank);
+			commScheme_addBuffer(scheme, buf, type);
+		}
+	}
+} /* local_transposeAddChunkBuffers */
 
 static local_layoutElement_t
 local_layoutElement_new(gridPointUint32_t idxLo,
@@ -333,7 +521,45 @@ gridRegularDistrib_transpose(gridRegularDistrib_t distrib,
 	assert(dimB >= 0 && dimB < NDIM);
 
 #ifdef WITH_MPI
+	profile_begin("transpose.mpi");
 	local_transposeMPI(distrib, dimA, dimB);
+	profile_end("transpose.mpi");
+#endif
+	gridRegular_transpose(distrib->grid, dimA, dimB);
+}
+
+extern void
+gridRegularDistrib_transposePipelined(gridRegularDistrib_t          distrib,
+                                      int                           dimA,
+                                      int                           dimB,
+                                      int                           numChunks,
+                                      gridRegularDistribChunkFunc_t chunkFunc,
+                                      void                          *data)
+{
+	assert(distrib != NULL);
+	assert(dimA >= 0 && dimA < NDIM);
+	assert(dimB >= 0 && dimB < NDIM);
+	assert(numChunks > 0);
+	assert(chunkFunc != NULL);
+
+#ifdef WITH_MPI
+	profile_begin("transpose.mpi");
+	local_transposeMPIPipelined(distrib, dimA, dimB, numChunks,
+	                            chunkFunc, data);
+	profile_end("transpose.mpi");
+#else
+	gridPointUint32_t dims;
+	uint32_t          numSlabs;
+	uint32_t          chunkLo, chunkHi;
+
+	gridPatch_getDims(gridRegular_getPatchHandle(distrib->grid, 0), dims);
+	numSlabs  = dims[NDIM - 1];
+	numChunks = local_calcNumChunks(numSlabs, numChunks);
+	for (int j = 0; j < numChunks; j++) {
+		gridRegularDistrib_calcIdxsForRank1D(numSlabs, numChunks, j,
+		                                     &chunkLo, &chunkHi);
+		chunkFunc(chunkLo, chunkHi - chunkLo + 1, data);
+	}
 #endif
 	gridRegular_transpose(distrib->grid, dimA, dimB);
 }
@@ -354,25 +580,36 @@ local_calcProcCoords(gridRegularDistrib_t distrib,
 #endif
 }
 
+/*
+ * The slabs need not be divisible by the number of chunks, the chunks
+ * are then split like the cells over processes and differ in size by at
+ * most one slab.  A caller hence deals with at most two chunk sizes.
+ */
+static int
+local_calcNumChunks(uint32_t numSlabs, int numChunks)
+{
+	if ((uint32_t)numChunks > numSlabs)
+		numChunks = (int)numSlabs;
+
+	return (numChunks < 1) ? 1 : numChunks;
+}
+
 #ifdef WITH_MPI
 
 /*
  * The idea here is:
  *   - figure out where to send stuff to and from where to receive stuff
- *   - Explode the data from the patch into send buffers
- *   - Delete the patch data (it is copied to the send buffer)
- *   - Allocate receive buffers
- *   - Perform communication
+ *   - Allocate the final patch data
+ *   - Describe every window by a subarray datatype of the patch it
+ *     lives in
+ *   - Perform communication directly from the original patch into the
+ *     final patch
  *   - Wait for communication to completely finish
- *   - Remove send buffers
- *   - Allocate final patch data
- *   - Move the receive buffers to the final patch (deleting each receive
- *     buffer as soon as its content is copied)
+ *   - Delete the original patch data
  *
- *  This minimizes the amount of memory that is needed to approximately
- *  a tad more than twice the original patch data (depending on the
- *  difference in patch sizes between the tranposed and the
- *  un-transposed patch).
+ *  No intermediate buffers are required, the memory needed is the
+ *  original patch data plus the transposed patch data, and every
+ *  element is only touched by MPI.
  */
 static void
 local_transposeMPI(gridRegularDistrib_t distrib,
@@ -558,25 +795,29 @@ local_transposeAllVarsAtPatch(gridPatch_t    patch,
 	for (int i = 0; i < numVars; i++) {
 		int          idxOfVar;
 		dataVar_t    varTmp;
+		MPI_Datatype elementType;
 		dataVar_t    var    = gridPatch_getVarHandle(patch, 0);
 		commScheme_t scheme = commScheme_new(commCart, 4223);
 
 		var = dataVar_getRef(var);
+		// Elements are moved as opaque blocks, this also covers
+		// variables with several components.
+		MPI_Type_contiguous(dataVar_getSizePerElement(var), MPI_BYTE,
+		                    &elementType);
+		MPI_Type_commit(&elementType);
+		idxOfVar = gridPatch_attachVar(patchT, var);
 
 #  ifdef WITH_MPITRACE
 		MPItrace_event(LOCAL_MPITRACE_EVENT, 12);
 #  endif
-		local_transposeGetFullSendBuffers(scheme, sendLayout, patch,
-		                                  var, commCart);
-#  ifdef WITH_MPITRACE
-		MPItrace_event(LOCAL_MPITRACE_EVENT, 0);
-#  endif
-		varTmp = gridPatch_detachVar(patch, 0);
-		dataVar_del(&varTmp);
-#  ifdef WITH_MPITRACE
-		MPItrace_event(LOCAL_MPITRACE_EVENT, 13);
-#  endif
-		local_transposeGetRecvBuffers(scheme, recvLayout, var, commCart);
+		// We always work on the 0th variable as the patch is
+		// emptied during the course of the main loop.
+		local_transposeAddBuffers(scheme, sendLayout, patch, 0,
+		                          elementType, commCart,
+		                          COMMSCHEME_TYPE_SEND);
+		local_transposeAddBuffers(scheme, recvLayout, patchT, idxOfVar,
+		                          elementType, commCart,
+		                          COMMSCHEME_TYPE_RECV);
 #  ifdef WITH_MPITRACE
 		MPItrace_event(LOCAL_MPITRACE_EVENT, 0);
 #  endif
@@ -590,22 +831,11 @@ local_transposeAllVarsAtPatch(gridPatch_t    patch,
 		MPItrace_event(LOCAL_MPITRACE_EVENT, 0);
 #  endif
 
-#  ifdef WITH_MPITRACE
-		MPItrace_event(LOCAL_MPITRACE_EVENT, 15);
-#  endif
-		local_transposeDelSendBuffers(sendLayout, var);
-#  ifdef WITH_MPITRACE
-		MPItrace_event(LOCAL_MPITRACE_EVENT, 0);
-#  endif
-		idxOfVar = gridPatch_attachVar(patchT, var);
-#  ifdef WITH_MPITRACE
-		MPItrace_event(LOCAL_MPITRACE_EVENT, 16);
-#  endif
-		local_transposeMoveRecvBuffersToPatch(recvLayout, patchT,
-		                                      idxOfVar, var);
-#  ifdef WITH_MPITRACE
-		MPItrace_event(LOCAL_MPITRACE_EVENT, 0);
-#  endif
+		local_transposeFreeTypes(sendLayout);
+		local_transposeFreeTypes(recvLayout);
+		MPI_Type_free(&elementType);
+		varTmp = gridPatch_detachVar(patch, 0);
+		dataVar_del(&varTmp);
 
 		commScheme_del(&scheme);
 		dataVar_del(&var);
@@ -613,85 +843,73 @@ local_transposeAllVarsAtPatch(gridPatch_t    patch,
 } /* local_transposeAllVarsAtPatch */
 
 static void
-local_transposeGetFullSendBuffers(commScheme_t      scheme,
-                                  const varArr_t    layout,
-                                  const gridPatch_t patch,
-                                  const dataVar_t   var,
-                                  MPI_Comm          comm)
-{
-	int          len  = varArr_getLength(layout);
-	MPI_Datatype type = dataVar_getMPIDatatype(var);
-
-	for (int j = 0; j < len; j++) {
-		void                  *dataSend;
-		uint64_t              dataSize;
-		local_layoutElement_t le = varArr_getElementHandle(layout, j);
-		int                   count;
-		int                   rankSend;
-
-		// We always work on the 0th variable as the patch is
-		// emptied during the course of the main loop.
-		dataSend   = gridPatch_getWindowedDataCopy(patch, 0, le->idxLo,
-		                                           le->idxHi, &dataSize);
-		count      = dataVar_getMPICount(var, dataSize);
-		MPI_Cart_rank(comm, le->processCoord, &rankSend);
-		le->buffer = commSchemeBuffer_new(dataSend, count, type, rankSend);
-		commScheme_addBuffer(scheme, le->buffer, COMMSCHEME_TYPE_SEND);
-	}
-}
-
-static void
-local_transposeGetRecvBuffers(commScheme_t    scheme,
-                              const varArr_t  layout,
-                              const dataVar_t var,
-                              MPI_Comm        comm)
+local_transposeAddBuffers(commScheme_t   scheme,
+                          const varArr_t layout,
+                          gridPatch_t    patch,
+                          const int      idxOfVar,
+                          MPI_Datatype   elementType,
+                          MPI_Comm       comm,
+                          int            type)
 {
-	int          len  = varArr_getLength(layout);
-	MPI_Datatype type = dataVar_getMPIDatatype(var);
+	int  len   = varArr_getLength(layout);
+	void *data = gridPatch_getVarDataHandle(patch, idxOfVar);
 
 	for (int j = 0; j < len; j++) {
 		local_layoutElement_t le = varArr_getElementHandle(layout, j);
-		void                  *dataRecv;
-		int                   rankRecv;
-		int                   count;
-		uint64_t              dataSize = 1;
-
-		for (int k = 0; k < NDIM; k++) {
-			dataSize *= (le->idxHi[k] - le->idxLo[k] + 1);
+		int                   rank;
+
+		le->type   = local_getWindowType(patch, idxOfVar,
+		                                 le->idxLo, le->idxHi,
+		                                 elementType);
+		if (type == COMMSCHEME_TYPE_SEND) {
+			MPI_Count size;
+			MPI_Type_size_x(le->type, &size);
+			profile_addBytes((uint64_t)size);
 		}
-		dataRecv   = dataVar_getMemory(var, dataSize);
-		count      = dataVar_getMPICount(var, dataSize);
-		MPI_Cart_rank(comm, le->processCoord, &rankRecv);
-		le->buffer = commSchemeBuffer_new(dataRecv, count, type, rankRecv);
-		commScheme_addBuffer(scheme, le->buffer, COMMSCHEME_TYPE_RECV);
+		MPI_Cart_rank(comm, le->processCoord, &rank);
+		le->buffer = commSchemeBuffer_new(data, 1, le->type, rank);
+		commScheme_addBuffer(scheme, le->buffer, type);
 	}
 }
 
 static void
-local_transposeDelSendBuffers(const varArr_t  layout,
-                              const dataVar_t var)
+local_transposeFreeTypes(const varArr_t layout)
 {
 	for (int j = 0; j < varArr_getLength(layout); j++) {
 		local_layoutElement_t le = varArr_getElementHandle(layout, j);
-		dataVar_freeMemory(var, commSchemeBuffer_getBuf(le->buffer));
+		MPI_Type_free(&(le->type));
 	}
 }
 
-static void
-local_transposeMoveRecvBuffersToPatch(const varArr_t  layout,
-                                      gridPatch_t     patchT,
-                                      const int       idxOfVar,
-                                      const dataVar_t var)
+static MPI_Datatype
+local_getWindowType(const gridPatch_t       patch,
+                    int                     idxOfVar,
+                    const gridPointUint32_t idxLo,
+                    const gridPointUint32_t idxHi,
+                    MPI_Datatype            elementType)
 {
-	for (int j = 0; j < varArr_getLength(layout); j++) {
-		local_layoutElement_t le = varArr_getElementHandle(layout, j);
-		void                  *dataRecv;
-
-		dataRecv = commSchemeBuffer_getBuf(le->buffer);
-		gridPatch_putWindowedData(patchT, idxOfVar, le->idxLo,
-		                          le->idxHi, dataRecv);
-		dataVar_freeMemory(var, dataRecv);
+	MPI_Datatype      type;
+	gridPointUint32_t dims, dimsActual, idxLoPatch;
+	int               sizes[NDIM], subSizes[NDIM], starts[NDIM];
+
+	// The array is laid out with the actual dimensions, such that the
+	// padding of FFTW padded variables is skipped.
+	gridPatch_getDims(patch, dims);
+	gridPatch_getDimsActual(patch, idxOfVar, dimsActual);
+	gridPatch_getIdxLo(patch, idxLoPatch);
+	for (int i = 0; i < NDIM; i++) {
+		assert(idxLo[i] >= idxLoPatch[i]);
+		assert(idxHi[i] < idxLoPatch[i] + dims[i]);
+		sizes[i]    = (int)dimsActual[i];
+		subSizes[i] = (int)(idxHi[i] - idxLo[i] + 1);
+		starts[i]   = (int)(idxLo[i] - idxLoPatch[i]);
 	}
+
+	MPI_Type_create_subarray(NDIM, sizes, subSizes, starts,
+	                         MPI_ORDER_FORTRAN, elementType, &type);
+	MPI_Type_commit(&type);
+
+	return type;
 }
 
 static local_layoutElement_t
@@ -706,8 +924,9 @@ local_layoutElement_new(gridPointUint32_t idxLo,
 		element->idxLo[i]        = idxLo[i];
 		element->idxHi[i]        = idxHi[i];
 		element->processCoord[i] = processCoord[i];
-		element->buffer          = NULL;
 	}
+	element->buffer = NULL;
+	element->type   = MPI_DATATYPE_NULL;
 
 	return element;
 }
@@ -32,6 +32,21 @@
 typedef struct gridRegularDistrib_struct *gridRegularDistrib_t;
 
 
+/*--- Callback types ----------------------------------------------------*/
+
+/**
+ * @brief  The signature of the function that is called for every chunk
+ *         by gridRegularDistrib_transposePipelined().
+ *
+ * The chunk consists of the @c num slabs (along the last dimension) of
+ * the local patch that start at the local index @c idxLo.  Only those
+ * slabs may be accessed.
+ */
+typedef void (*gridRegularDistribChunkFunc_t)(uint32_t idxLo,
+                                              uint32_t num,
+                                              void     *data);
+
+
 /*--- Prototypes of exported functions ----------------------------------*/
 
 /**
@@ -185,6 +200,44 @@ gridRegularDistrib_transpose(gridRegularDistrib_t distrib,
                              int                  dimA,
                              int                  dimB);
 
+/**
+ * @brief  Performs a transposition of the distributed grid while the
+ *         data is still being produced.
+ *
+ * The local patch is split into @c numChunks chunks along the last
+ * dimension (fewer, if there are less local slabs than that).  If the
+ * number of local slabs is not divisible by @c numChunks, the chunks
+ * differ in size by one slab.  For every chunk, @c chunkFunc is called
+ * to finalise the data of the chunk, after which its part of the
+ * communication is started right away, such that it overlaps with the
+ * work on the next chunk.  The receives are posted before the first
+ * chunk is processed and the data is received directly into the
+ * transposed patch, for all variables at once.
+ *
+ * @param[in]      distrib
+ *                    The distribution object to work with.
+ * @param[in]      dimA
+ *                    The dimension to exchange.
+ * @param[in]      dimB
+ *                    The dimension to exchange with.
+ * @param[in]      numChunks
+ *                    The requested number of chunks, must be positive.
+ *                    The same value must be used on all processes.
+ * @param[in]      chunkFunc
+ *                    The function that is called for every chunk.
+ * @param[in,out]  *data
+ *                    Passed on to @c chunkFunc.
+ *
+ * @return  Returns nothing.
+ */
+extern void
+gridRegularDistrib_transposePipelined(gridRegularDistrib_t          distrib,
+                                      int                           dimA,
+                                      int                           dimB,
+                                      int                           numChunks,
+                                      gridRegularDistribChunkFunc_t chunkFunc,
+                                      void                          *data);
+
 
 /*--- Doxygen group definitions -----------------------------------------*/
 
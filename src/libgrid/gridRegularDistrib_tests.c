@@ -29,6 +29,15 @@
 /*--- Local defines -----------------------------------------------------*/
 
 
+/*--- Local structures and typedefs -------------------------------------*/
+struct local_chunkData_struct {
+	gridRegular_t grid;
+	bool          doFill;
+	uint32_t      numSlabsSeen;
+	int           numChunksSeen;
+};
+
+
 /*--- Prototypes of local functions -------------------------------------*/
 static gridRegular_t
 local_getFakeGrid(void);
@@ -46,6 +55,20 @@ local_getFakeDistribForTranspose(void);
 static void
 local_fillFakeGridForTranspose(gridRegular_t grid);
 
+static void
+local_fillFakeSlabsForTranspose(gridRegular_t grid,
+                                uint32_t      slabLo,
+                                uint32_t      numSlabs);
+
+static void
+local_chunkFunc(uint32_t idxLo, uint32_t num, void *data);
+
+static bool
+local_transposePipelined(gridRegularDistrib_t          distrib,
+                         int                           dimA,
+                         int                           dimB,
+                         struct local_chunkData_struct *chunkData);
+
 static bool
 local_verifyFakeDistribForTranspose(gridRegularDistrib_t distrib);
 
@@ -461,6 +484,59 @@ gridRegularDistrib_transpose_test(void)
 	return hasPassed ? true : false;
 } /* gridRegularDistrib_transpose_test */
 
+extern bool
+gridRegularDistrib_transposePipelined_test(void)
+{
+	bool                          hasPassed = true;
+	int                           rank      = 0;
+	gridRegularDistrib_t          distrib;
+	gridPatch_t                   patch;
+	struct local_chunkData_struct chunkData;
+#ifdef XMEM_TRACK_MEM
+	size_t                        allocatedBytes = global_allocated_bytes;
+#endif
+#ifdef WITH_MPI
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+#endif
+
+	if (rank == 0)
+		printf("Testing %s... ", __func__);
+
+	distrib = local_getFakeDistribForTranspose();
+	patch   = gridRegular_getPatchHandle(distrib->grid, 0);
+	memset(gridPatch_getVarDataHandle(patch, 0), 0,
+	       gridPatch_getNumCells(patch) * sizeof(int));
+
+	// The data only becomes valid chunk by chunk.
+	chunkData.grid   = distrib->grid;
+	chunkData.doFill = true;
+	if (!local_transposePipelined(distrib, 0, 1, &chunkData))
+		hasPassed = false;
+	if (!local_verifyFakeDistribForTranspose(distrib))
+		hasPassed = false;
+
+	chunkData.doFill = false;
+	if (!local_transposePipelined(distrib, 0, 1, &chunkData))
+		hasPassed = false;
+	if (!local_transposePipelined(distrib, 0, 2, &chunkData))
+		hasPassed = false;
+	if (!local_transposePipelined(distrib, 0, 2, &chunkData))
+		hasPassed = false;
+	if (!local_transposePipelined(distrib, 0, 1, &chunkData))
+		hasPassed = false;
+	if (!local_verifyFakeDistribForTranspose(distrib))
+		hasPassed = false;
+
+	gridRegularDistrib_del(&distrib);
+
+#ifdef XMEM_TRACK_MEM
+	if (allocatedBytes != global_allocated_bytes)
+		hasPassed = false;
+#endif
+
+	return hasPassed ? true : false;
+} /* gridRegularDistrib_transposePipelined_test */
+
 /*--- Implementations of local functions --------------------------------*/
 static gridRegular_t
 local_getFakeGrid(void)
@@ -540,13 +616,24 @@ local_getFakeDistribForTranspose(void)
 
 static void
 local_fillFakeGridForTranspose(gridRegular_t grid)
+{
+	gridPointUint32_t dims;
+
+	gridPatch_getDims(gridRegular_getPatchHandle(grid, 0), dims);
+	local_fillFakeSlabsForTranspose(grid, 0, dims[NDIM - 1]);
+}
+
+static void
+local_fillFakeSlabsForTranspose(gridRegular_t grid,
+                                uint32_t      slabLo,
+                                uint32_t      numSlabs)
 {
 	gridPatch_t       patch;
 	int               *data;
 	gridPointUint32_t idxLo;
 	gridPointUint32_t dims;
 	gridPointUint32_t dimsGlobal;
-	uint64_t          offset = 0;
+	uint64_t          offset;
 
 	patch = gridRegular_getPatchHandle(grid, 0);
 	gridPatch_getDims(patch, dims);
@@ -555,7 +642,8 @@ local_fillFakeGridForTranspose(gridRegular_t grid)
 	gridRegular_getDims(grid, dimsGlobal);
 
 #if (NDIM == 2)
-	for (int j = 0; j < dims[1]; j++) {
+	offset = (uint64_t)slabLo * dims[0];
+	for (int j = slabLo; j < slabLo + numSlabs; j++) {
 		for (int i = 0; i < dims[0]; i++) {
 			data[offset] = i + idxLo[0]
 			               + (j + idxLo[1]) * dimsGlobal[0];
@@ -563,7 +651,8 @@ local_fillFakeGridForTranspose(gridRegular_t grid)
 		}
 	}
 #elif (NDIM == 3)
-	for (int k = 0; k < dims[2]; k++) {
+	offset = (uint64_t)slabLo * dims[0] * dims[1];
+	for (int k = slabLo; k < slabLo + numSlabs; k++) {
 		for (int j = 0; j < dims[1]; j++) {
 			for (int i = 0; i < dims[0]; i++) {
 				data[offset] = i + idxLo[0]
@@ -575,7 +664,46 @@ local_fillFakeGridForTranspose(gridRegular_t grid)
 		}
 	}
 #endif
-} /* local_fillFakeGridForTranspose */
+} /* local_fillFakeSlabsForTranspose */
+
+static void
+local_chunkFunc(uint32_t idxLo, uint32_t num, void *data)
+{
+	struct local_chunkData_struct *chunkData = data;
+	gridPointUint32_t             dims;
+
+	gridPatch_getDims(gridRegular_getPatchHandle(chunkData->grid, 0), dims);
+	// Chunks must come in order and without gaps.
+	if (idxLo != chunkData->numSlabsSeen || idxLo + num > dims[NDIM - 1])
+		return;
+
+	if (chunkData->doFill)
+		local_fillFakeSlabsForTranspose(chunkData->grid, idxLo, num);
+	chunkData->numSlabsSeen += num;
+	chunkData->numChunksSeen++;
+}
+
+static bool
+local_transposePipelined(gridRegularDistrib_t          distrib,
+                         int                           dimA,
+                         int                           dimB,
+                         struct local_chunkData_struct *chunkData)
+{
+	gridPointUint32_t dims;
+
+	gridPatch_getDims(gridRegular_getPatchHandle(distrib->grid, 0), dims);
+	chunkData->numSlabsSeen  = 0;
+	chunkData->numChunksSeen = 0;
+	gridRegularDistrib_transposePipelined(distrib, dimA, dimB, 5,
+	                                      &local_chunkFunc, chunkData);
+
+	// The chunks need not divide the slabs evenly.
+	if (chunkData->numChunksSeen != ((dims[NDIM - 1] < 5)
+	                                 ? (int)dims[NDIM - 1] : 5))
+		return false;
+
+	return chunkData->numSlabsSeen == dims[NDIM - 1] ? true : false;
+}
 
 static bool
 local_verifyFakeDistribForTranspose(gridRegularDistrib_t distrib)
@@ -38,4 +38,7 @@ gridRegularDistrib_calcIdxsForRank1D_test(void);
 extern bool
 gridRegularDistrib_transpose_test(void);
 
+extern bool
+gridRegularDistrib_transposePipelined_test(void);
+
 #endif
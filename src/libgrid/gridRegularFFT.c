@@ -7,13 +7,22 @@
 #include "gridConfig.h"
 #include "gridRegularFFT.h"
 #include "../libdata/dataVarType.h"
+#include <stdlib.h>
 #include <assert.h>
+#include <stdio.h>
+#include <string.h>
 #include "../libutil/xmem.h"
+#include "../libutil/xfile.h"
+#include "../libutil/xstring.h"
 #include "../libutil/diediedie.h"
+#include "../libutil/profile.h"
 #ifdef WITH_FFT_FFTW3
 #  include <complex.h>
 #  include <fftw3.h>
 #endif
+#ifdef _OPENMP
+#  include <omp.h>
+#endif
 #ifdef WITH_MPITRACE
 #  include <mpitrace_user_events.h>
 #endif
@@ -27,12 +36,120 @@
 #ifdef WITH_MPITRACE
 #  define LOCAL_MPITRACE_EVENT 460000000
 #endif
+#define LOCAL_NUM_EFFORTS 4
+#define LOCAL_NUM_CHUNKS  4
+#define LOCAL_PLAN_R2C    0
+#define LOCAL_PLAN_C2R    1
+#define LOCAL_PLAN_C2C(phase, direction) \
+	(2 * (phase) + (((direction) == GRIDREGULARFFT_FORWARD) ? 0 : 1))
+
+
+/*--- Local structures and typedefs -------------------------------------*/
+#if (defined WITH_MPI && defined WITH_FFT_FFTW3)
+struct local_chunk_struct {
+	gridRegularFFT_t fft;
+	int              slot;
+	void             *in;
+	void             *out;
+};
+#endif
+
+
+/*--- Local variables ---------------------------------------------------*/
+static const char *const local_effortStr[LOCAL_NUM_EFFORTS]
+    = { "estimate", "measure", "patient", "unknown" };
+
+#if (defined _OPENMP && defined WITH_FFT_FFTW3)
+static bool local_threadsAreInitialised = false;
+#endif
 
 
 /*--- Prototypes of local functions -------------------------------------*/
 static void
 local_getFFTedThings(gridRegularFFT_t fft);
 
+static void
+local_reenterKSpaceLayout(gridRegularFFT_t fft);
+
+static char *
+local_getKSpaceStoreFileName(const char *fileName);
+
+#if (defined WITH_FFT_FFTW3)
+static void
+local_initPlans(gridRegularFFT_t fft);
+
+static void
+local_destroyPlans(gridRegularFFT_t fft);
+
+static void
+local_destroyPlan(gridRegularFFT_t fft, int slot);
+
+static unsigned
+local_getPlannerFlags(const gridRegularFFT_t fft);
+
+static bool
+local_isInPlace(const gridRegularFFT_t fft, int slot);
+
+static void
+local_executePlan(gridRegularFFT_t fft, int slot, void *in, void *out);
+
+static void
+local_executeGivenPlan(int        slot,
+                       fftw_plan  plan,
+                       fftwf_plan planf,
+                       void       *in,
+                       void       *out);
+
+static void
+local_createPlan(gridRegularFFT_t fft, int slot, void *in, void *out,
+                 unsigned flags);
+
+static void
+local_createPlanOnScratch(gridRegularFFT_t fft, int slot);
+
+static void
+local_createPlanAnyAlign(gridRegularFFT_t fft, int slot, void *in,
+                         void *out);
+
+static void
+local_getPlanArraySizes(const gridRegularFFT_t fft,
+                        int                    slot,
+                        size_t                 *numBytesIn,
+                        size_t                 *numBytesOut);
+
+static int
+local_getAlignment(const gridRegularFFT_t fft, void *data);
+
+#  if (defined WITH_MPI)
+static void
+local_executePlanOnSlabs(gridRegularFFT_t fft,
+                         int              slot,
+                         void             *in,
+                         void             *out,
+                         uint32_t         idxLo,
+                         uint32_t         num);
+
+static void
+local_swapPlans(gridRegularFFT_t fft, int slot);
+
+static void
+local_getSlabStrides(const gridRegularFFT_t fft,
+                     int                    slot,
+                     size_t                 *numBytesIn,
+                     size_t                 *numBytesOut);
+
+static void
+local_executeChunk(uint32_t idxLo, uint32_t num, void *data);
+
+#  endif
+#endif
+
+#if (defined _OPENMP && defined WITH_FFT_FFTW3)
+static void
+local_initThreads(void);
+
+#endif
+
 
 #if (defined WITH_MPI)
 static void
@@ -59,14 +176,14 @@ static void *
 local_doFFTParallelR2CPencil(gridRegularFFT_t fft);
 
 static void *
-local_doFFTParallelC2CPencil(gridRegularFFT_t fft, int phase, int sign);
+local_doFFTParallelC2CPencil(gridRegularFFT_t fft,
+                             int              phase,
+                             int              sign,
+                             int              dimT);
 
 static void *
 local_doFFTParallelC2RPencil(gridRegularFFT_t fft);
 
-static void *
-local_doFFTParallelBackward(gridRegularFFT_t fft);
-
 #endif
 
 /*--- Implementations of exported functios ------------------------------*/
@@ -98,6 +215,20 @@ gridRegularFFT_new(gridRegular_t        grid,
 #if (defined WITH_FFT_FFTW3)
 	fft->norm = 1. / ((double)gridRegular_getNumCellsTotal(grid));
 #endif
+	fft->isInKSpace          = false;
+	fft->kSpaceStore         = NULL;
+	fft->kSpaceStoreFileName = NULL;
+	fft->kSpaceStoreNumBytes = UINT64_C(0);
+	fft->effort              = GRIDREGULARFFT_EFFORT_ESTIMATE;
+#ifdef _OPENMP
+	fft->numThreads          = omp_get_max_threads();
+#else
+	fft->numThreads          = 1;
+#endif
+	fft->numChunks           = LOCAL_NUM_CHUNKS;
+#if (defined WITH_FFT_FFTW3)
+	local_initPlans(fft);
+#endif
 
 	return fft;
 }
@@ -107,6 +238,10 @@ gridRegularFFT_del(gridRegularFFT_t *fft)
 {
 	assert(fft != NULL && *fft != NULL);
 
+	gridRegularFFT_discardKSpace(*fft);
+#if (defined WITH_FFT_FFTW3)
+	local_destroyPlans(*fft);
+#endif
 	gridRegular_del(&((*fft)->grid));
 	gridRegular_del(&((*fft)->gridFFTed));
 	gridRegularDistrib_del(&((*fft)->distrib));
@@ -135,20 +270,224 @@ gridRegularFFT_getNorm(const gridRegularFFT_t fft)
 extern void *
 gridRegularFFT_execute(gridRegularFFT_t fft, int direction)
 {
-	void *result;
+	void       *result;
+	const char *region;
 
 	assert(fft != NULL);
 	assert(direction == GRIDREGULARFFT_FORWARD
 	       || direction == GRIDREGULARFFT_BACKWARD);
 
+	region = (direction == GRIDREGULARFFT_FORWARD) ? "fft.r2c" : "fft.c2r";
+	profile_begin(region);
 #if (!defined WITH_MPI)
 	result = local_doFFTCompletelyLocal(fft, direction);
 #else
 	result = local_doFFTParallel(fft, direction);
 #endif
+	profile_end(region);
+	fft->isInKSpace = (direction == GRIDREGULARFFT_FORWARD) ? true : false;
+
 	return result;
 }
 
+extern void
+gridRegularFFT_storeKSpace(gridRegularFFT_t fft, const char *fileName)
+{
+	void              *data;
+	gridPointUint32_t dims;
+
+	assert(fft != NULL);
+	assert(fft->isInKSpace);
+
+	gridRegularFFT_discardKSpace(fft);
+
+	data = gridPatch_getVarDataHandle(fft->patchFFTed, fft->idxFFTVarFFTed);
+	fft->kSpaceStoreNumBytes = dataVar_getSizePerElement(fft->varFFTed)
+	                           * gridPatch_getNumCellsActual(fft->patchFFTed,
+	                                                         fft->
+	                                                         idxFFTVarFFTed);
+	gridPatch_getIdxLo(fft->patchFFTed, fft->kSpaceStoreIdxLo);
+	gridPatch_getDims(fft->patchFFTed, dims);
+	for (int i = 0; i < NDIM; i++)
+		fft->kSpaceStoreIdxHi[i] = fft->kSpaceStoreIdxLo[i] + dims[i] - 1;
+
+	if (fileName == NULL) {
+		fft->kSpaceStore = xmalloc(fft->kSpaceStoreNumBytes);
+		memcpy(fft->kSpaceStore, data, fft->kSpaceStoreNumBytes);
+	} else {
+		FILE *f;
+		fft->kSpaceStoreFileName = local_getKSpaceStoreFileName(fileName);
+		f                        = xfopen(fft->kSpaceStoreFileName, "wb");
+		xfwrite(data, fft->kSpaceStoreNumBytes, 1, f);
+		xfclose(&f);
+	}
+}
+
+extern void
+gridRegularFFT_restoreKSpace(gridRegularFFT_t fft)
+{
+	void *data;
+
+	assert(fft != NULL);
+	assert(fft->kSpaceStore != NULL || fft->kSpaceStoreFileName != NULL);
+
+	if (!fft->isInKSpace) {
+		// The real space field has been consumed by the caller, so there
+		// is no need to keep it around while k-space is occupied.
+		gridPatch_freeVarData(fft->patch, fft->idxFFTVar);
+		local_reenterKSpaceLayout(fft);
+		fft->isInKSpace = true;
+	}
+
+	data = gridPatch_getVarDataHandle(fft->patchFFTed, fft->idxFFTVarFFTed);
+	if (fft->kSpaceStore != NULL) {
+		memcpy(data, fft->kSpaceStore, fft->kSpaceStoreNumBytes);
+	} else {
+		FILE *f = xfopen(fft->kSpaceStoreFileName, "rb");
+		xfread(data, fft->kSpaceStoreNumBytes, 1, f);
+		xfclose(&f);
+	}
+}
+
+extern void
+gridRegularFFT_discardKSpace(gridRegularFFT_t fft)
+{
+	assert(fft != NULL);
+
+	if (fft->kSpaceStore != NULL)
+		xfree(fft->kSpaceStore);
+	if (fft->kSpaceStoreFileName != NULL) {
+		(void)remove(fft->kSpaceStoreFileName);
+		xfree(fft->kSpaceStoreFileName);
+	}
+	fft->kSpaceStore         = NULL;
+	fft->kSpaceStoreFileName = NULL;
+	fft->kSpaceStoreNumBytes = UINT64_C(0);
+}
+
+extern void
+gridRegularFFT_setPlannerEffort(gridRegularFFT_t        fft,
+                                gridRegularFFT_effort_t effort)
+{
+	assert(fft != NULL);
+	assert(effort >= GRIDREGULARFFT_EFFORT_ESTIMATE
+	       && effort < GRIDREGULARFFT_EFFORT_UNKNOWN);
+
+	if (effort == fft->effort)
+		return;
+
+	// Plans made with the old effort are dropped, they are rebuilt on
+	// the next transform.
+#if (defined WITH_FFT_FFTW3)
+	local_destroyPlans(fft);
+#endif
+	fft->effort = effort;
+}
+
+extern void
+gridRegularFFT_setNumThreads(gridRegularFFT_t fft, int numThreads)
+{
+	assert(fft != NULL);
+	assert(numThreads > 0);
+
+#ifndef _OPENMP
+	numThreads = 1;
+#endif
+	if (numThreads == fft->numThreads)
+		return;
+
+	// The thread count is baked into the plans.
+#if (defined WITH_FFT_FFTW3)
+	local_destroyPlans(fft);
+#endif
+	fft->numThreads = numThreads;
+}
+
+extern int
+gridRegularFFT_getNumThreads(const gridRegularFFT_t fft)
+{
+	assert(fft != NULL);
+
+	return fft->numThreads;
+}
+
+extern void
+gridRegularFFT_setNumChunks(gridRegularFFT_t fft, int numChunks)
+{
+	assert(fft != NULL);
+	assert(numChunks > 0);
+
+	fft->numChunks = numChunks;
+}
+
+extern int
+gridRegularFFT_getNumChunks(const gridRegularFFT_t fft)
+{
+	assert(fft != NULL);
+
+	return fft->numChunks;
+}
+
+extern gridRegularFFT_effort_t
+gridRegularFFT_getEffortFromName(const char *name)
+{
+	gridRegularFFT_effort_t effort = GRIDREGULARFFT_EFFORT_UNKNOWN;
+
+	assert(name != NULL);
+
+	for (int i = 0; i < LOCAL_NUM_EFFORTS; i++) {
+		if ((strlen(name) == strlen(local_effortStr[i]))
+		    && (strcmp(name, local_effortStr[i]) == 0)) {
+			effort = (gridRegularFFT_effort_t)i;
+			break;
+		}
+	}
+
+	return effort;
+}
+
+extern const char *
+gridRegularFFT_getNameFromEffort(gridRegularFFT_effort_t effort)
+{
+	return local_effortStr[effort];
+}
+
+extern bool
+gridRegularFFT_importWisdom(const char *fileName)
+{
+	int rtn = 0;
+
+	assert(fileName != NULL);
+
+#if (defined WITH_FFT_FFTW3)
+#  ifdef ENABLE_DOUBLE
+	rtn = fftw_import_wisdom_from_filename(fileName);
+#  else
+	rtn = fftwf_import_wisdom_from_filename(fileName);
+#  endif
+#endif
+
+	return (rtn != 0) ? true : false;
+}
+
+extern bool
+gridRegularFFT_exportWisdom(const char *fileName)
+{
+	int rtn = 0;
+
+	assert(fileName != NULL);
+
+#if (defined WITH_FFT_FFTW3)
+#  ifdef ENABLE_DOUBLE
+	rtn = fftw_export_wisdom_to_filename(fileName);
+#  else
+	rtn = fftwf_export_wisdom_to_filename(fileName);
+#  endif
+#endif
+
+	return (rtn != 0) ? true : false;
+}
+
 /*--- Implementations of local functions --------------------------------*/
 static void
 local_getFFTedThings(gridRegularFFT_t fft)
@@ -176,11 +515,63 @@ local_getFFTedThings(gridRegularFFT_t fft)
 	                                                     rank);
 	fft->varFFTed   = dataVar_clone(fft->var);
 	dataVar_setComplexified(fft->varFFTed);
+	// The complex field is never padded, the real field might be.
+	dataVar_unsetFFTWPadded(fft->varFFTed);
 	gridRegular_attachPatch(fft->gridFFTed, fft->patchFFTed);
 	fft->idxFFTVarFFTed = gridRegular_attachVar(fft->gridFFTed,
 	                                            fft->varFFTed);
 }
 
+/*
+ * Puts the FFTed grid back into the layout it has after a forward
+ * transform, without moving any data.  In the serial case the layout
+ * never changes, in the parallel case the transposes of the forward
+ * transform are replayed on the grid description only and the patch is
+ * replaced by one covering the k-space region that was stored.
+ */
+static void
+local_reenterKSpaceLayout(gridRegularFFT_t fft)
+{
+#if (defined WITH_MPI)
+	gridPatch_t patch;
+	dataVar_t   var;
+
+	// Detach the (empty) variable first, otherwise the local transposes
+	// would allocate and shuffle memory that is thrown away right after.
+	patch = gridRegular_getPatchHandle(fft->gridFFTed, 0);
+	var   = gridPatch_detachVar(patch, fft->idxFFTVarFFTed);
+	dataVar_del(&var);
+
+	gridRegular_transpose(fft->gridFFTed, 0, 1);
+#  if (NDIM > 2)
+	gridRegular_transpose(fft->gridFFTed, 0, 2);
+#  endif
+	patch = gridPatch_new(fft->kSpaceStoreIdxLo, fft->kSpaceStoreIdxHi);
+	(void)gridPatch_attachVar(patch, fft->varFFTed);
+	gridRegular_replacePatch(fft->gridFFTed, 0, patch);
+	fft->patchFFTed = patch;
+#endif
+}
+
+static char *
+local_getKSpaceStoreFileName(const char *fileName)
+{
+	char *name;
+#if (defined WITH_MPI)
+	int  rank;
+	char *suffix = xmalloc(sizeof(char) * 16);
+
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+	sprintf(suffix, ".%i", rank);
+	name = xstrmerge(fileName, suffix);
+	xfree(suffix);
+#else
+	name = xstrdup(fileName);
+#endif
+
+	return name;
+}
+
 #if (defined WITH_MPI)
 static void
 local_initMPIStuff(gridRegularFFT_t fft)
@@ -223,60 +614,38 @@ static void *
 local_doFFTCompletelyLocal(gridRegularFFT_t fft, int direction)
 {
 #  if (defined WITH_FFT_FFTW3)
-	gridPointUint32_t dims;
-	int               n[NDIM];
-	void              *dataIn;
-	void              *dataOut;
+	void *dataIn;
+	void *dataOut;
 
 	if (direction == GRIDREGULARFFT_FORWARD) {
-		dataIn  = gridPatch_getVarDataHandle(fft->patch, fft->idxFFTVar);
-		dataOut = gridPatch_getVarDataHandle(fft->patchFFTed,
-		                                     fft->idxFFTVarFFTed);
-	} else {
-		dataIn  = gridPatch_getVarDataHandle(fft->patchFFTed,
-		                                     fft->idxFFTVarFFTed);
-		dataOut = gridPatch_getVarDataHandle(fft->patch, fft->idxFFTVar);
-	}
-
-	// We always need the non-complex dimensions
-	gridPatch_getDims(fft->patch, dims);
-
-	// We have the opposite ordering of the array, hence flip dims
-	for (int i = 0; i < NDIM; i++)
-		n[i] = dims[NDIM - 1 - i];
-
-	if (dataVarType_isNativeFloat(dataVar_getType(fft->var))) {
-		fftwf_plan plan;
-		if (direction == GRIDREGULARFFT_FORWARD) {
-			plan = fftwf_plan_dft_r2c(NDIM, n, (float *)(dataIn),
-			                          (fftwf_complex *)(dataOut),
-			                          FFTW_ESTIMATE);
+		if (local_isInPlace(fft, LOCAL_PLAN_R2C)) {
+			dataIn  = gridPatch_popVarData(fft->patch, fft->idxFFTVar);
+			dataOut = dataIn;
+			gridPatch_replaceVarData(fft->patchFFTed,
+			                         fft->idxFFTVarFFTed, dataOut);
 		} else {
-			plan = fftwf_plan_dft_c2r(NDIM, n, (fftwf_complex *)(dataIn),
-			                          (float *)(dataOut),
-			                          FFTW_ESTIMATE);
+			dataIn  = gridPatch_getVarDataHandle(fft->patch,
+			                                     fft->idxFFTVar);
+			dataOut = gridPatch_getVarDataHandle(fft->patchFFTed,
+			                                     fft->idxFFTVarFFTed);
 		}
-		fftwf_execute(plan);
-		fftwf_destroy_plan(plan);
+		local_executePlan(fft, LOCAL_PLAN_R2C, dataIn, dataOut);
+		gridPatch_freeVarData(fft->patch, fft->idxFFTVar);
 	} else {
-		fftw_plan plan;
-		if (direction == GRIDREGULARFFT_FORWARD) {
-			plan = fftw_plan_dft_r2c(NDIM, n, (double *)(dataIn),
-			                         (fftw_complex *)(dataOut),
-			                         FFTW_ESTIMATE);
+		if (local_isInPlace(fft, LOCAL_PLAN_C2R)) {
+			dataIn  = gridPatch_popVarData(fft->patchFFTed,
+			                               fft->idxFFTVarFFTed);
+			dataOut = dataIn;
+			gridPatch_replaceVarData(fft->patch, fft->idxFFTVar, dataOut);
 		} else {
-			plan = fftw_plan_dft_c2r(NDIM, n, (fftw_complex *)(dataIn),
-			                         (double *)(dataOut),
-			                         FFTW_ESTIMATE);
+			dataIn  = gridPatch_getVarDataHandle(fft->patchFFTed,
+			                                     fft->idxFFTVarFFTed);
+			dataOut = gridPatch_getVarDataHandle(fft->patch,
+			                                     fft->idxFFTVar);
 		}
-		fftw_execute(plan);
-		fftw_destroy_plan(plan);
-	}
-
-	if (direction == GRIDREGULARFFT_FORWARD)
-		gridPatch_freeVarData(fft->patch, fft->idxFFTVar);
-	else
+		local_executePlan(fft, LOCAL_PLAN_C2R, dataIn, dataOut);
 		gridPatch_freeVarData(fft->patchFFTed, fft->idxFFTVarFFTed);
+	}
 
 	return dataOut;
 #  endif
@@ -296,25 +665,26 @@ local_doFFTParallel(gridRegularFFT_t fft, int direction)
 	return result;
 }
 
+/*
+ * All but the last pencil transform are done chunk-wise, such that the
+ * transposition following them can already communicate the finished
+ * chunks while the next one is being transformed.
+ */
 static void *
 local_doFFTParallelForward(gridRegularFFT_t fft)
 {
 	void *result;
 
-	result = local_doFFTParallelR2CPencil(fft);
-
-	gridRegularDistrib_transpose(fft->distribFFTed, 0, 1);
+	(void)local_doFFTParallelR2CPencil(fft);
 	fft->patchFFTed = gridRegular_getPatchHandle(fft->gridFFTed, 0);
-	result          = local_doFFTParallelC2CPencil(fft, 1,
-	                                               GRIDREGULARFFT_FORWARD);
-	gridPatch_replaceVarData(fft->patchFFTed, fft->idxFFTVarFFTed, result);
 
 #  if (NDIM > 2)
-	gridRegularDistrib_transpose(fft->distribFFTed, 0, 2);
+	(void)local_doFFTParallelC2CPencil(fft, 1, GRIDREGULARFFT_FORWARD, 2);
 	fft->patchFFTed = gridRegular_getPatchHandle(fft->gridFFTed, 0);
 	result          = local_doFFTParallelC2CPencil(fft, 2,
-	                                               GRIDREGULARFFT_FORWARD);
-	gridPatch_replaceVarData(fft->patchFFTed, fft->idxFFTVarFFTed, result);
+	                                               GRIDREGULARFFT_FORWARD, 0);
+#  else
+	result = local_doFFTParallelC2CPencil(fft, 1, GRIDREGULARFFT_FORWARD, 0);
 #  endif
 
 	return result;
@@ -326,103 +696,72 @@ local_doFFTParallelBackward(gridRegularFFT_t fft)
 	void *result;
 
 #  if (NDIM > 2)
-	result = local_doFFTParallelC2CPencil(fft, 2, GRIDREGULARFFT_BACKWARD);
-	gridPatch_replaceVarData(fft->patchFFTed, fft->idxFFTVarFFTed, result);
-
-	gridRegularDistrib_transpose(fft->distribFFTed, 0, 2);
+	(void)local_doFFTParallelC2CPencil(fft, 2, GRIDREGULARFFT_BACKWARD, 2);
 	fft->patchFFTed = gridRegular_getPatchHandle(fft->gridFFTed, 0);
 #  endif
-	result          = local_doFFTParallelC2CPencil(fft, 1,
-	                                               GRIDREGULARFFT_BACKWARD);
-	gridPatch_replaceVarData(fft->patchFFTed, fft->idxFFTVarFFTed, result);
-
-	gridRegularDistrib_transpose(fft->distribFFTed, 0, 1);
+	(void)local_doFFTParallelC2CPencil(fft, 1, GRIDREGULARFFT_BACKWARD, 1);
 	fft->patchFFTed = gridRegular_getPatchHandle(fft->gridFFTed, 0);
 	result          = local_doFFTParallelC2RPencil(fft);
 
 	return result;
 }
 
+/*
+ * Note that this also performs the transposition of dimensions 0 and 1
+ * of the FFTed grid, the returned data is thus the one of the new patch.
+ */
 static void *
 local_doFFTParallelR2CPencil(gridRegularFFT_t fft)
 {
-	int  howmany  = 1;
-	void *dataIn  = gridPatch_getVarDataHandle(fft->patch,
-	                                           fft->idxFFTVar);
-	void *dataOut = gridPatch_getVarDataHandle(fft->patchFFTed,
-	                                           fft->idxFFTVarFFTed);
-
-	for (int i = 1; i < NDIM; i++)
-		howmany *= fft->localDims[0][i];
-
-#  ifdef WITH_MPITRACE
-	MPItrace_event(LOCAL_MPITRACE_EVENT, 1);
-#  endif
-	if (dataVarType_isNativeFloat(dataVar_getType(fft->var))) {
-		fftwf_plan plan;
-		plan = fftwf_plan_many_dft_r2c(1, &(fft->localNumRealElements),
-		                               howmany, (float *)dataIn,
-		                               NULL, 1, fft->localNumRealElements,
-		                               (fftwf_complex *)dataOut,
-		                               NULL, 1, fft->localDims[0][0],
-		                               FFTW_ESTIMATE);
-		fftwf_execute(plan);
-		fftwf_destroy_plan(plan);
+	struct local_chunk_struct chunk;
+	void                      *dataIn;
+	void                      *dataOut;
+
+	if (local_isInPlace(fft, LOCAL_PLAN_R2C)) {
+		dataIn  = gridPatch_popVarData(fft->patch, fft->idxFFTVar);
+		dataOut = dataIn;
+		gridPatch_replaceVarData(fft->patchFFTed, fft->idxFFTVarFFTed,
+		                         dataOut);
 	} else {
-		fftw_plan plan;
-		plan = fftw_plan_many_dft_r2c(1, &(fft->localNumRealElements),
-		                              howmany, (double *)dataIn,
-		                              NULL, 1, fft->localNumRealElements,
-		                              (fftw_complex *)dataOut,
-		                              NULL, 1, fft->localDims[0][0],
-		                              FFTW_ESTIMATE);
-		fftw_execute(plan);
-		fftw_destroy_plan(plan);
+		dataIn  = gridPatch_getVarDataHandle(fft->patch, fft->idxFFTVar);
+		dataOut = gridPatch_getVarDataHandle(fft->patchFFTed,
+		                                     fft->idxFFTVarFFTed);
 	}
-#  ifdef WITH_MPITRACE
-	MPItrace_event(LOCAL_MPITRACE_EVENT, 0);
-#  endif
+
+	chunk.fft  = fft;
+	chunk.slot = LOCAL_PLAN_R2C;
+	chunk.in   = dataIn;
+	chunk.out  = dataOut;
+	gridRegularDistrib_transposePipelined(fft->distribFFTed, 0, 1,
+	                                      fft->numChunks,
+	                                      &local_executeChunk, &chunk);
 	gridPatch_freeVarData(fft->patch, fft->idxFFTVar);
 
-	return dataOut;
+	return gridRegular_getPatchHandle(fft->gridFFTed, 0);
 } /* local_doFFTParallelR2CPencil */
 
 static void *
 local_doFFTParallelC2RPencil(gridRegularFFT_t fft)
 {
-	int  howmany  = 1;
-	void *dataIn  = gridPatch_getVarDataHandle(fft->patchFFTed,
-	                                           fft->idxFFTVarFFTed);
-	void *dataOut = gridPatch_getVarDataHandle(fft->patch,
-	                                           fft->idxFFTVar);
-
-	for (int i = 1; i < NDIM; i++)
-		howmany *= fft->localDims[0][i];
+	void *dataIn;
+	void *dataOut;
+
+	if (local_isInPlace(fft, LOCAL_PLAN_C2R)) {
+		dataIn  = gridPatch_popVarData(fft->patchFFTed,
+		                               fft->idxFFTVarFFTed);
+		dataOut = dataIn;
+		gridPatch_replaceVarData(fft->patch, fft->idxFFTVar, dataOut);
+	} else {
+		dataIn  = gridPatch_getVarDataHandle(fft->patchFFTed,
+		                                     fft->idxFFTVarFFTed);
+		dataOut = gridPatch_getVarDataHandle(fft->patch, fft->idxFFTVar);
+	}
 
 #  ifdef WITH_MPITRACE
 	MPItrace_event(LOCAL_MPITRACE_EVENT, 3);
 #  endif
-	if (dataVarType_isNativeFloat(dataVar_getType(fft->var))) {
-		fftwf_plan plan;
-		plan = fftwf_plan_many_dft_c2r(1, &(fft->localNumRealElements),
-		                               howmany, (fftwf_complex *)dataIn,
-		                               NULL, 1, fft->localDims[0][0],
-		                               (float *)dataOut,
-		                               NULL, 1, fft->localNumRealElements,
-		                               FFTW_ESTIMATE);
-		fftwf_execute(plan);
-		fftwf_destroy_plan(plan);
-	} else {
-		fftw_plan plan;
-		plan = fftw_plan_many_dft_c2r(1, &(fft->localNumRealElements),
-		                              howmany, (fftw_complex *)dataIn,
-		                              NULL, 1, fft->localDims[0][0],
-		                              (double *)dataOut,
-		                              NULL, 1, fft->localNumRealElements,
-		                              FFTW_ESTIMATE);
-		fftw_execute(plan);
-		fftw_destroy_plan(plan);
-	}
+	local_executePlanOnSlabs(fft, LOCAL_PLAN_C2R, dataIn, dataOut,
+	                         0, fft->localDims[0][NDIM - 1]);
 #  ifdef WITH_MPITRACE
 	MPItrace_event(LOCAL_MPITRACE_EVENT, 0);
 #  endif
@@ -432,52 +771,558 @@ local_doFFTParallelC2RPencil(gridRegularFFT_t fft)
 	return dataOut;
 } /* local_doFFTParallelC2RPencil */
 
+/*
+ * If dimT is positive, the FFTed grid is transposed in dimensions 0 and
+ * dimT while the transform is done, and the data of the new patch is
+ * returned.
+ */
 static void *
-local_doFFTParallelC2CPencil(gridRegularFFT_t fft, int phase, int sign)
+local_doFFTParallelC2CPencil(gridRegularFFT_t fft,
+                             int              phase,
+                             int              sign,
+                             int              dimT)
 {
-	int  howmany = 1;
-	void *result;
-	void *data   = gridPatch_getVarDataHandle(fft->patchFFTed,
-	                                          fft->idxFFTVarFFTed);
+	int  slot  = LOCAL_PLAN_C2C(phase, sign);
+	void *data = gridPatch_getVarDataHandle(fft->patchFFTed,
+	                                        fft->idxFFTVarFFTed);
+
+	if (dimT > 0) {
+		struct local_chunk_struct chunk;
+
+		chunk.fft  = fft;
+		chunk.slot = slot;
+		chunk.in   = data;
+		chunk.out  = data;
+		gridRegularDistrib_transposePipelined(fft->distribFFTed, 0, dimT,
+		                                      fft->numChunks,
+		                                      &local_executeChunk, &chunk);
+		data = gridPatch_getVarDataHandle(
+		    gridRegular_getPatchHandle(fft->gridFFTed, 0),
+		    fft->idxFFTVarFFTed);
+	} else {
+#  ifdef WITH_MPITRACE
+		MPItrace_event(LOCAL_MPITRACE_EVENT, 2);
+#  endif
+		local_executePlanOnSlabs(fft, slot, data, data,
+		                         0, fft->localDims[phase][NDIM - 1]);
+#  ifdef WITH_MPITRACE
+		MPItrace_event(LOCAL_MPITRACE_EVENT, 0);
+#  endif
+	}
 
-	sign = (sign == GRIDREGULARFFT_FORWARD) ? FFTW_FORWARD : FFTW_BACKWARD;
+	return data;
+} /* local_doFFTParallelC2CPencil */
 
-	for (int i = 1; i < NDIM; i++)
-		howmany *= fft->localDims[phase][i];
+#endif
 
-#  ifdef WITH_MPITRACE
-	MPItrace_event(LOCAL_MPITRACE_EVENT, 2);
+#if (defined WITH_FFT_FFTW3)
+static void
+local_initPlans(gridRegularFFT_t fft)
+{
+	for (int i = 0; i < GRIDREGULARFFT_NUM_PLANS; i++) {
+		fft->plan[i]          = NULL;
+		fft->planf[i]         = NULL;
+		fft->planAnyAlign[i]  = NULL;
+		fft->planfAnyAlign[i] = NULL;
+		fft->planAlignIn[i]   = 0;
+		fft->planAlignOut[i]  = 0;
+#  if (defined WITH_MPI)
+		fft->planHowmany[i]        = 0;
+		fft->planUnaligned[i]      = false;
+		fft->planOther[i]          = NULL;
+		fft->planfOther[i]         = NULL;
+		fft->planAnyAlignOther[i]  = NULL;
+		fft->planfAnyAlignOther[i] = NULL;
+		fft->planAlignInOther[i]   = 0;
+		fft->planAlignOutOther[i]  = 0;
+		fft->planHowmanyOther[i]   = 0;
+		fft->planUnalignedOther[i] = false;
+#  endif
+	}
+}
+
+static void
+local_destroyPlans(gridRegularFFT_t fft)
+{
+	for (int i = 0; i < GRIDREGULARFFT_NUM_PLANS; i++) {
+		local_destroyPlan(fft, i);
+#  if (defined WITH_MPI)
+		local_swapPlans(fft, i);
+		local_destroyPlan(fft, i);
+#  endif
+	}
+	local_initPlans(fft);
+}
+
+static void
+local_destroyPlan(gridRegularFFT_t fft, int slot)
+{
+	if (fft->plan[slot] != NULL)
+		fftw_destroy_plan(fft->plan[slot]);
+	if (fft->planf[slot] != NULL)
+		fftwf_destroy_plan(fft->planf[slot]);
+	if (fft->planAnyAlign[slot] != NULL)
+		fftw_destroy_plan(fft->planAnyAlign[slot]);
+	if (fft->planfAnyAlign[slot] != NULL)
+		fftwf_destroy_plan(fft->planfAnyAlign[slot]);
+	fft->plan[slot]          = NULL;
+	fft->planf[slot]         = NULL;
+	fft->planAnyAlign[slot]  = NULL;
+	fft->planfAnyAlign[slot] = NULL;
+}
+
+static unsigned
+local_getPlannerFlags(const gridRegularFFT_t fft)
+{
+	unsigned flags;
+
+	switch (fft->effort) {
+	case GRIDREGULARFFT_EFFORT_MEASURE:
+		flags = FFTW_MEASURE;
+		break;
+	case GRIDREGULARFFT_EFFORT_PATIENT:
+		flags = FFTW_PATIENT;
+		break;
+	default:
+		flags = FFTW_ESTIMATE;
+		break;
+	}
+
+	return flags;
+}
+
+/*
+ * The complex-to-complex stages always work on the buffer they are
+ * given.  The real-to-complex stages can only do so if the real field
+ * carries the FFTW padding of its first dimension.
+ */
+static bool
+local_isInPlace(const gridRegularFFT_t fft, int slot)
+{
+	if ((slot == LOCAL_PLAN_R2C) || (slot == LOCAL_PLAN_C2R))
+		return dataVar_isFFTWPadded(fft->var);
+
+	return true;
+}
+
+/*
+ * Executes the plan of the given slot on the provided arrays, creating
+ * the plan on first use.  FFTW requires the arrays passed to a plan to
+ * have the same alignment as those the plan was created for; should
+ * this not be the case, a second plan of the slot that accepts arrays of
+ * any alignment is used, it is created on first use as well.
+ */
+static void
+local_executePlan(gridRegularFFT_t fft, int slot, void *in, void *out)
+{
+	bool isFloat = dataVarType_isNativeFloat(dataVar_getType(fft->var));
+	bool hasPlan = isFloat ? (fft->planf[slot] != NULL)
+	               : (fft->plan[slot] != NULL);
+
+	if (!hasPlan) {
+		if (fft->effort == GRIDREGULARFFT_EFFORT_ESTIMATE)
+			local_createPlan(fft, slot, in, out, FFTW_ESTIMATE);
+		else
+			local_createPlanOnScratch(fft, slot);
+	}
+
+	// Plans for unaligned arrays (alignment -1) accept everything.
+	if ((fft->planAlignIn[slot] >= 0)
+	    && ((local_getAlignment(fft, in) != fft->planAlignIn[slot])
+	        || (local_getAlignment(fft, out) != fft->planAlignOut[slot]))) {
+		hasPlan = isFloat ? (fft->planfAnyAlign[slot] != NULL)
+		          : (fft->planAnyAlign[slot] != NULL);
+		if (!hasPlan)
+			local_createPlanAnyAlign(fft, slot, in, out);
+		local_executeGivenPlan(slot, fft->planAnyAlign[slot],
+		                       fft->planfAnyAlign[slot], in, out);
+		return;
+	}
+
+	local_executeGivenPlan(slot, fft->plan[slot], fft->planf[slot],
+	                       in, out);
+} /* local_executePlan */
+
+/*
+ * Only one of the two plans is set, depending on the precision of the
+ * variable.
+ */
+static void
+local_executeGivenPlan(int        slot,
+                       fftw_plan  plan,
+                       fftwf_plan planf,
+                       void       *in,
+                       void       *out)
+{
+	if (planf != NULL) {
+		if (slot == LOCAL_PLAN_R2C)
+			fftwf_execute_dft_r2c(planf, in, out);
+		else if (slot == LOCAL_PLAN_C2R)
+			fftwf_execute_dft_c2r(planf, in, out);
+		else
+			fftwf_execute_dft(planf, in, out);
+	} else {
+		if (slot == LOCAL_PLAN_R2C)
+			fftw_execute_dft_r2c(plan, in, out);
+		else if (slot == LOCAL_PLAN_C2R)
+			fftw_execute_dft_c2r(plan, in, out);
+		else
+			fftw_execute_dft(plan, in, out);
+	}
+}
+
+static void
+local_createPlan(gridRegularFFT_t fft, int slot, void *in, void *out,
+                 unsigned flags)
+{
+	bool isFloat = dataVarType_isNativeFloat(dataVar_getType(fft->var));
+#  ifdef _OPENMP
+	local_initThreads();
+	if (isFloat)
+		fftwf_plan_with_nthreads(fft->numThreads);
+	else
+		fftw_plan_with_nthreads(fft->numThreads);
 #  endif
-	if (dataVarType_isNativeFloat(dataVar_getType(fft->var))) {
-		fftwf_plan plan;
-		result = fftwf_malloc(sizeof(fftwf_complex) * howmany
-		                      * fft->localDims[phase][0]);
-		plan   = fftwf_plan_many_dft(1, fft->localDims[phase],
-		                             howmany, (float complex *)data,
-		                             NULL, 1, fft->localDims[phase][0],
-		                             (fftwf_complex *)result,
-		                             NULL, 1, fft->localDims[phase][0],
-		                             sign, FFTW_ESTIMATE);
-		fftwf_execute(plan);
-		fftwf_destroy_plan(plan);
+#  if (!defined WITH_MPI)
+	gridPointUint32_t dims;
+	int               n[NDIM];
+
+	// We always need the non-complex dimensions
+	gridPatch_getDims(fft->patch, dims);
+
+	// We have the opposite ordering of the array, hence flip dims
+	for (int i = 0; i < NDIM; i++)
+		n[i] = dims[NDIM - 1 - i];
+
+	if (isFloat) {
+		if (slot == LOCAL_PLAN_R2C)
+			fft->planf[slot] = fftwf_plan_dft_r2c(NDIM, n, (float *)in,
+			                                      (fftwf_complex *)out,
+			                                      flags);
+		else
+			fft->planf[slot] = fftwf_plan_dft_c2r(NDIM, n,
+			                                      (fftwf_complex *)in,
+			                                      (float *)out, flags);
 	} else {
-		fftw_plan plan;
-		result = fftw_malloc(sizeof(fftw_complex) * howmany
-		                     * fft->localDims[phase][0]);
-		plan   = fftw_plan_many_dft(1, fft->localDims[phase],
-		                            howmany, (double complex *)data,
-		                            NULL, 1, fft->localDims[phase][0],
-		                            (fftw_complex *)result,
-		                            NULL, 1, fft->localDims[phase][0],
-		                            sign, FFTW_ESTIMATE);
-		fftw_execute(plan);
-		fftw_destroy_plan(plan);
+		if (slot == LOCAL_PLAN_R2C)
+			fft->plan[slot] = fftw_plan_dft_r2c(NDIM, n, (double *)in,
+			                                    (fftw_complex *)out,
+			                                    flags);
+		else
+			fft->plan[slot] = fftw_plan_dft_c2r(NDIM, n,
+			                                    (fftw_complex *)in,
+			                                    (double *)out, flags);
 	}
-#  ifdef WITH_MPITRACE
+#  else
+	int phase    = slot / 2;
+	int howmany  = fft->planHowmany[slot];
+	int sign     = (slot % 2 == 0) ? FFTW_FORWARD : FFTW_BACKWARD;
+	int distReal = fft->localNumRealElements;
+
+	assert(howmany > 0);
+	if (local_isInPlace(fft, slot) && (phase == 0))
+		distReal = 2 * fft->localDims[0][0];
+	if (fft->planUnaligned[slot])
+		flags |= FFTW_UNALIGNED;
+
+	if (isFloat) {
+		if (slot == LOCAL_PLAN_R2C) {
+			fft->planf[slot] = fftwf_plan_many_dft_r2c(
+			    1, &(fft->localNumRealElements), howmany, (float *)in,
+			    NULL, 1, distReal,
+			    (fftwf_complex *)out, NULL, 1, fft->localDims[0][0],
+			    flags);
+		} else if (slot == LOCAL_PLAN_C2R) {
+			fft->planf[slot] = fftwf_plan_many_dft_c2r(
+			    1, &(fft->localNumRealElements), howmany,
+			    (fftwf_complex *)in, NULL, 1, fft->localDims[0][0],
+			    (float *)out, NULL, 1, distReal,
+			    flags);
+		} else {
+			fft->planf[slot] = fftwf_plan_many_dft(
+			    1, fft->localDims[phase], howmany, (fftwf_complex *)in,
+			    NULL, 1, fft->localDims[phase][0],
+			    (fftwf_complex *)out, NULL, 1, fft->localDims[phase][0],
+			    sign, flags);
+		}
+	} else {
+		if (slot == LOCAL_PLAN_R2C) {
+			fft->plan[slot] = fftw_plan_many_dft_r2c(
+			    1, &(fft->localNumRealElements), howmany, (double *)in,
+			    NULL, 1, distReal,
+			    (fftw_complex *)out, NULL, 1, fft->localDims[0][0],
+			    flags);
+		} else if (slot == LOCAL_PLAN_C2R) {
+			fft->plan[slot] = fftw_plan_many_dft_c2r(
+			    1, &(fft->localNumRealElements), howmany,
+			    (fftw_complex *)in, NULL, 1, fft->localDims[0][0],
+			    (double *)out, NULL, 1, distReal,
+			    flags);
+		} else {
+			fft->plan[slot] = fftw_plan_many_dft(
+			    1, fft->localDims[phase], howmany, (fftw_complex *)in,
+			    NULL, 1, fft->localDims[phase][0],
+			    (fftw_complex *)out, NULL, 1, fft->localDims[phase][0],
+			    sign, flags);
+		}
+	}
+#  endif
+	fft->planAlignIn[slot]  = local_getAlignment(fft, in);
+	fft->planAlignOut[slot] = local_getAlignment(fft, out);
+#  if (defined WITH_MPI)
+	if (fft->planUnaligned[slot]) {
+		fft->planAlignIn[slot]  = -1;
+		fft->planAlignOut[slot] = -1;
+	}
+#  endif
+} /* local_createPlan */
+
+/*
+ * The plan is made with FFTW_ESTIMATE, as measuring would overwrite the
+ * arrays.  It ends up in the second plan of the slot, the regular plan
+ * is left untouched.
+ */
+static void
+local_createPlanAnyAlign(gridRegularFFT_t fft, int slot, void *in,
+                         void *out)
+{
+	fftw_plan  plan     = fft->plan[slot];
+	fftwf_plan planf    = fft->planf[slot];
+	int        alignIn  = fft->planAlignIn[slot];
+	int        alignOut = fft->planAlignOut[slot];
+
+	fft->plan[slot]  = NULL;
+	fft->planf[slot] = NULL;
+	local_createPlan(fft, slot, in, out, FFTW_ESTIMATE | FFTW_UNALIGNED);
+	fft->planAnyAlign[slot]  = fft->plan[slot];
+	fft->planfAnyAlign[slot] = fft->planf[slot];
+	fft->plan[slot]          = plan;
+	fft->planf[slot]         = planf;
+	fft->planAlignIn[slot]   = alignIn;
+	fft->planAlignOut[slot]  = alignOut;
+}
+
+/*
+ * Measuring overwrites the arrays, hence the planning is done on scratch
+ * arrays.  They are only needed the first time a slot is used and not
+ * at all if the plan can be taken from previously imported wisdom.
+ */
+static void
+local_createPlanOnScratch(gridRegularFFT_t fft, int slot)
+{
+	size_t numBytesIn, numBytesOut;
+	void   *in, *out;
+	bool   isFloat = dataVarType_isNativeFloat(dataVar_getType(fft->var));
+
+	local_getPlanArraySizes(fft, slot, &numBytesIn, &numBytesOut);
+	in = isFloat ? fftwf_malloc(numBytesIn) : fftw_malloc(numBytesIn);
+	if (local_isInPlace(fft, slot))
+		out = in;
+	else
+		out = isFloat ? fftwf_malloc(numBytesOut) : fftw_malloc(numBytesOut);
+	if ((in == NULL) || (out == NULL)) {
+		fprintf(stderr, "FATAL: Could not allocate planning arrays.\n");
+		diediedie(EXIT_FAILURE);
+	}
+
+	local_createPlan(fft, slot, in, out, local_getPlannerFlags(fft));
+
+	if (out != in) {
+		if (isFloat)
+			fftwf_free(out);
+		else
+			fftw_free(out);
+	}
+	if (isFloat)
+		fftwf_free(in);
+	else
+		fftw_free(in);
+}
+
+static void
+local_getPlanArraySizes(const gridRegularFFT_t fft,
+                        int                    slot,
+                        size_t                 *numBytesIn,
+                        size_t                 *numBytesOut)
+{
+	size_t sizeReal, sizeComplex;
+	size_t numReal, numComplex;
+
+	if (dataVarType_isNativeFloat(dataVar_getType(fft->var)))
+		sizeReal = sizeof(float);
+	else
+		sizeReal = sizeof(double);
+	sizeComplex = 2 * sizeReal;
+
+#  if (!defined WITH_MPI)
+	numReal    = gridPatch_getNumCellsActual(fft->patch, fft->idxFFTVar);
+	numComplex = gridPatch_getNumCellsActual(fft->patchFFTed,
+	                                         fft->idxFFTVarFFTed);
+#  else
+	int phase   = slot / 2;
+	int howmany = fft->planHowmany[slot];
+
+	numReal    = (size_t)howmany * fft->localNumRealElements;
+	if (dataVar_isFFTWPadded(fft->var))
+		numReal = (size_t)howmany * 2 * fft->localDims[0][0];
+	numComplex = (size_t)howmany * fft->localDims[phase][0];
+#  endif
+
+	if (slot == LOCAL_PLAN_R2C) {
+		*numBytesIn  = numReal * sizeReal;
+		*numBytesOut = numComplex * sizeComplex;
+	} else if (slot == LOCAL_PLAN_C2R) {
+		*numBytesIn  = numComplex * sizeComplex;
+		*numBytesOut = numReal * sizeReal;
+	} else {
+		*numBytesIn  = numComplex * sizeComplex;
+		*numBytesOut = numComplex * sizeComplex;
+	}
+} /* local_getPlanArraySizes */
+
+static int
+local_getAlignment(const gridRegularFFT_t fft, void *data)
+{
+	if (dataVarType_isNativeFloat(dataVar_getType(fft->var)))
+		return fftwf_alignment_of((float *)data);
+
+	return fftw_alignment_of((double *)data);
+}
+
+#  if (defined WITH_MPI)
+
+/*
+ * Transforms the num slabs (along the last dimension) starting at idxLo.
+ * The chunks of a transform come in at most two sizes, the plans for
+ * both are kept and the plan is only remade if a third number of pencils
+ * shows up.  If the chunks do not start at aligned addresses, the plan
+ * is made for unaligned arrays right away, instead of falling back to
+ * throw-away plans for every chunk.
+ */
+static void
+local_executePlanOnSlabs(gridRegularFFT_t fft,
+                         int              slot,
+                         void             *in,
+                         void             *out,
+                         uint32_t         idxLo,
+                         uint32_t         num)
+{
+	int    phase       = slot / 2;
+	int    howmany     = (int)num;
+	size_t numBytesIn  = 0;
+	size_t numBytesOut = 0;
+
+	for (int i = 1; i < NDIM - 1; i++)
+		howmany *= fft->localDims[phase][i];
+	local_getSlabStrides(fft, slot, &numBytesIn, &numBytesOut);
+
+	if (howmany != fft->planHowmany[slot]) {
+		// The least recently used plan of the slot is the one replaced.
+		local_swapPlans(fft, slot);
+		if (howmany != fft->planHowmany[slot]) {
+			local_destroyPlan(fft, slot);
+			fft->planHowmany[slot]   = howmany;
+			fft->planUnaligned[slot] = ((num * numBytesIn) % 16 != 0)
+			                           || ((num * numBytesOut) % 16 != 0);
+		}
+	}
+
+	profile_begin("fft.exec");
+	local_executePlan(fft, slot,
+	                  (char *)in + idxLo * numBytesIn,
+	                  (char *)out + idxLo * numBytesOut);
+	profile_end("fft.exec");
+}
+
+static void
+local_swapPlans(gridRegularFFT_t fft, int slot)
+{
+	fftw_plan  plan          = fft->plan[slot];
+	fftwf_plan planf         = fft->planf[slot];
+	fftw_plan  planAnyAlign  = fft->planAnyAlign[slot];
+	fftwf_plan planfAnyAlign = fft->planfAnyAlign[slot];
+	int        alignIn       = fft->planAlignIn[slot];
+	int        alignOut      = fft->planAlignOut[slot];
+	int        howmany       = fft->planHowmany[slot];
+	bool       isUnaligned   = fft->planUnaligned[slot];
+
+	fft->plan[slot]               = fft->planOther[slot];
+	fft->planf[slot]              = fft->planfOther[slot];
+	fft->planAnyAlign[slot]       = fft->planAnyAlignOther[slot];
+	fft->planfAnyAlign[slot]      = fft->planfAnyAlignOther[slot];
+	fft->planAlignIn[slot]        = fft->planAlignInOther[slot];
+	fft->planAlignOut[slot]       = fft->planAlignOutOther[slot];
+	fft->planHowmany[slot]        = fft->planHowmanyOther[slot];
+	fft->planUnaligned[slot]      = fft->planUnalignedOther[slot];
+	fft->planOther[slot]          = plan;
+	fft->planfOther[slot]         = planf;
+	fft->planAnyAlignOther[slot]  = planAnyAlign;
+	fft->planfAnyAlignOther[slot] = planfAnyAlign;
+	fft->planAlignInOther[slot]   = alignIn;
+	fft->planAlignOutOther[slot]  = alignOut;
+	fft->planHowmanyOther[slot]   = howmany;
+	fft->planUnalignedOther[slot] = isUnaligned;
+} /* local_swapPlans */
+
+static void
+local_getSlabStrides(const gridRegularFFT_t fft,
+                     int                    slot,
+                     size_t                 *numBytesIn,
+                     size_t                 *numBytesOut)
+{
+	int    phase      = slot / 2;
+	size_t numPencils = 1;
+	size_t sizeReal   = sizeof(double);
+	size_t numReal    = fft->localNumRealElements;
+	size_t numComplex = fft->localDims[phase][0];
+
+	if (dataVarType_isNativeFloat(dataVar_getType(fft->var)))
+		sizeReal = sizeof(float);
+	if (dataVar_isFFTWPadded(fft->var))
+		numReal = 2 * numComplex;
+	for (int i = 1; i < NDIM - 1; i++)
+		numPencils *= fft->localDims[phase][i];
+
+	*numBytesIn  = numPencils * numComplex * 2 * sizeReal;
+	*numBytesOut = *numBytesIn;
+	if (slot == LOCAL_PLAN_R2C)
+		*numBytesIn = numPencils * numReal * sizeReal;
+	else if (slot == LOCAL_PLAN_C2R)
+		*numBytesOut = numPencils * numReal * sizeReal;
+}
+
+static void
+local_executeChunk(uint32_t idxLo, uint32_t num, void *data)
+{
+	struct local_chunk_struct *chunk = data;
+
+#    ifdef WITH_MPITRACE
+	MPItrace_event(LOCAL_MPITRACE_EVENT,
+	               (chunk->slot == LOCAL_PLAN_R2C) ? 1 : 2);
+#    endif
+	local_executePlanOnSlabs(chunk->fft, chunk->slot, chunk->in, chunk->out,
+	                         idxLo, num);
+#    ifdef WITH_MPITRACE
 	MPItrace_event(LOCAL_MPITRACE_EVENT, 0);
+#    endif
+}
+
 #  endif
 
-	return result;
-} /* local_doFFTParallelC2CPencil */
+#endif
+
+#if (defined _OPENMP && defined WITH_FFT_FFTW3)
+static void
+local_initThreads(void)
+{
+	if (local_threadsAreInitialised)
+		return;
+
+	if ((fftw_init_threads() == 0) || (fftwf_init_threads() == 0)) {
+		fprintf(stderr, "FATAL: Could not initialise FFTW threads.\n");
+		diediedie(EXIT_FAILURE);
+	}
+	local_threadsAreInitialised = true;
+}
 
 #endif
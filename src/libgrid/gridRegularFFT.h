@@ -10,6 +10,7 @@
 #include "gridConfig.h"
 #include "gridRegular.h"
 #include "gridRegularDistrib.h"
+#include <stdbool.h>
 
 
 /*--- ADT handle --------------------------------------------------------*/
@@ -21,6 +22,15 @@ typedef struct gridRegularFFT_struct *gridRegularFFT_t;
 #define GRIDREGULARFFT_BACKWARD -1
 
 
+/*--- Exported types ----------------------------------------------------*/
+typedef enum {
+	GRIDREGULARFFT_EFFORT_ESTIMATE = 0,
+	GRIDREGULARFFT_EFFORT_MEASURE  = 1,
+	GRIDREGULARFFT_EFFORT_PATIENT  = 2,
+	GRIDREGULARFFT_EFFORT_UNKNOWN  = 3
+} gridRegularFFT_effort_t;
+
+
 /*--- Prototypes of exported functions ----------------------------------*/
 extern gridRegularFFT_t
 gridRegularFFT_new(gridRegular_t        grid,
@@ -39,4 +49,41 @@ gridRegularFFT_getNorm(const gridRegularFFT_t fft);
 extern void *
 gridRegularFFT_execute(gridRegularFFT_t fft, int direction);
 
+extern void
+gridRegularFFT_storeKSpace(gridRegularFFT_t fft, const char *fileName);
+
+extern void
+gridRegularFFT_restoreKSpace(gridRegularFFT_t fft);
+
+extern void
+gridRegularFFT_discardKSpace(gridRegularFFT_t fft);
+
+extern void
+gridRegularFFT_setPlannerEffort(gridRegularFFT_t        fft,
+                                gridRegularFFT_effort_t effort);
+
+extern void
+gridRegularFFT_setNumThreads(gridRegularFFT_t fft, int numThreads);
+
+extern int
+gridRegularFFT_getNumThreads(const gridRegularFFT_t fft);
+
+extern void
+gridRegularFFT_setNumChunks(gridRegularFFT_t fft, int numChunks);
+
+extern int
+gridRegularFFT_getNumChunks(const gridRegularFFT_t fft);
+
+extern gridRegularFFT_effort_t
+gridRegularFFT_getEffortFromName(const char *name);
+
+extern const char *
+gridRegularFFT_getNameFromEffort(gridRegularFFT_effort_t effort);
+
+extern bool
+gridRegularFFT_importWisdom(const char *fileName);
+
+extern bool
+gridRegularFFT_exportWisdom(const char *fileName);
+
 #endif
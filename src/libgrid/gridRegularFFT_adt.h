@@ -8,28 +8,67 @@
 
 /*--- Includes ----------------------------------------------------------*/
 #include "gridConfig.h"
+#include <stdbool.h>
+#ifdef WITH_FFT_FFTW3
+#  include <complex.h>
+#  include <fftw3.h>
+#endif
+
+
+/*--- Exported defines --------------------------------------------------*/
+#define GRIDREGULARFFT_NUM_PLANS (2 * NDIM)
 
 
 /*--- ADT implementation ------------------------------------------------*/
 struct gridRegularFFT_struct {
-	gridRegular_t        grid;
-	gridRegularDistrib_t distrib;
-	int                  idxFFTVar;
-	dataVar_t            var;
-	gridPatch_t          patch;
-	gridPointInt_t       nProcs;
-	gridRegular_t        gridFFTed;
-	gridRegularDistrib_t distribFFTed;
-	int                  idxFFTVarFFTed;
-	dataVar_t            varFFTed;
-	gridPatch_t          patchFFTed;
-	double               norm;
+	gridRegular_t           grid;
+	gridRegularDistrib_t    distrib;
+	int                     idxFFTVar;
+	dataVar_t               var;
+	gridPatch_t             patch;
+	gridPointInt_t          nProcs;
+	gridRegular_t           gridFFTed;
+	gridRegularDistrib_t    distribFFTed;
+	int                     idxFFTVarFFTed;
+	dataVar_t               varFFTed;
+	gridPatch_t             patchFFTed;
+	double                  norm;
+	bool                    isInKSpace;
+	void                    *kSpaceStore;
+	char                    *kSpaceStoreFileName;
+	uint64_t                kSpaceStoreNumBytes;
+	gridPointUint32_t       kSpaceStoreIdxLo;
+	gridPointUint32_t       kSpaceStoreIdxHi;
+	gridRegularFFT_effort_t effort;
+	int                     numThreads;
+	int                     numChunks;
+#ifdef WITH_FFT_FFTW3
+	fftw_plan               plan[GRIDREGULARFFT_NUM_PLANS];
+	fftwf_plan              planf[GRIDREGULARFFT_NUM_PLANS];
+	fftw_plan               planAnyAlign[GRIDREGULARFFT_NUM_PLANS];
+	fftwf_plan              planfAnyAlign[GRIDREGULARFFT_NUM_PLANS];
+	int                     planAlignIn[GRIDREGULARFFT_NUM_PLANS];
+	int                     planAlignOut[GRIDREGULARFFT_NUM_PLANS];
+#endif
 #if (defined WITH_MPI)
-	gridPointUint32_t    globalDims[NDIM];
-	gridPointUint32_t    localIdxLo[NDIM];
-	gridPointUint32_t    localIdxHi[NDIM];
-	gridPointInt_t       localDims[NDIM];
-	int                  localNumRealElements;
+	gridPointUint32_t       globalDims[NDIM];
+	gridPointUint32_t       localIdxLo[NDIM];
+	gridPointUint32_t       localIdxHi[NDIM];
+	gridPointInt_t          localDims[NDIM];
+	int                     localNumRealElements;
+#  ifdef WITH_FFT_FFTW3
+	int                     planHowmany[GRIDREGULARFFT_NUM_PLANS];
+	bool                    planUnaligned[GRIDREGULARFFT_NUM_PLANS];
+	// Uneven chunks come in two sizes, the plans for the other one.
+	fftw_plan               planOther[GRIDREGULARFFT_NUM_PLANS];
+	fftwf_plan              planfOther[GRIDREGULARFFT_NUM_PLANS];
+	fftw_plan               planAnyAlignOther[GRIDREGULARFFT_NUM_PLANS];
+	fftwf_plan              planfAnyAlignOther[GRIDREGULARFFT_NUM_PLANS];
+	int                     planAlignInOther[GRIDREGULARFFT_NUM_PLANS];
+	int                     planAlignOutOther[GRIDREGULARFFT_NUM_PLANS];
+	int                     planHowmanyOther[GRIDREGULARFFT_NUM_PLANS];
+	bool                    planUnalignedOther[GRIDREGULARFFT_NUM_PLANS];
+#  endif
 #endif
 };
 
@@ -35,7 +35,7 @@
 
 /*--- Prototypes of local functions -------------------------------------*/
 static gridRegular_t
-local_getFakeGrid(void);
+local_getFakeGrid(bool isPadded);
 
 static gridRegularDistrib_t
 local_getFakeGridDistrib(gridRegular_t grid);
@@ -46,6 +46,11 @@ local_fillFakeGrid(gridRegular_t grid);
 static bool
 local_testFFTResult(gridRegular_t grid, fpv_t *dataCpy);
 
+static bool
+local_testRestoredKSpace(gridRegularFFT_t fft,
+                         gridRegular_t    grid,
+                         const char       *fileName);
+
 
 /*--- Implementations of exported functios ------------------------------*/
 extern bool
@@ -66,7 +71,7 @@ gridRegularFFT_new_test(void)
 	if (rank == 0)
 		printf("Testing %s... ", __func__);
 
-	grid    = local_getFakeGrid();
+	grid    = local_getFakeGrid(true);
 	distrib = local_getFakeGridDistrib(grid);
 	fft     = gridRegularFFT_new(grid, distrib, 0);
 	if (dataVar_getType(fft->var) != DATAVARTYPE_FPV)
@@ -100,7 +105,7 @@ gridRegularFFT_del_test(void)
 	if (rank == 0)
 		printf("Testing %s... ", __func__);
 
-	grid    = local_getFakeGrid();
+	grid    = local_getFakeGrid(true);
 	distrib = local_getFakeGridDistrib(grid);
 	fft     = gridRegularFFT_new(grid, distrib, 0);
 	gridRegular_del(&grid);
@@ -135,7 +140,7 @@ gridRegularFFT_getNorm_test(void)
 	if (rank == 0)
 		printf("Testing %s... ", __func__);
 
-	grid    = local_getFakeGrid();
+	grid    = local_getFakeGrid(true);
 	distrib = local_getFakeGridDistrib(grid);
 	fft     = gridRegularFFT_new(grid, distrib, 0);
 	norm = gridRegularFFT_getNorm(fft);
@@ -181,7 +186,7 @@ gridRegularFFT_execute_test(void)
 	if (rank == 0)
 		printf("Testing %s... ", __func__);
 
-	grid    = local_getFakeGrid();
+	grid    = local_getFakeGrid(false);
 	distrib = local_getFakeGridDistrib(grid);
 	local_fillFakeGrid(grid);
 	patch   = gridRegular_getPatchHandle(grid, 0);
@@ -241,9 +246,365 @@ gridRegularFFT_execute_test(void)
 	return hasPassed ? true : false;
 } /* gridRegularFFT_execute_test */
 
+extern bool
+gridRegularFFT_executeInPlace_test(void)
+{
+	bool                 hasPassed = true;
+	int                  rank      = 0;
+	gridRegularFFT_t     fft;
+	gridRegular_t        grid;
+	gridRegularDistrib_t distrib;
+	gridPatch_t          patch;
+	fpv_t                *dataCpy, *dataTmp;
+#ifdef XMEM_TRACK_MEM
+	size_t               allocatedBytes = global_allocated_bytes;
+#endif
+#ifdef WITH_MPI
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+#endif
+
+	if (rank == 0)
+		printf("Testing %s... ", __func__);
+
+	grid    = local_getFakeGrid(true);
+	distrib = local_getFakeGridDistrib(grid);
+	local_fillFakeGrid(grid);
+	patch   = gridRegular_getPatchHandle(grid, 0);
+	dataTmp = gridPatch_getVarDataHandle(patch, 0);
+	dataCpy = xmalloc(sizeof(fpv_t)
+	                  * gridPatch_getNumCellsActual(patch, 0));
+	memcpy(dataCpy, dataTmp,
+	       sizeof(fpv_t) * gridPatch_getNumCellsActual(patch, 0));
+
+	fft = gridRegularFFT_new(grid, distrib, 0);
+	gridRegularFFT_execute(fft, GRIDREGULARFFT_FORWARD);
+#if (defined WITH_FFT_FFTW3 && !defined WITH_MPI)
+	// The complex field must live in the buffer of the real field.
+	if (gridPatch_getVarDataHandle(fft->patchFFTed, fft->idxFFTVarFFTed)
+	    != dataTmp)
+		hasPassed = false;
+#endif
+	gridRegularFFT_execute(fft, GRIDREGULARFFT_BACKWARD);
+	if (!local_testFFTResult(grid, dataCpy))
+		hasPassed = false;
+
+	gridRegular_del(&grid);
+	gridRegularDistrib_del(&distrib);
+	gridRegularFFT_del(&fft);
+	xfree(dataCpy);
+#ifdef WITH_FFT_FFTW3
+	fftw_cleanup();
+	fftwf_cleanup();
+#endif
+#ifdef XMEM_TRACK_MEM
+	if (allocatedBytes != global_allocated_bytes)
+		hasPassed = false;
+#endif
+
+	return hasPassed ? true : false;
+} /* gridRegularFFT_executeInPlace_test */
+
+extern bool
+gridRegularFFT_storeKSpace_test(void)
+{
+	bool                 hasPassed = true;
+	int                  rank      = 0;
+	gridRegularFFT_t     fft;
+	gridRegular_t        grid;
+	gridRegularDistrib_t distrib;
+#ifdef XMEM_TRACK_MEM
+	size_t               allocatedBytes = global_allocated_bytes;
+#endif
+#ifdef WITH_MPI
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+#endif
+
+	if (rank == 0)
+		printf("Testing %s... ", __func__);
+
+	grid    = local_getFakeGrid(true);
+	distrib = local_getFakeGridDistrib(grid);
+	local_fillFakeGrid(grid);
+	fft     = gridRegularFFT_new(grid, distrib, 0);
+	gridRegularFFT_execute(fft, GRIDREGULARFFT_FORWARD);
+	if (!local_testRestoredKSpace(fft, grid, NULL))
+		hasPassed = false;
+	if (!local_testRestoredKSpace(fft, grid, "fftTest-kspace.dat"))
+		hasPassed = false;
+	gridRegularFFT_discardKSpace(fft);
+	if ((fft->kSpaceStore != NULL) || (fft->kSpaceStoreFileName != NULL))
+		hasPassed = false;
+
+	gridRegular_del(&grid);
+	gridRegularDistrib_del(&distrib);
+	gridRegularFFT_del(&fft);
+#ifdef WITH_FFT_FFTW3
+	fftw_cleanup();
+	fftwf_cleanup();
+#endif
+#ifdef XMEM_TRACK_MEM
+	if (allocatedBytes != global_allocated_bytes)
+		hasPassed = false;
+#endif
+
+	return hasPassed ? true : false;
+} /* gridRegularFFT_storeKSpace_test */
+
+extern bool
+gridRegularFFT_setPlannerEffort_test(void)
+{
+	bool                 hasPassed = true;
+	int                  rank      = 0;
+	gridRegularFFT_t     fft;
+	gridRegular_t        grid;
+	gridRegularDistrib_t distrib;
+	gridPatch_t          patch;
+	fpv_t                *dataCpy, *dataTmp;
+#ifdef XMEM_TRACK_MEM
+	size_t               allocatedBytes = global_allocated_bytes;
+#endif
+#ifdef WITH_MPI
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+#endif
+
+	if (rank == 0)
+		printf("Testing %s... ", __func__);
+
+	grid    = local_getFakeGrid(true);
+	distrib = local_getFakeGridDistrib(grid);
+	local_fillFakeGrid(grid);
+	patch   = gridRegular_getPatchHandle(grid, 0);
+	dataTmp = gridPatch_getVarDataHandle(patch, 0);
+	dataCpy = xmalloc(sizeof(fpv_t)
+	                  * gridPatch_getNumCellsActual(patch, 0));
+	memcpy(dataCpy, dataTmp,
+	       sizeof(fpv_t) * gridPatch_getNumCellsActual(patch, 0));
+
+	fft = gridRegularFFT_new(grid, distrib, 0);
+	gridRegularFFT_setPlannerEffort(fft, GRIDREGULARFFT_EFFORT_MEASURE);
+	if (fft->effort != GRIDREGULARFFT_EFFORT_MEASURE)
+		hasPassed = false;
+	gridRegularFFT_execute(fft, GRIDREGULARFFT_FORWARD);
+	gridRegularFFT_execute(fft, GRIDREGULARFFT_BACKWARD);
+	if (!local_testFFTResult(grid, dataCpy))
+		hasPassed = false;
+#ifdef WITH_FFT_FFTW3
+	// The plans must have been kept for the next transform.
+	if ((fft->plan[0] == NULL) && (fft->planf[0] == NULL))
+		hasPassed = false;
+	gridRegularFFT_setPlannerEffort(fft, GRIDREGULARFFT_EFFORT_PATIENT);
+	for (int i = 0; i < GRIDREGULARFFT_NUM_PLANS; i++) {
+		if ((fft->plan[i] != NULL) || (fft->planf[i] != NULL))
+			hasPassed = false;
+	}
+#endif
+
+	gridRegular_del(&grid);
+	gridRegularDistrib_del(&distrib);
+	gridRegularFFT_del(&fft);
+	xfree(dataCpy);
+#ifdef WITH_FFT_FFTW3
+	fftw_cleanup();
+	fftwf_cleanup();
+#endif
+#ifdef XMEM_TRACK_MEM
+	if (allocatedBytes != global_allocated_bytes)
+		hasPassed = false;
+#endif
+
+	return hasPassed ? true : false;
+} /* gridRegularFFT_setPlannerEffort_test */
+
+extern bool
+gridRegularFFT_getEffortFromName_test(void)
+{
+	bool hasPassed = true;
+	int  rank      = 0;
+#ifdef WITH_MPI
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+#endif
+
+	if (rank == 0)
+		printf("Testing %s... ", __func__);
+
+	if (gridRegularFFT_getEffortFromName("estimate")
+	    != GRIDREGULARFFT_EFFORT_ESTIMATE)
+		hasPassed = false;
+	if (gridRegularFFT_getEffortFromName("patient")
+	    != GRIDREGULARFFT_EFFORT_PATIENT)
+		hasPassed = false;
+	if (gridRegularFFT_getEffortFromName("measured")
+	    != GRIDREGULARFFT_EFFORT_UNKNOWN)
+		hasPassed = false;
+	if (strcmp(gridRegularFFT_getNameFromEffort(
+	               GRIDREGULARFFT_EFFORT_MEASURE), "measure") != 0)
+		hasPassed = false;
+
+	return hasPassed ? true : false;
+}
+
+extern bool
+gridRegularFFT_setNumThreads_test(void)
+{
+	bool                 hasPassed = true;
+	int                  rank      = 0;
+	gridRegularFFT_t     fft;
+	gridRegular_t        grid;
+	gridRegularDistrib_t distrib;
+	gridPatch_t          patch;
+	fpv_t                *dataCpy, *dataTmp;
+#ifdef XMEM_TRACK_MEM
+	size_t               allocatedBytes = global_allocated_bytes;
+#endif
+#ifdef WITH_MPI
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+#endif
+
+	if (rank == 0)
+		printf("Testing %s... ", __func__);
+
+	grid    = local_getFakeGrid(true);
+	distrib = local_getFakeGridDistrib(grid);
+	local_fillFakeGrid(grid);
+	patch   = gridRegular_getPatchHandle(grid, 0);
+	dataTmp = gridPatch_getVarDataHandle(patch, 0);
+	dataCpy = xmalloc(sizeof(fpv_t)
+	                  * gridPatch_getNumCellsActual(patch, 0));
+	memcpy(dataCpy, dataTmp,
+	       sizeof(fpv_t) * gridPatch_getNumCellsActual(patch, 0));
+
+	fft = gridRegularFFT_new(grid, distrib, 0);
+	gridRegularFFT_setNumThreads(fft, 2);
+#ifdef _OPENMP
+	if (gridRegularFFT_getNumThreads(fft) != 2)
+		hasPassed = false;
+#else
+	if (gridRegularFFT_getNumThreads(fft) != 1)
+		hasPassed = false;
+#endif
+	gridRegularFFT_execute(fft, GRIDREGULARFFT_FORWARD);
+	gridRegularFFT_execute(fft, GRIDREGULARFFT_BACKWARD);
+	if (!local_testFFTResult(grid, dataCpy))
+		hasPassed = false;
+
+	gridRegular_del(&grid);
+	gridRegularDistrib_del(&distrib);
+	gridRegularFFT_del(&fft);
+	xfree(dataCpy);
+#ifdef WITH_FFT_FFTW3
+	fftw_cleanup();
+	fftwf_cleanup();
+#endif
+#ifdef XMEM_TRACK_MEM
+	if (allocatedBytes != global_allocated_bytes)
+		hasPassed = false;
+#endif
+
+	return hasPassed ? true : false;
+} /* gridRegularFFT_setNumThreads_test */
+
+extern bool
+gridRegularFFT_setNumChunks_test(void)
+{
+	bool                 hasPassed = true;
+	int                  rank      = 0;
+	gridRegularFFT_t     fft;
+	gridRegular_t        grid;
+	gridRegularDistrib_t distrib;
+	gridPatch_t          patch;
+	fpv_t                *dataCpy, *dataTmp;
+#ifdef XMEM_TRACK_MEM
+	size_t               allocatedBytes = global_allocated_bytes;
+#endif
+#ifdef WITH_MPI
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+#endif
+
+	if (rank == 0)
+		printf("Testing %s... ", __func__);
+
+	grid    = local_getFakeGrid(true);
+	distrib = local_getFakeGridDistrib(grid);
+	local_fillFakeGrid(grid);
+	patch   = gridRegular_getPatchHandle(grid, 0);
+	dataTmp = gridPatch_getVarDataHandle(patch, 0);
+	dataCpy = xmalloc(sizeof(fpv_t)
+	                  * gridPatch_getNumCellsActual(patch, 0));
+	memcpy(dataCpy, dataTmp,
+	       sizeof(fpv_t) * gridPatch_getNumCellsActual(patch, 0));
+
+	fft = gridRegularFFT_new(grid, distrib, 0);
+	// Odd chunk counts give chunks at unaligned addresses.
+	for (int numChunks = 1; numChunks < 8; numChunks += 2) {
+		gridRegularFFT_setNumChunks(fft, numChunks);
+		if (gridRegularFFT_getNumChunks(fft) != numChunks)
+			hasPassed = false;
+		dataTmp = gridPatch_getVarDataHandle(patch, 0);
+		memcpy(dataTmp, dataCpy,
+		       sizeof(fpv_t) * gridPatch_getNumCellsActual(patch, 0));
+		gridRegularFFT_execute(fft, GRIDREGULARFFT_FORWARD);
+		gridRegularFFT_execute(fft, GRIDREGULARFFT_BACKWARD);
+		if (!local_testFFTResult(grid, dataCpy))
+			hasPassed = false;
+	}
+
+	gridRegular_del(&grid);
+	gridRegularDistrib_del(&distrib);
+	gridRegularFFT_del(&fft);
+	xfree(dataCpy);
+#ifdef WITH_FFT_FFTW3
+	fftw_cleanup();
+	fftwf_cleanup();
+#endif
+#ifdef XMEM_TRACK_MEM
+	if (allocatedBytes != global_allocated_bytes)
+		hasPassed = false;
+#endif
+
+	return hasPassed ? true : false;
+} /* gridRegularFFT_setNumChunks_test */
+
 /*--- Implementations of local functions --------------------------------*/
+static bool
+local_testRestoredKSpace(gridRegularFFT_t fft,
+                         gridRegular_t    grid,
+                         const char       *fileName)
+{
+	bool              hasPassed = true;
+	gridPatch_t       patch;
+	fpv_t             *data, *dataCpy;
+	uint64_t          numCells;
+	gridPointUint32_t dims, dimsActual;
+
+	gridRegularFFT_storeKSpace(fft, fileName);
+	gridRegularFFT_execute(fft, GRIDREGULARFFT_BACKWARD);
+	patch    = gridRegular_getPatchHandle(grid, 0);
+	numCells = gridPatch_getNumCellsActual(patch, 0);
+	gridPatch_getDims(patch, dims);
+	gridPatch_getDimsActual(patch, 0, dimsActual);
+	data     = gridPatch_getVarDataHandle(patch, 0);
+	dataCpy  = xmalloc(sizeof(fpv_t) * numCells);
+	memcpy(dataCpy, data, sizeof(fpv_t) * numCells);
+
+	gridRegularFFT_restoreKSpace(fft);
+	gridRegularFFT_execute(fft, GRIDREGULARFFT_BACKWARD);
+	patch = gridRegular_getPatchHandle(grid, 0);
+	data  = gridPatch_getVarDataHandle(patch, 0);
+	// Only the cells are compared, the padding is not defined.
+	for (uint64_t i = 0; i < numCells; i += dimsActual[0]) {
+		if (memcmp(data + i, dataCpy + i, sizeof(fpv_t) * dims[0]) != 0)
+			hasPassed = false;
+	}
+	xfree(dataCpy);
+
+	// Leave the FFT in k-space, as it was handed to us.
+	gridRegularFFT_restoreKSpace(fft);
+
+	return hasPassed;
+}
+
 static gridRegular_t
-local_getFakeGrid(void)
+local_getFakeGrid(bool isPadded)
 {
 	gridRegular_t     grid;
 	gridPointDbl_t    origin;
@@ -257,9 +618,8 @@ local_getFakeGrid(void)
 		dims[i]   = 32 + i;
 	}
 	var = dataVar_new("test", DATAVARTYPE_FPV, 1);
-#ifndef WITH_MPI
-	dataVar_setFFTWPadded(var);
-#endif
+	if (isPadded)
+		dataVar_setFFTWPadded(var);
 #ifdef WITH_FFT_FFTW3
 #  ifdef ENABLE_DOUBLE
 	dataVar_setMemFuncs(var, &fftw_malloc, &fftw_free);
@@ -345,6 +705,7 @@ static bool
 local_testFFTResult(gridRegular_t grid, fpv_t *dataCpy)
 {
 	gridPointUint32_t dims;
+	gridPointUint32_t dimsActual;
 	gridPointUint32_t dimsGlobal;
 	uint64_t          normFac = 1;
 	uint64_t          offset  = UINT64_C(0);
@@ -355,6 +716,7 @@ local_testFFTResult(gridRegular_t grid, fpv_t *dataCpy)
 	dataVarType_t     varType = dataVar_getType(var);
 
 	gridPatch_getDims(patch, dims);
+	gridPatch_getDimsActual(patch, 0, dimsActual);
 	gridRegular_getDims(grid, dimsGlobal);
 
 	for (int i = 0; i < NDIM; i++)
@@ -368,6 +730,7 @@ local_testFFTResult(gridRegular_t grid, fpv_t *dataCpy)
 				sumSqr += tmp * tmp;
 				offset++;
 			}
+			offset += dimsActual[0] - dims[0];
 		}
 	}
 #elif (NDIM == 2)
@@ -377,6 +740,7 @@ local_testFFTResult(gridRegular_t grid, fpv_t *dataCpy)
 			sumSqr += tmp * tmp;
 			offset++;
 		}
+		offset += dimsActual[0] - dims[0];
 	}
 #endif
 
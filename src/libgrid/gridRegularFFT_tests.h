@@ -24,5 +24,23 @@ gridRegularFFT_getNorm_test(void);
 extern bool
 gridRegularFFT_execute_test(void);
 
+extern bool
+gridRegularFFT_executeInPlace_test(void);
+
+extern bool
+gridRegularFFT_storeKSpace_test(void);
+
+extern bool
+gridRegularFFT_setPlannerEffort_test(void);
+
+extern bool
+gridRegularFFT_getEffortFromName_test(void);
+
+extern bool
+gridRegularFFT_setNumThreads_test(void);
+
+extern bool
+gridRegularFFT_setNumChunks_test(void);
+
 
 #endif
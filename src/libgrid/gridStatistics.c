@@ -20,15 +20,21 @@
 #include <stdbool.h>
 #include <stdint.h>
 #include <math.h>
+#include <string.h>
 #ifdef WITH_MPI
 #  include <mpi.h>
 #endif
+#ifdef WITH_OPENMP
+#  include <omp.h>
+#endif
 #include "../libdata/dataVar.h"
 #include "../libdata/dataVarType.h"
 #include "gridPatch.h"
 #include "gridRegular.h"
 #include "gridRegularDistrib.h"
+#include "gridHistogram.h"
 #include "../libutil/xmem.h"
+#include "../libutil/varArr.h"
 #include "../libutil/utilMath.h"
 #include "../libutil/diediedie.h"
 
@@ -37,8 +43,38 @@
 #include "gridStatistics_adt.h"
 
 
+/*--- Local structures --------------------------------------------------*/
+
+/** @brief  Holds the central moments of a set of values. */
+typedef struct localMoments_struct {
+	/** @brief  The number of values. */
+	double num;
+	/** @brief  The mean of the values. */
+	double mean;
+	/** @brief  The sum of the squared deviations from the mean. */
+	double m2;
+	/** @brief  The sum of the cubed deviations from the mean. */
+	double m3;
+	/** @brief  The sum of the fourth power of the deviations. */
+	double m4;
+	/** @brief  The smallest value. */
+	double min;
+	/** @brief  The largest value. */
+	double max;
+} localMoments_struct_t;
+
+/** @brief  Handle for the moments. */
+typedef localMoments_struct_t *localMoments_t;
+
+
 /*--- Local defines -----------------------------------------------------*/
 
+/** @brief  The number of values that are processed as one block. */
+#define LOCAL_BLOCK_SIZE 1024
+
+/** @brief  The number of doubles needed to store the moments. */
+#define LOCAL_NUM_MOMENTS 7
+
 
 /*--- Prototypes of local functions -------------------------------------*/
 static void
@@ -52,54 +88,49 @@ local_calcRegularCore(gridStatistics_t           stat,
                       int                        idxOfVar);
 
 static void
-local_calcRegularMeanMinMax(gridStatistics_t           stat,
-                            const gridRegularDistrib_t distrib,
-                            const gridRegular_t        grid,
-                            const gridPatch_t          patch,
-                            int                        idxOfVar,
-                            int                        numPatches,
-                            uint64_t                   norm);
+local_calcPatch(gridStatistics_t  stat,
+                const gridPatch_t patch,
+                int               idxOfVar,
+                localMoments_t    moments,
+                uint64_t          *counts,
+                const uint64_t    *binOffsets);
+
+static void
+local_getBlock(const void    *data,
+               dataVar_t     var,
+               uint64_t      first,
+               uint32_t      num,
+               double        *values);
 
 static void
-local_calcRegularVarSkewKurt(gridStatistics_t           stat,
-                             const gridRegularDistrib_t distrib,
-                             const gridRegular_t        grid,
-                             const gridPatch_t          patch,
-                             int                        idxOfVar,
-                             int                        numPatches,
-                             uint64_t                   norm);
+local_nullMoments(localMoments_t moments);
 
 static void
-local_calcProtoMeanMinMax(void      *data,
-                          dataVar_t var,
-                          uint64_t  len,
-                          double    *protoMean,
-                          double    *min,
-                          double    *max);
+local_calcBlockMoments(const double   *values,
+                       uint32_t       num,
+                       localMoments_t moments);
 
+static void
+local_combineMoments(const localMoments_t a,
+                     const localMoments_t b,
+                     localMoments_t       out);
 
 static void
-local_calcProtoVarSkewKurt(void         *data,
-                           dataVar_t    var,
-                           uint64_t     len,
-                           double       *variance,
-                           double       *skew,
-                           double       *kurt,
-                           const double mean);
+local_setFromMoments(gridStatistics_t stat, const localMoments_t moments);
 
 
 #ifdef WITH_MPI
 static void
-local_mpiCalcProtoMeanMinMax(MPI_Comm comm,
-                             double   *mean,
-                             double   *min,
-                             double   *max);
+local_mpiReduce(MPI_Comm       comm,
+                localMoments_t moments,
+                uint64_t       *counts,
+                uint64_t       totalNumBins);
 
 static void
-local_mpiCalcProtoVarSkewKurt(MPI_Comm comm,
-                              double   *var,
-                              double   *skew,
-                              double   *kurt);
+local_mpiCombine(void         *in,
+                 void         *inout,
+                 int          *len,
+                 MPI_Datatype *datatype);
 
 #endif
 
@@ -110,8 +141,9 @@ gridStatistics_new(void)
 {
 	gridStatistics_t stat;
 
-	stat = xmalloc(sizeof(struct gridStatistics_struct));
+	stat         = xmalloc(sizeof(struct gridStatistics_struct));
 	local_nullStat(stat);
+	stat->histos = varArr_new(1);
 
 	return stat;
 }
@@ -121,11 +153,31 @@ gridStatistics_del(gridStatistics_t *stat)
 {
 	assert(stat != NULL && *stat != NULL);
 
+	gridStatistics_detachHistograms(*stat);
+	varArr_del(&((*stat)->histos));
 	xfree(*stat);
 
 	*stat = NULL;
 }
 
+extern void
+gridStatistics_attachHistogram(gridStatistics_t stat, gridHistogram_t histo)
+{
+	assert(stat != NULL);
+	assert(histo != NULL);
+
+	(void)varArr_insert(stat->histos, histo);
+}
+
+extern void
+gridStatistics_detachHistograms(gridStatistics_t stat)
+{
+	assert(stat != NULL);
+
+	while (varArr_getLength(stat->histos) != 0)
+		(void)varArr_remove(stat->histos, 0);
+}
+
 extern void
 gridStatistics_calcGridPatch(gridStatistics_t  stat,
                              const gridPatch_t patch,
@@ -293,230 +345,325 @@ local_calcRegularCore(gridStatistics_t           stat,
                       const gridPatch_t          patch,
                       int                        idxOfVar)
 {
-	uint64_t norm       = 2;
-	int      numPatches = 1;
-
-	if (grid != NULL) {
+	int                   numPatches = 1;
+	int                   numThreads = 1;
+	int                   numHistos  = varArr_getLength(stat->histos);
+	uint64_t              *binOffsets, totalNumBins = 0;
+	uint64_t              *counts;
+	localMoments_struct_t *moments;
+
+	if (grid != NULL)
 		numPatches = gridRegular_getNumPatches(grid);
-		norm       = gridRegular_getNumCellsTotal(grid);
-	} else if (patch != NULL) {
-		norm = gridPatch_getNumCells(patch);
+#ifdef WITH_OPENMP
+	numThreads = omp_get_max_threads();
+#endif
+
+	// All histograms share one array of counts, one copy per thread.
+	binOffsets = xmalloc(sizeof(uint64_t) * (numHistos + 1));
+	for (int h = 0; h < numHistos; h++) {
+		gridHistogram_t histo = varArr_getElementHandle(stat->histos, h);
+		binOffsets[h] = totalNumBins;
+		totalNumBins += gridHistogram_getNumBins(histo);
 	}
+	binOffsets[numHistos] = totalNumBins;
+	counts                = xmalloc(sizeof(uint64_t)
+	                                * (totalNumBins * numThreads + 1));
+	for (uint64_t i = 0; i < totalNumBins * numThreads; i++)
+		counts[i] = UINT64_C(0);
+	moments = xmalloc(sizeof(localMoments_struct_t) * numThreads);
+	for (int t = 0; t < numThreads; t++)
+		local_nullMoments(moments + t);
 
-	local_calcRegularMeanMinMax(stat, distrib, grid, patch,
-	                            idxOfVar, numPatches, norm);
-	local_calcRegularVarSkewKurt(stat, distrib, grid, patch,
-	                             idxOfVar, numPatches, norm);
-}
+	for (int i = 0; i < numPatches; i++) {
+		gridPatch_t myPatch;
 
-static void
-local_calcRegularMeanMinMax(gridStatistics_t           stat,
-                            const gridRegularDistrib_t distrib,
-                            const gridRegular_t        grid,
-                            const gridPatch_t          patch,
-                            int                        idxOfVar,
-                            int                        numPatches,
-                            uint64_t                   norm)
-{
-	gridPatch_t myPatch;
-	dataVar_t   dataVar;
-	void        *data;
-	uint64_t    len;
-	double      min, max;
+		myPatch = (grid != NULL) ? gridRegular_getPatchHandle(grid, i) : patch;
+		local_calcPatch(stat, myPatch, idxOfVar, moments, counts,
+		                binOffsets);
+	}
 
-	for (int i = 0; i < numPatches; i++) {
-		min = 1e50;
-		max = -1e50;
-
-		if (grid != NULL)
-			myPatch = gridRegular_getPatchHandle(grid, i);
-		else
-			myPatch = patch;
-
-		dataVar = gridPatch_getVarHandle(myPatch, idxOfVar);
-		data    = gridPatch_getVarDataHandle(myPatch, idxOfVar);
-		len     = gridPatch_getNumCells(myPatch);
-
-		local_calcProtoMeanMinMax(data, dataVar, len, &(stat->mean),
-		                          &min, &max);
-		stat->min = (stat->min > min) ? min : stat->min;
-		stat->max = (stat->max < max) ? max : stat->max;
+	// Fold the threads in order to keep the result reproducible.
+	for (int t = 1; t < numThreads; t++) {
+		local_combineMoments(moments, moments + t, moments);
+		for (uint64_t i = 0; i < totalNumBins; i++)
+			counts[i] += counts[t * totalNumBins + i];
 	}
 
 	if (distrib != NULL) {
 #ifdef WITH_MPI
 		MPI_Comm thisComm = gridRegularDistrib_getGlobalComm(distrib);
-		local_mpiCalcProtoMeanMinMax(thisComm, &(stat->mean),
-		                             &(stat->min), &(stat->max));
+		local_mpiReduce(thisComm, moments, counts, totalNumBins);
 #endif
 	}
 
-	stat->mean /= norm;
-} /* local_calcRegularMeanMinMax */
+	local_setFromMoments(stat, moments);
+	for (int h = 0; h < numHistos; h++) {
+		gridHistogram_t histo = varArr_getElementHandle(stat->histos, h);
+		gridHistogram_setCounts(histo, counts + binOffsets[h]);
+	}
+
+	xfree(moments);
+	xfree(counts);
+	xfree(binOffsets);
+} /* local_calcRegularCore */
 
 static void
-local_calcRegularVarSkewKurt(gridStatistics_t           stat,
-                             const gridRegularDistrib_t distrib,
-                             const gridRegular_t        grid,
-                             const gridPatch_t          patch,
-                             int                        idxOfVar,
-                             int                        numPatches,
-                             uint64_t                   norm)
+local_calcPatch(gridStatistics_t  stat,
+                const gridPatch_t patch,
+                int               idxOfVar,
+                localMoments_t    moments,
+                uint64_t          *counts,
+                const uint64_t    *binOffsets)
 {
-	gridPatch_t myPatch;
-	dataVar_t   dataVar;
-	void        *data;
-	uint64_t    len;
+	dataVar_t      dataVar      = gridPatch_getVarHandle(patch, idxOfVar);
+	const void     *data        = gridPatch_getVarDataHandle(patch,
+	                                                         idxOfVar);
+	const uint64_t len          = gridPatch_getNumCells(patch);
+	const uint32_t dim0         = gridPatch_getOneDim(patch, 0);
+	const uint32_t dimActual0   = gridPatch_getDimActual1D(patch, idxOfVar,
+	                                                       0);
+	const uint64_t numBlocks    = (len + LOCAL_BLOCK_SIZE - 1)
+	                              / LOCAL_BLOCK_SIZE;
+	const int      numHistos    = varArr_getLength(stat->histos);
+	const uint64_t totalNumBins = binOffsets[numHistos];
+
+#ifdef WITH_OPENMP
+#  pragma omp parallel for shared(stat, dataVar, data, moments, counts, \
+	binOffsets) schedule(static)
+#endif
+	for (uint64_t b = 0; b < numBlocks; b++) {
+		double                values[LOCAL_BLOCK_SIZE];
+		localMoments_struct_t blockMoments;
+		uint64_t              first = b * LOCAL_BLOCK_SIZE;
+		uint32_t              num   = LOCAL_BLOCK_SIZE;
+		uint64_t              row;
+		uint32_t              col, numDone = 0;
+		int                   t     = 0;
+#ifdef WITH_OPENMP
+		t = omp_get_thread_num();
+#endif
 
-	for (int i = 0; i < numPatches; i++) {
-		if (grid != NULL)
-			myPatch = gridRegular_getPatchHandle(grid, i);
-		else
-			myPatch = patch;
-
-		dataVar = gridPatch_getVarHandle(myPatch, idxOfVar);
-		data    = gridPatch_getVarDataHandle(myPatch, idxOfVar);
-		len     = gridPatch_getNumCells(myPatch);
-
-		local_calcProtoVarSkewKurt(data, dataVar, len, &(stat->var),
-		                           &(stat->skew), &(stat->kurt),
-		                           stat->mean);
+		if (first + num > len)
+			num = (uint32_t)(len - first);
+
+		// The blocks count the cells without the FFTW padding, the rows
+		// of the data are dimActual0 apart.
+		row = first / dim0;
+		col = (uint32_t)(first % dim0);
+		while (numDone < num) {
+			uint32_t numInRow = dim0 - col;
+			if (numInRow > num - numDone)
+				numInRow = num - numDone;
+			local_getBlock(data, dataVar, row * dimActual0 + col, numInRow,
+			               values + numDone);
+			numDone += numInRow;
+			row++;
+			col = 0;
+		}
+		local_calcBlockMoments(values, num, &blockMoments);
+		local_combineMoments(moments + t, &blockMoments, moments + t);
+
+		for (int h = 0; h < numHistos; h++) {
+			gridHistogram_t histo = varArr_getElementHandle(stat->histos, h);
+			uint64_t        *c    = counts + t * totalNumBins
+			                        + binOffsets[h];
+			for (uint32_t i = 0; i < num; i++)
+				c[gridHistogram_calcBin(histo, values[i])]++;
+		}
 	}
+} /* local_calcPatch */
 
-	if (distrib != NULL) {
-#ifdef WITH_MPI
-		MPI_Comm thisComm = gridRegularDistrib_getGlobalComm(distrib);
-		local_mpiCalcProtoVarSkewKurt(thisComm, &(stat->var),
-		                              &(stat->skew), &(stat->kurt));
-#endif
+static void
+local_getBlock(const void    *data,
+               dataVar_t     var,
+               uint64_t      first,
+               uint32_t      num,
+               double        *values)
+{
+	const size_t size = dataVar_getSizePerElement(var);
+	const char   *ptr = (const char *)data + first * size;
+
+	switch (dataVar_getType(var)) {
+	case DATAVARTYPE_INT8:
+		for (uint32_t i = 0; i < num; i++)
+			values[i] = (double)*((const int8_t *)(ptr + i * size));
+		break;
+	case DATAVARTYPE_INT:
+		for (uint32_t i = 0; i < num; i++)
+			values[i] = (double)*((const int *)(ptr + i * size));
+		break;
+	case DATAVARTYPE_INT32:
+		for (uint32_t i = 0; i < num; i++)
+			values[i] = (double)*((const int32_t *)(ptr + i * size));
+		break;
+	case DATAVARTYPE_INT64:
+		for (uint32_t i = 0; i < num; i++)
+			values[i] = (double)*((const int64_t *)(ptr + i * size));
+		break;
+	case DATAVARTYPE_DOUBLE:
+		for (uint32_t i = 0; i < num; i++)
+			values[i] = *((const double *)(ptr + i * size));
+		break;
+	case DATAVARTYPE_FLOAT:
+		for (uint32_t i = 0; i < num; i++)
+			values[i] = (double)*((const float *)(ptr + i * size));
+		break;
+	case DATAVARTYPE_FPV:
+		for (uint32_t i = 0; i < num; i++)
+			values[i] = (double)*((const fpv_t *)(ptr + i * size));
+		break;
+	default:
+		diediedie(999);
 	}
+} /* local_getBlock */
 
-	stat->var  /= (norm - 1);
-	stat->skew /= (norm * stat->var * sqrt(stat->var));
-	stat->kurt  = stat->kurt / (norm * POW2(stat->var)) - 3;
+static void
+local_nullMoments(localMoments_t moments)
+{
+	moments->num  = 0.0;
+	moments->mean = 0.0;
+	moments->m2   = 0.0;
+	moments->m3   = 0.0;
+	moments->m4   = 0.0;
+	moments->min  = 1e50;
+	moments->max  = -1e50;
 }
 
 static void
-local_calcProtoMeanMinMax(void      *data,
-                          dataVar_t var,
-                          uint64_t  len,
-                          double    *protoMean,
-                          double    *min,
-                          double    *max)
+local_calcBlockMoments(const double   *values,
+                       uint32_t       num,
+                       localMoments_t moments)
 {
-	union { double *lf;
-		    int    *i;
-		    int8_t *i8;
-		    fpv_t  *fpv;
-		    void   *v;
-	}             tmp;
-	dataVarType_t type = dataVar_getType(var);
-
-	for (uint64_t i = 0; i < len; i++) {
-		tmp.v = dataVar_getPointerByOffset(var, data, i);
-		switch (type) {
-		case DATAVARTYPE_INT:
-			*min        = (*(tmp.i) < *min) ? (double)*(tmp.i) : *min;
-			*max        = (*(tmp.i) > *max) ? (double)*(tmp.i) : *max;
-			*protoMean += (double)*(tmp.i);
-			break;
-		case DATAVARTYPE_INT8:
-			*min        = (*(tmp.i8) < *min) ? (double)*(tmp.i8) : *min;
-			*max        = (*(tmp.i8) > *max) ? (double)*(tmp.i8) : *max;
-			*protoMean += (double)*(tmp.i);
-			break;
-		case DATAVARTYPE_DOUBLE:
-			*min        = (*(tmp.lf) < *min) ? *(tmp.lf) : *min;
-			*max        = (*(tmp.lf) > *max) ? *(tmp.lf) : *max;
-			*protoMean += *(tmp.lf);
-			break;
-		case DATAVARTYPE_FPV:
-			*min        = (*(tmp.fpv) < *min) ? (double)*(tmp.fpv) : *min;
-			*max        = (*(tmp.fpv) > *max) ? (double)*(tmp.fpv) : *max;
-			*protoMean += (double)*(tmp.fpv);
-			break;
-		default:
-			diediedie(999);
-		}
+	double sum = 0.0;
+
+	local_nullMoments(moments);
+
+	// The block is small enough to stay in cache for the second pass.
+	for (uint32_t i = 0; i < num; i++) {
+		sum         += values[i];
+		moments->min = (values[i] < moments->min) ? values[i] : moments->min;
+		moments->max = (values[i] > moments->max) ? values[i] : moments->max;
+	}
+	moments->num  = (double)num;
+	moments->mean = sum / num;
+
+	for (uint32_t i = 0; i < num; i++) {
+		double tmpNo  = values[i] - moments->mean;
+		double tmpSqr = POW2(tmpNo);
+		moments->m2 += tmpSqr;
+		moments->m3 += tmpSqr * tmpNo;
+		moments->m4 += POW2(tmpSqr);
 	}
 }
 
 static void
-local_calcProtoVarSkewKurt(void         *data,
-                           dataVar_t    var,
-                           uint64_t     len,
-                           double       *variance,
-                           double       *skew,
-                           double       *kurt,
-                           const double mean)
+local_combineMoments(const localMoments_t a,
+                     const localMoments_t b,
+                     localMoments_t       out)
 {
-	union { double *lf;
-		    int    *i;
-		    int    *i8;
-		    fpv_t  *fpv;
-		    void   *v;
-	}             tmp;
-	double        tmpNo, tmpSqr;
-	dataVarType_t type = dataVar_getType(var);
-
-	for (uint64_t i = 0; i < len; i++) {
-		tmp.v = dataVar_getPointerByOffset(var, data, i);
-		switch (type) {
-		case DATAVARTYPE_INT:
-			tmpNo = (double)*(tmp.i) - mean;
-			break;
-		case DATAVARTYPE_INT8:
-			tmpNo = (double)*(tmp.i8) - mean;
-			break;
-		case DATAVARTYPE_DOUBLE:
-			tmpNo = *(tmp.lf) - mean;
-			break;
-		case DATAVARTYPE_FPV:
-			tmpNo = (double)*(tmp.fpv) - mean;
-			break;
-		default:
-			diediedie(999);
-		}
-		tmpSqr     = POW2(tmpNo);
-		*variance += tmpSqr;
-		*skew     += tmpSqr * tmpNo;
-		*kurt     += POW2(tmpSqr);
+	localMoments_struct_t res;
+	double                nA = a->num, nB = b->num, n, delta, delta2;
+
+	// Pebay (2008), Sandia Report SAND2008-6212, eqs. 2.1 and 3.1.
+	if (nA == 0.0) {
+		*out = *b;
+		return;
+	}
+	if (nB == 0.0) {
+		*out = *a;
+		return;
 	}
+
+	n        = nA + nB;
+	delta    = b->mean - a->mean;
+	delta2   = POW2(delta);
+
+	res.num  = n;
+	res.mean = a->mean + delta * nB / n;
+	res.m2   = a->m2 + b->m2 + delta2 * nA * nB / n;
+	res.m3   = a->m3 + b->m3
+	           + delta2 * delta * nA * nB * (nA - nB) / POW2(n)
+	           + 3. * delta * (nA * b->m2 - nB * a->m2) / n;
+	res.m4   = a->m4 + b->m4
+	           + POW2(delta2) * nA * nB * (POW2(nA) - nA * nB + POW2(nB))
+	           / (POW2(n) * n)
+	           + 6. * delta2 * (POW2(nA) * b->m2 + POW2(nB) * a->m2)
+	           / POW2(n)
+	           + 4. * delta * (nA * b->m3 - nB * a->m3) / n;
+	res.min  = (a->min < b->min) ? a->min : b->min;
+	res.max  = (a->max > b->max) ? a->max : b->max;
+
+	*out     = res;
 }
 
-#ifdef WITH_MPI
 static void
-local_mpiCalcProtoMeanMinMax(MPI_Comm comm,
-                             double   *mean,
-                             double   *min,
-                             double   *max)
+local_setFromMoments(gridStatistics_t stat, const localMoments_t moments)
 {
-	double myMean = *mean;
-	double myMin  = *min;
-	double myMax  = *max;
-
-	MPI_Allreduce(&myMean, mean, 1, MPI_DOUBLE, MPI_SUM, comm);
-	MPI_Allreduce(&myMin, min, 1, MPI_DOUBLE, MPI_MIN, comm);
-	MPI_Allreduce(&myMax, max, 1, MPI_DOUBLE, MPI_MAX, comm);
+	double norm = moments->num;
+
+	stat->mean = moments->mean;
+	stat->var  = moments->m2 / (norm - 1);
+	stat->skew = moments->m3 / (norm * stat->var * sqrt(stat->var));
+	stat->kurt = moments->m4 / (norm * POW2(stat->var)) - 3;
+	stat->min  = moments->min;
+	stat->max  = moments->max;
 }
 
+#ifdef WITH_MPI
 static void
-local_mpiCalcProtoVarSkewKurt(MPI_Comm comm,
-                              double   *var,
-                              double   *skew,
-                              double   *kurt)
+local_mpiReduce(MPI_Comm       comm,
+                localMoments_t moments,
+                uint64_t       *counts,
+                uint64_t       totalNumBins)
 {
-	double tmpIn[3], tmpOut[3];
-
-	tmpIn[0] = *var;
-	tmpIn[1] = *skew;
-	tmpIn[2] = *kurt;
-
-	MPI_Allreduce(tmpIn, tmpOut, 3, MPI_DOUBLE, MPI_SUM, comm);
+	int          len = (int)(LOCAL_NUM_MOMENTS + totalNumBins);
+	double       *bufSend, *bufRecv;
+	MPI_Datatype type;
+	MPI_Op       op;
+
+	bufSend = xmalloc(sizeof(double) * len);
+	bufRecv = xmalloc(sizeof(double) * len);
+	memcpy(bufSend, moments, sizeof(double) * LOCAL_NUM_MOMENTS);
+	for (uint64_t i = 0; i < totalNumBins; i++)
+		bufSend[LOCAL_NUM_MOMENTS + i] = (double)counts[i];
+
+	// The whole buffer is one element, so that MPI cannot split it.
+	// The combination is not commutative (in floating point), declaring
+	// it as such makes MPI combine in rank order.
+	MPI_Type_contiguous(len, MPI_DOUBLE, &type);
+	MPI_Type_commit(&type);
+	MPI_Op_create(&local_mpiCombine, 0, &op);
+	MPI_Allreduce(bufSend, bufRecv, 1, type, op, comm);
+	MPI_Op_free(&op);
+	MPI_Type_free(&type);
+
+	memcpy(moments, bufRecv, sizeof(double) * LOCAL_NUM_MOMENTS);
+	for (uint64_t i = 0; i < totalNumBins; i++)
+		counts[i] = (uint64_t)bufRecv[LOCAL_NUM_MOMENTS + i];
+
+	xfree(bufRecv);
+	xfree(bufSend);
+} /* local_mpiReduce */
 
-	*var  = tmpOut[0];
-	*skew = tmpOut[1];
-	*kurt = tmpOut[2];
+static void
+local_mpiCombine(void         *in,
+                 void         *inout,
+                 int          *len,
+                 MPI_Datatype *datatype)
+{
+	int size;
+
+	MPI_Type_size(*datatype, &size);
+	size /= sizeof(double);
+
+	for (int i = 0; i < *len; i++) {
+		double *a = ((double *)in) + i * size;
+		double *b = ((double *)inout) + i * size;
+		local_combineMoments((localMoments_t)a, (localMoments_t)b,
+		                     (localMoments_t)b);
+		for (int j = LOCAL_NUM_MOMENTS; j < size; j++)
+			b[j] += a[j];
+	}
 }
 
 #endif
@@ -20,6 +20,7 @@
 #include "gridPatch.h"
 #include "gridRegular.h"
 #include "gridRegularDistrib.h"
+#include "gridHistogram.h"
 #include <stdio.h>
 #include <stdint.h>
 #include <stdbool.h>
@@ -38,6 +39,12 @@ gridStatistics_new(void);
 extern void
 gridStatistics_del(gridStatistics_t *stat);
 
+extern void
+gridStatistics_attachHistogram(gridStatistics_t stat, gridHistogram_t histo);
+
+extern void
+gridStatistics_detachHistograms(gridStatistics_t stat);
+
 extern void
 gridStatistics_calcGridPatch(gridStatistics_t  stat,
                              const gridPatch_t patch,
@@ -18,6 +18,7 @@
 /*--- Includes ----------------------------------------------------------*/
 #include "gridConfig.h"
 #include <stdbool.h>
+#include "../libutil/varArr.h"
 
 
 /*--- ADT implementation ------------------------------------------------*/
@@ -25,19 +26,21 @@
 /** @brief  The main structure for the grid statistics. */
 struct gridStatistics_struct {
 	/** @brief  Flags if the statistics is valid or not. */
-	bool   valid;
+	bool     valid;
 	/** @brief  The mean of the data. */
-	double mean;
+	double   mean;
 	/** @brief  The variance of the data. */
-	double var;
+	double   var;
 	/** @brief  The skewness of the data. */
-	double skew;
+	double   skew;
 	/** @brief  The kurtosis of the data. */
-	double kurt;
+	double   kurt;
 	/** @brief  The minimum value in the data. */
-	double min;
+	double   min;
 	/** @brief  The maximum value in the data. */
-	double max;
+	double   max;
+	/** @brief  The histograms that are filled alongside the statistics. */
+	varArr_t histos;
 };
 
 
@@ -50,6 +50,12 @@ local_getFakeGrid(void);
 static gridRegularDistrib_t
 local_getFakeDistrib(void);
 
+static gridPatch_t
+local_getPaddedPatch(void);
+
+static bool
+local_checkPaddedPatch(const gridPatch_t patch);
+
 
 /*--- Implementations of exported functios ------------------------------*/
 extern bool
@@ -106,6 +112,72 @@ gridStatistics_del_test(void)
 	return hasPassed ? true : false;
 }
 
+extern bool
+gridStatistics_attachHistogram_test(void)
+{
+	bool             hasPassed = true;
+	int              rank      = 0;
+	gridStatistics_t gridStatistics;
+	gridHistogram_t  histo[2], histoRef;
+	gridRegular_t    grid;
+#ifdef XMEM_TRACK_MEM
+	size_t           allocatedBytes = global_allocated_bytes;
+#endif
+#ifdef WITH_MPI
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+#endif
+
+	if (rank == 0)
+		printf("Testing %s... ", __func__);
+
+	gridStatistics = gridStatistics_new();
+	histo[0]       = gridHistogram_new(7, -3.0, 3.0);
+	histo[1]       = gridHistogram_new(40, -1.0, 5.0);
+	gridStatistics_attachHistogram(gridStatistics, histo[0]);
+	gridStatistics_attachHistogram(gridStatistics, histo[1]);
+
+	grid = local_getFakeGrid();
+	gridStatistics_calcGridRegular(gridStatistics, grid, 0);
+	if (fabs(gridStatistics->mean - LOCAL_FAKE_MEAN) > 0.05)
+		hasPassed = false;
+	if (fabs(gridStatistics->var - LOCAL_FAKE_VARIANCE) > 0.10)
+		hasPassed = false;
+
+	// The histograms must come out exactly as if computed on their own.
+	for (int h = 0; h < 2; h++) {
+		uint32_t numBins = gridHistogram_getNumBins(histo[h]);
+		histoRef = gridHistogram_new(numBins - 2,
+		                             gridHistogram_getBinLimitLeft(histo[h],
+		                                                           1),
+		                             gridHistogram_getBinLimitLeft(histo[h],
+		                                                           numBins
+		                                                           - 1));
+		gridHistogram_calcGridRegular(histoRef, grid, 0);
+		for (uint32_t i = 0; i < numBins; i++) {
+			if (gridHistogram_getCountInBin(histoRef, i)
+			    != gridHistogram_getCountInBin(histo[h], i))
+				hasPassed = false;
+		}
+		gridHistogram_del(&histoRef);
+	}
+
+	gridStatistics_detachHistograms(gridStatistics);
+	gridStatistics_calcGridRegular(gridStatistics, grid, 0);
+	if (gridHistogram_getCountInBin(histo[0], 4) == 0)
+		hasPassed = false;
+
+	gridStatistics_del(&gridStatistics);
+	gridHistogram_del(&histo[1]);
+	gridHistogram_del(&histo[0]);
+	gridRegular_del(&grid);
+#ifdef XMEM_TRACK_MEM
+	if (allocatedBytes != global_allocated_bytes)
+		hasPassed = false;
+#endif
+
+	return hasPassed ? true : false;
+} /* gridStatistics_attachHistogram_test */
+
 extern bool
 gridStatistics_calcGridPatch_test(void)
 {
@@ -226,6 +298,44 @@ gridStatistics_calcGridRegularDistrib_test(void)
 	return hasPassed ? true : false;
 } /* gridStatistics_calcGridRegular_test */
 
+extern bool
+gridStatistics_calcGridPatchPadded_test(void)
+{
+	bool             hasPassed = true;
+	int              rank      = 0;
+	gridStatistics_t gridStatistics;
+	gridPatch_t      patch;
+#ifdef XMEM_TRACK_MEM
+	size_t           allocatedBytes = global_allocated_bytes;
+#endif
+#ifdef WITH_MPI
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+#endif
+
+	if (rank == 0)
+		printf("Testing %s... ", __func__);
+
+	gridStatistics = gridStatistics_new();
+
+	patch          = local_getPaddedPatch();
+	gridStatistics_calcGridPatch(gridStatistics, patch, 0);
+	if (fabs(gridStatistics->mean - 1.5) > 1e-10)
+		hasPassed = false;
+	if ((gridStatistics->min != 0.0) || (gridStatistics->max != 3.0))
+		hasPassed = false;
+	if (!local_checkPaddedPatch(patch))
+		hasPassed = false;
+
+	gridStatistics_del(&gridStatistics);
+	gridPatch_del(&patch);
+#ifdef XMEM_TRACK_MEM
+	if (allocatedBytes != global_allocated_bytes)
+		hasPassed = false;
+#endif
+
+	return hasPassed ? true : false;
+} /* gridStatistics_calcGridPatchPadded_test */
+
 /*--- Implementations of local functions --------------------------------*/
 static gridPatch_t
 local_getFakePatch(void)
@@ -325,3 +435,52 @@ local_getFakeDistrib(void)
 
 	return distrib;
 } /* local_getFakeDistrib */
+
+static gridPatch_t
+local_getPaddedPatch(void)
+{
+	gridPatch_t       patch;
+	dataVar_t         var;
+	gridPointUint32_t idxLo = { 0, 0, 0 };
+	gridPointUint32_t idxHi = { 5, 3, 2 };
+	uint64_t          numCellsActual;
+	uint32_t          dim0, dim0Actual;
+	fpv_t             *data;
+
+	var   = dataVar_new("Padded", DATAVARTYPE_FPV, 1);
+	dataVar_setFFTWPadded(var);
+	patch = gridPatch_new(idxLo, idxHi);
+	gridPatch_attachVar(patch, var);
+
+	// The cells hold 0, 1, 2, 3, ..., the padding a value far off.
+	numCellsActual = gridPatch_getNumCellsActual(patch, 0);
+	dim0           = gridPatch_getOneDim(patch, 0);
+	dim0Actual     = gridPatch_getDimActual1D(patch, 0, 0);
+	data           = gridPatch_getVarDataHandle(patch, 0);
+	for (uint64_t i = 0; i < numCellsActual; i++) {
+		uint64_t row = i / dim0Actual;
+		uint32_t col = (uint32_t)(i % dim0Actual);
+		data[i] = (col < dim0) ? (fpv_t)((row * dim0 + col) % 4) : 1e3;
+	}
+
+	return patch;
+}
+
+static bool
+local_checkPaddedPatch(const gridPatch_t patch)
+{
+	uint64_t    numCellsActual = gridPatch_getNumCellsActual(patch, 0);
+	uint32_t    dim0           = gridPatch_getOneDim(patch, 0);
+	uint32_t    dim0Actual     = gridPatch_getDimActual1D(patch, 0, 0);
+	const fpv_t *data          = gridPatch_getVarDataHandle(patch, 0);
+
+	for (uint64_t i = 0; i < numCellsActual; i++) {
+		uint64_t row = i / dim0Actual;
+		uint32_t col = (uint32_t)(i % dim0Actual);
+		fpv_t    exp = (col < dim0) ? (fpv_t)((row * dim0 + col) % 4) : 1e3;
+		if (data[i] != exp)
+			return false;
+	}
+
+	return true;
+}
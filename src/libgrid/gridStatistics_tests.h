@@ -27,6 +27,9 @@ gridStatistics_new_test(void);
 extern bool
 gridStatistics_del_test(void);
 
+extern bool
+gridStatistics_attachHistogram_test(void);
+
 extern bool
 gridStatistics_calcGridPatch_test(void);
 
@@ -36,6 +39,9 @@ gridStatistics_calcGridRegular_test(void);
 extern bool
 gridStatistics_calcGridRegularDistrib_test(void);
 
+extern bool
+gridStatistics_calcGridPatchPadded_test(void);
+
 extern bool
 gridStatistics_invalidate_test(void);
 
@@ -173,8 +173,10 @@ gridWriterGrafic_writeGridPatch(gridWriter_t   writer,
 	numComponents = dataVar_getNumComponents(var);
 	format        = local_getGraficTypeFromGridType(var);
 
-	grafic_writeWindowed(w->grafic, data, format, numComponents,
-	                     idxLo, dims);
+	// The rows may be followed by FFTW padding, which is not written.
+	grafic_writeWindowedStrided(w->grafic, data, format, numComponents,
+	                            idxLo, dims,
+	                            gridPatch_getDimActual1D(patch, 0, 0));
 }
 
 extern void
@@ -0,0 +1,165 @@
+// Copyright (C) 2010, Steffen Knollmann
+// Released under the terms of the GNU General Public License version 3.
+// This file is part of `ginnungagap'.
+
+
+/*--- Doxygen file description ------------------------------------------*/
+
+/**
+ * @file libgrid/gridWriterGrafic_tests.c
+ * @ingroup  libgridIOOutGrafic
+ * @brief  Implements the tests for gridWriterGrafic.c.
+ */
+
+
+/*--- Includes ----------------------------------------------------------*/
+#include "gridConfig.h"
+#include "gridWriterGrafic_tests.h"
+#include "gridWriterGrafic.h"
+#include <stdio.h>
+#include <string.h>
+#ifdef WITH_MPI
+#  include <mpi.h>
+#endif
+#include "gridPatch.h"
+#include "../libdata/dataVar.h"
+#include "../libutil/grafic.h"
+#include "../libutil/filename.h"
+#include "../libutil/xmem.h"
+#include "../libutil/xstring.h"
+
+
+/*--- Implementation of main structure ----------------------------------*/
+#include "gridWriterGrafic_adt.h"
+
+
+/*--- Local defines -----------------------------------------------------*/
+
+
+/*--- Prototypes of local functions -------------------------------------*/
+static gridPatch_t
+local_getPaddedPatch(void);
+
+static bool
+local_checkPaddedPatch(const gridPatch_t patch);
+
+
+/*--- Implementations of exported functions -----------------------------*/
+extern bool
+gridWriterGrafic_writeGridPatchPadded_test(void)
+{
+	bool               hasPassed = true;
+	int                rank      = 0;
+	gridWriterGrafic_t writer;
+	gridPatch_t        patch;
+	gridPointDbl_t     origin = { 0., 0., 0. };
+	gridPointDbl_t     delta  = { 1., 1., 1. };
+	uint32_t           np[3]  = { 6, 4, 3 };
+	char               qualifier[32];
+	char               *fileName;
+	grafic_t           grafic;
+	float              *data;
+#ifdef XMEM_TRACK_MEM
+	size_t             allocatedBytes = global_allocated_bytes;
+#endif
+#ifdef WITH_MPI
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+#endif
+
+	if (rank == 0)
+		printf("Testing %s... ", __func__);
+
+	patch  = local_getPaddedPatch();
+
+	// Every process writes its own file.
+	sprintf(qualifier, "_%i", rank);
+	writer = gridWriterGrafic_new();
+	gridWriter_setFileName((gridWriter_t)writer,
+	                       filename_newFull(NULL, "outGraficPadded",
+	                                        qualifier, NULL));
+	grafic_setSize(gridWriterGrafic_getGrafic(writer), np);
+#ifdef WITH_MPI
+	gridWriterGrafic_initParallel((gridWriter_t)writer, MPI_COMM_SELF);
+#endif
+	gridWriter_activate((gridWriter_t)writer);
+	gridWriter_writeGridPatch((gridWriter_t)writer, patch, "padded",
+	                          origin, delta);
+	gridWriter_deactivate((gridWriter_t)writer);
+	fileName = xstrdup(filename_getFullName(writer->base.fileName));
+	gridWriter_del((gridWriter_t *)&writer);
+
+	if (!local_checkPaddedPatch(patch))
+		hasPassed = false;
+
+	// The file holds the cells without the padding.
+	grafic = grafic_newFromFile(fileName);
+	data   = xmalloc(sizeof(float) * np[0] * np[1] * np[2]);
+	grafic_read(grafic, data, GRAFIC_FORMAT_FLOAT, 1);
+	for (uint32_t i = 0; i < np[0] * np[1] * np[2]; i++) {
+		if (data[i] != (float)(i % 4))
+			hasPassed = false;
+	}
+	xfree(data);
+	grafic_del(&grafic);
+	remove(fileName);
+	xfree(fileName);
+
+	gridPatch_del(&patch);
+#ifdef XMEM_TRACK_MEM
+	if (allocatedBytes != global_allocated_bytes)
+		hasPassed = false;
+#endif
+
+	return hasPassed ? true : false;
+} /* gridWriterGrafic_writeGridPatchPadded_test */
+
+
+/*--- Implementations of local functions --------------------------------*/
+static gridPatch_t
+local_getPaddedPatch(void)
+{
+	gridPatch_t       patch;
+	dataVar_t         var;
+	gridPointUint32_t idxLo = { 0, 0, 0 };
+	gridPointUint32_t idxHi = { 5, 3, 2 };
+	uint64_t          numCellsActual;
+	uint32_t          dim0, dim0Actual;
+	fpv_t             *data;
+
+	var   = dataVar_new("Padded", DATAVARTYPE_FPV, 1);
+	dataVar_setFFTWPadded(var);
+	patch = gridPatch_new(idxLo, idxHi);
+	gridPatch_attachVar(patch, var);
+
+	// The cells hold 0, 1, 2, 3, ..., the padding a value far off.
+	numCellsActual = gridPatch_getNumCellsActual(patch, 0);
+	dim0           = gridPatch_getOneDim(patch, 0);
+	dim0Actual     = gridPatch_getDimActual1D(patch, 0, 0);
+	data           = gridPatch_getVarDataHandle(patch, 0);
+	for (uint64_t i = 0; i < numCellsActual; i++) {
+		uint64_t row = i / dim0Actual;
+		uint32_t col = (uint32_t)(i % dim0Actual);
+		data[i] = (col < dim0) ? (fpv_t)((row * dim0 + col) % 4) : 1e3;
+	}
+
+	return patch;
+}
+
+static bool
+local_checkPaddedPatch(const gridPatch_t patch)
+{
+	uint64_t    numCellsActual = gridPatch_getNumCellsActual(patch, 0);
+	uint32_t    dim0           = gridPatch_getOneDim(patch, 0);
+	uint32_t    dim0Actual     = gridPatch_getDimActual1D(patch, 0, 0);
+	const fpv_t *data          = gridPatch_getVarDataHandle(patch, 0);
+
+	for (uint64_t i = 0; i < numCellsActual; i++) {
+		uint64_t row = i / dim0Actual;
+		uint32_t col = (uint32_t)(i % dim0Actual);
+		fpv_t    exp = (col < dim0) ? (fpv_t)((row * dim0 + col) % 4) : 1e3;
+		if (data[i] != exp)
+			return false;
+	}
+
+	return true;
+}
@@ -0,0 +1,28 @@
+// Copyright (C) 2010, Steffen Knollmann
+// Released under the terms of the GNU General Public License version 3.
+// This file is part of `ginnungagap'.
+
+#ifndef GRIDWRITERGRAFIC_TESTS_H
+#define GRIDWRITERGRAFIC_TESTS_H
+
+
+/*--- Doxygen file description ------------------------------------------*/
+
+/**
+ * @file libgrid/gridWriterGrafic_tests.h
+ * @ingroup  libgridIOOutGrafic
+ * @brief  Provides the interface to the tests of the Grafic writer.
+ */
+
+
+/*--- Includes ----------------------------------------------------------*/
+#include "gridConfig.h"
+#include <stdbool.h>
+
+
+/*--- Prototypes of exported functions ----------------------------------*/
+extern bool
+gridWriterGrafic_writeGridPatchPadded_test(void);
+
+
+#endif
@@ -116,6 +116,8 @@ local_getDSCreationPropList(const gridWriterHDF5_t writer);
  *                The variable that should be written.
  * @param[in]  patch
  *                The patch that should be written.
+ * @param[in]  idxOfVar
+ *                The index of the variable in the patch.
  * @param[in]  dataSet
  *                The HDF5 dataset to work with.
  * @param[in]  dt
@@ -129,6 +131,7 @@ local_getDSCreationPropList(const gridWriterHDF5_t writer);
 inline static void
 local_writeVariableAtPatch(dataVar_t   var,
                            gridPatch_t patch,
+                           int         idxOfVar,
                            hid_t       dataSet,
                            hid_t       dt,
                            hid_t       gridSize);
@@ -223,7 +226,7 @@ gridWriterHDF5_writeGridPatch(gridWriter_t   writer,
 		                              dt, patchSize, H5P_DEFAULT,
 		                              dsCreationPropList,
 		                              H5P_DEFAULT);
-		local_writeVariableAtPatch(var, patch, dataSet, dt, patchSize);
+		local_writeVariableAtPatch(var, patch, i, dataSet, dt, patchSize);
 		H5Dclose(dataSet);
 	}
 }
@@ -260,7 +263,8 @@ gridWriterHDF5_writeGridRegular(gridWriter_t  writer,
 		for (int j = 0; j < numPatches; j++) {
 			gridPatch_t patch = gridRegular_getPatchHandle(grid, j);
 			assert(w->fileHandle != H5I_INVALID_HID);
-			local_writeVariableAtPatch(var, patch, dataSet, dt, gridSize);
+			local_writeVariableAtPatch(var, patch, i, dataSet, dt,
+			                           gridSize);
 		}
 		H5Dclose(dataSet);
 	}
@@ -501,12 +505,13 @@ local_getDSCreationPropList(const gridWriterHDF5_t writer)
 inline static void
 local_writeVariableAtPatch(dataVar_t   var,
                            gridPatch_t patch,
+                           int         idxOfVar,
                            hid_t       dataSet,
                            hid_t       dt,
                            hid_t       gridSize)
 {
 	hid_t             transProps = H5P_DEFAULT;
-	gridPointUint32_t dimsPatch;
+	gridPointUint32_t dimsPatch, dimsActual;
 	hid_t             dataSpacePatch, dataSpaceFile;
 	void              *data = gridPatch_getVarDataHandleByVar(patch, var);
 
@@ -526,7 +531,10 @@ local_writeVariableAtPatch(dataVar_t   var,
 		gridPatch_getIdxLo(patch, idxLo);
 		gridUtilHDF5_selectHyperslab(dataSpaceFile, idxLo, dimsPatch);
 	}
-	dataSpacePatch = gridUtilHDF5_getDataSpaceFromDims(dimsPatch);
+	// Select the cells without the FFTW padding in memory.
+	gridPatch_getDimsActual(patch, idxOfVar, dimsActual);
+	dataSpacePatch = gridUtilHDF5_getDataSpaceFromDims(dimsActual);
+	gridUtilHDF5_selectHyperslab(dataSpacePatch, NULL, dimsPatch);
 
 	H5Dwrite(dataSet, dt, dataSpacePatch, dataSpaceFile,
 	         transProps, data);
@@ -273,6 +273,21 @@ local_writePatchData(gridWriterSilo_t writer,
                      const char       *patchName);
 
 
+/**
+ * @brief  Copies the data of a variable with FFTW padding into a new
+ *         array without the padding.
+ *
+ * @param[in]  patch
+ *                The patch holding the variable.
+ * @param[in]  idxOfVar
+ *                The index of the variable.
+ *
+ * @return  Returns a new array holding the cells of the patch contiguously.
+ */
+static void *
+local_getPackedData(const gridPatch_t patch, int idxOfVar);
+
+
 /**
  * @brief  Translates the grid variable type to the corresponding Silo
  *         variable type.
@@ -719,6 +734,7 @@ local_writePatchData(gridWriterSilo_t writer,
 	for (int i = 0; i < numVars; i++) {
 		dataVar_t var          = gridPatch_getVarHandle(patch, i);
 		void      *data        = gridPatch_getVarDataHandle(patch, i);
+		void      *dataPacked  = NULL;
 		int       varType      = local_getVarType(var);
 		int       varCentering = DB_ZONECENT;
 
@@ -728,15 +744,42 @@ local_writePatchData(gridWriterSilo_t writer,
 				dims[j]++;
 		}
 
+		// Silo wants contiguous rows, pack FFTW padded data row by row.
+		if (gridPatch_getDimActual1D(patch, i, 0)
+		    != gridPatch_getOneDim(patch, 0)) {
+			dataPacked = local_getPackedData(patch, i);
+			data       = dataPacked;
+		}
+
 		varName = local_getPatchVarName(var, patchName, varName);
 		DBPutQuadvar1(writer->f, varName, patchName, data, dims, NDIM,
 		              NULL, 0, varType, varCentering, NULL);
+		if (dataPacked != NULL)
+			xfree(dataPacked);
 	}
 
 	if (varName != NULL)
 		xfree(varName);
 }
 
+static void *
+local_getPackedData(const gridPatch_t patch, int idxOfVar)
+{
+	dataVar_t  var        = gridPatch_getVarHandle(patch, idxOfVar);
+	size_t     size       = dataVar_getSizePerElement(var);
+	uint32_t   dim0       = gridPatch_getOneDim(patch, 0);
+	uint32_t   dimActual0 = gridPatch_getDimActual1D(patch, idxOfVar, 0);
+	uint64_t   numCells   = gridPatch_getNumCells(patch);
+	const char *data      = gridPatch_getVarDataHandle(patch, idxOfVar);
+	char       *packed    = xmalloc(size * numCells);
+
+	for (uint64_t j = 0; j < numCells / dim0; j++)
+		memcpy(packed + j * dim0 * size, data + j * dimActual0 * size,
+		       dim0 * size);
+
+	return packed;
+}
+
 inline static int
 local_getVarType(dataVar_t var)
 {
@@ -15,6 +15,7 @@
 #include "gridReaderFactory_tests.h"
 #include "gridReader_tests.h"
 #include "gridReaderBov_tests.h"
+#include "gridWriterGrafic_tests.h"
 #ifdef WITH_HDF5
 #  include "gridWriterHDF5_tests.h"
 #  include "gridReaderHDF5_tests.h"
@@ -103,6 +104,7 @@ main(int argc, char **argv)
 	RUNTEST(&gridPatch_getNumVars_test, hasFailed);
 	RUNTEST(&gridPatch_transpose_test, hasFailed);
 	RUNTEST(&gridPatch_getWindowedDataCopy_test, hasFailed);
+	RUNTEST(&gridPatch_removeFFTWPadding_test, hasFailed);
 	RUNTEST(&gridPatch_putWindowedData_test, hasFailed);
 	RUNTEST(&gridPatch_calcDistanceVector_test, hasFailed);
 #ifdef XMEM_TRACK_MEM
@@ -154,6 +156,7 @@ main(int argc, char **argv)
 	RUNTEST(&gridRegularDistrib_getPatchForRank_test, hasFailed);
 	RUNTEST(&gridRegularDistrib_calcIdxsForRank1D_test, hasFailed);
 	RUNTEST(&gridRegularDistrib_transpose_test, hasFailed);
+	RUNTEST(&gridRegularDistrib_transposePipelined_test, hasFailed);
 #ifdef XMEM_TRACK_MEM
 	if (rank == 0)
 		xmem_info(stdout);
@@ -167,6 +170,12 @@ main(int argc, char **argv)
 	RUNTEST(&gridRegularFFT_del_test, hasFailed);
 	RUNTEST(&gridRegularFFT_getNorm_test, hasFailed);
 	RUNTEST(&gridRegularFFT_execute_test, hasFailed);
+	RUNTEST(&gridRegularFFT_executeInPlace_test, hasFailed);
+	RUNTEST(&gridRegularFFT_storeKSpace_test, hasFailed);
+	RUNTEST(&gridRegularFFT_setPlannerEffort_test, hasFailed);
+	RUNTEST(&gridRegularFFT_getEffortFromName_test, hasFailed);
+	RUNTEST(&gridRegularFFT_setNumThreads_test, hasFailed);
+	RUNTEST(&gridRegularFFT_setNumChunks_test, hasFailed);
 #ifdef XMEM_TRACK_MEM
 	if (rank == 0)
 		xmem_info(stdout);
@@ -183,6 +192,8 @@ main(int argc, char **argv)
 #ifdef WITH_MPI
 	RUNTEST(&gridHistogram_calcGridRegularDistrib_test, hasFailed);
 #endif
+	RUNTEST(&gridHistogram_calcBin_test, hasFailed);
+	RUNTEST(&gridHistogram_calcGridPatchPadded_test, hasFailed);
 #ifdef XMEM_TRACK_MEM
 	if (rank == 0)
 		xmem_info(stdout);
@@ -194,11 +205,13 @@ main(int argc, char **argv)
 	}
 	RUNTEST(&gridStatistics_new_test, hasFailed);
 	RUNTEST(&gridStatistics_del_test, hasFailed);
+	RUNTEST(&gridStatistics_attachHistogram_test, hasFailed);
 	RUNTEST(&gridStatistics_calcGridPatch_test, hasFailed);
 	RUNTEST(&gridStatistics_calcGridRegular_test, hasFailed);
 #ifdef WITH_MPI
 	RUNTEST(&gridStatistics_calcGridRegularDistrib_test, hasFailed);
 #endif
+	RUNTEST(&gridStatistics_calcGridPatchPadded_test, hasFailed);
 #ifdef XMEM_TRACK_MEM
 	if (rank == 0)
 		xmem_info(stdout);
@@ -253,6 +266,16 @@ main(int argc, char **argv)
 	global_max_allocated_bytes = 0;
 #endif
 
+	if (rank == 0) {
+		printf("\nRunning tests for gridWriterGrafic:\n");
+	}
+	RUNTEST(&gridWriterGrafic_writeGridPatchPadded_test, hasFailed);
+#ifdef XMEM_TRACK_MEM
+	if (rank == 0)
+		xmem_info(stdout);
+	global_max_allocated_bytes = 0;
+#endif
+
 
 #ifdef WITH_HDF5
 	if (rank == 0) {
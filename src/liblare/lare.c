@@ -8,6 +8,7 @@
 #include "lare.h"
 #include <assert.h>
 #include <inttypes.h>
+#include <string.h>
 #include "../libutil/xmem.h"
 #include "../libutil/diediedie.h"
 #include "../libgrid/gridPoint.h"
@@ -19,11 +20,20 @@
 
 /*--- Local defines -----------------------------------------------------*/
 
+/** @brief  The minimum number of elements to allocate when growing. */
+#define LOCAL_MIN_ALLOCATION 1024
+
+/** @brief  The number of bits sorted in one pass of the radix sort. */
+#define LOCAL_RADIX_BITS 11
+
 
 /*--- Prototypes of local functions -------------------------------------*/
 static inline void
 local_setInvalidElement(lare_t lare, uint32_t idxOfElement);
 
+static void
+local_radixSort(uint64_t *keys, uint64_t *tmp, uint32_t num, uint64_t maxKey);
+
 
 /*--- Implementations of exported functios ------------------------------*/
 extern lare_t
@@ -33,8 +43,9 @@ lare_new(gridPointUint32_t dims, uint32_t numElements)
 
 	assert(numElements < UINT32_MAX);
 
-	lare              = xmalloc(sizeof(struct lare_struct));
-	lare->numElements = numElements;
+	lare                       = xmalloc(sizeof(struct lare_struct));
+	lare->numElements          = numElements;
+	lare->numElementsAllocated = numElements;
 	for (int i = 0; i < NDIM; i++)
 		lare->dims[i] = dims[i];
 	if (lare->numElements > 0) {
@@ -123,15 +134,87 @@ lare_addElement(lare_t                  lare,
                 const gridPointUint32_t element)
 {
 	assert(lare != NULL);
+	assert(lare->numElements < UINT32_MAX - 1);
 
-	lare->elements = xrealloc(lare->elements,
-	                          sizeof(gridPointUint32_t)
-	                          * (lare->numElements + 1));
+	if (lare->numElements == lare->numElementsAllocated) {
+		uint64_t newSize = (uint64_t)(lare->numElementsAllocated) * 2;
+		if (newSize < LOCAL_MIN_ALLOCATION)
+			newSize = LOCAL_MIN_ALLOCATION;
+		if (newSize > UINT32_MAX - 1)
+			newSize = UINT32_MAX - 1;
+		lare->elements             = xrealloc(lare->elements,
+		                                      sizeof(gridPointUint32_t)
+		                                      * newSize);
+		lare->numElementsAllocated = (uint32_t)newSize;
+	}
 	local_setInvalidElement(lare, lare->numElements);
 	lare->numElements++;
 	lare_setElement(lare, element, lare->numElements - 1);
 }
 
+extern void
+lare_sortAndUnique(lare_t lare)
+{
+	uint64_t *keys, *tmp;
+	uint64_t maxKey = 1;
+	uint32_t numUnique;
+
+	assert(lare != NULL);
+
+	if (lare->numElements < 2)
+		return;
+
+	keys = xmalloc(sizeof(uint64_t) * lare->numElements);
+	tmp  = xmalloc(sizeof(uint64_t) * lare->numElements);
+	for (int i = 0; i < NDIM; i++)
+		maxKey *= lare->dims[i];
+
+#ifdef WITH_OPENMP
+#  pragma omp parallel for shared(keys, lare) schedule(static)
+#endif
+	for (uint32_t i = 0; i < lare->numElements; i++)
+		keys[i] = lare_getLinearIdxOfElement(lare, i);
+
+	local_radixSort(keys, tmp, lare->numElements, maxKey);
+	xfree(tmp);
+
+	numUnique = 1;
+	for (uint32_t i = 1; i < lare->numElements; i++) {
+		if (keys[i] != keys[numUnique - 1])
+			keys[numUnique++] = keys[i];
+	}
+
+#ifdef WITH_OPENMP
+#  pragma omp parallel for shared(keys, lare) schedule(static)
+#endif
+	for (uint32_t i = 0; i < numUnique; i++) {
+		uint64_t idx = keys[i];
+		for (int j = 0; j < NDIM; j++) {
+			lare->elements[i][j] = (uint32_t)(idx % lare->dims[j]);
+			idx                 /= lare->dims[j];
+		}
+	}
+	xfree(keys);
+
+	lare->numElements = numUnique;
+} /* lare_sortAndUnique */
+
+extern uint64_t
+lare_getLinearIdxOfElement(const lare_t lare, uint32_t idxOfElement)
+{
+	uint64_t idx = 0;
+
+	assert(lare != NULL);
+	assert(idxOfElement < lare->numElements);
+
+	for (int i = NDIM - 1; i >= 0; i--) {
+		assert(lare->elements[idxOfElement][i] < lare->dims[i]);
+		idx = idx * lare->dims[i] + lare->elements[idxOfElement][i];
+	}
+
+	return idx;
+}
+
 /*--- Implementations of local functions --------------------------------*/
 static inline void
 local_setInvalidElement(lare_t lare, uint32_t idxOfElement)
@@ -139,3 +222,43 @@ local_setInvalidElement(lare_t lare, uint32_t idxOfElement)
 	for (int i = 0; i < NDIM; i++)
 		lare->elements[idxOfElement][i] = lare->dims[i];
 }
+
+static void
+local_radixSort(uint64_t *keys, uint64_t *tmp, uint32_t num, uint64_t maxKey)
+{
+	const uint64_t numBuckets = UINT64_C(1) << LOCAL_RADIX_BITS;
+	const uint64_t bitMask    = numBuckets - 1;
+	uint64_t       *counts    = xmalloc(sizeof(uint64_t) * numBuckets);
+	int            numPasses  = 0;
+
+	while (numPasses * LOCAL_RADIX_BITS < 64
+	       && (maxKey - 1) >> (numPasses * LOCAL_RADIX_BITS) != 0)
+		numPasses++;
+
+	for (int pass = 0; pass < numPasses; pass++) {
+		int      shift = pass * LOCAL_RADIX_BITS;
+		uint64_t sum   = 0;
+		uint64_t *swap;
+
+		memset(counts, 0, sizeof(uint64_t) * numBuckets);
+		for (uint32_t i = 0; i < num; i++)
+			counts[(keys[i] >> shift) & bitMask]++;
+		for (uint64_t b = 0; b < numBuckets; b++) {
+			uint64_t c = counts[b];
+			counts[b] = sum;
+			sum      += c;
+		}
+		for (uint32_t i = 0; i < num; i++)
+			tmp[counts[(keys[i] >> shift) & bitMask]++] = keys[i];
+		swap = keys;
+		keys = tmp;
+		tmp  = swap;
+	}
+
+	// After an odd number of passes the sorted keys are in the scratch
+	// array.
+	if (numPasses % 2 == 1)
+		memcpy(tmp, keys, sizeof(uint64_t) * num);
+
+	xfree(counts);
+} /* local_radixSort */
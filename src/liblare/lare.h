@@ -43,4 +43,10 @@ extern void
 lare_addElement(lare_t                  lare,
                 const gridPointUint32_t element);
 
+extern void
+lare_sortAndUnique(lare_t lare);
+
+extern uint64_t
+lare_getLinearIdxOfElement(const lare_t lare, uint32_t idxOfElement);
+
 #endif
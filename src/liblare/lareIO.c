@@ -18,6 +18,7 @@
 /*--- Local variables ---------------------------------------------------*/
 static const char *local_typeLegacyStr  = "legacy";
 static const char *local_typeLOIStr     = "loi";
+static const char *local_typeBinaryStr  = "binary";
 static const char *local_typeUnknownStr = "unknown";
 
 
@@ -36,6 +37,8 @@ lareIO_getTypeFromName(const char *name)
 		rtn = LAREIO_TYPE_LEGACY;
 	else if (strcmp(name, local_typeLOIStr) == 0)
 		rtn = LAREIO_TYPE_LOI;
+	else if (strcmp(name, local_typeBinaryStr) == 0)
+		rtn = LAREIO_TYPE_BINARY;
 	else
 		rtn = LAREIO_TYPE_UNKNOWN;
 
@@ -51,10 +54,46 @@ lareIO_getNameFromType(lareIO_type_t type)
 		rtn = local_typeLegacyStr;
 	else if (type == LAREIO_TYPE_LOI)
 		rtn = local_typeLOIStr;
+	else if (type == LAREIO_TYPE_BINARY)
+		rtn = local_typeBinaryStr;
 	else
 		rtn = local_typeUnknownStr;
 
 	return rtn;
 }
 
+extern void
+lareIO_writeBinary(lare_t lare, const char *fileName)
+{
+	FILE                  *f;
+	lareIO_binaryHeader_t header;
+	gridPointUint32_t     dims;
+	uint64_t              buffer[1024];
+	uint32_t              numElements;
+
+	assert(lare != NULL);
+	assert(fileName != NULL);
+
+	lare_sortAndUnique(lare);
+	numElements = lare_getNumElements(lare);
+	lare_getDims(lare, dims);
+
+	memset(&header, 0, sizeof(header));
+	strncpy(header.magic, LAREIO_BINARY_MAGIC, sizeof(header.magic));
+	header.version = LAREIO_BINARY_VERSION;
+	for (int i = 0; i < 3; i++)
+		header.dims[i] = (i < NDIM) ? dims[i] : 1;
+	header.numElements = numElements;
+
+	f = xfopen(fileName, "wb");
+	xfwrite(&header, sizeof(header), 1, f);
+	for (uint32_t i = 0; i < numElements; i += 1024) {
+		uint32_t num = (numElements - i < 1024) ? numElements - i : 1024;
+		for (uint32_t j = 0; j < num; j++)
+			buffer[j] = lare_getLinearIdxOfElement(lare, i + j);
+		xfwrite(buffer, sizeof(uint64_t), num, f);
+	}
+	xfclose(&f);
+}
+
 /*--- Implementations of local functions --------------------------------*/
@@ -9,15 +9,42 @@
 /*--- Includes ----------------------------------------------------------*/
 #include "lareConfig.h"
 #include <stdbool.h>
+#include <stdint.h>
+#include "lare.h"
+
+
+/*--- Exported defines --------------------------------------------------*/
+
+/** @brief  The magic bytes at the start of a binary lare file. */
+#define LAREIO_BINARY_MAGIC "g9pLARE"
+
+/** @brief  The version of the binary lare format. */
+#define LAREIO_BINARY_VERSION UINT32_C(1)
 
 
 /*--- Exported types ----------------------------------------------------*/
 typedef enum {
 	LAREIO_TYPE_LEGACY,
 	LAREIO_TYPE_LOI,
+	LAREIO_TYPE_BINARY,
 	LAREIO_TYPE_UNKNOWN
 } lareIO_type_t;
 
+/**
+ * @brief  The header of a binary lare file.
+ *
+ * The header is followed by @c numElements sorted and unique linear
+ * indices (uint64_t, x varying fastest).  All values are stored in the
+ * byte order of the writing machine, the version field is used to detect
+ * files that need to be byte swapped.
+ */
+typedef struct {
+	char     magic[8];
+	uint32_t version;
+	uint32_t dims[3];
+	uint64_t numElements;
+} lareIO_binaryHeader_t;
+
 /*--- Prototypes of exported functions ----------------------------------*/
 extern lareIO_type_t
 lareIO_getTypeFromName(const char *name);
@@ -25,4 +52,7 @@ lareIO_getTypeFromName(const char *name);
 extern const char *
 lareIO_getNameFromType(lareIO_type_t type);
 
+extern void
+lareIO_writeBinary(lare_t lare, const char *fileName);
+
 #endif
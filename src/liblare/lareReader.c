@@ -10,6 +10,7 @@
 #include "lareIO.h"
 #include "lareReaderLegacy.h"
 #include "lareReaderLOI.h"
+#include "lareReaderBinary.h"
 #include <assert.h>
 #include "../libutil/xmem.h"
 #include "../libutil/parse_ini.h"
@@ -86,6 +87,8 @@ local_newFromIniWrapper(parse_ini_t   ini,
 		reader = (lareReader_t)lareReaderLegacy_newFromIni(ini, secName);
 	} else if (type == LAREIO_TYPE_LOI) {
 		reader = (lareReader_t)lareReaderLOI_newFromIni(ini, secName);
+	} else if (type == LAREIO_TYPE_BINARY) {
+		reader = (lareReader_t)lareReaderBinary_newFromIni(ini, secName);
 	} else {
 		fprintf(stderr, "Cannot create lare reader for %s\n",
 		        lareIO_getNameFromType(type));
@@ -0,0 +1,216 @@
+// Copyright (C) 2011, Steffen Knollmann
+// Released under the terms of the GNU General Public License version 3.
+// This file is part of `ginnungagap'.
+
+
+/*--- Includes ----------------------------------------------------------*/
+#include "lareConfig.h"
+#include "lareReaderBinary.h"
+#include "lareIO.h"
+#include <assert.h>
+#include <inttypes.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "../libutil/parse_ini.h"
+#include "../libutil/xmem.h"
+#include "../libutil/xstring.h"
+#include "../libutil/byteswap.h"
+#include "../libutil/diediedie.h"
+
+
+/*--- Implemention of main structure ------------------------------------*/
+#include "lareReader_adt.h"
+#include "lareReaderBinary_adt.h"
+
+
+/*--- Local variables ---------------------------------------------------*/
+static struct lareReader_func_struct local_func
+    = {&lareReaderBinary_del,
+	   &lareReaderBinary_read};
+
+
+/*--- Prototypes of local functions -------------------------------------*/
+static bool
+local_checkHeader(lareIO_binaryHeader_t *header,
+                  size_t                fileSize,
+                  const char            *fileName);
+
+static void
+local_readElementsIntoLare(lare_t         lare,
+                           const uint64_t *idxs,
+                           bool           needsSwap);
+
+
+/*--- Implementations of exported functions -----------------------------*/
+extern lareReaderBinary_t
+lareReaderBinary_new(const char *fileName)
+{
+	lareReaderBinary_t reader;
+
+	assert(fileName != NULL);
+
+	reader           = xmalloc(sizeof(struct lareReaderBinary_struct));
+	reader->type     = LAREIO_TYPE_BINARY;
+	reader->func     = (lareReader_func_t)&local_func;
+	reader->fileName = xstrdup(fileName);
+
+	return reader;
+}
+
+extern lareReaderBinary_t
+lareReaderBinary_newFromIni(parse_ini_t ini, const char *sectionName)
+{
+	lareReaderBinary_t reader;
+	char               *fileName;
+
+	getFromIni(&fileName, parse_ini_get_string,
+	           ini, "fileName", sectionName);
+	reader = lareReaderBinary_new(fileName);
+	xfree(fileName);
+
+	return reader;
+}
+
+extern void
+lareReaderBinary_del(lareReader_t *reader)
+{
+	lareReaderBinary_t tmp;
+
+	assert(reader != NULL && *reader != NULL);
+	tmp = (lareReaderBinary_t)*reader;
+	assert(tmp->type == LAREIO_TYPE_BINARY);
+
+	xfree(tmp->fileName);
+
+	xfree(*reader);
+
+	*reader = NULL;
+}
+
+extern lare_t
+lareReaderBinary_read(lareReader_t reader)
+{
+	lareReaderBinary_t    tmp;
+	lare_t                lare;
+	int                   fd;
+	struct stat           st;
+	void                  *map;
+	lareIO_binaryHeader_t header;
+	gridPointUint32_t     dims;
+	bool                  needsSwap;
+
+	assert(reader != NULL);
+	assert(reader->type == LAREIO_TYPE_BINARY);
+	tmp = (lareReaderBinary_t)reader;
+
+	fd  = open(tmp->fileName, O_RDONLY);
+	if ((fd < 0) || (fstat(fd, &st) != 0)) {
+		fprintf(stderr, "FATAL:  Could not open %s: %s\n",
+		        tmp->fileName, strerror(errno));
+		diediedie(EXIT_FAILURE);
+	}
+	if ((size_t)st.st_size < sizeof(lareIO_binaryHeader_t)) {
+		fprintf(stderr, "FATAL:  %s is too small to be a lare file.\n",
+		        tmp->fileName);
+		diediedie(EXIT_FAILURE);
+	}
+
+	map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	if (map == MAP_FAILED) {
+		fprintf(stderr, "FATAL:  Could not map %s: %s\n",
+		        tmp->fileName, strerror(errno));
+		diediedie(EXIT_FAILURE);
+	}
+	close(fd);
+#ifdef MADV_SEQUENTIAL
+	(void)madvise(map, (size_t)st.st_size, MADV_SEQUENTIAL);
+#endif
+
+	memcpy(&header, map, sizeof(lareIO_binaryHeader_t));
+	needsSwap = local_checkHeader(&header, (size_t)st.st_size,
+	                              tmp->fileName);
+
+	for (int i = 0; i < NDIM; i++)
+		dims[i] = header.dims[i];
+	lare = lare_new(dims, (uint32_t)header.numElements);
+
+	local_readElementsIntoLare(lare,
+	                           (const uint64_t *)((char *)map
+	                                              + sizeof(header)),
+	                           needsSwap);
+
+	munmap(map, (size_t)st.st_size);
+
+	return lare;
+} /* lareReaderBinary_read */
+
+/*--- Implementations of local functions --------------------------------*/
+static bool
+local_checkHeader(lareIO_binaryHeader_t *header,
+                  size_t                fileSize,
+                  const char            *fileName)
+{
+	bool needsSwap = false;
+
+	if (strncmp(header->magic, LAREIO_BINARY_MAGIC,
+	            sizeof(header->magic)) != 0) {
+		fprintf(stderr, "FATAL:  %s is not a binary lare file.\n",
+		        fileName);
+		diediedie(EXIT_FAILURE);
+	}
+
+	if (header->version != LAREIO_BINARY_VERSION) {
+		byteswap(&(header->version), sizeof(uint32_t));
+		if (header->version != LAREIO_BINARY_VERSION) {
+			fprintf(stderr, "FATAL:  %s has unsupported version.\n",
+			        fileName);
+			diediedie(EXIT_FAILURE);
+		}
+		needsSwap = true;
+		for (int i = 0; i < 3; i++)
+			byteswap(header->dims + i, sizeof(uint32_t));
+		byteswap(&(header->numElements), sizeof(uint64_t));
+	}
+
+	if ((header->numElements >= UINT32_MAX)
+	    || (fileSize != sizeof(lareIO_binaryHeader_t)
+	        + header->numElements * sizeof(uint64_t))) {
+		fprintf(stderr, "FATAL:  %s has an inconsistent size.\n",
+		        fileName);
+		diediedie(EXIT_FAILURE);
+	}
+
+	return needsSwap;
+} /* local_checkHeader */
+
+static void
+local_readElementsIntoLare(lare_t         lare,
+                           const uint64_t *idxs,
+                           bool           needsSwap)
+{
+	gridPointUint32_t dims;
+	uint32_t          numElements = lare_getNumElements(lare);
+
+	lare_getDims(lare, dims);
+
+#ifdef WITH_OPENMP
+#  pragma omp parallel for shared(lare, idxs, needsSwap, dims) \
+	schedule(static)
+#endif
+	for (uint32_t i = 0; i < numElements; i++) {
+		gridPointUint32_t element;
+		uint64_t          id = idxs[i];
+
+		if (needsSwap)
+			byteswap(&id, sizeof(uint64_t));
+		for (int j = 0; j < NDIM; j++) {
+			element[j] = id % dims[j];
+			id        /= dims[j];
+		}
+		lare_setElement(lare, element, i);
+	}
+}
@@ -0,0 +1,34 @@
+// Copyright (C) 2011, Steffen Knollmann
+// Released under the terms of the GNU General Public License version 3.
+// This file is part of `ginnungagap'.
+
+#ifndef LAREREADERBINARY_H
+#define LAREREADERBINARY_H
+
+
+/*--- Includes ----------------------------------------------------------*/
+#include "lareConfig.h"
+#include "lareReader.h"
+#include "lare.h"
+#include "../libutil/parse_ini.h"
+
+
+/*--- ADT handle --------------------------------------------------------*/
+typedef struct lareReaderBinary_struct *lareReaderBinary_t;
+
+
+/*--- Prototypes of exported functions ----------------------------------*/
+extern lareReaderBinary_t
+lareReaderBinary_new(const char *fileName);
+
+extern lareReaderBinary_t
+lareReaderBinary_newFromIni(parse_ini_t ini, const char *sectionName);
+
+extern void
+lareReaderBinary_del(lareReader_t *reader);
+
+extern lare_t
+lareReaderBinary_read(lareReader_t reader);
+
+
+#endif
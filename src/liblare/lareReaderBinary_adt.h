@@ -0,0 +1,21 @@
+// Copyright (C) 2011, Steffen Knollmann
+// Released under the terms of the GNU General Public License version 3.
+// This file is part of `ginnungagap'.
+
+#ifndef LAREREADERBINARY_ADT_H
+#define LAREREADERBINARY_ADT_H
+
+
+/*--- Includes ----------------------------------------------------------*/
+#include "lareConfig.h"
+#include "lareReader_adt.h"
+
+
+/*--- ADT implementation ------------------------------------------------*/
+struct lareReaderBinary_struct {
+	LAREREADER_T_CONTENT
+	char *fileName;
+};
+
+
+#endif
@@ -0,0 +1,78 @@
+// Copyright (C) 2011, Steffen Knollmann
+// Released under the terms of the GNU General Public License version 3.
+// This file is part of `ginnungagap'.
+
+
+/*--- Includes ----------------------------------------------------------*/
+#include "lareConfig.h"
+#include "lareReaderBinary_tests.h"
+#include "lareReaderBinary.h"
+#include "lareIO.h"
+#include "lare.h"
+#include <stdio.h>
+#include <string.h>
+#include "../libgrid/gridPoint.h"
+#ifdef XMEM_TRACK_MEM
+#  include "../libutil/xmem.h"
+#endif
+
+
+/*--- Local defines -----------------------------------------------------*/
+#define LOCAL_TESTFILE "lareReaderBinary_test.dat"
+
+
+/*--- Implementations of exported functios ------------------------------*/
+extern bool
+lareReaderBinary_read_test(void)
+{
+	bool              hasPassed = true;
+	lare_t            lare, lareRead;
+	lareReader_t      reader;
+	gridPointUint32_t dims, dimsRead, element, elementRead;
+#ifdef XMEM_TRACK_MEM
+	size_t            allocatedBytes = global_allocated_bytes;
+#endif
+
+	printf("Testing %s... ", __func__);
+
+	for (int i = 0; i < NDIM; i++)
+		dims[i] = 32 + i;
+	lare = lare_new(dims, 0);
+	for (uint32_t i = 0; i < 100; i++) {
+		for (int j = 0; j < NDIM; j++)
+			element[j] = (99 - i + 7 * j) % dims[j];
+		lare_addElement(lare, element);
+		lare_addElement(lare, element);
+	}
+	lareIO_writeBinary(lare, LOCAL_TESTFILE);
+
+	reader   = (lareReader_t)lareReaderBinary_new(LOCAL_TESTFILE);
+	lareRead = lareReader_read(reader);
+	lareReader_del(&reader);
+	remove(LOCAL_TESTFILE);
+
+	lare_getDims(lareRead, dimsRead);
+	for (int i = 0; i < NDIM; i++) {
+		if (dimsRead[i] != dims[i])
+			hasPassed = false;
+	}
+	if (lare_getNumElements(lareRead) != 100)
+		hasPassed = false;
+	for (uint32_t i = 0; hasPassed && i < 100; i++) {
+		lare_getElement(lare, element, i);
+		lare_getElement(lareRead, elementRead, i);
+		for (int j = 0; j < NDIM; j++) {
+			if (element[j] != elementRead[j])
+				hasPassed = false;
+		}
+	}
+
+	lare_del(&lareRead);
+	lare_del(&lare);
+#ifdef XMEM_TRACK_MEM
+	if (allocatedBytes != global_allocated_bytes)
+		hasPassed = false;
+#endif
+
+	return hasPassed ? true : false;
+} /* lareReaderBinary_read_test */
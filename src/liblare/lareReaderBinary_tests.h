@@ -0,0 +1,19 @@
+// Copyright (C) 2011, Steffen Knollmann
+// Released under the terms of the GNU General Public License version 3.
+// This file is part of `ginnungagap'.
+
+#ifndef LAREREADERBINARY_TESTS_H
+#define LAREREADERBINARY_TESTS_H
+
+
+/*--- Includes ----------------------------------------------------------*/
+#include "lareConfig.h"
+#include <stdbool.h>
+
+
+/*--- Prototypes of exported functions ----------------------------------*/
+extern bool
+lareReaderBinary_read_test(void);
+
+
+#endif
@@ -8,6 +8,7 @@
 #include "lareReaderLOI.h"
 #include <assert.h>
 #include <inttypes.h>
+#include <stdlib.h>
 #include "../libutil/parse_ini.h"
 #include "../libutil/xmem.h"
 #include "../libutil/xfile.h"
@@ -107,7 +108,7 @@ local_readElementsIntoLare(lare_t lare, FILE *f)
 		uint64_t id;
 		if (line[0] == '#')
 			continue;
-		sscanf(line, "%" SCNu64, &id);
+		id = strtoull(line, NULL, 10);
 		for (int i = 0; i < NDIM; i++) {
 			element[i] = id % dimsLare[i];
 			id        /= dimsLare[i];
@@ -15,6 +15,7 @@
 /*--- ADT implementation ------------------------------------------------*/
 struct lare_struct {
 	uint32_t          numElements;
+	uint32_t          numElementsAllocated;
 	gridPointUint32_t dims;
 	gridPointUint32_t *elements;
 };
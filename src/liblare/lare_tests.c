@@ -207,4 +207,51 @@ lare_addElement_test(void)
 	return hasPassed ? true : false;
 } /* lare_addElement_test */
 
+extern bool
+lare_sortAndUnique_test(void)
+{
+	bool              hasPassed = true;
+	lare_t            lare;
+	gridPointUint32_t dims;
+	gridPointUint32_t element;
+	uint32_t          numElements = 5000;
+	uint32_t          seed        = 7;
+#ifdef XMEM_TRACK_MEM
+	size_t            allocatedBytes = global_allocated_bytes;
+#endif
+
+	printf("Testing %s... ", __func__);
+
+	for (int i = 0; i < NDIM; i++)
+		dims[i] = 16 + i;
+	lare = lare_new(dims, 0);
+	for (uint32_t i = 0; i < numElements; i++) {
+		for (int j = 0; j < NDIM; j++) {
+			seed       = seed * 1103515245 + 12345;
+			element[j] = (seed >> 16) % dims[j];
+		}
+		lare_addElement(lare, element);
+	}
+	if ((lare->numElements != numElements)
+	    || (lare->numElementsAllocated < numElements))
+		hasPassed = false;
+
+	lare_sortAndUnique(lare);
+	if ((lare->numElements == 0) || (lare->numElements >= numElements))
+		hasPassed = false;
+	for (uint32_t i = 1; i < lare->numElements; i++) {
+		if (lare_getLinearIdxOfElement(lare, i - 1)
+		    >= lare_getLinearIdxOfElement(lare, i))
+			hasPassed = false;
+	}
+
+	lare_del(&lare);
+#ifdef XMEM_TRACK_MEM
+	if (allocatedBytes != global_allocated_bytes)
+		hasPassed = false;
+#endif
+
+	return hasPassed ? true : false;
+} /* lare_sortAndUnique_test */
+
 /*--- Implementations of local functions --------------------------------*/
@@ -27,4 +27,7 @@ lare_setElement_test(void);
 extern bool
 lare_addElement_test(void);
 
+extern bool
+lare_sortAndUnique_test(void);
+
 #endif
@@ -5,6 +5,7 @@
 /*--- Includes ----------------------------------------------------------*/
 #include "lareConfig.h"
 #include "lare_tests.h"
+#include "lareReaderBinary_tests.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -46,6 +47,10 @@ main(int argc, char **argv)
 	RUNTEST(&lare_getElement_test, hasFailed);
 	RUNTEST(&lare_setElement_test, hasFailed);
 	RUNTEST(&lare_addElement_test, hasFailed);
+	RUNTEST(&lare_sortAndUnique_test, hasFailed);
+
+	printf("\nRunning tests for lareReaderBinary:\n");
+	RUNTEST(&lareReaderBinary_read_test, hasFailed);
 
 	if (hasFailed) {
 		fprintf(stderr, "\nSome tests failed!\n\n");
@@ -50,3 +50,33 @@ byteswapVec(void *vec, size_t sizeOfVec, int numComponents)
 		}
 	}
 }
+
+extern void
+byteswapArray(void *data, size_t sizeOfElement, uint64_t numElements)
+{
+	if (sizeOfElement == 2) {
+		uint16_t *d = data;
+		for (uint64_t i = 0; i < numElements; i++)
+			d[i] = (uint16_t)((d[i] >> 8) | (d[i] << 8));
+	} else if (sizeOfElement == 4) {
+		uint32_t *d = data;
+		for (uint64_t i = 0; i < numElements; i++) {
+			uint32_t x = d[i];
+			d[i] = (x >> 24) | ((x >> 8) & UINT32_C(0x0000ff00))
+			       | ((x << 8) & UINT32_C(0x00ff0000)) | (x << 24);
+		}
+	} else if (sizeOfElement == 8) {
+		uint64_t *d = data;
+		for (uint64_t i = 0; i < numElements; i++) {
+			uint64_t x = d[i];
+			x    = ((x >> 8) & UINT64_C(0x00ff00ff00ff00ff))
+			       | ((x & UINT64_C(0x00ff00ff00ff00ff)) << 8);
+			x    = ((x >> 16) & UINT64_C(0x0000ffff0000ffff))
+			       | ((x & UINT64_C(0x0000ffff0000ffff)) << 16);
+			d[i] = (x >> 32) | (x << 32);
+		}
+	} else if (sizeOfElement > 1) {
+		for (uint64_t i = 0; i < numElements; i++)
+			byteswap((char *)data + i * sizeOfElement, sizeOfElement);
+	}
+}
@@ -18,6 +18,7 @@
 /*--- Includes ----------------------------------------------------------*/
 #include "util_config.h"
 #include <stdlib.h>
+#include <stdint.h>
 
 
 /*--- Prototypes of exported functions ----------------------------------*/
@@ -58,4 +59,24 @@ byteswap(void *p, size_t s);
 extern void
 byteswapVec(void *vec, size_t sizeOfVec, int numComponents);
 
+/**
+ * @brief  Performs a byteswapping of every element of an array.
+ *
+ * This is equivalent to calling byteswap() for each element, but elements
+ * of 2, 4, and 8 bytes are swapped with dedicated loops that the compiler
+ * can vectorize.
+ *
+ * @param[in,out]  *data
+ *                    The array that should be swapped.  Must be suitably
+ *                    aligned for elements of @c sizeOfElement bytes.
+ * @param[in]      sizeOfElement
+ *                    The size of one element in bytes.
+ * @param[in]      numElements
+ *                    The number of elements in the array.
+ *
+ * @return  Returns nothing.
+ */
+extern void
+byteswapArray(void *data, size_t sizeOfElement, uint64_t numElements);
+
 #endif
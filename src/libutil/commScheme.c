@@ -198,7 +198,8 @@ local_startSending(commScheme_t scheme)
 			break;
 		firstSendBuf++;
 	}
-	firstSendBuf %= numBuffersSend;
+	if (numBuffersSend > 0)
+		firstSendBuf %= numBuffersSend;
 
 	for (int i = firstSendBuf; i < numBuffersSend; i++) {
 		buf = varArr_getElementHandle(scheme->buffersSend, i);
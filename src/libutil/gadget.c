@@ -51,6 +51,18 @@
  */
 #define LOCAL_MAX_SIZE_COMPONENT_IN_BYTES 16
 
+/**
+ * @brief  Gives the size of the buffer used to stage data that needs to
+ *         be converted between the file and the memory representation.
+ */
+#define LOCAL_STAGING_BUFFER_SIZE_IN_BYTES (1 << 22)
+
+/**
+ * @brief  Gives the alignment in bytes of the second part of the staging
+ *         buffer, if it is split.
+ */
+#define LOCAL_STAGING_BUFFER_ALIGNMENT 16
+
 
 /*--- Prototypes of local functions -------------------------------------*/
 
@@ -97,29 +109,73 @@ local_enlargeADTArrays(gadget_t gadget, int numFiles);
 
 
 /**
- * @brief  This will seek to a given position in the block.
+ * @brief  Writes raw bytes into the data part of a block, stepping over
+ *         the delimiters between subrecords.
  *
  * @param[in,out]  *f
- *                    The file pointer that should be put to the correct
- *                    position.  This must point to the beginning of the
- *                    data block (to the leading block size integer).
- * @param[in]      pSkip
- *                    The number of particles that should be skipped.
- * @param[in]      sizeOfElement
- *                    The size of each element in bytes.
+ *                    The file pointer, must point to the position of the
+ *                    byte at @c *offsetInData.
+ * @param[in]      *data
+ *                    The bytes to write.
+ * @param[in]      numBytes
+ *                    The number of bytes to write.
+ * @param[in,out]  *offsetInData
+ *                    The offset of the first byte within the data of the
+ *                    block, will be advanced by @c numBytes.
+ * @param[in]      isSplit
+ *                    Whether the block is split into subrecords, if not,
+ *                    there are no delimiters to step over.
  *
  * @return  Returns nothing.
  */
 inline static void
-local_skipToReqPosInBlock(FILE *f, uint64_t pSkip, size_t sizeOfElement);
+local_writeRecordData(FILE       *f,
+                      const void *data,
+                      uint64_t   numBytes,
+                      uint64_t   *offsetInData,
+                      bool       isSplit);
 
 
 /**
- * @brief  This is the actual function that deals with writing a block.
+ * @brief  Reads raw bytes from the data part of a block, stepping over
+ *         the delimiters between subrecords.
  *
  * @param[in,out]  *f
- *                    The file pointer.  Needs to point to the actual
- *                    position in file at which to start writing to.
+ *                    The file pointer, must point to the position of the
+ *                    byte at @c *offsetInData.
+ * @param[out]     *data
+ *                    The buffer to read into.
+ * @param[in]      numBytes
+ *                    The number of bytes to read.
+ * @param[in,out]  *offsetInData
+ *                    The offset of the first byte within the data of the
+ *                    block, will be advanced by @c numBytes.
+ * @param[in]      isSplit
+ *                    Whether the block is split into subrecords, if not,
+ *                    there are no delimiters to step over.
+ *
+ * @return  Returns nothing.
+ */
+inline static void
+local_readRecordData(FILE     *f,
+                     void     *data,
+                     uint64_t numBytes,
+                     uint64_t *offsetInData,
+                     bool     isSplit);
+
+
+/**
+ * @brief  This is the actual function that deals with writing a block.
+ *
+ * @param[in,out]  gadget
+ *                    The gadget object.  Its file pointer needs to point to
+ *                    the actual position in file at which to start writing
+ *                    to.
+ * @param[in]      offsetInData
+ *                    The offset in bytes of the first element within the
+ *                    data of the block.
+ * @param[in]      isSplit
+ *                    Whether the block is split into subrecords.
  * @param[in]      *stai
  *                    The abstract data description.
  * @param[in]      doByteSwap
@@ -139,10 +195,12 @@ local_skipToReqPosInBlock(FILE *f, uint64_t pSkip, size_t sizeOfElement);
  * @return  Returns nothing.
  */
 inline static void
-local_writeBlockActual(FILE         *f,
+local_writeBlockActual(gadget_t     gadget,
+                       uint64_t     offsetInData,
+                       bool         isSplit,
                        const stai_t stai,
                        bool         doByteSwap,
-                       uint32_t     pWrite,
+                       uint64_t     pWrite,
                        size_t       sizeOfElementFile,
                        int          numComponents,
                        bool         isInteger);
@@ -151,13 +209,20 @@ local_writeBlockActual(FILE         *f,
 /**
  * @brief  This is the general version of writing data to the file.
  *
- * This works element by element: Every element is retrieved and, if
- * required, adjusted for endianess and up- or down-cast to adjust with
- * different precisions in the file and in memory.
+ * The data is staged in chunks through the staging buffer of the gadget
+ * object: The elements of a chunk are gathered from the stai, up- or
+ * down-cast to the precision in the file, adjusted for endianess, and
+ * written with a single call.
  *
- * @param[in,out]  *f
- *                    The file pointer.  Needs to point to the actual
- *                    position in file at which to start writing to.
+ * @param[in,out]  gadget
+ *                    The gadget object.  Its file pointer needs to point to
+ *                    the actual position in file at which to start writing
+ *                    to.
+ * @param[in]      offsetInData
+ *                    The offset in bytes of the first element within the
+ *                    data of the block.
+ * @param[in]      isSplit
+ *                    Whether the block is split into subrecords.
  * @param[in]      pWrite
  *                    The number of particle to write.
  * @param[in]      doByteSwap
@@ -180,7 +245,9 @@ local_writeBlockActual(FILE         *f,
  * @return  Returns nothing.
  */
 static void
-local_writeBlockActualGeneral(FILE         *f,
+local_writeBlockActualGeneral(gadget_t     gadget,
+                              uint64_t     offsetInData,
+                              bool         isSplit,
                               uint64_t     pWrite,
                               bool         doByteSwap,
                               const stai_t stai,
@@ -193,9 +260,15 @@ local_writeBlockActualGeneral(FILE         *f,
 /**
  * @brief  This is the actual function that deals with reading a block.
  *
- * @param[in,out]  *f
- *                    The file pointer.  Needs to point to the actual
- *                    position in file at which to start writing to.
+ * @param[in,out]  gadget
+ *                    The gadget object.  Its file pointer needs to point to
+ *                    the actual position in file at which to start reading
+ *                    from.
+ * @param[in]      offsetInData
+ *                    The offset in bytes of the first element within the
+ *                    data of the block.
+ * @param[in]      isSplit
+ *                    Whether the block is split into subrecords.
  * @param[in]      stai
  *                    The abstract data description.
  * @param[in]      doByteSwap
@@ -215,7 +288,9 @@ local_writeBlockActualGeneral(FILE         *f,
  * @return  Returns nothing.
  */
 inline static void
-local_readBlockActual(FILE     *f,
+local_readBlockActual(gadget_t gadget,
+                      uint64_t offsetInData,
+                      bool     isSplit,
                       stai_t   stai,
                       bool     doByteSwap,
                       uint64_t pRead,
@@ -227,13 +302,20 @@ local_readBlockActual(FILE     *f,
 /**
  * @brief  This is the general version of reading data from the file.
  *
- * This works element by element: Every element is retrieved and, if
- * required, adjusted for endianess and up- or down-cast to adjust with
- * different precisions in the file and in memory.
+ * The data is staged in chunks through the staging buffer of the gadget
+ * object: A chunk of elements is read with a single call, adjusted for
+ * endianess, up- or down-cast to the precision in memory, and scattered
+ * to the stai.
  *
- * @param[in,out]  *f
- *                    The file pointer.  Needs to point to the actual
- *                    position in file at which to start reading from.
+ * @param[in,out]  gadget
+ *                    The gadget object.  Its file pointer needs to point to
+ *                    the actual position in file at which to start reading
+ *                    from.
+ * @param[in]      offsetInData
+ *                    The offset in bytes of the first element within the
+ *                    data of the block.
+ * @param[in]      isSplit
+ *                    Whether the block is split into subrecords.
  * @param[in]      pRead
  *                    The number of particle to read.
  * @param[in]      doByteSwap
@@ -256,7 +338,9 @@ local_readBlockActual(FILE     *f,
  * @return  Returns nothing.
  */
 static void
-local_readBlockActualGeneral(FILE     *f,
+local_readBlockActualGeneral(gadget_t gadget,
+                             uint64_t offsetInData,
+                             bool     isSplit,
                              uint64_t pRead,
                              bool     doByteSwap,
                              stai_t   stai,
@@ -267,45 +351,78 @@ local_readBlockActualGeneral(FILE     *f,
 
 
 /**
- * @brief  Downcasts an element from 64bit to 32bit.
+ * @brief  Gives the number of elements that fit into the staging buffer.
+ *
+ * @param[in]  numBytesPerElement
+ *                The number of bytes of the staging buffer one element
+ *                needs.
+ * @param[in]  numElements
+ *                The total number of elements to process.
+ *
+ * @return  Returns the number of elements per chunk, this is at least 1
+ *          and not more than @c numElements (unless that is 0).
+ */
+inline static uint64_t
+local_getNumElementsPerChunk(size_t numBytesPerElement, uint64_t numElements);
+
+
+/**
+ * @brief  Gives the staging buffer of a gadget object.
+ *
+ * The buffer is kept with the object, such that it is only allocated
+ * once for all blocks.  It is freed by gadget_del().
+ *
+ * @param[in,out]  gadget
+ *                    The gadget object.
+ * @param[in]      numBytes
+ *                    The required size of the buffer in bytes.
+ *
+ * @return  Returns the buffer, it holds at least @c numBytes bytes.
+ */
+static char *
+local_getStagingBuffer(gadget_t gadget, size_t numBytes);
+
+
+/**
+ * @brief  Downcasts an array of scalars from 64bit to 32bit.
  *
- * @param[in]   eleHi
- *                 The 64bit element (may have multiple components).
- * @param[out]  eleLo
- *                 The 32bit element (may have multiple components).
- * @param[in]   numComponents
- *                 The number of components.
+ * @param[in]   hi
+ *                 The 64bit values.
+ * @param[out]  lo
+ *                 The 32bit values.
+ * @param[in]   numScalars
+ *                 The number of values.
  * @param[in]   isInteger
  *                 Toggles between integer values and floating point values.
  *
  * @return  Returns nothing.
  */
 inline static void
-local_downcastElement(const void *restrict eleHi,
-                      void *restrict       eleLo,
-                      int                  numComponents,
-                      bool                 isInteger);
+local_downcastArray(const void *restrict hi,
+                    void *restrict       lo,
+                    uint64_t             numScalars,
+                    bool                 isInteger);
 
 
 /**
- * @brief  Upcasts an element from 32bit to 64bit.
+ * @brief  Upcasts an array of scalars from 32bit to 64bit.
  *
- * @param[in]   eleLo
- *                 The 32bit element (may have multiple components).
- * @param[out]  eleHi
- *                 The 64bit element (may have multiple components).
- * @param[in]   numComponents
- *                 The number of components.
+ * @param[in]   lo
+ *                 The 32bit values.
+ * @param[out]  hi
+ *                 The 64bit values.
+ * @param[in]   numScalars
+ *                 The number of values.
  * @param[in]   isInteger
  *                 Toggles between integer values and floating point values.
  *
  * @return  Returns nothing.
  */
 inline static void
-local_upcastElement(const void *restrict eleLo,
-                    void *restrict       eleHi,
-                    int                  numComponents,
-                    bool                 isInteger);
+local_upcastArray(const void *restrict lo,
+                  void *restrict       hi,
+                  uint64_t             numScalars,
+                  bool                 isInteger);
 
 
 /*--- Implementations of exported functions -----------------------------*/
@@ -325,6 +442,9 @@ gadget_new(void)
 	gadget->headers     = NULL;
 	gadget->tocs        = NULL;
 
+	gadget->stagingBuffer     = NULL;
+	gadget->stagingBufferSize = 0;
+
 	return gadget;
 }
 
@@ -355,6 +475,9 @@ gadget_del(gadget_t *gadget)
 	if ((*gadget)->numFiles > 0)
 		local_shrinkADTArrays(*gadget, 0);
 
+	if ((*gadget)->stagingBuffer != NULL)
+		xfree((*gadget)->stagingBuffer);
+
 	xfree(*gadget);
 
 	*gadget = NULL;
@@ -615,7 +738,7 @@ gadget_writeBlock(gadget_t      gadget,
 
 		if (pWriteFile > 0) {
 			gadget_open(gadget, GADGET_MODE_WRITE_CONT, i);
-			pWriteFileCheck = gadget_writeBlockToCurrentFile(gadget, i,
+			pWriteFileCheck = gadget_writeBlockToCurrentFile(gadget, block,
 			                                                 pSkipFile,
 			                                                 pWriteFile,
 			                                                 staiClone);
@@ -660,8 +783,8 @@ gadget_writeHeaderToCurrentFile(gadget_t gadget)
 extern uint64_t
 gadget_writeBlockToCurrentFile(gadget_t      gadget,
                                gadgetBlock_t block,
-                               uint32_t      pSkipFile,
-                               uint32_t      pWriteFile,
+                               uint64_t      pSkipFile,
+                               uint64_t      pWriteFile,
                                const stai_t  stai)
 {
 	assert(gadget != NULL);
@@ -678,26 +801,34 @@ gadget_writeBlockToCurrentFile(gadget_t      gadget,
 
 	const gadgetHeader_t head = gadget->headers[gadget->lastOpened];
 	const gadgetTOC_t    toc  = gadget->tocs[gadget->lastOpened];
-	uint32_t             bs   = gadgetTOC_getSizeInBytesForBlock(toc, block);
-	uint32_t             nPiB = gadgetHeader_getNumPartsInBlock(head, block);
+	uint64_t             bs   = gadgetTOC_getSizeInBytesForBlock(toc, block);
 	size_t               sOE  = gadgetHeader_sizeOfElement(head, block);
 	uint32_t             nC   = gadgetBlock_getNumComponents(block);
+	bool                 split;
+	long                 start;
 
-	assert(bs == nPiB * sOE);
-	assert(pSkipFile + pWriteFile <= nPiB);
+	assert(bs == gadgetHeader_getNumPartsInBlock(head, block) * sOE);
+	assert(pSkipFile + pWriteFile <= bs / sOE);
 
 	gadgetTOC_seekToDescriptor(toc, block, gadget->f);
 	gadgetBlock_writeDescriptor(gadget->f, block, bs, gadget->doByteSwap,
 	                            gadget->fileVersion);
 
-	gadgetBlock_writeBlockSize(gadget->f, bs, gadget->doByteSwap);
-	xfseek(gadget->f, pSkipFile * sOE, SEEK_CUR);
+	split = gadgetBlock_isSplitRecord(bs);
+	start = xftell(gadget->f);
+	gadgetBlock_writeRecordMarkers(gadget->f, bs, gadget->doByteSwap);
+	xfseek(gadget->f,
+	       start + (long)gadgetBlock_getRecordOffsetOfData(pSkipFile * sOE,
+	                                                       split),
+	       SEEK_SET);
 
-	local_writeBlockActual(gadget->f, stai, gadget->doByteSwap, pWriteFile,
-	                       sOE, nC, gadgetBlock_isInteger(block));
+	local_writeBlockActual(gadget, pSkipFile * sOE, split, stai,
+	                       gadget->doByteSwap, pWriteFile, sOE, nC,
+	                       gadgetBlock_isInteger(block));
 
-	xfseek(gadget->f, (nPiB - pSkipFile - pWriteFile) * sOE, SEEK_CUR);
-	gadgetBlock_writeBlockSize(gadget->f, bs, gadget->doByteSwap);
+	xfseek(gadget->f,
+	       start + (long)gadgetBlock_getRecordSizeInFile(bs, split),
+	       SEEK_SET);
 
 	return pWriteFile;
 } /* gadget_writeBlockToCurrentFile */
@@ -834,13 +965,15 @@ gadget_readBlockFromCurrentFile(gadget_t      gadget,
 	assert(block != GADGETBLOCK_HEAD);
 	assert(stai != NULL);
 
-	uint32_t             bsF;
+	uint64_t             bsF;
+	bool                 split;
 	const gadgetHeader_t head = gadget->headers[gadget->lastOpened];
 	const gadgetTOC_t    toc  = gadget->tocs[gadget->lastOpened];
-	uint32_t             bs   = gadgetTOC_getSizeInBytesForBlock(toc, block);
-	uint32_t             nPiB = gadgetHeader_getNumPartsInBlock(head, block);
+	uint64_t             bs   = gadgetTOC_getSizeInBytesForBlock(toc, block);
+	uint64_t             nPiB = gadgetHeader_getNumPartsInBlock(head, block);
 	size_t               sOE  = gadgetHeader_sizeOfElement(head, block);
 	uint32_t             nC   = gadgetBlock_getNumComponents(block);
+	long                 start;
 
 	if (bs != nPiB * sOE) {
 		if (bs == nPiB * sOE * 2) {
@@ -853,16 +986,24 @@ gadget_readBlockFromCurrentFile(gadget_t      gadget,
 
 	gadgetTOC_seekToData(toc, block, gadget->f);
 
-	gadgetBlock_readBlockSize(gadget->f, &bsF, gadget->doByteSwap);
-	assert(bsF == bs);
-	xfseek(gadget->f, pSkipFile * sOE, SEEK_CUR);
+	start = xftell(gadget->f);
+	// Whether the block is split is taken from the file, blocks between
+	// 2GB and 4GB may be stored either way.
+	if (!gadgetBlock_skip2(gadget->f, gadget->doByteSwap, &bsF, &split)
+	    || (bsF != bs))
+		diediedie(EXIT_FAILURE);
+	xfseek(gadget->f,
+	       start + (long)gadgetBlock_getRecordOffsetOfData(pSkipFile * sOE,
+	                                                       split),
+	       SEEK_SET);
 
-	local_readBlockActual(gadget->f, stai, gadget->doByteSwap, pReadFile,
-	                      sOE, nC, gadgetBlock_isInteger(block));
+	local_readBlockActual(gadget, pSkipFile * sOE, split, stai,
+	                      gadget->doByteSwap, pReadFile, sOE, nC,
+	                      gadgetBlock_isInteger(block));
 
-	xfseek(gadget->f, (nPiB - pSkipFile - pReadFile) * sOE, SEEK_CUR);
-	gadgetBlock_readBlockSize(gadget->f, &bsF, gadget->doByteSwap);
-	assert(bsF == bs);
+	xfseek(gadget->f,
+	       start + (long)gadgetBlock_getRecordSizeInFile(bs, split),
+	       SEEK_SET);
 
 	return pReadFile;
 } /* gadget_readBlockFromCurrentFile */
@@ -923,16 +1064,70 @@ local_enlargeADTArrays(gadget_t gadget, int numFiles)
 }
 
 inline static void
-local_skipToReqPosInBlock(FILE *f, uint64_t pSkip, size_t sizeOfElement)
+local_writeRecordData(FILE       *f,
+                      const void *data,
+                      uint64_t   numBytes,
+                      uint64_t   *offsetInData,
+                      bool       isSplit)
 {
-	xfseek(f, (long)(pSkip * sizeOfElement), SEEK_CUR);
+	const char *d = data;
+
+	if (!isSplit) {
+		xfwrite(d, 1, numBytes, f);
+		*offsetInData += numBytes;
+		return;
+	}
+
+	while (numBytes > 0) {
+		uint64_t left = GADGETBLOCK_MAX_SUBRECORD_LENGTH
+		                - *offsetInData % GADGETBLOCK_MAX_SUBRECORD_LENGTH;
+		uint64_t num  = (numBytes < left) ? numBytes : left;
+
+		xfwrite(d, 1, num, f);
+		d             += num;
+		numBytes      -= num;
+		*offsetInData += num;
+		if (num == left)
+			xfseek(f, 2L * sizeof(uint32_t), SEEK_CUR);
+	}
 }
 
 inline static void
-local_writeBlockActual(FILE         *f,
+local_readRecordData(FILE     *f,
+                     void     *data,
+                     uint64_t numBytes,
+                     uint64_t *offsetInData,
+                     bool     isSplit)
+{
+	char *d = data;
+
+	if (!isSplit) {
+		xfread(d, 1, numBytes, f);
+		*offsetInData += numBytes;
+		return;
+	}
+
+	while (numBytes > 0) {
+		uint64_t left = GADGETBLOCK_MAX_SUBRECORD_LENGTH
+		                - *offsetInData % GADGETBLOCK_MAX_SUBRECORD_LENGTH;
+		uint64_t num  = (numBytes < left) ? numBytes : left;
+
+		xfread(d, 1, num, f);
+		d             += num;
+		numBytes      -= num;
+		*offsetInData += num;
+		if (num == left)
+			xfseek(f, 2L * sizeof(uint32_t), SEEK_CUR);
+	}
+}
+
+inline static void
+local_writeBlockActual(gadget_t     gadget,
+                       uint64_t     offsetInData,
+                       bool         isSplit,
                        const stai_t stai,
                        bool         doByteSwap,
-                       uint32_t     pWrite,
+                       uint64_t     pWrite,
                        size_t       sizeOfElementFile,
                        int          numComponents,
                        bool         isInteger)
@@ -941,16 +1136,21 @@ local_writeBlockActual(FILE         *f,
 
 	if ((sizeOfElementFile == sizeOfElementStai) && !doByteSwap
 	    && stai_isLinear(stai)) {
-		xfwrite(stai_getBase(stai), sizeOfElementStai, pWrite, f);
+		local_writeRecordData(gadget->f, stai_getBase(stai),
+		                      sizeOfElementStai * pWrite, &offsetInData,
+		                      isSplit);
 	} else {
-		local_writeBlockActualGeneral(f, pWrite, doByteSwap, stai,
+		local_writeBlockActualGeneral(gadget, offsetInData, isSplit, pWrite,
+		                              doByteSwap, stai,
 		                              sizeOfElementFile, sizeOfElementStai,
 		                              numComponents, isInteger);
 	}
 }
 
 static void
-local_writeBlockActualGeneral(FILE         *f,
+local_writeBlockActualGeneral(gadget_t     gadget,
+                              uint64_t     offsetInData,
+                              bool         isSplit,
                               uint64_t     pWrite,
                               bool         doByteSwap,
                               const stai_t stai,
@@ -959,40 +1159,61 @@ local_writeBlockActualGeneral(FILE         *f,
                               int          numComponents,
                               bool         isInteger)
 {
-	char ele[sizeOfElement];
-
-	if (sizeOfElement > sizeOfElementStai) {
-		assert(sizeOfElement == 2 * sizeOfElementStai);
-		char eleStai[sizeOfElementStai];
-		for (uint64_t i = 0; i < pWrite; i++) {
-			stai_getElement(stai, i, eleStai);
-			if (doByteSwap)
-				byteswapVec(eleStai, sizeOfElementStai, numComponents);
-			local_upcastElement(eleStai, ele, numComponents, isInteger);
-			xfwrite(ele, sizeOfElement, 1, f);
-		}
-	} else if (sizeOfElement < sizeOfElementStai) {
-		assert(sizeOfElement * 2 == sizeOfElementStai);
-		char eleStai[sizeOfElementStai];
-		for (uint64_t i = 0; i < pWrite; i++) {
-			stai_getElement(stai, i, eleStai);
-			if (doByteSwap)
-				byteswapVec(eleStai, sizeOfElementStai, numComponents);
-			local_downcastElement(eleStai, ele, numComponents, isInteger);
-			xfwrite(ele, sizeOfElement, 1, f);
-		}
-	} else {
-		for (uint64_t i = 0; i < pWrite; i++) {
-			stai_getElement(stai, i, ele);
-			if (doByteSwap)
-				byteswapVec(ele, sizeOfElement, numComponents);
-			xfwrite(ele, sizeOfElement, 1, f);
+	const bool isLinear  = stai_isLinear(stai);
+	const bool needsStai = (sizeOfElement != sizeOfElementStai) && !isLinear;
+	size_t     numBytes  = sizeOfElement + (needsStai ? sizeOfElementStai : 0);
+	uint64_t   numChunk  = local_getNumElementsPerChunk(numBytes, pWrite);
+	size_t     offsetStai;
+	char       *buf, *bufStai = NULL;
+
+	// Both parts share the staging buffer, the second one is kept aligned
+	// for the casts.
+	numBytes   = numChunk * sizeOfElement;
+	offsetStai = (numBytes + LOCAL_STAGING_BUFFER_ALIGNMENT - 1)
+	             / LOCAL_STAGING_BUFFER_ALIGNMENT
+	             * LOCAL_STAGING_BUFFER_ALIGNMENT;
+	if (needsStai)
+		numBytes = offsetStai + numChunk * sizeOfElementStai;
+	buf = local_getStagingBuffer(gadget, numBytes);
+	if (needsStai)
+		bufStai = buf + offsetStai;
+
+	for (uint64_t first = 0; first < pWrite; first += numChunk) {
+		uint64_t   num = (pWrite - first < numChunk) ? pWrite - first
+		                 : numChunk;
+		const char *src;
+
+		if (sizeOfElement == sizeOfElementStai) {
+			stai_getElementsMulti(stai, first, buf, num);
+		} else {
+			if (isLinear) {
+				src = (const char *)stai_getBase(stai)
+				      + first * sizeOfElementStai;
+			} else {
+				stai_getElementsMulti(stai, first, bufStai, num);
+				src = bufStai;
+			}
+			if (sizeOfElement > sizeOfElementStai) {
+				assert(sizeOfElement == 2 * sizeOfElementStai);
+				local_upcastArray(src, buf, num * numComponents, isInteger);
+			} else {
+				assert(sizeOfElement * 2 == sizeOfElementStai);
+				local_downcastArray(src, buf, num * numComponents,
+				                    isInteger);
+			}
 		}
+		if (doByteSwap)
+			byteswapArray(buf, sizeOfElement / numComponents,
+			              num * numComponents);
+		local_writeRecordData(gadget->f, buf, sizeOfElement * num,
+		                      &offsetInData, isSplit);
 	}
-}
+} /* local_writeBlockActualGeneral */
 
 inline static void
-local_readBlockActual(FILE     *f,
+local_readBlockActual(gadget_t gadget,
+                      uint64_t offsetInData,
+                      bool     isSplit,
                       stai_t   stai,
                       bool     doByteSwap,
                       uint64_t pRead,
@@ -1006,16 +1227,21 @@ local_readBlockActual(FILE     *f,
 
 	if ((!doByteSwap) && stai_isLinear(stai)
 	    && (sizeOfElementFile == sizeOfElementStai)) {
-		xfread(stai_getBase(stai), sizeOfElementFile, pRead, f);
+		local_readRecordData(gadget->f, stai_getBase(stai),
+		                     sizeOfElementFile * pRead, &offsetInData,
+		                     isSplit);
 	} else {
-		local_readBlockActualGeneral(f, pRead, doByteSwap, stai,
+		local_readBlockActualGeneral(gadget, offsetInData, isSplit, pRead,
+		                             doByteSwap, stai,
 		                             sizeOfElementFile, sizeOfElementStai,
 		                             numComponents, isInteger);
 	}
 }
 
 static void
-local_readBlockActualGeneral(FILE     *f,
+local_readBlockActualGeneral(gadget_t gadget,
+                             uint64_t offsetInData,
+                             bool     isSplit,
                              uint64_t pRead,
                              bool     doByteSwap,
                              stai_t   stai,
@@ -1024,64 +1250,114 @@ local_readBlockActualGeneral(FILE     *f,
                              int      numComponents,
                              bool     isInteger)
 {
-	char ele[sizeOfElement];
-
-	if (sizeOfElement > sizeOfElementStai) {
-		assert(sizeOfElement == 2 * sizeOfElementStai);
-		char eleStai[sizeOfElementStai];
-		for (uint64_t i = 0; i < pRead; i++) {
-			xfread(ele, sizeOfElement, 1, f);
-			if (doByteSwap)
-				byteswapVec(ele, sizeOfElement, numComponents);
-			local_downcastElement(ele, eleStai, numComponents, isInteger);
-			stai_setElement(stai, i, eleStai);
+	const bool isLinear  = stai_isLinear(stai);
+	const bool needsStai = (sizeOfElement != sizeOfElementStai) && !isLinear;
+	size_t     numBytes  = sizeOfElement + (needsStai ? sizeOfElementStai : 0);
+	uint64_t   numChunk  = local_getNumElementsPerChunk(numBytes, pRead);
+	size_t     offsetStai;
+	char       *buf, *bufStai = NULL;
+
+	// Both parts share the staging buffer, the second one is kept aligned
+	// for the casts.
+	numBytes   = numChunk * sizeOfElement;
+	offsetStai = (numBytes + LOCAL_STAGING_BUFFER_ALIGNMENT - 1)
+	             / LOCAL_STAGING_BUFFER_ALIGNMENT
+	             * LOCAL_STAGING_BUFFER_ALIGNMENT;
+	if (needsStai)
+		numBytes = offsetStai + numChunk * sizeOfElementStai;
+	buf = local_getStagingBuffer(gadget, numBytes);
+	if (needsStai)
+		bufStai = buf + offsetStai;
+
+	for (uint64_t first = 0; first < pRead; first += numChunk) {
+		uint64_t num = (pRead - first < numChunk) ? pRead - first
+		               : numChunk;
+		char     *trgt;
+
+		local_readRecordData(gadget->f, buf, sizeOfElement * num,
+		                     &offsetInData, isSplit);
+		if (doByteSwap)
+			byteswapArray(buf, sizeOfElement / numComponents,
+			              num * numComponents);
+
+		if (sizeOfElement == sizeOfElementStai) {
+			stai_setElementsMulti(stai, first, buf, num);
+			continue;
 		}
-	} else if (sizeOfElement < sizeOfElementStai) {
-		assert(sizeOfElement * 2 == sizeOfElementStai);
-		char eleStai[sizeOfElementStai];
-		for (uint64_t i = 0; i < pRead; i++) {
-			xfread(ele, sizeOfElement, 1, f);
-			if (doByteSwap)
-				byteswapVec(ele, sizeOfElement, numComponents);
-			local_upcastElement(ele, eleStai, numComponents, isInteger);
-			stai_setElement(stai, i, eleStai);
-		}
-	} else {
-		for (uint64_t i = 0; i < pRead; i++) {
-			xfread(ele, sizeOfElement, 1, f);
-			if (doByteSwap)
-				byteswapVec(ele, sizeOfElement, numComponents);
-			stai_setElement(stai, i, ele);
+
+		trgt = isLinear ? (char *)stai_getBase(stai)
+		       + first * sizeOfElementStai : bufStai;
+		if (sizeOfElement > sizeOfElementStai) {
+			assert(sizeOfElement == 2 * sizeOfElementStai);
+			local_downcastArray(buf, trgt, num * numComponents, isInteger);
+		} else {
+			assert(sizeOfElement * 2 == sizeOfElementStai);
+			local_upcastArray(buf, trgt, num * numComponents, isInteger);
 		}
+		if (!isLinear)
+			stai_setElementsMulti(stai, first, bufStai, num);
+	}
+} /* local_readBlockActualGeneral */
+
+inline static uint64_t
+local_getNumElementsPerChunk(size_t numBytesPerElement, uint64_t numElements)
+{
+	uint64_t num = (LOCAL_STAGING_BUFFER_SIZE_IN_BYTES
+	                - LOCAL_STAGING_BUFFER_ALIGNMENT) / numBytesPerElement;
+
+	if (num > numElements)
+		num = numElements;
+
+	return (num > 0) ? num : 1;
+}
+
+static char *
+local_getStagingBuffer(gadget_t gadget, size_t numBytes)
+{
+	if (numBytes > gadget->stagingBufferSize) {
+		if (gadget->stagingBuffer != NULL)
+			xfree(gadget->stagingBuffer);
+		gadget->stagingBuffer     = xmalloc(numBytes);
+		gadget->stagingBufferSize = numBytes;
 	}
+
+	return gadget->stagingBuffer;
 }
 
 inline static void
-local_downcastElement(const void *restrict eleHi,
-                      void *restrict       eleLo,
-                      int                  numComponents,
-                      bool                 isInteger)
+local_downcastArray(const void *restrict hi,
+                    void *restrict       lo,
+                    uint64_t             numScalars,
+                    bool                 isInteger)
 {
 	if (isInteger) {
-		for (int i = 0; i < numComponents; i++)
-			((uint32_t *)eleLo)[i] = (uint32_t)(((uint64_t *)eleHi)[i]);
+		const uint64_t *h = hi;
+		uint32_t       *l = lo;
+		for (uint64_t i = 0; i < numScalars; i++)
+			l[i] = (uint32_t)(h[i]);
 	} else {
-		for (int i = 0; i < numComponents; i++)
-			((float *)eleLo)[i] = (float)(((double *)eleHi)[i]);
+		const double *h = hi;
+		float        *l = lo;
+		for (uint64_t i = 0; i < numScalars; i++)
+			l[i] = (float)(h[i]);
 	}
 }
 
 inline static void
-local_upcastElement(const void *restrict eleLo,
-                    void *restrict       eleHi,
-                    int                  numComponents,
-                    bool                 isInteger)
+local_upcastArray(const void *restrict lo,
+                  void *restrict       hi,
+                  uint64_t             numScalars,
+                  bool                 isInteger)
 {
 	if (isInteger) {
-		for (int i = 0; i < numComponents; i++)
-			((uint64_t *)eleHi)[i] = (uint64_t)(((uint32_t *)eleLo)[i]);
+		const uint32_t *l = lo;
+		uint64_t       *h = hi;
+		for (uint64_t i = 0; i < numScalars; i++)
+			h[i] = (uint64_t)(l[i]);
 	} else {
-		for (int i = 0; i < numComponents; i++)
-			((double *)eleHi)[i] = (double)(((float *)eleLo)[i]);
+		const float *l = lo;
+		double      *h = hi;
+		for (uint64_t i = 0; i < numScalars; i++)
+			h[i] = (double)(l[i]);
 	}
 }
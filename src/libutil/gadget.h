@@ -488,8 +488,8 @@ gadget_writeHeaderToCurrentFile(gadget_t gadget);
 extern uint64_t
 gadget_writeBlockToCurrentFile(gadget_t      gadget,
                                gadgetBlock_t block,
-                               uint32_t      pSkipFile,
-                               uint32_t      pWriteFile,
+                               uint64_t      pSkipFile,
+                               uint64_t      pWriteFile,
                                const stai_t  stai);
 
 
@@ -40,24 +40,52 @@ static const char *local_blockNames[GADGETBLOCK_NUM]
 /*--- Prototypes of local functions -------------------------------------*/
 
 /**
- * @brief  Skips a block of a given size.
+ * @brief  Skips a block consisting of one record with unsigned block size
+ *         integers.
  *
- * This assumes that the block exists and can be skipped, otherwise the
- * program will terminated with an IO error.
+ * @param[in,out]  *f
+ *                    The file pointer, must be positioned at the leading
+ *                    block size integer.
+ * @param[in]      doByteSwap
+ *                    Indicates whether an endian correction is needed.
+ * @param[out]     *blockSizeInBytes
+ *                    Receives the size of the block in bytes.
+ *
+ * @return  Returns @c true if the block could be skipped, @c false
+ *          otherwise.  The position of the file pointer is undefined in
+ *          the latter case.
+ */
+inline static bool
+local_skipRecord(FILE *f, bool doByteSwap, uint64_t *blockSizeInBytes);
+
+
+/**
+ * @brief  Skips a block that is split into subrecords.
  *
  * @param[in,out]  *f
- *                    The file pointer, must be positioned at the
- *                    beginning of the block (i.e. at the first block
- *                    size integer).
- * @param[in]      blockSize
- *                    The size of the data block that should be skipped.
- *                    This should be size of the actual data without the
- *                    bracketing block size integers.
+ *                    The file pointer, must be positioned at the leading
+ *                    block size integer of the first subrecord.
+ * @param[in]      doByteSwap
+ *                    Indicates whether an endian correction is needed.
+ * @param[out]     *blockSizeInBytes
+ *                    Receives the size of the block in bytes, summed over
+ *                    all subrecords.
+ * @param[out]     *isSplit
+ *                    Receives whether there was more than one subrecord,
+ *                    i.e. whether the first block size integer was
+ *                    negative.
+ *
+ * @return  Returns @c true if the block could be skipped, @c false
+ *          otherwise.  The position of the file pointer is undefined in
+ *          the latter case.
  *
- * @return  Returns nothing.
+ * @sa  #GADGETBLOCK_MAX_SUBRECORD_LENGTH
  */
-inline static void
-local_skipBlockByBlockSize(FILE *f, uint32_t blockSize);
+inline static bool
+local_skipSubrecords(FILE     *f,
+                     bool     doByteSwap,
+                     uint64_t *blockSizeInBytes,
+                     bool     *isSplit);
 
 
 /**
@@ -178,12 +206,12 @@ gadgetBlock_isInteger(const gadgetBlock_t block)
 	return false;
 }
 
-extern uint32_t
+extern uint64_t
 gadgetBlock_getNumPartsInBlock(const gadgetBlock_t block,
                                const uint32_t      np[6],
                                const double        massarr[6])
 {
-	uint32_t numParts = UINT32_C(0);
+	uint64_t numParts = UINT64_C(0);
 
 	switch (block) {
 	case GADGETBLOCK_POS_:
@@ -209,7 +237,7 @@ gadgetBlock_getNumPartsInBlock(const gadgetBlock_t block,
 		numParts = np[4];
 		break;
 	case GADGETBLOCK_Z___:
-		numParts = np[0] + np[4];
+		numParts = (uint64_t)np[0] + np[4];
 		break;
 	default:
 		break;
@@ -221,7 +249,7 @@ gadgetBlock_getNumPartsInBlock(const gadgetBlock_t block,
 extern void
 gadgetBlock_writeDescriptor(FILE            *f,
                             gadgetBlock_t   block,
-                            uint32_t        dataBlockSize,
+                            uint64_t        dataBlockSize,
                             bool            doByteSwap,
                             gadgetVersion_t fileVersion)
 {
@@ -229,7 +257,8 @@ gadgetBlock_writeDescriptor(FILE            *f,
 	assert(block != GADGETBLOCK_UNKNOWN);
 
 	if (fileVersion != GADGETVERSION_ONE) {
-		uint32_t nextBlockSize = dataBlockSize + 8; // Fortran delimiters!
+		// Fortran delimiters!  Wraps around for blocks beyond 4GB.
+		uint32_t nextBlockSize = (uint32_t)(dataBlockSize + 8);
 
 		xfwrite(doByteSwap ? &local_blockSizeSwapped : &local_blockSize,
 		        sizeof(uint32_t), 1, f);
@@ -330,40 +359,39 @@ gadgetBlock_find(FILE            *f,
 extern bool
 gadgetBlock_skip(FILE *f, bool doByteSwap)
 {
-	return gadgetBlock_skip2(f, doByteSwap, NULL);
+	return gadgetBlock_skip2(f, doByteSwap, NULL, NULL);
 }
 
 extern bool
-gadgetBlock_skip2(FILE *f, bool doByteSwap, uint32_t *blockSizeInBytes)
+gadgetBlock_skip2(FILE     *f,
+                  bool     doByteSwap,
+                  uint64_t *blockSizeInBytes,
+                  bool     *isSplit)
 {
 	assert(f != NULL);
 
-	uint32_t bs1, bs2;
+	uint64_t size;
 	long     oldPos = xftell(f);
 	bool     failed = false;
+	bool     split  = false;
 
-	if (fread(&bs1, sizeof(uint32_t), 1, f) != 1) {
-		failed = true;
-	} else {
-		if (doByteSwap)
-			byteswap(&bs1, sizeof(uint32_t));
-		if (fseek(f, (long)bs1, SEEK_CUR) != 0)
-			failed = true;
-		else if (fread(&bs2, sizeof(uint32_t), 1, f) != 1)
-			failed = true;
-		else {
-			if (doByteSwap)
-				byteswap(&bs2, sizeof(uint32_t));
-			if (bs1 != bs2)
-				failed = true;
-		}
+	// Plain records first, this also covers blocks between 2GB and 4GB
+	// that have been written without splitting them.
+	if (!local_skipRecord(f, doByteSwap, &size)) {
+		if (ferror(f))
+			clearerr(f);
+		xfseek(f, oldPos, SEEK_SET);
+		failed = !local_skipSubrecords(f, doByteSwap, &size, &split);
 	}
 	if (failed) {
 		if (ferror(f))
 			clearerr(f);
 		xfseek(f, oldPos, SEEK_SET);
-	} else if (blockSizeInBytes != NULL) {
-		*blockSizeInBytes = bs1;
+	} else {
+		if (blockSizeInBytes != NULL)
+			*blockSizeInBytes = size;
+		if (isSplit != NULL)
+			*isSplit = split;
 	}
 
 	return failed ? false : true;
@@ -404,11 +432,127 @@ gadgetBlock_readBlockSize(FILE *f, uint32_t *blockSize, bool doByteSwap)
 		byteswap(blockSize, sizeof(uint32_t));
 }
 
+extern bool
+gadgetBlock_isSplitRecord(uint64_t dataBlockSize)
+{
+	return (dataBlockSize > UINT32_MAX) ? true : false;
+}
+
+extern void
+gadgetBlock_writeRecordMarkers(FILE     *f,
+                               uint64_t dataBlockSize,
+                               bool     doByteSwap)
+{
+	uint64_t left    = dataBlockSize;
+	bool     isFirst = true;
+
+	assert(f != NULL);
+
+	if (!gadgetBlock_isSplitRecord(dataBlockSize)) {
+		gadgetBlock_writeBlockSize(f, (uint32_t)dataBlockSize, doByteSwap);
+		xfseek(f, (long)dataBlockSize, SEEK_CUR);
+		gadgetBlock_writeBlockSize(f, (uint32_t)dataBlockSize, doByteSwap);
+		return;
+	}
+
+	do {
+		bool     isLast = (left <= GADGETBLOCK_MAX_SUBRECORD_LENGTH);
+		uint32_t len    = (uint32_t)(isLast ? left
+		                             : GADGETBLOCK_MAX_SUBRECORD_LENGTH);
+
+		gadgetBlock_writeBlockSize(f, isLast ? len : UINT32_C(0) - len,
+		                           doByteSwap);
+		xfseek(f, (long)len, SEEK_CUR);
+		gadgetBlock_writeBlockSize(f, isFirst ? len : UINT32_C(0) - len,
+		                           doByteSwap);
+		left   -= len;
+		isFirst = false;
+	} while (left > 0);
+}
+
+extern uint64_t
+gadgetBlock_getRecordSizeInFile(uint64_t dataBlockSize, bool isSplit)
+{
+	uint64_t numSubrecords = 1;
+
+	if (isSplit)
+		numSubrecords = (dataBlockSize + GADGETBLOCK_MAX_SUBRECORD_LENGTH
+		                 - 1) / GADGETBLOCK_MAX_SUBRECORD_LENGTH;
+	if (numSubrecords == 0)
+		numSubrecords = 1;
+
+	return dataBlockSize + numSubrecords * 2 * sizeof(uint32_t);
+}
+
+extern uint64_t
+gadgetBlock_getRecordOffsetOfData(uint64_t offsetInData, bool isSplit)
+{
+	uint64_t numSubrecordsBefore = UINT64_C(0);
+
+	if (isSplit)
+		numSubrecordsBefore = offsetInData / GADGETBLOCK_MAX_SUBRECORD_LENGTH;
+
+	return sizeof(uint32_t) + offsetInData
+	       + numSubrecordsBefore * 2 * sizeof(uint32_t);
+}
+
 /*--- Implementations of local functions --------------------------------*/
-inline static void
-local_skipBlockByBlockSize(FILE *f, uint32_t blockSize)
+inline static bool
+local_skipRecord(FILE *f, bool doByteSwap, uint64_t *blockSizeInBytes)
+{
+	uint32_t bs1, bs2;
+
+	if (fread(&bs1, sizeof(uint32_t), 1, f) != 1)
+		return false;
+	if (doByteSwap)
+		byteswap(&bs1, sizeof(uint32_t));
+	if (fseek(f, (long)bs1, SEEK_CUR) != 0)
+		return false;
+	if (fread(&bs2, sizeof(uint32_t), 1, f) != 1)
+		return false;
+	if (doByteSwap)
+		byteswap(&bs2, sizeof(uint32_t));
+
+	*blockSizeInBytes = bs1;
+
+	return (bs1 == bs2) ? true : false;
+}
+
+inline static bool
+local_skipSubrecords(FILE     *f,
+                     bool     doByteSwap,
+                     uint64_t *blockSizeInBytes,
+                     bool     *isSplit)
 {
-	xfseek(f, (long)blockSize + 4L, SEEK_CUR);
+	bool isFirst = true;
+	bool isLast  = false;
+
+	*blockSizeInBytes = UINT64_C(0);
+
+	while (!isLast) {
+		uint32_t bs1, bs2, len;
+
+		if (fread(&bs1, sizeof(uint32_t), 1, f) != 1)
+			return false;
+		if (doByteSwap)
+			byteswap(&bs1, sizeof(uint32_t));
+		isLast = (bs1 <= (uint32_t)INT32_MAX);
+		len    = isLast ? bs1 : UINT32_C(0) - bs1;
+		if (isFirst)
+			*isSplit = !isLast;
+		if (fseek(f, (long)len, SEEK_CUR) != 0)
+			return false;
+		if (fread(&bs2, sizeof(uint32_t), 1, f) != 1)
+			return false;
+		if (doByteSwap)
+			byteswap(&bs2, sizeof(uint32_t));
+		if (bs2 != (isFirst ? len : UINT32_C(0) - len))
+			return false;
+		*blockSizeInBytes += len;
+		isFirst            = false;
+	}
+
+	return true;
 }
 
 inline static bool
@@ -448,18 +592,17 @@ local_findBlockV2(FILE            *f,
                   gadgetVersion_t version)
 {
 	gadgetBlock_t nextBlock;
-	uint32_t      nextBlockSize;
 	bool          hasNextBlock, found = false;
 
-	hasNextBlock = gadgetBlock_readDescriptor(f, &nextBlock,
-	                                          &nextBlockSize,
+	hasNextBlock = gadgetBlock_readDescriptor(f, &nextBlock, NULL,
 	                                          doByteSwap, version);
 
+	// The size given in the descriptor wraps around for large blocks,
+	// hence skip by the block size integers of the data block.
 	while (hasNextBlock && nextBlock != block) {
-		local_skipBlockByBlockSize(f, nextBlockSize);
-		hasNextBlock = gadgetBlock_readDescriptor(f, &nextBlock,
-		                                          &nextBlockSize,
-		                                          doByteSwap, version);
+		hasNextBlock = gadgetBlock_skip(f, doByteSwap)
+		               && gadgetBlock_readDescriptor(f, &nextBlock, NULL,
+		                                             doByteSwap, version);
 	}
 
 	if (hasNextBlock && (nextBlock == block))
@@ -31,6 +31,17 @@
 /** @brief  Gives the length of the descriptor blocks (1 int, 4 char). */
 #define GADGETBLOCK_DESCRIPTOR_BLOCK_LENGTH 8
 
+/**
+ * @brief  Gives the maximum length of one Fortran subrecord in bytes.
+ *
+ * Blocks with more data are split into several subrecords, following the
+ * convention used by gfortran: The leading block size integer of every
+ * subrecord but the last is negative (as a signed 32bit integer) and so
+ * is the trailing block size integer of every subrecord but the first.
+ * The absolute value always gives the length of the subrecord.
+ */
+#define GADGETBLOCK_MAX_SUBRECORD_LENGTH UINT64_C(2147483639)
+
 
 /*--- Typedefs ----------------------------------------------------------*/
 
@@ -162,7 +173,7 @@ gadgetBlock_isInteger(const gadgetBlock_t block);
  *          block.  if @c block is #GADGETBLOCK_UNKNOWN, @c 0 will be
  *          returned.
  */
-extern uint32_t
+extern uint64_t
 gadgetBlock_getNumPartsInBlock(const gadgetBlock_t block,
                                const uint32_t      np[6],
                                const double        massarr[6]);
@@ -188,7 +199,10 @@ gadgetBlock_getNumPartsInBlock(const gadgetBlock_t block,
  * @param[in]      dataBlockSize
  *                    The size of the actual data block in bytes.  This
  *                    should not include the guarding Fortran delimiters
- *                    of the data block.
+ *                    of the data block.  The descriptor only has room for
+ *                    32bit, for larger blocks the stored value wraps
+ *                    around and readers need to rely on the block size
+ *                    integers of the data block instead.
  * @param[in]      doByteSwap
  *                    Selects whether the binary values need to be byte
  *                    swapped for endianess adjustment.
@@ -204,7 +218,7 @@ gadgetBlock_getNumPartsInBlock(const gadgetBlock_t block,
 extern void
 gadgetBlock_writeDescriptor(FILE            *f,
                             gadgetBlock_t   block,
-                            uint32_t        dataBlockSize,
+                            uint64_t        dataBlockSize,
                             bool            doByteSwap,
                             gadgetVersion_t fileVersion);
 
@@ -282,7 +296,8 @@ gadgetBlock_readDescriptorString(FILE            *f,
  *
  * A block is everything that is encapuslated into a leading and
  * trailing block size integer, which have to be equal and give the size
- * of block in bytes.
+ * of block in bytes.  Blocks that are split into several subrecords (see
+ * #GADGETBLOCK_MAX_SUBRECORD_LENGTH) are skipped as a whole.
  *
  * @param[in,out]  *f
  *                    The file pointer.  Must be positioned at the
@@ -322,8 +337,13 @@ gadgetBlock_skip(FILE *f, bool doByteSwap);
  *                    Indicates whether an endian correction is needed.
  * @param[out]     *blockSizeInBytes
  *                    External variable that will receive the size of the
- *                    block in bytes.  This will only be set if the skipping
- *                    worked.
+ *                    block in bytes, summed over all subrecords.  This will
+ *                    only be set if the skipping worked.
+ * @param[out]     *isSplit
+ *                    Receives whether the block is split into subrecords
+ *                    (@c true) or stored as one record (@c false).  This
+ *                    will only be set if the skipping worked, may be
+ *                    @c NULL.
  *
  * @return  Retruns @c true if the block could be correctly skipped.  In
  *          this case, @c *blockSizeInBytes will also be set correctly.  If
@@ -334,7 +354,10 @@ gadgetBlock_skip(FILE *f, bool doByteSwap);
  *          occur.
  */
 extern bool
-gadgetBlock_skip2(FILE *f, bool doByteSwap, uint32_t *blockSizeInBytes);
+gadgetBlock_skip2(FILE     *f,
+                  bool     doByteSwap,
+                  uint64_t *blockSizeInBytes,
+                  bool     *isSplit);
 
 
 /**
@@ -391,6 +414,80 @@ extern void
 gadgetBlock_readBlockSize(FILE *f, uint32_t *blockSize, bool doByteSwap);
 
 
+/**
+ * @brief  Checks whether a data block of a given size is written split
+ *         into subrecords.
+ *
+ * Blocks that fit the unsigned 32bit block size integers are written as
+ * one record, as Gadget itself does, only larger ones are split into
+ * subrecords of #GADGETBLOCK_MAX_SUBRECORD_LENGTH bytes.
+ *
+ * @param[in]  dataBlockSize
+ *                The size of the data in bytes.
+ *
+ * @return  Returns @c true if the block is split and @c false otherwise.
+ */
+extern bool
+gadgetBlock_isSplitRecord(uint64_t dataBlockSize);
+
+
+/**
+ * @brief  Writes all block size integers of a data block.
+ *
+ * For blocks that are split (see gadgetBlock_isSplitRecord()) this writes
+ * the delimiters of all subrecords, the data part of the subrecords is
+ * skipped and not touched.
+ *
+ * @param[in,out]  *f
+ *                    The file to write to, must be positioned at the
+ *                    leading block size integer.  Will be positioned
+ *                    after the trailing block size integer on return.
+ * @param[in]      dataBlockSize
+ *                    The size of the data in bytes.
+ * @param[in]      doByteSwap
+ *                    Toggles whether the endianess needs to be adjusted
+ *                    (@c true) or not (@c false).
+ *
+ * @return  Returns nothing.
+ */
+extern void
+gadgetBlock_writeRecordMarkers(FILE     *f,
+                               uint64_t dataBlockSize,
+                               bool     doByteSwap);
+
+
+/**
+ * @brief  Calculates how many bytes a data block occupies in the file.
+ *
+ * @param[in]  dataBlockSize
+ *                The size of the data in bytes.
+ * @param[in]  isSplit
+ *                Whether the block is split into subrecords.
+ *
+ * @return  Returns the size of the data plus the size of all block size
+ *          integers.
+ */
+extern uint64_t
+gadgetBlock_getRecordSizeInFile(uint64_t dataBlockSize, bool isSplit);
+
+
+/**
+ * @brief  Calculates the position of a data byte relative to the start
+ *         of the block.
+ *
+ * @param[in]  offsetInData
+ *                The offset of the byte within the data of the block.
+ * @param[in]  isSplit
+ *                Whether the block is split into subrecords.
+ *
+ * @return  Returns the offset of the byte relative to the leading block
+ *          size integer, accounting for the delimiters of all preceeding
+ *          subrecords.
+ */
+extern uint64_t
+gadgetBlock_getRecordOffsetOfData(uint64_t offsetInData, bool isSplit);
+
+
 /** @} */
 
 
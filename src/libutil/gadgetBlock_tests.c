@@ -348,4 +348,120 @@ gadgetBlock_readDescriptorString_test(void)
 	return hasPassed ? true : false;
 }
 
+extern bool
+gadgetBlock_getRecordSizeInFile_test(void)
+{
+	bool           hasPassed = true;
+	int            rank      = 0;
+	const uint64_t max       = GADGETBLOCK_MAX_SUBRECORD_LENGTH;
+#ifdef WITH_MPI
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+#endif
+
+	if (rank == 0)
+		printf("Testing %s... ", __func__);
+
+	if (gadgetBlock_getRecordSizeInFile(0, false) != 8)
+		hasPassed = false;
+	if (gadgetBlock_getRecordSizeInFile(256, false) != 264)
+		hasPassed = false;
+	if (gadgetBlock_getRecordSizeInFile(max + 1, false) != max + 9)
+		hasPassed = false;
+	if (gadgetBlock_getRecordSizeInFile(max, true) != max + 8)
+		hasPassed = false;
+	if (gadgetBlock_getRecordSizeInFile(max + 1, true) != max + 17)
+		hasPassed = false;
+	if (gadgetBlock_getRecordSizeInFile(3 * max, true) != 3 * max + 24)
+		hasPassed = false;
+
+	if (gadgetBlock_getRecordOffsetOfData(0, true) != 4)
+		hasPassed = false;
+	if (gadgetBlock_getRecordOffsetOfData(max - 1, true) != max + 3)
+		hasPassed = false;
+	if (gadgetBlock_getRecordOffsetOfData(max, true) != max + 12)
+		hasPassed = false;
+	if (gadgetBlock_getRecordOffsetOfData(2 * max + 5, true) != 2 * max + 25)
+		hasPassed = false;
+	if (gadgetBlock_getRecordOffsetOfData(max + 5, false) != max + 9)
+		hasPassed = false;
+
+	if (gadgetBlock_isSplitRecord(UINT32_MAX))
+		hasPassed = false;
+	if (!gadgetBlock_isSplitRecord((uint64_t)UINT32_MAX + 1))
+		hasPassed = false;
+
+	return hasPassed ? true : false;
+}
+
+extern bool
+gadgetBlock_writeRecordMarkers_test(void)
+{
+	bool   hasPassed      = true;
+	int    rank           = 0;
+#ifdef XMEM_TRACK_MEM
+	size_t allocatedBytes = global_allocated_bytes;
+#endif
+#ifdef WITH_MPI
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+#endif
+
+	if (rank == 0) {
+		printf("Testing %s... ", __func__);
+
+		FILE     *f;
+		uint64_t sizeRead;
+		uint64_t size = 64;
+		uint64_t sizeLarge;
+		bool     isSplit;
+
+		// One small block, one block that is larger than a subrecord but
+		// still fits a single record and one that needs to be split, the
+		// data part is never written, hence the file is sparse.
+		f = xfopen("TEST_gadgetBlockLarge.dat", "w+b");
+		gadgetBlock_writeRecordMarkers(f, size, true);
+		if (xftell(f) != (long)gadgetBlock_getRecordSizeInFile(size, false))
+			hasPassed = false;
+		size = GADGETBLOCK_MAX_SUBRECORD_LENGTH + 16;
+		gadgetBlock_writeRecordMarkers(f, size, true);
+		if (xftell(f) != (long)(gadgetBlock_getRecordSizeInFile(size, false)
+		                        + 72))
+			hasPassed = false;
+		sizeLarge = (uint64_t)UINT32_MAX + 16;
+		gadgetBlock_writeRecordMarkers(f, sizeLarge, true);
+		if (xftell(f) != (long)(gadgetBlock_getRecordSizeInFile(sizeLarge,
+		                                                        true)
+		                        + gadgetBlock_getRecordSizeInFile(size, false)
+		                        + 72))
+			hasPassed = false;
+
+		rewind(f);
+		if (!gadgetBlock_skip2(f, true, &sizeRead, &isSplit)
+		    || (sizeRead != 64) || isSplit)
+			hasPassed = false;
+		if (!gadgetBlock_skip2(f, true, &sizeRead, &isSplit)
+		    || (sizeRead != size) || isSplit)
+			hasPassed = false;
+		if (!gadgetBlock_skip2(f, true, &sizeRead, &isSplit)
+		    || (sizeRead != sizeLarge) || !isSplit)
+			hasPassed = false;
+		if (gadgetBlock_skip2(f, true, &sizeRead, NULL))
+			hasPassed = false;
+
+		rewind(f);
+		if (gadgetBlock_skip2(f, false, &sizeRead, NULL))
+			hasPassed = false;
+		if (xftell(f) != 0L)
+			hasPassed = false;
+
+		xfclose(&f);
+		remove("TEST_gadgetBlockLarge.dat");
+#ifdef XMEM_TRACK_MEM
+		if (allocatedBytes != global_allocated_bytes)
+			hasPassed = false;
+#endif
+	}
+
+	return hasPassed ? true : false;
+}
+
 /*--- Implementations of local functions --------------------------------*/
@@ -58,6 +58,14 @@ gadgetBlock_writereadDescriptor_test(void);
 extern bool
 gadgetBlock_readDescriptorString_test(void);
 
+/** @brief  Tests gadgetBlock_getRecordSizeInFile(). */
+extern bool
+gadgetBlock_getRecordSizeInFile_test(void);
+
+/** @brief  Tests gadgetBlock_writeRecordMarkers(). */
+extern bool
+gadgetBlock_writeRecordMarkers_test(void);
+
 /*--- Doxygen group definition ------------------------------------------*/
 
 /**
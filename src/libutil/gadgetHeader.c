@@ -513,7 +513,7 @@ gadgetHeader_getTotalNumParts(const gadgetHeader_t header)
 	return totalNumParts;
 }
 
-extern uint32_t
+extern uint64_t
 gadgetHeader_getNumPartsInFile(const gadgetHeader_t gadgetHeader)
 {
 	uint64_t numPartsInFile = UINT64_C(0);
@@ -526,7 +526,7 @@ gadgetHeader_getNumPartsInFile(const gadgetHeader_t gadgetHeader)
 	return numPartsInFile;
 }
 
-extern uint32_t
+extern uint64_t
 gadgetHeader_getNumPartsInFileWithMass(const gadgetHeader_t gadgetHeader)
 {
 	assert(gadgetHeader != NULL);
@@ -536,7 +536,7 @@ gadgetHeader_getNumPartsInFileWithMass(const gadgetHeader_t gadgetHeader)
 	                                      gadgetHeader->massarr);
 }
 
-extern uint32_t
+extern uint64_t
 gadgetHeader_getNumPartsInBlock(const gadgetHeader_t header,
                                 const gadgetBlock_t  block)
 {
@@ -580,11 +580,13 @@ gadgetHeader_write(const gadgetHeader_t gadgetHeader,
                    FILE                 *f,
                    bool                 doByteSwap)
 {
-	static const uint32_t thisBlockSize = GADGETHEADER_SIZE;
+	uint32_t thisBlockSize = GADGETHEADER_SIZE;
 
 	assert(gadgetHeader != NULL);
 	assert(f != NULL);
 
+	if (doByteSwap)
+		byteswap(&thisBlockSize, sizeof(uint32_t));
 	xfwrite(&thisBlockSize, sizeof(uint32_t), 1, f);
 	if (doByteSwap) {
 		gadgetHeader_t copy = gadgetHeader_clone(gadgetHeader);
@@ -607,6 +609,8 @@ gadgetHeader_read(gadgetHeader_t gadgetHeader, FILE *f, bool doByteSwap)
 
 	gadgetBlock_readBlockSize(f, &blockSize1, doByteSwap);
 	local_actualReadHeader(gadgetHeader, f);
+	if (doByteSwap)
+		local_byteswapHeader(gadgetHeader);
 	gadgetBlock_readBlockSize(f, &blockSize2, doByteSwap);
 
 	if (blockSize1 != blockSize2) {
@@ -631,7 +635,7 @@ gadgetHeader_prettyPrint(const gadgetHeader_t header,
 
 	gadgetHeader_getNall(header, nall);
 
-	fprintf(f, "%sNumber of particles in file (sum: %" PRIu32 "):\n",
+	fprintf(f, "%sNumber of particles in file (sum: %" PRIu64 "):\n",
 	        p, gadgetHeader_getNumPartsInFile(header));
 	fprintf(f, "%s  Gas:    %" PRIu32 "\n", p, header->np[LOCAL_GAS]);
 	fprintf(f, "%s  Halo:   %" PRIu32 "\n", p, header->np[LOCAL_HALO]);
@@ -754,7 +754,7 @@ gadgetHeader_getTotalNumParts(const gadgetHeader_t header);
  *
  * @sa gadgetHeader_getNp()
  */
-extern uint32_t
+extern uint64_t
 gadgetHeader_getNumPartsInFile(const gadgetHeader_t gadgetHeader);
 
 
@@ -770,7 +770,7 @@ gadgetHeader_getNumPartsInFile(const gadgetHeader_t gadgetHeader);
  *
  * @sa gadgetHeader_getNumPartsInBlock(), gadgetBlock_getNumPartsInBlock()
  */
-extern uint32_t
+extern uint64_t
 gadgetHeader_getNumPartsInFileWithMass(const gadgetHeader_t gadgetHeader);
 
 
@@ -790,7 +790,7 @@ gadgetHeader_getNumPartsInFileWithMass(const gadgetHeader_t gadgetHeader);
  *
  * @sq gadgetBlock_getNumPartsInBlock()
  */
-extern uint32_t
+extern uint64_t
 gadgetHeader_getNumPartsInBlock(const gadgetHeader_t header,
                                 const gadgetBlock_t  block);
 
@@ -197,14 +197,14 @@ gadgetTOC_getOffsetForBlock(const gadgetTOC_t toc, gadgetBlock_t block)
 	return -1L;
 }
 
-extern uint32_t
+extern uint64_t
 gadgetTOC_getSizeInBytesForBlock(const gadgetTOC_t toc, gadgetBlock_t block)
 {
 	for (int i = 0; i < toc->numBlocks; i++) {
 		if (toc->blocks[i].type == block)
 			return toc->blocks[i].sizeInBytes;
 	}
-	return UINT32_C(0);
+	return UINT64_C(0);
 }
 
 extern const char *
@@ -236,7 +236,7 @@ gadgetTOC_getTypeBySeqNumber(const gadgetTOC_t toc, int seqNumber)
 	return toc->blocks[seqNumber].type;
 }
 
-extern uint32_t
+extern uint64_t
 gadgetTOC_getSizeInBytesBySeqNumber(const gadgetTOC_t toc, int seqNumber)
 {
 	assert(toc != NULL);
@@ -260,7 +260,9 @@ gadgetTOC_getTotalFileSize(const gadgetTOC_t toc)
 	assert(toc != NULL);
 
 	return toc->blocks[toc->numBlocks - 1].offset
-	       + gadgetTOC_getSizeInBytesBySeqNumber(toc, toc->numBlocks - 1);
+	       + gadgetBlock_getRecordSizeInFile(
+	    toc->blocks[toc->numBlocks - 1].sizeInBytes,
+	    toc->blocks[toc->numBlocks - 1].isSplit);
 }
 
 extern void
@@ -274,7 +276,8 @@ gadgetTOC_addEntryByName(gadgetTOC_t toc, const char *name)
 
 		entry.offset           = -1;
 		entry.type             = gadgetBlock_getTypeFromName(name);
-		entry.sizeInBytes      = UINT32_C(0);
+		entry.sizeInBytes      = UINT64_C(0);
+		entry.isSplit          = false;
 		memcpy(entry.nameInV2Files, name, 4);
 		entry.nameInV2Files[4] = '\0';
 
@@ -293,7 +296,8 @@ gadgetTOC_addEntryByType(gadgetTOC_t toc, gadgetBlock_t type)
 
 		entry.offset           = -1;
 		entry.type             = type;
-		entry.sizeInBytes      = UINT32_C(0);
+		entry.sizeInBytes      = UINT64_C(0);
+		entry.isSplit          = false;
 		memcpy(entry.nameInV2Files, gadgetBlock_getNameFromType(type), 4);
 		entry.nameInV2Files[4] = '\0';
 
@@ -313,7 +317,8 @@ gadgetTOC_calcSizes(gadgetTOC_t    toc,
 		if (type == GADGETBLOCK_HEAD) {
 			toc->blocks[i].sizeInBytes = GADGETHEADER_SIZE;
 		} else {
-			uint32_t numParticles, sizePerParticle;
+			uint64_t numParticles;
+			uint32_t sizePerParticle;
 			numParticles    = gadgetBlock_getNumPartsInBlock(type,
 			                                                 np,
 			                                                 massarr);
@@ -324,6 +329,8 @@ gadgetTOC_calcSizes(gadgetTOC_t    toc,
 				sizePerParticle *= useDoublePrec ? 8 : 4;
 			toc->blocks[i].sizeInBytes = numParticles * sizePerParticle;
 		}
+		toc->blocks[i].isSplit = gadgetBlock_isSplitRecord(
+		    toc->blocks[i].sizeInBytes);
 	}
 }
 
@@ -338,7 +345,8 @@ gadgetTOC_calcOffset(gadgetTOC_t toc)
 		if (toc->fileVersion != GADGETVERSION_ONE)
 			curOffset += 4 + GADGETBLOCK_DESCRIPTOR_BLOCK_LENGTH  + 4;
 		toc->blocks[i].offset = curOffset;
-		curOffset            += 4 + toc->blocks[i].sizeInBytes + 4;
+		curOffset            += (long)gadgetBlock_getRecordSizeInFile(
+		    toc->blocks[i].sizeInBytes, toc->blocks[i].isSplit);
 	}
 }
 
@@ -376,7 +384,8 @@ gadgetTOC_isValid(const gadgetTOC_t toc)
 			return false;
 
 		expectedMinOffset = toc->blocks[i].offset
-		                    + toc->blocks[i].sizeInBytes + 8;
+		                    + (long)gadgetBlock_getRecordSizeInFile(
+		    toc->blocks[i].sizeInBytes, toc->blocks[i].isSplit);
 	}
 
 	return true;
@@ -393,7 +402,7 @@ gadgetTOC_prettyPrint(const gadgetTOC_t toc, FILE *out, const char *prefix)
 	fprintf(out, "%sTable of Content (%i entries)\n",
 	        actualPrefix, toc->numBlocks);
 	for (int i = 0; i < toc->numBlocks; i++)
-		fprintf(out, "%s\t%i  Offset: %li  type: %s  size: %" PRIu32
+		fprintf(out, "%s\t%i  Offset: %li  type: %s  size: %" PRIu64
 		        "b  name: %s\n",
 		        actualPrefix, i,
 		        toc->blocks[i].offset,
@@ -424,17 +433,20 @@ local_newFromFileActual(gadgetTOC_t     toc,
 	struct gadgetTOC_entry_struct entry;
 	while (true) {
 		if (version == GADGETVERSION_TWO) {
+			// The size in the descriptor wraps around for large blocks,
+			// so the size is taken from the data block itself.
 			if (!gadgetBlock_readDescriptorString(f, entry.nameInV2Files,
-			                                      &(entry).sizeInBytes,
-			                                      doByteSwap, version))
+			                                      NULL, doByteSwap, version))
 				break;
 			entry.offset = xftell(f);
 			entry.type   = gadgetBlock_getTypeFromName(entry.nameInV2Files);
-			if (!gadgetBlock_skip(f, doByteSwap))
+			if (!gadgetBlock_skip2(f, doByteSwap, &(entry.sizeInBytes),
+			                       &(entry.isSplit)))
 				break;
 		} else {
 			entry.offset = xftell(f);
-			if (!gadgetBlock_skip2(f, doByteSwap, &(entry.sizeInBytes)))
+			if (!gadgetBlock_skip2(f, doByteSwap, &(entry.sizeInBytes),
+			                       &(entry.isSplit)))
 				break;
 			entry.type = (gadgetBlock_t)(toc->numBlocks);
 			memcpy(entry.nameInV2Files,
@@ -187,7 +187,7 @@ gadgetTOC_getOffsetForBlock(const gadgetTOC_t toc, gadgetBlock_t block);
  * @return  Returns the size of the requested block.  This may be @c 0, if
  *          the block does not exist in the TOC or the size is unknown.
  */
-extern uint32_t
+extern uint64_t
 gadgetTOC_getSizeInBytesForBlock(const gadgetTOC_t toc, gadgetBlock_t block);
 
 
@@ -249,7 +249,7 @@ gadgetTOC_getTypeBySeqNumber(const gadgetTOC_t toc, int seqNumber);
  *
  * @return  Returns the size of the block in bytes.
  */
-extern uint32_t
+extern uint64_t
 gadgetTOC_getSizeInBytesBySeqNumber(const gadgetTOC_t toc, int seqNumber);
 
 
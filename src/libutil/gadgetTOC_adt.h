@@ -37,7 +37,9 @@ struct gadgetTOC_entry_struct {
 	/** @brief  The bock type. */
 	gadgetBlock_t type;
 	/** @brief  The size of the block in bytes. */
-	uint32_t      sizeInBytes;
+	uint64_t      sizeInBytes;
+	/** @brief  Whether the block is split into subrecords. */
+	bool          isSplit;
 	/** @brief  The name of the block in Gadget V2 files. */
 	char          nameInV2Files[5];
 };
@@ -49,6 +49,10 @@ struct gadget_struct {
 	gadgetHeader_t  *headers;
 	/** @brief An array of length #numFiles holding the TOC of each file. */
 	gadgetTOC_t     *tocs;
+	/** @brief The buffer for converting data, allocated on first use. */
+	char            *stagingBuffer;
+	/** @brief The size of #stagingBuffer in bytes. */
+	size_t          stagingBufferSize;
 };
 
 #endif
@@ -43,6 +43,9 @@ local_getGadgetSimpleRead(void);
 static gadget_t
 local_getGadgetSimpleWrite(void);
 
+static bool
+local_writeAndReadBlocks(endian_t endianess);
+
 
 /*--- Implementations of exported functions -----------------------------*/
 extern bool
@@ -296,6 +299,139 @@ gadget_writeBlockToCurrentFile_test(void)
 	return hasPassed ? true : false;
 } /* gadget_writeBlockToCurrentFile_test */
 
+extern bool
+gadget_readBlockFromCurrentFile_test(void)
+{
+	bool   hasPassed = true;
+	int    rank      = 0;
+#ifdef XMEM_TRACK_MEM
+	size_t allocatedBytes = global_allocated_bytes;
+#endif
+#ifdef WITH_MPI
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+#endif
+
+	if (rank == 0)
+		printf("Testing %s... ", __func__);
+
+	if (!local_writeAndReadBlocks(ENDIAN_LITTLE))
+		hasPassed = false;
+	if (!local_writeAndReadBlocks(ENDIAN_BIG))
+		hasPassed = false;
+	remove("TEST_gadget_reading.dat");
+
+#ifdef XMEM_TRACK_MEM
+	if (allocatedBytes != global_allocated_bytes)
+		hasPassed = false;
+#endif
+
+	return hasPassed ? true : false;
+} /* gadget_readBlockFromCurrentFile_test */
+
+extern bool
+gadget_readLargeBlock_test(void)
+{
+	bool     hasPassed = true;
+	int      rank      = 0;
+	// The position block is larger than a subrecord, but is still stored
+	// as a single record.
+	uint32_t np[6]      = {0, 178956971, 0, 0, 0, 0};
+	uint64_t nall[6]    = {0, 178956971, 0, 0, 0, 0};
+	double   massarr[6] = {0.0, 1.0, 0.0, 0.0, 0.0, 0.0};
+#ifdef XMEM_TRACK_MEM
+	size_t   allocatedBytes = global_allocated_bytes;
+#endif
+#ifdef WITH_MPI
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+#endif
+
+	if (rank == 0) {
+		printf("Testing %s... ", __func__);
+
+		gadget_t       gadget;
+		gadgetHeader_t header;
+		gadgetTOC_t    toc;
+		stai_t         stai;
+		float          pos[4][3];
+		uint32_t       ids[4];
+		const uint64_t pSkip = np[1] - 4;
+
+		for (int i = 0; i < 4; i++) {
+			for (int j = 0; j < 3; j++)
+				pos[i][j] = (float)(i * 3 + j) + 0.5f;
+			ids[i] = (uint32_t)(pSkip + i);
+		}
+
+		// Only the last particles are written, hence the file is sparse.
+		remove("TEST_gadget_large.dat");
+		gadget = gadget_newSimple("TEST_gadget_large.dat", 1);
+		header = gadgetHeader_new();
+		gadgetHeader_setNp(header, np);
+		gadgetHeader_setMassArr(header, massarr);
+		gadgetHeader_setNall(header, nall);
+		gadgetHeader_setNumFiles(header, 1);
+		gadget_setHeaderOfFile(gadget, 0, header);
+		toc = gadgetTOC_new();
+		gadgetTOC_setFileVersion(toc, GADGETVERSION_TWO);
+		gadgetTOC_addEntryByType(toc, GADGETBLOCK_HEAD);
+		gadgetTOC_addEntryByType(toc, GADGETBLOCK_POS_);
+		gadgetTOC_addEntryByType(toc, GADGETBLOCK_ID__);
+		gadgetTOC_calcSizes(toc, np, massarr, false, false);
+		gadgetTOC_calcOffset(toc);
+		gadget_setTOCOfFile(gadget, 0, toc);
+		gadget_setFileVersion(gadget, GADGETVERSION_TWO);
+		gadget_open(gadget, GADGET_MODE_WRITE_CONT, 0);
+		gadget_writeHeaderToCurrentFile(gadget);
+		stai = stai_new(pos, 3 * sizeof(float), 3 * sizeof(float));
+		gadget_writeBlockToCurrentFile(gadget, GADGETBLOCK_POS_, pSkip, 4,
+		                               stai);
+		stai_del(&stai);
+		stai = stai_new(ids, sizeof(uint32_t), sizeof(uint32_t));
+		gadget_writeBlockToCurrentFile(gadget, GADGETBLOCK_ID__, pSkip, 4,
+		                               stai);
+		stai_del(&stai);
+		gadget_close(gadget);
+		gadget_del(&gadget);
+
+		memset(pos, 0, sizeof(pos));
+		memset(ids, 0, sizeof(ids));
+		gadget = gadget_newSimple("TEST_gadget_large.dat", 1);
+		gadget_initForRead(gadget);
+		toc = gadget_getTOCOfFile(gadget, 0);
+		if (gadgetTOC_getSizeInBytesForBlock(toc, GADGETBLOCK_POS_)
+		    != (uint64_t)np[1] * 3 * sizeof(float))
+			hasPassed = false;
+		gadget_open(gadget, GADGET_MODE_READ, 0);
+		stai = stai_new(pos, 3 * sizeof(float), 3 * sizeof(float));
+		gadget_readBlockFromCurrentFile(gadget, GADGETBLOCK_POS_, pSkip, 4,
+		                                stai);
+		stai_del(&stai);
+		stai = stai_new(ids, sizeof(uint32_t), sizeof(uint32_t));
+		gadget_readBlockFromCurrentFile(gadget, GADGETBLOCK_ID__, pSkip, 4,
+		                                stai);
+		stai_del(&stai);
+		gadget_close(gadget);
+		gadget_del(&gadget);
+
+		for (int i = 0; i < 4; i++) {
+			for (int j = 0; j < 3; j++) {
+				if (pos[i][j] != (float)(i * 3 + j) + 0.5f)
+					hasPassed = false;
+			}
+			if (ids[i] != (uint32_t)(pSkip + i))
+				hasPassed = false;
+		}
+		remove("TEST_gadget_large.dat");
+	}
+
+#ifdef XMEM_TRACK_MEM
+	if (allocatedBytes != global_allocated_bytes)
+		hasPassed = false;
+#endif
+
+	return hasPassed ? true : false;
+} /* gadget_readLargeBlock_test */
+
 /*--- Implementations of local functions --------------------------------*/
 static gadget_t
 local_getGadgetSimpleRead(void)
@@ -340,3 +476,103 @@ local_getGadgetSimpleWrite(void)
 	// Done
 	return gadget;
 }
+
+static bool
+local_writeAndReadBlocks(endian_t endianess)
+{
+	bool           hasPassed = true;
+	gadget_t       gadget;
+	gadgetHeader_t header;
+	stai_t         stai;
+	float          dataF[20][4];
+	double         dataD[20][3];
+	uint64_t       ids[20];
+	uint32_t       np[6]      = {10, 10, 0, 0, 0, 0};
+	double         massarr[6] = {0.0, 1.0, 0.0, 0.0, 0.0, 0.0};
+
+	for (int i = 0; i < 20; i++) {
+		for (int j = 0; j < 4; j++)
+			dataF[i][j] = (float)(i * 4 + j) + 0.25f;
+		ids[i] = (uint64_t)(1000 + i);
+	}
+
+	// Write a double precision file from strided float data and linear
+	// 64bit IDs, this exercises the up- and downcasting paths.
+	gadget = local_getGadgetSimpleWrite();
+	header = gadget_getHeaderOfFile(gadget, 0);
+	gadgetHeader_setFlagDoublePrecision(header, 1);
+	gadgetTOC_calcSizes(gadget_getTOCOfFile(gadget, 0), np, massarr,
+	                    true, false);
+	gadgetTOC_calcOffset(gadget_getTOCOfFile(gadget, 0));
+	gadget_setFileNamesFromStem(gadget, "TEST_gadget_reading.dat");
+	gadget_setFileVersion(gadget, GADGETVERSION_TWO);
+	gadget_setFileEndianess(gadget, endianess);
+	gadget_createEmptyFile(gadget, 0);
+	gadget_open(gadget, GADGET_MODE_WRITE_CONT, 0);
+	gadget_writeHeaderToCurrentFile(gadget);
+	stai = stai_new(&(dataF[0][0]), 3 * sizeof(float), 4 * sizeof(float));
+	gadget_writeBlockToCurrentFile(gadget, GADGETBLOCK_POS_, 0, 20, stai);
+	gadget_writeBlockToCurrentFile(gadget, GADGETBLOCK_VEL_, 0, 20, stai);
+	stai_del(&stai);
+	stai = stai_new(ids, sizeof(uint64_t), sizeof(uint64_t));
+	gadget_writeBlockToCurrentFile(gadget, GADGETBLOCK_ID__, 0, 20, stai);
+	stai_del(&stai);
+	stai = stai_new(&(dataF[0][3]), sizeof(float), 4 * sizeof(float));
+	gadget_writeBlockToCurrentFile(gadget, GADGETBLOCK_MASS, 0, 10, stai);
+	stai_del(&stai);
+	gadget_close(gadget);
+	gadget_del(&gadget);
+
+	// Read back, once into a linear double array, once into a strided
+	// float array.  A file not in system endianess is byteswapped.
+	gadget = gadget_newSimple("TEST_gadget_reading.dat", 1);
+	gadget_initForRead(gadget);
+	gadget_open(gadget, GADGET_MODE_READ, 0);
+	if (gadget->doByteSwap != (endianess != endian_getSystemEndianess()))
+		hasPassed = false;
+	stai = stai_new(&(dataD[0][0]), 3 * sizeof(double), 3 * sizeof(double));
+	gadget_readBlockFromCurrentFile(gadget, GADGETBLOCK_POS_, 0, 20, stai);
+	stai_del(&stai);
+	for (int i = 0; i < 20; i++) {
+		for (int j = 0; j < 3; j++) {
+			if (dataD[i][j] != (double)dataF[i][j])
+				hasPassed = false;
+			dataF[i][j] = 0.0f;
+		}
+	}
+	stai = stai_new(&(dataF[0][0]), 3 * sizeof(float), 4 * sizeof(float));
+	gadget_readBlockFromCurrentFile(gadget, GADGETBLOCK_VEL_, 0, 20, stai);
+	stai_del(&stai);
+	for (int i = 0; i < 20; i++) {
+		for (int j = 0; j < 3; j++) {
+			if ((double)dataF[i][j] != dataD[i][j])
+				hasPassed = false;
+		}
+		ids[i] = 0;
+	}
+	stai = stai_new(ids, sizeof(uint64_t), sizeof(uint64_t));
+	gadget_readBlockFromCurrentFile(gadget, GADGETBLOCK_ID__, 0, 20, stai);
+	stai_del(&stai);
+	for (int i = 0; i < 20; i++) {
+		if (ids[i] != (uint64_t)(1000 + i))
+			hasPassed = false;
+	}
+	stai = stai_new(&(dataD[0][0]), sizeof(double), 3 * sizeof(double));
+	gadget_readBlockFromCurrentFile(gadget, GADGETBLOCK_MASS, 0, 10, stai);
+	stai_del(&stai);
+	for (int i = 0; i < 10; i++) {
+		if (dataD[i][0] != (double)dataF[i][3])
+			hasPassed = false;
+	}
+	// The conversions share one staging buffer of at most 4MB.
+	if ((gadget->stagingBuffer == NULL)
+	    || (gadget->stagingBufferSize > (1 << 22)))
+		hasPassed = false;
+	gadget_close(gadget);
+
+	gadget_del(&gadget);
+	if (gadget != NULL)
+		hasPassed = false;
+
+	return hasPassed;
+} /* local_writeAndReadBlocks */
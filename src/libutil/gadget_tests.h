@@ -42,6 +42,17 @@ gadget_writeHeaderToCurrentFile_test(void);
 extern bool
 gadget_writeBlockToCurrentFile_test(void);
 
+/** @brief  Tests gadget_readBlockFromCurrentFile(). */
+extern bool
+gadget_readBlockFromCurrentFile_test(void);
+
+/**
+ * @brief  Tests reading a block that is stored as one record, but is
+ *         larger than a subrecord.
+ */
+extern bool
+gadget_readLargeBlock_test(void);
+
 
 /*--- Doxygen group definition ------------------------------------------*/
 
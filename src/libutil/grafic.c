@@ -73,6 +73,7 @@ local_writeWindowedActualRead(const grafic_t           grafic,
                               int                      numComponents,
                               const uint32_t *restrict idxLo,
                               const uint32_t *restrict dims,
+                              uint32_t                 rowStride,
                               bool                     doByteswap);
 
 static void
@@ -102,6 +103,9 @@ local_skipRow(FILE *f, long numInRow);
 static void
 local_writeHeader(grafic_t grafic, FILE *f);
 
+static void
+local_closeSlabFile(grafic_t grafic);
+
 static void
 local_writePlane(FILE           *f,
                  const void     *data,
@@ -133,6 +137,8 @@ grafic_new(void)
 	grafic->omegav           = 0.0f;
 	grafic->h0               = 0.0f;
 	grafic->iseed            = 0;
+	grafic->slabFile         = NULL;
+	grafic->slabFilePos      = -1;
 
 	grafic_setIsWhiteNoise(grafic, false);
 
@@ -166,6 +172,7 @@ grafic_del(grafic_t *grafic)
 {
 	assert(grafic != NULL && *grafic != NULL);
 
+	local_closeSlabFile(*grafic);
 	if ((*grafic)->graficFileName != NULL)
 		xfree((*grafic)->graficFileName);
 	xfree(*grafic);
@@ -271,6 +278,7 @@ grafic_setFileName(grafic_t grafic, const char *fileName)
 	assert(grafic != NULL);
 	assert(fileName != NULL);
 
+	local_closeSlabFile(grafic);
 	if (grafic->graficFileName != NULL)
 		xfree(grafic->graficFileName);
 
@@ -394,6 +402,7 @@ grafic_makeEmptyFile(const grafic_t grafic)
 	fileSize  += grafic->headerSkip + 8;
 	xfile_createFileWithSize(grafic->graficFileName, fileSize);
 
+	local_closeSlabFile(grafic);
 	f = xfopen(grafic->graficFileName, "w+b");
 	local_writeHeader(grafic, f);
 	b = (int)(numInPlane * sizeof(float));
@@ -460,6 +469,7 @@ grafic_write(const grafic_t grafic,
 
 	numPlane = grafic->np1 * grafic->np2;
 
+	local_closeSlabFile(grafic);
 	f        = xfopen(grafic->graficFileName, "wb");
 
 	local_writeHeader(grafic, f);
@@ -513,6 +523,21 @@ grafic_writeWindowed(const grafic_t           grafic,
                      int                      numComponents,
                      const uint32_t *restrict idxLo,
                      const uint32_t *restrict dims)
+{
+	assert(dims != NULL);
+
+	grafic_writeWindowedStrided(grafic, data, dataFormat, numComponents,
+	                            idxLo, dims, dims[0]);
+}
+
+extern void
+grafic_writeWindowedStrided(const grafic_t           grafic,
+                            const void *restrict     data,
+                            graficFormat_t           dataFormat,
+                            int                      numComponents,
+                            const uint32_t *restrict idxLo,
+                            const uint32_t *restrict dims,
+                            uint32_t                 rowStride)
 {
 	bool doByteswap;
 
@@ -522,6 +547,7 @@ grafic_writeWindowed(const grafic_t           grafic,
 	assert(idxLo != NULL);
 	assert(dims != NULL);
 	assert(dims[0] > 0 && dims[1] > 0 && dims[2] > 0);
+	assert(rowStride >= dims[0]);
 
 	if ((idxLo[0] + dims[0] > grafic->np1)
 	    || (idxLo[1] + dims[1] > grafic->np2)
@@ -533,7 +559,7 @@ grafic_writeWindowed(const grafic_t           grafic,
 	doByteswap = grafic->machineEndianess != grafic->fileEndianess;
 
 	local_writeWindowedActualRead(grafic, data, dataFormat, numComponents,
-	                              idxLo, dims, doByteswap);
+	                              idxLo, dims, rowStride, doByteswap);
 }
 
 extern void
@@ -554,9 +580,13 @@ grafic_readSlab(grafic_t       grafic,
 
 	numInPlane = grafic->np1 * grafic->np2;
 	doByteswap = grafic->machineEndianess != grafic->fileEndianess;
-	f          = xfopen(grafic->graficFileName, "rb");
-	xfseek(f, grafic->headerSkip + 8L, SEEK_SET);
-	xfseek(f, (numInPlane * sizeof(float) + 8L) * slabNum, SEEK_CUR);
+	if (grafic->slabFile == NULL)
+		grafic->slabFile = xfopen(grafic->graficFileName, "rb");
+	f = grafic->slabFile;
+	if (grafic->slabFilePos != slabNum) {
+		xfseek(f, grafic->headerSkip + 8L, SEEK_SET);
+		xfseek(f, (numInPlane * sizeof(float) + 8L) * slabNum, SEEK_CUR);
+	}
 	if ((dataFormat == GRAFIC_FORMAT_FLOAT)
 	    && (numComponents == 1)) {
 		local_readPlane(((float *)data), numInPlane, f, doByteswap);
@@ -567,7 +597,7 @@ grafic_readSlab(grafic_t       grafic,
 		                               numInPlane, f, doByteswap);
 		xfree(buffer);
 	}
-	xfclose(&f);
+	grafic->slabFilePos = slabNum + 1;
 }
 
 /*--- Implementations of local functions --------------------------------*/
@@ -659,8 +689,7 @@ local_readPlane(float *data, size_t numInPlane, FILE *f, bool doByteswap)
 		diediedie(EXIT_FAILURE);
 
 	if (doByteswap)
-		for (size_t i = 0; i < numInPlane; i++)
-			byteswap(data + i, sizeof(float));
+		byteswapArray(data, sizeof(float), numInPlane);
 }
 
 static void *
@@ -741,12 +770,14 @@ local_writeWindowedActualRead(const grafic_t           grafic,
                               int                      numComponents,
                               const uint32_t *restrict idxLo,
                               const uint32_t *restrict dims,
+                              uint32_t                 rowStride,
                               bool                     doByteswap)
 {
 	FILE   *f;
 	float  *buffer    = xmalloc(sizeof(float) * dims[0]);
 	size_t dataOffset = 0;
 
+	local_closeSlabFile(grafic);
 	f = xfopen(grafic->graficFileName, "r+b");
 	xfseek(f, grafic->headerSkip + 8L, SEEK_SET);
 	for (uint32_t k = 0; k < idxLo[2]; k++)
@@ -761,7 +792,7 @@ local_writeWindowedActualRead(const grafic_t           grafic,
 				xfseek(f, sizeof(float) * idxLo[0], SEEK_CUR);
 			local_cpDataToBuffer(buffer, dims[0], data, dataFormat,
 			                     numComponents, dataOffset, doByteswap);
-			dataOffset += dims[0];
+			dataOffset += rowStride;
 			xfwrite(buffer, sizeof(float), dims[0], f);
 			if (grafic->np1 - dims[0] - idxLo[0] > 0)
 				xfseek(f, sizeof(float) * (grafic->np1 - dims[0] - idxLo[0]),
@@ -883,6 +914,14 @@ local_writeHeader(grafic_t grafic, FILE *f)
 	}
 }
 
+static void
+local_closeSlabFile(grafic_t grafic)
+{
+	if (grafic->slabFile != NULL)
+		xfclose(&(grafic->slabFile));
+	grafic->slabFilePos = -1;
+}
+
 static void
 local_writePlane(FILE           *f,
                  const void     *data,
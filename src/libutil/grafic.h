@@ -494,9 +494,48 @@ grafic_writeWindowed(const grafic_t           grafic,
                      const uint32_t *restrict idxLo,
                      const uint32_t *restrict dims);
 
+/**
+ * @brief  Writes a selection into the file, taking the rows of the data
+ *         array from a fixed stride.
+ *
+ * This is grafic_writeWindowed() for data arrays whose rows are padded,
+ * e.g. for in-place FFTs; the padding is not written.
+ *
+ * @param[in]  grafic
+ *                The file object to work with.
+ * @param[in]  data
+ *                The array to write.
+ * @param[in]  dataFormat
+ *                The format of the data array.
+ * @param[in]  numComponents
+ *                The number of components in the data array.
+ * @param[in]  *idxLo
+ *                The lower left corner of the window.
+ * @param[in]  *dims
+ *                The size of the window.
+ * @param[in]  rowStride
+ *                The distance (in elements) between the starts of two
+ *                consecutive rows in the data array.  Must be at least
+ *                @c dims[0].
+ *
+ * @return  Returns nothing.
+ */
+extern void
+grafic_writeWindowedStrided(const grafic_t           grafic,
+                            const void *restrict     data,
+                            graficFormat_t           dataFormat,
+                            int                      numComponents,
+                            const uint32_t *restrict idxLo,
+                            const uint32_t *restrict dims,
+                            uint32_t                 rowStride);
+
 /**
  * @brief  Reads a slab from the file.
  *
+ * The file is kept open between consecutive calls, reading the slabs in
+ * ascending order will thus not require any seeking.  The file is closed
+ * again when the object is deleted or when the file is written to.
+ *
  * @param[in]   grafic
  *                 The file object to work with.
  * @param[out]  data
@@ -18,6 +18,7 @@
 /*--- Includes ----------------------------------------------------------*/
 #include "util_config.h"
 #include "grafic.h"
+#include <stdio.h>
 #include <stdbool.h>
 #include <stdint.h>
 #include "endian.h"
@@ -38,6 +39,10 @@ struct grafic_struct {
 	bool     isWhiteNoise;
 	/** @brief  Gives the size of the header. */
 	int      headerSkip;
+	/** @brief  The file handle kept open by grafic_readSlab(). */
+	FILE     *slabFile;
+	/** @brief  The slab at which @c slabFile is currently positioned. */
+	int      slabFilePos;
 	// Header entries always there
 	/** @brief  The x-size of the grid. */
 	uint32_t np1;
@@ -1055,4 +1055,58 @@ grafic_writeWindowed_test(void)
 	return hasPassed ? true : false;
 } /* grafic_readWindowed_test */
 
+extern bool
+grafic_readSlab_test(void)
+{
+	bool     hasPassed = true;
+	int      rank      = 0;
+	grafic_t grafic;
+	uint32_t size[3];
+	size_t   numInPlane;
+	double   *data;
+	float    *dataFloat;
+	int      slabs[4];
+#ifdef XMEM_TRACK_MEM
+	size_t   allocatedBytes = global_allocated_bytes;
+#endif
+#ifdef WITH_MPI
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+#endif
+
+	if (rank == 0)
+		printf("Testing %s... ", __func__);
+
+	grafic     = grafic_newFromFile("tests/testNormal.grafic");
+	grafic_getSize(grafic, size);
+	numInPlane = size[0] * size[1];
+	slabs[0]   = 0;
+	slabs[1]   = 1;
+	slabs[2]   = (int)size[2] - 1;
+	slabs[3]   = 0;
+
+	dataFloat  = xmalloc(sizeof(float) * numInPlane);
+	data       = xmalloc(sizeof(double) * 2 * numInPlane);
+	for (int j = 0; j < 4; j++) {
+		grafic_readSlab(grafic, dataFloat, GRAFIC_FORMAT_FLOAT, 1, slabs[j]);
+		grafic_readSlab(grafic, data, GRAFIC_FORMAT_DOUBLE, 2, slabs[j]);
+		for (size_t i = 0; i < numInPlane; i++) {
+			double expected = (double)(i + slabs[j] * numInPlane);
+			if (islessgreater(dataFloat[i], (float)expected))
+				hasPassed = false;
+			if (islessgreater(data[i * 2], expected))
+				hasPassed = false;
+		}
+	}
+	xfree(data);
+	xfree(dataFloat);
+
+	grafic_del(&grafic);
+#ifdef XMEM_TRACK_MEM
+	if (allocatedBytes != global_allocated_bytes)
+		hasPassed = false;
+#endif
+
+	return hasPassed ? true : false;
+} /* grafic_readSlab_test */
+
 /*--- Implementations of local functions --------------------------------*/
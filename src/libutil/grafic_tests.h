@@ -96,5 +96,8 @@ grafic_readWindowed_test(void);
 extern bool
 grafic_writeWindowed_test(void);
 
+extern bool
+grafic_readSlab_test(void);
+
 
 #endif
@@ -21,6 +21,8 @@
 #include "gadgetTOC_tests.h"
 #include "gadgetHeader_tests.h"
 #include "gadget_tests.h"
+#include "rng_tests.h"
+#include "profile_tests.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -75,7 +77,7 @@ local_runtestMPI(bool       (*f
 
 /*--- M A I N -----------------------------------------------------------*/
 int
-main(void)
+main(int argc, char **argv)
 {
 	bool hasFailed = false;
 	int  rank      = 0;
@@ -178,6 +180,29 @@ main(void)
 		RUNTEST(&varArr_getElementHandle_test, hasFailed);
 	}
 
+	if (rank == 0) {
+		printf("\nRunning tests for rng:\n");
+		RUNTEST(&rng_new_test, hasFailed);
+		RUNTEST(&rng_reset_test, hasFailed);
+		RUNTEST(&rng_isCounterBased_test, hasFailed);
+		RUNTEST(&rng_getGaussUnitAt_test, hasFailed);
+		RUNTEST(&rng_fillGaussUnit_test, hasFailed);
+		RUNTEST(&rng_fillGaussUnitAt_test, hasFailed);
+		RUNTEST(&rng_philox4x32_test, hasFailed);
+	}
+
+	if (rank == 0) {
+		printf("\nRunning tests for profile:\n");
+		RUNTEST(&profile_begin_test, hasFailed);
+		RUNTEST(&profile_end_test, hasFailed);
+		RUNTEST(&profile_addBytes_test, hasFailed);
+	}
+#ifdef WITH_MPI
+	RUNTESTMPI(&profile_writeReport_test, hasFailed);
+#else
+	RUNTEST(&profile_writeReport_test, hasFailed);
+#endif
+
 	if (rank == 0) {
 		printf("\nRunning tests for bov:\n");
 		RUNTEST(&bov_new_test, hasFailed);
@@ -237,6 +262,7 @@ main(void)
 		RUNTEST(&grafic_readWindowed_test, hasFailed);
 		RUNTEST(&grafic_write_test, hasFailed);
 		RUNTEST(&grafic_writeWindowed_test, hasFailed);
+		RUNTEST(&grafic_readSlab_test, hasFailed);
 	}
 
 	if (rank == 0) {
@@ -261,6 +287,8 @@ main(void)
 		RUNTEST(&gadgetBlock_getNumPartsInBlock_test, hasFailed);
 		RUNTEST(&gadgetBlock_writereadDescriptor_test, hasFailed);
 		RUNTEST(&gadgetBlock_readDescriptorString_test, hasFailed);
+		RUNTEST(&gadgetBlock_getRecordSizeInFile_test, hasFailed);
+		RUNTEST(&gadgetBlock_writeRecordMarkers_test, hasFailed);
 	}
 
 	if (rank == 0) {
@@ -307,6 +335,8 @@ main(void)
 		RUNTEST(&gadget_del_test, hasFailed);
 		RUNTEST(&gadget_writeHeaderToCurrentFile_test, hasFailed);
 		RUNTEST(&gadget_writeBlockToCurrentFile_test, hasFailed);
+		RUNTEST(&gadget_readBlockFromCurrentFile_test, hasFailed);
+		RUNTEST(&gadget_readLargeBlock_test, hasFailed);
 	}
 
 #ifdef WITH_MPI
@@ -0,0 +1,515 @@
+// Copyright (C) 2012, Steffen Knollmann
+// Released under the terms of the GNU General Public License version 3.
+// This file is part of `ginnungagap'.
+
+
+/*--- Doxygen file description ------------------------------------------*/
+
+/**
+ * @file libutil/profile.c
+ * @ingroup libutilMisc
+ * @brief  This file provides the implementation of the phase profiler.
+ */
+
+
+/*--- Includes ----------------------------------------------------------*/
+#include "util_config.h"
+#include "profile.h"
+#include "timer.h"
+#include "xmem.h"
+#include "xstring.h"
+#include "xfile.h"
+#include "diediedie.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <stdbool.h>
+#include <assert.h>
+#ifdef WITH_MPI
+#  include <mpi.h>
+#endif
+#ifdef WITH_OPENMP
+#  include <omp.h>
+#endif
+
+
+/*--- Local structures --------------------------------------------------*/
+
+/** @brief  Holds the accumulated values of one region. */
+typedef struct localRegion_struct {
+	/** @brief  The name of the region. */
+	char     *name;
+	/** @brief  The index of the enclosing region, -1 for none. */
+	int      parent;
+	/** @brief  The number of times the region was entered. */
+	uint64_t calls;
+	/** @brief  The number of bytes moved in the region. */
+	uint64_t bytes;
+	/** @brief  The time spent in the region. */
+	double   time;
+	/** @brief  The time spent in the nested regions. */
+	double   timeNested;
+	/** @brief  The wall clock time at which the region was entered. */
+	double   timeStart;
+} localRegion_struct_t;
+
+/** @brief  Handle for a region. */
+typedef localRegion_struct_t *localRegion_t;
+
+
+/*--- Local defines -----------------------------------------------------*/
+
+/** @brief  The separator of region names in a path. */
+#define LOCAL_PATH_SEPARATOR '/'
+
+/** @brief  The number of values per region that are aggregated. */
+#define LOCAL_NUM_VALUES 4
+
+
+/*--- Local variables ---------------------------------------------------*/
+
+/** @brief  All regions, a region is always stored after its parent. */
+static localRegion_t localRegions = NULL;
+
+/** @brief  The number of regions in use. */
+static int localNumRegions = 0;
+
+/** @brief  The number of regions allocated. */
+static int localNumAllocated = 0;
+
+/** @brief  The index of the active region, -1 if there is none. */
+static int localCurrent = -1;
+
+
+/*--- Prototypes of local functions -------------------------------------*/
+static bool
+local_isIgnored(void);
+
+static int
+local_findChild(int parent, const char *name, size_t len);
+
+static int
+local_findByPath(const char *path);
+
+static int
+local_addRegion(int parent, const char *name);
+
+static char *
+local_getPath(int idx);
+
+static int
+local_getDepth(const char *path);
+
+static char **
+local_getReportPaths(int *numPaths);
+
+static void
+local_getValues(char **paths, int numPaths, double *values);
+
+static void
+local_writeJSON(FILE   *f,
+                char   **paths,
+                int    numPaths,
+                int    numProcs,
+                double *vMin,
+                double *vMax,
+                double *vSum);
+
+static void
+local_writeCSV(FILE   *f,
+               char   **paths,
+               int    numPaths,
+               int    numProcs,
+               double *vMin,
+               double *vMax,
+               double *vSum);
+
+
+/*--- Implementations of exported functios ------------------------------*/
+extern void
+profile_begin(const char *name)
+{
+	int idx;
+
+	assert(name != NULL);
+	assert(strchr(name, LOCAL_PATH_SEPARATOR) == NULL);
+
+	if (local_isIgnored())
+		return;
+
+	idx = local_findChild(localCurrent, name, strlen(name));
+	if (idx < 0)
+		idx = local_addRegion(localCurrent, name);
+
+	localRegions[idx].calls++;
+	localRegions[idx].timeStart = timer_getWallTime();
+	localCurrent                = idx;
+}
+
+extern void
+profile_end(const char *name)
+{
+	localRegion_t region;
+	double        elapsed;
+
+	assert(name != NULL);
+
+	if (local_isIgnored())
+		return;
+
+	assert(localCurrent >= 0);
+	region = localRegions + localCurrent;
+	assert(strcmp(region->name, name) == 0);
+
+	elapsed       = timer_getWallTime() - region->timeStart;
+	region->time += elapsed;
+	if (region->parent >= 0)
+		localRegions[region->parent].timeNested += elapsed;
+	localCurrent = region->parent;
+}
+
+extern void
+profile_addBytes(uint64_t bytes)
+{
+	if (local_isIgnored() || (localCurrent < 0))
+		return;
+
+	localRegions[localCurrent].bytes += bytes;
+}
+
+extern uint64_t
+profile_getCalls(const char *path)
+{
+	int idx = local_findByPath(path);
+
+	return (idx < 0) ? UINT64_C(0) : localRegions[idx].calls;
+}
+
+extern double
+profile_getTime(const char *path)
+{
+	int idx = local_findByPath(path);
+
+	return (idx < 0) ? 0.0 : localRegions[idx].time;
+}
+
+extern uint64_t
+profile_getBytes(const char *path)
+{
+	int idx = local_findByPath(path);
+
+	return (idx < 0) ? UINT64_C(0) : localRegions[idx].bytes;
+}
+
+extern void
+profile_writeReport(const char *fileName)
+{
+	char   **paths;
+	int    numPaths, numProcs = 1, rank = 0;
+	double *values, *vMin, *vMax, *vSum;
+	size_t len;
+
+	assert(fileName != NULL);
+	assert(localCurrent == -1);
+
+#ifdef WITH_MPI
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+	MPI_Comm_size(MPI_COMM_WORLD, &numProcs);
+#endif
+
+	paths  = local_getReportPaths(&numPaths);
+	// Allocate at least one element, numPaths may well be 0.
+	len    = (size_t)(numPaths * LOCAL_NUM_VALUES + 1);
+	values = xmalloc(sizeof(double) * len * 4);
+	vMin   = values + len;
+	vMax   = vMin + len;
+	vSum   = vMax + len;
+	local_getValues(paths, numPaths, values);
+
+#ifdef WITH_MPI
+	MPI_Reduce(values, vMin, (int)len, MPI_DOUBLE, MPI_MIN, 0,
+	           MPI_COMM_WORLD);
+	MPI_Reduce(values, vMax, (int)len, MPI_DOUBLE, MPI_MAX, 0,
+	           MPI_COMM_WORLD);
+	MPI_Reduce(values, vSum, (int)len, MPI_DOUBLE, MPI_SUM, 0,
+	           MPI_COMM_WORLD);
+#else
+	memcpy(vMin, values, sizeof(double) * len);
+	memcpy(vMax, values, sizeof(double) * len);
+	memcpy(vSum, values, sizeof(double) * len);
+#endif
+
+	if (rank == 0) {
+		FILE   *f;
+		size_t lenName = strlen(fileName);
+
+		f = xfopen(fileName, "w");
+		if ((lenName > 4) && (strcmp(fileName + lenName - 4, ".csv") == 0))
+			local_writeCSV(f, paths, numPaths, numProcs, vMin, vMax, vSum);
+		else
+			local_writeJSON(f, paths, numPaths, numProcs, vMin, vMax, vSum);
+		if (ferror(f)) {
+			fprintf(stderr, "Error writing profile report %s: %s\n",
+			        fileName, strerror(errno));
+			diediedie(EXIT_FAILURE);
+		}
+		xfclose(&f);
+	}
+
+	xfree(values);
+	for (int i = 0; i < numPaths; i++)
+		xfree(paths[i]);
+	xfree(paths);
+} /* profile_writeReport */
+
+extern void
+profile_reset(void)
+{
+	assert(localCurrent == -1);
+
+	for (int i = 0; i < localNumRegions; i++)
+		xfree(localRegions[i].name);
+	if (localRegions != NULL)
+		xfree(localRegions);
+	localRegions      = NULL;
+	localNumRegions   = 0;
+	localNumAllocated = 0;
+}
+
+/*--- Implementations of local functions --------------------------------*/
+static bool
+local_isIgnored(void)
+{
+#ifdef WITH_OPENMP
+	if (omp_in_parallel())
+		return true;
+#endif
+	return false;
+}
+
+static int
+local_findChild(int parent, const char *name, size_t len)
+{
+	for (int i = 0; i < localNumRegions; i++) {
+		if ((localRegions[i].parent == parent)
+		    && (strncmp(localRegions[i].name, name, len) == 0)
+		    && (localRegions[i].name[len] == '\0'))
+			return i;
+	}
+
+	return -1;
+}
+
+static int
+local_findByPath(const char *path)
+{
+	int idx = -1;
+
+	assert(path != NULL);
+
+	do {
+		const char *sep = strchr(path, LOCAL_PATH_SEPARATOR);
+		size_t     len  = (sep == NULL) ? strlen(path) : (size_t)(sep - path);
+
+		idx  = local_findChild(idx, path, len);
+		path = (sep == NULL) ? NULL : sep + 1;
+	} while ((idx >= 0) && (path != NULL));
+
+	return idx;
+}
+
+static int
+local_addRegion(int parent, const char *name)
+{
+	localRegion_t region;
+
+	if (localNumRegions == localNumAllocated) {
+		localNumAllocated = (localNumAllocated == 0)
+		                    ? 16 : 2 * localNumAllocated;
+		localRegions      = xrealloc(localRegions,
+		                             sizeof(localRegion_struct_t)
+		                             * localNumAllocated);
+	}
+
+	region             = localRegions + localNumRegions;
+	region->name       = xstrdup(name);
+	region->parent     = parent;
+	region->calls      = UINT64_C(0);
+	region->bytes      = UINT64_C(0);
+	region->time       = 0.0;
+	region->timeNested = 0.0;
+	region->timeStart  = 0.0;
+
+	return localNumRegions++;
+}
+
+static char *
+local_getPath(int idx)
+{
+	char *path, *parentPath, *tmp;
+	char sep[2] = { LOCAL_PATH_SEPARATOR, '\0' };
+
+	if (localRegions[idx].parent < 0)
+		return xstrdup(localRegions[idx].name);
+
+	parentPath = local_getPath(localRegions[idx].parent);
+	tmp        = xstrmerge(parentPath, sep);
+	path       = xstrmerge(tmp, localRegions[idx].name);
+	xfree(tmp);
+	xfree(parentPath);
+
+	return path;
+}
+
+static int
+local_getDepth(const char *path)
+{
+	int depth = 0;
+
+	while ((path = strchr(path, LOCAL_PATH_SEPARATOR)) != NULL) {
+		path++;
+		depth++;
+	}
+
+	return depth;
+}
+
+/*
+ * The report covers the regions of process 0, the other processes
+ * receive the paths and look them up in their own table, regions they
+ * do not know about count as never entered.
+ */
+static char **
+local_getReportPaths(int *numPaths)
+{
+	char **paths;
+
+	*numPaths = localNumRegions;
+	paths     = xmalloc(sizeof(char *) * (localNumRegions + 1));
+	for (int i = 0; i < localNumRegions; i++)
+		paths[i] = local_getPath(i);
+
+#ifdef WITH_MPI
+	{
+		int  rank, len = 0;
+		char *buf;
+
+		MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+		if (rank == 0) {
+			for (int i = 0; i < *numPaths; i++)
+				len += (int)strlen(paths[i]) + 1;
+		}
+		MPI_Bcast(numPaths, 1, MPI_INT, 0, MPI_COMM_WORLD);
+		MPI_Bcast(&len, 1, MPI_INT, 0, MPI_COMM_WORLD);
+		buf = xmalloc(len + 1);
+		if (rank == 0) {
+			char *pos = buf;
+			for (int i = 0; i < *numPaths; i++) {
+				strcpy(pos, paths[i]);
+				pos += strlen(paths[i]) + 1;
+			}
+		}
+		MPI_Bcast(buf, len, MPI_CHAR, 0, MPI_COMM_WORLD);
+		if (rank != 0) {
+			const char *pos = buf;
+			for (int i = 0; i < localNumRegions; i++)
+				xfree(paths[i]);
+			paths = xrealloc(paths, sizeof(char *) * (*numPaths + 1));
+			for (int i = 0; i < *numPaths; i++) {
+				paths[i] = xstrdup(pos);
+				pos     += strlen(pos) + 1;
+			}
+		}
+		xfree(buf);
+	}
+#endif
+
+	return paths;
+} /* local_getReportPaths */
+
+static void
+local_getValues(char **paths, int numPaths, double *values)
+{
+	for (int i = 0; i < numPaths; i++) {
+		int    idx = local_findByPath(paths[i]);
+		double *v  = values + i * LOCAL_NUM_VALUES;
+
+		if (idx < 0) {
+			for (int j = 0; j < LOCAL_NUM_VALUES; j++)
+				v[j] = 0.0;
+			continue;
+		}
+		v[0] = (double)localRegions[idx].calls;
+		v[1] = localRegions[idx].time;
+		v[2] = localRegions[idx].time - localRegions[idx].timeNested;
+		v[3] = (double)localRegions[idx].bytes;
+	}
+}
+
+static void
+local_writeJSON(FILE   *f,
+                char   **paths,
+                int    numPaths,
+                int    numProcs,
+                double *vMin,
+                double *vMax,
+                double *vSum)
+{
+	int numThreads = 1;
+#ifdef WITH_OPENMP
+	numThreads = omp_get_max_threads();
+#endif
+
+	fprintf(f, "{\n  \"numProcs\": %i,\n  \"numThreads\": %i,\n"
+	        "  \"regions\": [", numProcs, numThreads);
+	for (int i = 0; i < numPaths; i++) {
+		const char *name = strrchr(paths[i], LOCAL_PATH_SEPARATOR);
+		int        k     = i * LOCAL_NUM_VALUES;
+
+		name = (name == NULL) ? paths[i] : name + 1;
+		fprintf(f, "%s\n    {\"path\": \"%s\", \"name\": \"%s\", "
+		        "\"depth\": %i,\n", (i == 0) ? "" : ",", paths[i], name,
+		        local_getDepth(paths[i]));
+		fprintf(f, "     \"calls\": {\"min\": %.0f, \"max\": %.0f, "
+		        "\"mean\": %.6g},\n",
+		        vMin[k], vMax[k], vSum[k] / numProcs);
+		fprintf(f, "     \"time\": {\"min\": %.6e, \"max\": %.6e, "
+		        "\"mean\": %.6e},\n",
+		        vMin[k + 1], vMax[k + 1], vSum[k + 1] / numProcs);
+		fprintf(f, "     \"self\": {\"min\": %.6e, \"max\": %.6e, "
+		        "\"mean\": %.6e},\n",
+		        vMin[k + 2], vMax[k + 2], vSum[k + 2] / numProcs);
+		fprintf(f, "     \"bytes\": {\"min\": %.0f, \"max\": %.0f, "
+		        "\"mean\": %.6g, \"total\": %.0f}}",
+		        vMin[k + 3], vMax[k + 3], vSum[k + 3] / numProcs,
+		        vSum[k + 3]);
+	}
+	fprintf(f, "\n  ]\n}\n");
+} /* local_writeJSON */
+
+static void
+local_writeCSV(FILE   *f,
+               char   **paths,
+               int    numPaths,
+               int    numProcs,
+               double *vMin,
+               double *vMax,
+               double *vSum)
+{
+	fprintf(f, "path,depth,numProcs,callsMin,callsMax,callsMean,"
+	        "timeMin,timeMax,timeMean,selfMin,selfMax,selfMean,"
+	        "bytesMin,bytesMax,bytesMean,bytesTotal\n");
+	for (int i = 0; i < numPaths; i++) {
+		int k = i * LOCAL_NUM_VALUES;
+
+		fprintf(f, "%s,%i,%i,%.0f,%.0f,%.6g,", paths[i],
+		        local_getDepth(paths[i]), numProcs,
+		        vMin[k], vMax[k], vSum[k] / numProcs);
+		for (int j = 1; j < 3; j++)
+			fprintf(f, "%.6e,%.6e,%.6e,", vMin[k + j], vMax[k + j],
+			        vSum[k + j] / numProcs);
+		fprintf(f, "%.0f,%.0f,%.6g,%.0f\n", vMin[k + 3], vMax[k + 3],
+		        vSum[k + 3] / numProcs, vSum[k + 3]);
+	}
+}
@@ -0,0 +1,130 @@
+// Copyright (C) 2012, Steffen Knollmann
+// Released under the terms of the GNU General Public License version 3.
+// This file is part of `ginnungagap'.
+
+#ifndef PROFILE_H
+#define PROFILE_H
+
+
+/*--- Doxygen file description ------------------------------------------*/
+
+/**
+ * @file libutil/profile.h
+ * @ingroup libutilMisc
+ * @brief  This file provides the interface of the phase profiler.
+ *
+ * The profiler records named regions that may be nested, e.g. a region
+ * @c fft.r2c opened while the region @c wn is active becomes the region
+ * @c wn/fft.r2c.  For every region the number of calls, the elapsed
+ * wall clock time and the number of bytes moved are accumulated.  The
+ * profiler is process global and must only be used outside of OpenMP
+ * parallel regions, calls from within those are ignored.
+ */
+
+
+/*--- Includes ----------------------------------------------------------*/
+#include "util_config.h"
+#include <stdint.h>
+
+
+/*--- Prototypes of exported functions ----------------------------------*/
+
+/**
+ * @brief  Enters a region.
+ *
+ * @param[in]  *name
+ *                The name of the region, must not contain a @c /.
+ *
+ * @return  Returns nothing.
+ */
+extern void
+profile_begin(const char *name);
+
+/**
+ * @brief  Leaves the current region.
+ *
+ * @param[in]  *name
+ *                The name of the region, this must be the name that was
+ *                used for the matching call to profile_begin().
+ *
+ * @return  Returns nothing.
+ */
+extern void
+profile_end(const char *name);
+
+/**
+ * @brief  Adds to the number of bytes moved in the current region.
+ *
+ * @param[in]  bytes
+ *                The number of bytes.
+ *
+ * @return  Returns nothing.
+ */
+extern void
+profile_addBytes(uint64_t bytes);
+
+/**
+ * @brief  Retrieves the number of calls of a region.
+ *
+ * @param[in]  *path
+ *                The full path of the region, e.g. @c wn/fft.r2c.
+ *
+ * @return  Returns the number of times the region was entered, or 0 if
+ *          the region does not exist.
+ */
+extern uint64_t
+profile_getCalls(const char *path);
+
+/**
+ * @brief  Retrieves the accumulated time of a region.
+ *
+ * @param[in]  *path
+ *                The full path of the region.
+ *
+ * @return  Returns the time in seconds spent in the region, including
+ *          the time spent in nested regions, or 0.0 if the region does
+ *          not exist.
+ */
+extern double
+profile_getTime(const char *path);
+
+/**
+ * @brief  Retrieves the number of bytes moved in a region.
+ *
+ * @param[in]  *path
+ *                The full path of the region.
+ *
+ * @return  Returns the number of bytes (excluding the ones of nested
+ *          regions), or 0 if the region does not exist.
+ */
+extern uint64_t
+profile_getBytes(const char *path);
+
+/**
+ * @brief  Writes a report of all regions.
+ *
+ * This is a collective operation under MPI, all processes must call it
+ * and no region may be active.  The report lists the minimum, maximum
+ * and mean over all processes of the inclusive time, the exclusive time
+ * and the bytes of every region known to process 0.  The file is
+ * written by process 0, in CSV format if its name ends in @c .csv and
+ * in JSON format otherwise.
+ *
+ * @param[in]  *fileName
+ *                The name of the file to write to.
+ *
+ * @return  Returns nothing.
+ */
+extern void
+profile_writeReport(const char *fileName);
+
+/**
+ * @brief  Discards all regions.
+ *
+ * @return  Returns nothing.
+ */
+extern void
+profile_reset(void);
+
+
+#endif
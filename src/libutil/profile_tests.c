@@ -0,0 +1,227 @@
+// Copyright (C) 2012, Steffen Knollmann
+// Released under the terms of the GNU General Public License version 3.
+// This file is part of `ginnungagap'.
+
+
+/*--- Doxygen file description ------------------------------------------*/
+
+/**
+ * @file  libutil/profile_tests.c
+ * @ingroup  libutilMisc
+ * @brief  This provides the implementations of the test functions for
+ *         profile.c.
+ */
+
+
+/*--- Includes ----------------------------------------------------------*/
+#include "util_config.h"
+#include "profile_tests.h"
+#include "profile.h"
+#include "xmem.h"
+#include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
+#ifdef WITH_MPI
+#  include <mpi.h>
+#endif
+
+
+/*--- Local defines -----------------------------------------------------*/
+#define LOCAL_REPORT_NAME "profileTest.csv"
+
+
+/*--- Prototypes of local functions -------------------------------------*/
+
+
+/*--- Implementations of exported functions -----------------------------*/
+extern bool
+profile_begin_test(void)
+{
+	bool   hasPassed = true;
+	int    rank      = 0;
+#ifdef XMEM_TRACK_MEM
+	size_t allocatedBytes = global_allocated_bytes;
+#endif
+#ifdef WITH_MPI
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+#endif
+
+	if (rank == 0)
+		printf("Testing %s... ", __func__);
+
+	profile_begin("a");
+	profile_begin("b");
+	profile_end("b");
+	profile_begin("b");
+	profile_end("b");
+	profile_end("a");
+	profile_begin("b");
+	profile_end("b");
+
+	if (profile_getCalls("a") != 1)
+		hasPassed = false;
+	if (profile_getCalls("a/b") != 2)
+		hasPassed = false;
+	if (profile_getCalls("b") != 1)
+		hasPassed = false;
+	if (profile_getCalls("a/c") != 0)
+		hasPassed = false;
+	if (profile_getCalls("c/b") != 0)
+		hasPassed = false;
+	profile_reset();
+	if (profile_getCalls("a") != 0)
+		hasPassed = false;
+
+#ifdef XMEM_TRACK_MEM
+	if (allocatedBytes != global_allocated_bytes)
+		hasPassed = false;
+#endif
+
+	return hasPassed ? true : false;
+}
+
+extern bool
+profile_end_test(void)
+{
+	bool   hasPassed = true;
+	int    rank      = 0;
+	double timeOuter, timeInner;
+#ifdef XMEM_TRACK_MEM
+	size_t allocatedBytes = global_allocated_bytes;
+#endif
+#ifdef WITH_MPI
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+#endif
+
+	if (rank == 0)
+		printf("Testing %s... ", __func__);
+
+	profile_begin("outer");
+	for (int i = 0; i < 3; i++) {
+		profile_begin("inner");
+		profile_end("inner");
+	}
+	profile_end("outer");
+
+	timeOuter = profile_getTime("outer");
+	timeInner = profile_getTime("outer/inner");
+	if ((timeInner < 0.0) || (timeOuter < timeInner))
+		hasPassed = false;
+	if (profile_getTime("inner") != 0.0)
+		hasPassed = false;
+	profile_reset();
+
+#ifdef XMEM_TRACK_MEM
+	if (allocatedBytes != global_allocated_bytes)
+		hasPassed = false;
+#endif
+
+	return hasPassed ? true : false;
+}
+
+extern bool
+profile_addBytes_test(void)
+{
+	bool   hasPassed = true;
+	int    rank      = 0;
+#ifdef XMEM_TRACK_MEM
+	size_t allocatedBytes = global_allocated_bytes;
+#endif
+#ifdef WITH_MPI
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+#endif
+
+	if (rank == 0)
+		printf("Testing %s... ", __func__);
+
+	profile_addBytes(UINT64_C(7));
+	profile_begin("a");
+	profile_addBytes(UINT64_C(5));
+	profile_begin("b");
+	profile_addBytes(UINT64_C(5000000000));
+	profile_end("b");
+	profile_addBytes(UINT64_C(5));
+	profile_end("a");
+
+	if (profile_getBytes("a") != UINT64_C(10))
+		hasPassed = false;
+	if (profile_getBytes("a/b") != UINT64_C(5000000000))
+		hasPassed = false;
+	profile_reset();
+
+#ifdef XMEM_TRACK_MEM
+	if (allocatedBytes != global_allocated_bytes)
+		hasPassed = false;
+#endif
+
+	return hasPassed ? true : false;
+}
+
+extern bool
+profile_writeReport_test(void)
+{
+	bool   hasPassed = true;
+	int    rank      = 0;
+	int    size      = 1;
+	char   line[1024];
+	FILE   *f;
+#ifdef XMEM_TRACK_MEM
+	size_t allocatedBytes = global_allocated_bytes;
+#endif
+#ifdef WITH_MPI
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+	MPI_Comm_size(MPI_COMM_WORLD, &size);
+#endif
+
+	if (rank == 0)
+		printf("Testing %s... ", __func__);
+
+	// Every process moves rank + 1 bytes, only process 0 knows `c'.
+	profile_begin("a");
+	profile_begin("b");
+	profile_addBytes((uint64_t)(rank + 1));
+	profile_end("b");
+	profile_end("a");
+	if (rank == 0) {
+		profile_begin("c");
+		profile_end("c");
+	}
+	profile_writeReport(LOCAL_REPORT_NAME);
+	profile_reset();
+
+	if (rank == 0) {
+		char expected[1024];
+		int  numLines = 0;
+
+		f = fopen(LOCAL_REPORT_NAME, "r");
+		if (f == NULL)
+			return false;
+		while (fgets(line, 1024, f) != NULL) {
+			if ((numLines == 2)
+			    && (strncmp(line, "a/b,1,", 6) != 0))
+				hasPassed = false;
+			if (numLines == 2) {
+				sprintf(expected, ",1,%i,%g,%i\n", size,
+				        (size + 1) / 2., size * (size + 1) / 2);
+				if (strcmp(line + strlen(line) - strlen(expected),
+				           expected) != 0)
+					hasPassed = false;
+			}
+			if ((numLines == 3)
+			    && (strncmp(line, "c,0,", 4) != 0))
+				hasPassed = false;
+			numLines++;
+		}
+		fclose(f);
+		if (numLines != 4)
+			hasPassed = false;
+		remove(LOCAL_REPORT_NAME);
+	}
+
+#ifdef XMEM_TRACK_MEM
+	if (allocatedBytes != global_allocated_bytes)
+		hasPassed = false;
+#endif
+
+	return hasPassed ? true : false;
+} /* profile_writeReport_test */
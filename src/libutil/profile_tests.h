@@ -0,0 +1,58 @@
+// Copyright (C) 2012, Steffen Knollmann
+// Released under the terms of the GNU General Public License version 3.
+// This file is part of `ginnungagap'.
+
+#ifndef PROFILE_TESTS_H
+#define PROFILE_TESTS_H
+
+
+/*--- Doxygen file description ------------------------------------------*/
+
+/**
+ * @file  libutil/profile_tests.h
+ * @ingroup  libutilMisc
+ * @brief  This provides the prototypes of the test functions for
+ *         profile.c
+ */
+
+
+/*--- Includes ----------------------------------------------------------*/
+#include "util_config.h"
+#include <stdbool.h>
+
+
+/*--- Prototypes of exported functions ----------------------------------*/
+
+/**
+ * @brief  This will test profile_begin().
+ *
+ * @return  Returns true if the test succeeds, false otherwise.
+ */
+extern bool
+profile_begin_test(void);
+
+/**
+ * @brief  This will test profile_end().
+ *
+ * @return  Returns true if the test succeeds, false otherwise.
+ */
+extern bool
+profile_end_test(void);
+
+/**
+ * @brief  This will test profile_addBytes().
+ *
+ * @return  Returns true if the test succeeds, false otherwise.
+ */
+extern bool
+profile_addBytes_test(void);
+
+/**
+ * @brief  This will test profile_writeReport().
+ *
+ * @return  Returns true if the test succeeds, false otherwise.
+ */
+extern bool
+profile_writeReport_test(void);
+
+#endif
@@ -29,6 +29,7 @@
 #include <math.h>
 #include <float.h>
 #include <assert.h>
+#include <stdint.h>
 
 
 /*--- Implemention of main structure ------------------------------------*/
@@ -40,13 +41,23 @@
 #define CONFIG_TOTALSTREAMS_NAME "numStreamsTotal"
 #define CONFIG_RANDOMSEED_NAME   "randomSeed"
 
+#define LOCAL_PHILOX_M0          UINT32_C(0xD2511F53)
+#define LOCAL_PHILOX_M1          UINT32_C(0xCD9E8D57)
+#define LOCAL_PHILOX_W0          UINT32_C(0x9E3779B9)
+#define LOCAL_PHILOX_W1          UINT32_C(0xBB67AE85)
+#define LOCAL_PHILOX_ROUNDS      10
+#define LOCAL_TWO_PI             6.283185307179586476925286766559
+#define LOCAL_BATCH_PAIRS        128
+
 
 /*--- Prototypes of local functions -------------------------------------*/
 static int
 local_getGeneratorType(parse_ini_t ini, const char *sectionName);
 
 static int
-local_getNumStreamsTotal(parse_ini_t ini, const char *sectionName);
+local_getNumStreamsTotal(parse_ini_t ini,
+                         const char  *sectionName,
+                         int         generatorType);
 
 static int
 local_getRandomSeed(parse_ini_t ini, const char *sectionName);
@@ -57,6 +68,23 @@ local_getNumStreamsLocal(int numStreamsTotal);
 static int
 local_getBaseStreamId(int numStreamsTotal);
 
+static void
+local_getGaussPairs(uint32_t key0,
+                    uint32_t key1,
+                    uint64_t block,
+                    uint64_t numPairs,
+                    double   *out);
+
+static double
+local_getGaussFromCounter(uint32_t key0, uint32_t key1, uint64_t counter);
+
+static void
+local_fillGaussFromCounter(uint32_t key0,
+                           uint32_t key1,
+                           uint64_t counter,
+                           fpv_t    *out,
+                           uint64_t n);
+
 
 /*--- Implementations of exported functios ------------------------------*/
 extern rng_t
@@ -73,16 +101,18 @@ rng_new(int generatorType, int numStreamsTotal, int randomSeed)
 
 	assert(rng->baseStreamId + rng->numStreamsLocal <= rng->numStreamsTotal);
 
-	rng->streams = xmalloc(sizeof(int *) * rng->numStreamsLocal);
+	rng->streams  = xmalloc(sizeof(int *) * rng->numStreamsLocal);
+	rng->counters = xmalloc(sizeof(uint64_t) * rng->numStreamsLocal);
 	for (int i = 0; i < rng->numStreamsLocal; i++) {
+		rng->counters[i] = UINT64_C(0);
+		rng->streams[i]  = NULL;
 #ifdef WITH_SPRNG
-		rng->streams[i] = init_sprng(rng->generatorType,
-		                             rng->baseStreamId + i,
-		                             rng->numStreamsTotal,
-		                             rng->randomSeed,
-		                             SPRNG_DEFAULT);
-#else
-		rng->streams[i] = NULL;
+		if (!rng_isCounterBased(rng))
+			rng->streams[i] = init_sprng(rng->generatorType,
+			                             rng->baseStreamId + i,
+			                             rng->numStreamsTotal,
+			                             rng->randomSeed,
+			                             SPRNG_DEFAULT);
 #endif
 	}
 
@@ -93,7 +123,8 @@ extern rng_t
 rng_newFromIni(parse_ini_t ini, const char *sectionName)
 {
 	int generatorType   = local_getGeneratorType(ini, sectionName);
-	int numStreamsTotal = local_getNumStreamsTotal(ini, sectionName);
+	int numStreamsTotal = local_getNumStreamsTotal(ini, sectionName,
+	                                               generatorType);
 	int randomSeed      = local_getRandomSeed(ini, sectionName);
 
 	return rng_new(generatorType, numStreamsTotal, randomSeed);
@@ -106,9 +137,12 @@ rng_del(rng_t *rng)
 	assert(*rng != NULL);
 
 #ifdef WITH_SPRNG
-	for (int i = 0; i < (*rng)->numStreamsLocal; i++)
-		free_rng((*rng)->streams[i]);
+	for (int i = 0; i < (*rng)->numStreamsLocal; i++) {
+		if ((*rng)->streams[i] != NULL)
+			free_rng((*rng)->streams[i]);
+	}
 #endif
+	xfree((*rng)->counters);
 	xfree((*rng)->streams);
 	xfree(*rng);
 	*rng = NULL;
@@ -117,6 +151,10 @@ rng_del(rng_t *rng)
 extern void
 rng_reset(rng_t rng)
 {
+	for (int i = 0; i < rng->numStreamsLocal; i++)
+		rng->counters[i] = UINT64_C(0);
+	if (rng_isCounterBased(rng))
+		return;
 #ifdef WITH_SPRNG
 	for (int i = 0; i < rng->numStreamsLocal; i++) {
 		free_rng(rng->streams[i]);
@@ -142,6 +180,14 @@ rng_getGauss(const rng_t  rng,
              const double mean,
              const double sigma)
 {
+	if (rng_isCounterBased(rng)) {
+		// Every stream has its own key, the position within the stream
+		// is the counter.
+		uint32_t key1 = (uint32_t)(rng->baseStreamId + streamNumber + 1);
+		uint64_t ctr  = rng->counters[streamNumber]++;
+		return sigma * local_getGaussFromCounter((uint32_t)rng->randomSeed,
+		                                         key1, ctr) + mean;
+	}
 #ifdef WITH_SPRNG
 	double x, y, r2;
 
@@ -165,14 +211,93 @@ rng_getGaussUnit(const rng_t rng, const int streamNumber)
 	return rng_getGauss(rng, streamNumber, 0.0, 1.0);
 }
 
+extern void
+rng_fillGaussUnit(const rng_t    rng,
+                  const int      streamNumber,
+                  fpv_t          *out,
+                  const uint64_t n)
+{
+	assert(rng != NULL);
+	assert(streamNumber >= 0 && streamNumber < rng->numStreamsLocal);
+	assert(out != NULL || n == 0);
+
+	if (rng_isCounterBased(rng)) {
+		uint32_t key1 = (uint32_t)(rng->baseStreamId + streamNumber + 1);
+		local_fillGaussFromCounter((uint32_t)rng->randomSeed, key1,
+		                           rng->counters[streamNumber], out, n);
+		rng->counters[streamNumber] += n;
+	} else {
+		// Keep the sequence of rng_getGaussUnit() for SPRNG, so that
+		// existing set-ups reproduce their fields.
+		for (uint64_t i = 0; i < n; i++)
+			out[i] = (fpv_t)rng_getGauss(rng, streamNumber, 0.0, 1.0);
+	}
+}
+
+extern bool
+rng_isCounterBased(const rng_t rng)
+{
+	assert(rng != NULL);
+
+	return (rng->generatorType == RNG_GENERATOR_PHILOX) ? true : false;
+}
+
+extern double
+rng_getGaussUnitAt(const rng_t rng, const uint64_t counter)
+{
+	assert(rng != NULL);
+	assert(rng_isCounterBased(rng));
+
+	return local_getGaussFromCounter((uint32_t)rng->randomSeed,
+	                                 UINT32_C(0), counter);
+}
+
+extern void
+rng_fillGaussUnitAt(const rng_t    rng,
+                    const uint64_t counter,
+                    fpv_t          *out,
+                    const uint64_t n)
+{
+	assert(rng != NULL);
+	assert(rng_isCounterBased(rng));
+	assert(out != NULL || n == 0);
+
+	local_fillGaussFromCounter((uint32_t)rng->randomSeed, UINT32_C(0),
+	                           counter, out, n);
+}
+
+extern void
+rng_philox4x32(const uint32_t ctrIn[4],
+               const uint32_t keyIn[2],
+               uint32_t       out[4])
+{
+	uint32_t ctr[4] = { ctrIn[0], ctrIn[1], ctrIn[2], ctrIn[3] };
+	uint32_t key[2] = { keyIn[0], keyIn[1] };
+
+	for (int i = 0; i < LOCAL_PHILOX_ROUNDS; i++) {
+		uint64_t prod0 = (uint64_t)LOCAL_PHILOX_M0 * ctr[0];
+		uint64_t prod1 = (uint64_t)LOCAL_PHILOX_M1 * ctr[2];
+
+		ctr[0]  = (uint32_t)(prod1 >> 32) ^ ctr[1] ^ key[0];
+		ctr[1]  = (uint32_t)prod1;
+		ctr[2]  = (uint32_t)(prod0 >> 32) ^ ctr[3] ^ key[1];
+		ctr[3]  = (uint32_t)prod0;
+		key[0] += LOCAL_PHILOX_W0;
+		key[1] += LOCAL_PHILOX_W1;
+	}
+
+	for (int i = 0; i < 4; i++)
+		out[i] = ctr[i];
+}
+
 /*--- Implementations of local functions --------------------------------*/
 static int
 local_getGeneratorType(parse_ini_t ini, const char *sectionName)
 {
 	int32_t tmp;
-	getFromIni(&tmp, parse_ini_get_int32,
-	           ini, CONFIG_GENERATOR_NAME, sectionName);
-	if ((tmp < INT32_C(0)) || (tmp > INT32_C(5))) {
+	if (!parse_ini_get_int32(ini, CONFIG_GENERATOR_NAME, sectionName, &tmp))
+		tmp = RNG_GENERATOR_PHILOX;
+	if ((tmp < INT32_C(0)) || (tmp > INT32_C(RNG_GENERATOR_PHILOX))) {
 		fprintf(stderr, "FATAL:  Generator type %i unknown!.\n",
 		        (int)tmp);
 		exit(EXIT_FAILURE);
@@ -181,11 +306,26 @@ local_getGeneratorType(parse_ini_t ini, const char *sectionName)
 }
 
 static int
-local_getNumStreamsTotal(parse_ini_t ini, const char *sectionName)
+local_getNumStreamsTotal(parse_ini_t ini,
+                         const char  *sectionName,
+                         int         generatorType)
 {
 	int32_t tmp;
-	getFromIni(&tmp, parse_ini_get_int32,
-	           ini, CONFIG_TOTALSTREAMS_NAME, sectionName);
+
+	if (generatorType == RNG_GENERATOR_PHILOX) {
+		// Optional, as the streams are not needed for rng_getGaussUnitAt().
+		if (!parse_ini_get_int32(ini, CONFIG_TOTALSTREAMS_NAME,
+		                         sectionName, &tmp)) {
+			int size = 1;
+#ifdef WITH_MPI
+			MPI_Comm_size(MPI_COMM_WORLD, &size);
+#endif
+			tmp = (int32_t)size;
+		}
+	} else {
+		getFromIni(&tmp, parse_ini_get_int32,
+		           ini, CONFIG_TOTALSTREAMS_NAME, sectionName);
+	}
 	if (tmp < INT32_C(1)) {
 		fprintf(stderr, "FATAL:  Cannot use less than 1 stream!\n");
 		exit(EXIT_FAILURE);
@@ -232,3 +372,84 @@ local_getBaseStreamId(int numStreamsLocal)
 #endif
 	return rank * numStreamsLocal;
 }
+
+/*
+ * Every Philox block gives two uniforms with 53 bits each and thus,
+ * via Box-Muller, a pair of Gaussians.  Counter c refers to element
+ * c % 2 of the pair of block c / 2.  The uniforms are generated first
+ * and transformed in a second loop, which keeps both loops free of
+ * branches.
+ */
+static void
+local_getGaussPairs(uint32_t key0,
+                    uint32_t key1,
+                    uint64_t block,
+                    uint64_t numPairs,
+                    double   *out)
+{
+	const uint32_t key[2] = { key0, key1 };
+	double         u1[LOCAL_BATCH_PAIRS], u2[LOCAL_BATCH_PAIRS];
+
+	assert(numPairs <= LOCAL_BATCH_PAIRS);
+
+	for (uint64_t i = 0; i < numPairs; i++) {
+		uint64_t b      = block + i;
+		uint32_t ctr[4] = { (uint32_t)b, (uint32_t)(b >> 32), 0, 0 };
+		uint32_t rnd[4];
+		uint64_t tmp;
+
+		rng_philox4x32(ctr, key, rnd);
+		// u1 in (0, 1] and u2 in [0, 1).
+		tmp   = ((uint64_t)rnd[0] << 32 | rnd[1]) >> 11;
+		u1[i] = (tmp + 1) * (1.0 / 9007199254740992.0);
+		tmp   = ((uint64_t)rnd[2] << 32 | rnd[3]) >> 11;
+		u2[i] = tmp * (1.0 / 9007199254740992.0);
+	}
+
+	for (uint64_t i = 0; i < numPairs; i++) {
+		double r     = sqrt(-2.0 * log(u1[i]));
+		double theta = LOCAL_TWO_PI * u2[i];
+		out[2 * i]     = r * cos(theta);
+		out[2 * i + 1] = r * sin(theta);
+	}
+}
+
+static double
+local_getGaussFromCounter(uint32_t key0, uint32_t key1, uint64_t counter)
+{
+	double pair[2];
+
+	local_getGaussPairs(key0, key1, counter >> 1, 1, pair);
+
+	return pair[counter & 1];
+}
+
+static void
+local_fillGaussFromCounter(uint32_t key0,
+                           uint32_t key1,
+                           uint64_t counter,
+                           fpv_t    *out,
+                           uint64_t n)
+{
+	double buf[2 * LOCAL_BATCH_PAIRS];
+
+	if (n > 0 && (counter & 1)) {
+		*out++ = (fpv_t)local_getGaussFromCounter(key0, key1, counter++);
+		n--;
+	}
+
+	while (n >= 2) {
+		uint64_t numPairs = n / 2;
+		if (numPairs > LOCAL_BATCH_PAIRS)
+			numPairs = LOCAL_BATCH_PAIRS;
+		local_getGaussPairs(key0, key1, counter >> 1, numPairs, buf);
+		for (uint64_t i = 0; i < 2 * numPairs; i++)
+			out[i] = (fpv_t)buf[i];
+		out     += 2 * numPairs;
+		counter += 2 * numPairs;
+		n       -= 2 * numPairs;
+	}
+
+	if (n > 0)
+		*out = (fpv_t)local_getGaussFromCounter(key0, key1, counter);
+}
@@ -18,6 +18,18 @@
 /*--- Includes ----------------------------------------------------------*/
 #include "util_config.h"
 #include "parse_ini.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+
+/*--- Exported defines --------------------------------------------------*/
+
+/**
+ * @brief  Selects the counter-based (Philox4x32-10) generator.
+ *
+ * The values below this are the SPRNG generator types.
+ */
+#define RNG_GENERATOR_PHILOX 6
 
 
 /*--- ADT handle --------------------------------------------------------*/
@@ -150,6 +162,119 @@ extern double
 rng_getGaussUnit(const rng_t rng, const int streamNumber);
 
 
+/**
+ * @brief  Fills an array with Gaussian random numbers of zero mean and
+ *         unit variance.
+ *
+ * This draws from the same stream as rng_getGaussUnit().  For
+ * counter-based generators the result is identical to @c n calls of
+ * rng_getGaussUnit(), but both numbers of each Box-Muller pair are
+ * used and the transform runs over batches.  SPRNG generators produce
+ * the same sequence as rng_getGaussUnit() as well, but they are not
+ * batched: every element is a separate call to rng_getGaussUnit(), as
+ * using both numbers of the polar method would change the fields of
+ * existing set-ups.  SPRNG builds hence gain no speed from this
+ * function.
+ *
+ * @param[in,out]  rng
+ *                    The random generator object to use.
+ * @param[in]      streamNumber
+ *                    The stream number to use.
+ * @param[out]     *out
+ *                    The array to fill, must hold at least @c n
+ *                    elements.
+ * @param[in]      n
+ *                    The number of random numbers to generate.
+ *
+ * @return  Returns nothing.
+ */
+extern void
+rng_fillGaussUnit(const rng_t    rng,
+                  const int      streamNumber,
+                  fpv_t          *out,
+                  const uint64_t n);
+
+
+/**
+ * @brief  Checks whether the generator is counter-based.
+ *
+ * @param[in]  rng
+ *                The generator object to query.
+ *
+ * @return  Returns @c true if the generator is #RNG_GENERATOR_PHILOX,
+ *          @c false otherwise.
+ */
+extern bool
+rng_isCounterBased(const rng_t rng);
+
+
+/**
+ * @brief  Generates the Gaussian random number (zero mean, unit
+ *         variance) associated with a given counter.
+ *
+ * The result only depends on the random seed and the counter, not on
+ * the number of tasks, threads, or streams, nor on the order in which
+ * the numbers are requested.  This is only available for counter-based
+ * generators.
+ *
+ * @param[in]  rng
+ *                The random generator object to use.
+ * @param[in]  counter
+ *                The counter, typically a global cell index.
+ *
+ * @return  A Gaussian distributed random number.
+ */
+extern double
+rng_getGaussUnitAt(const rng_t rng, const uint64_t counter);
+
+
+/**
+ * @brief  Fills an array with the Gaussian random numbers associated
+ *         with consecutive counters.
+ *
+ * Element @c i of @c out is the value rng_getGaussUnitAt() gives for
+ * <tt>counter + i</tt>.  This is only available for counter-based
+ * generators.
+ *
+ * @param[in]   rng
+ *                 The random generator object to use.
+ * @param[in]   counter
+ *                 The counter of the first element.
+ * @param[out]  *out
+ *                 The array to fill, must hold at least @c n elements.
+ * @param[in]   n
+ *                 The number of random numbers to generate.
+ *
+ * @return  Returns nothing.
+ */
+extern void
+rng_fillGaussUnitAt(const rng_t    rng,
+                    const uint64_t counter,
+                    fpv_t          *out,
+                    const uint64_t n);
+
+
+/**
+ * @brief  Applies the Philox4x32-10 bijection of Salmon et al. (2011),
+ *         "Parallel random numbers: as easy as 1, 2, 3".
+ *
+ * This is the raw generator underlying #RNG_GENERATOR_PHILOX.
+ *
+ * @param[in]   ctrIn
+ *                 The counter.
+ * @param[in]   keyIn
+ *                 The key.
+ * @param[out]  out
+ *                 Receives the four random words.
+ *
+ * @return  Returns nothing.
+ */
+extern void
+rng_philox4x32(const uint32_t ctrIn[4],
+               const uint32_t keyIn[2],
+               uint32_t       out[4]);
+
+
 /** @} */
 
 
@@ -162,6 +287,20 @@ rng_getGaussUnit(const rng_t rng, const int streamNumber);
  *
  * @section libutilMiscRNGIniFormat  Ini Format for RNG
  *
+ * @code
+ * # The generator type.  0 to 5 select the SPRNG generators (LFG, LCG,
+ * # LCG64, CMRG, MLFG, PMLCG), 6 (the default) selects the counter-based
+ * # Philox4x32-10 generator, which does not require SPRNG.
+ * generator = <integer>
+ * #
+ * # The total number of streams, must be an integer multiple of the
+ * # number of MPI tasks.  Optional for the counter-based generator,
+ * # where it defaults to the number of MPI tasks.
+ * numStreamsTotal = <positive integer>
+ * #
+ * # The random seed.
+ * randomSeed = <integer>
+ * @endcode
  */
 
 
@@ -19,16 +19,18 @@
 /*--- Includes ----------------------------------------------------------*/
 #include "util_config.h"
 #include "rng.h"
+#include <stdint.h>
 
 
 /*--- ADT implementation ------------------------------------------------*/
 struct rng_struct {
-	int **streams;
-	int generatorType;
-	int baseStreamId;
-	int numStreamsTotal;
-	int numStreamsLocal;
-	int randomSeed;
+	int      **streams;
+	uint64_t *counters;
+	int      generatorType;
+	int      baseStreamId;
+	int      numStreamsTotal;
+	int      numStreamsLocal;
+	int      randomSeed;
 };
 
 #endif
@@ -0,0 +1,345 @@
+// Copyright (C) 2010, 2011, Steffen Knollmann
+// Released under the terms of the GNU General Public License version 3.
+// This file is part of `ginnungagap'.
+
+
+/*--- Doxygen file description ------------------------------------------*/
+
+/**
+ * @file  libutil/rng_tests.c
+ * @ingroup  libutilMiscRNG
+ * @brief  This provides the implementations of the test functions for
+ *         rng.c.
+ */
+
+
+/*--- Includes ----------------------------------------------------------*/
+#include "util_config.h"
+#include "rng_tests.h"
+#include "rng.h"
+#include "xmem.h"
+#include <stdio.h>
+#include <math.h>
+#ifdef WITH_MPI
+#  include <mpi.h>
+#endif
+
+
+/*--- Local defines -----------------------------------------------------*/
+#define LOCAL_NUM_SAMPLES 100000
+#define LOCAL_NUM_FILL    1001
+
+
+/*--- Prototypes of local functions -------------------------------------*/
+
+
+/*--- Implementations of exported functions -----------------------------*/
+extern bool
+rng_new_test(void)
+{
+	bool   hasPassed = true;
+	int    rank      = 0;
+	int    size      = 1;
+	rng_t  rng;
+#ifdef XMEM_TRACK_MEM
+	size_t allocatedBytes = global_allocated_bytes;
+#endif
+#ifdef WITH_MPI
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+	MPI_Comm_size(MPI_COMM_WORLD, &size);
+#endif
+
+	if (rank == 0)
+		printf("Testing %s... ", __func__);
+
+	rng = rng_new(RNG_GENERATOR_PHILOX, 4 * size, 42);
+	if (rng_getNumStreamsLocal(rng) != 4)
+		hasPassed = false;
+	rng_del(&rng);
+	if (rng != NULL)
+		hasPassed = false;
+
+#ifdef XMEM_TRACK_MEM
+	if (allocatedBytes != global_allocated_bytes)
+		hasPassed = false;
+#endif
+
+	return hasPassed ? true : false;
+}
+
+extern bool
+rng_reset_test(void)
+{
+	bool   hasPassed = true;
+	int    rank      = 0;
+	rng_t  rng;
+	double first[2];
+#ifdef XMEM_TRACK_MEM
+	size_t allocatedBytes = global_allocated_bytes;
+#endif
+#ifdef WITH_MPI
+	int    size;
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+	MPI_Comm_size(MPI_COMM_WORLD, &size);
+	rng = rng_new(RNG_GENERATOR_PHILOX, 2 * size, 42);
+#else
+	rng = rng_new(RNG_GENERATOR_PHILOX, 2, 42);
+#endif
+
+	if (rank == 0)
+		printf("Testing %s... ", __func__);
+
+	first[0] = rng_getGaussUnit(rng, 0);
+	first[1] = rng_getGaussUnit(rng, 1);
+	if (first[0] == first[1])
+		hasPassed = false;
+	if (rng_getGaussUnit(rng, 0) == first[0])
+		hasPassed = false;
+
+	rng_reset(rng);
+	if (rng_getGaussUnit(rng, 1) != first[1])
+		hasPassed = false;
+	if (rng_getGaussUnit(rng, 0) != first[0])
+		hasPassed = false;
+	rng_del(&rng);
+
+#ifdef XMEM_TRACK_MEM
+	if (allocatedBytes != global_allocated_bytes)
+		hasPassed = false;
+#endif
+
+	return hasPassed ? true : false;
+}
+
+extern bool
+rng_isCounterBased_test(void)
+{
+	bool   hasPassed = true;
+	int    rank      = 0;
+	int    size      = 1;
+	rng_t  rng;
+#ifdef XMEM_TRACK_MEM
+	size_t allocatedBytes = global_allocated_bytes;
+#endif
+#ifdef WITH_MPI
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+	MPI_Comm_size(MPI_COMM_WORLD, &size);
+#endif
+
+	if (rank == 0)
+		printf("Testing %s... ", __func__);
+
+	rng = rng_new(RNG_GENERATOR_PHILOX, size, 42);
+	if (!rng_isCounterBased(rng))
+		hasPassed = false;
+	rng_del(&rng);
+
+#ifdef XMEM_TRACK_MEM
+	if (allocatedBytes != global_allocated_bytes)
+		hasPassed = false;
+#endif
+
+	return hasPassed ? true : false;
+}
+
+extern bool
+rng_getGaussUnitAt_test(void)
+{
+	bool   hasPassed = true;
+	int    rank      = 0;
+	int    size      = 1;
+	rng_t  rng, rngOther, rngSeed;
+	double sum = 0.0, sumSqr = 0.0;
+#ifdef XMEM_TRACK_MEM
+	size_t allocatedBytes = global_allocated_bytes;
+#endif
+#ifdef WITH_MPI
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+	MPI_Comm_size(MPI_COMM_WORLD, &size);
+#endif
+
+	if (rank == 0)
+		printf("Testing %s... ", __func__);
+
+	rng      = rng_new(RNG_GENERATOR_PHILOX, size, 42);
+	rngOther = rng_new(RNG_GENERATOR_PHILOX, 3 * size, 42);
+	rngSeed  = rng_new(RNG_GENERATOR_PHILOX, size, 43);
+
+	// The value must only depend on the seed and the counter.
+	if (rng_getGaussUnitAt(rng, 12345) != rng_getGaussUnitAt(rng, 12345))
+		hasPassed = false;
+	if (rng_getGaussUnitAt(rng, 12345)
+	    != rng_getGaussUnitAt(rngOther, 12345))
+		hasPassed = false;
+	(void)rng_getGaussUnit(rngOther, 0);
+	if (rng_getGaussUnitAt(rng, 7) != rng_getGaussUnitAt(rngOther, 7))
+		hasPassed = false;
+	if (rng_getGaussUnitAt(rng, 12345) == rng_getGaussUnitAt(rngSeed, 12345))
+		hasPassed = false;
+	if (rng_getGaussUnitAt(rng, 12345) == rng_getGaussUnitAt(rng, 12346))
+		hasPassed = false;
+
+	for (uint64_t i = 0; i < LOCAL_NUM_SAMPLES; i++) {
+		double g = rng_getGaussUnitAt(rng, i);
+		if (!isfinite(g))
+			hasPassed = false;
+		sum    += g;
+		sumSqr += g * g;
+	}
+	sum    /= LOCAL_NUM_SAMPLES;
+	sumSqr  = sumSqr / LOCAL_NUM_SAMPLES - sum * sum;
+	if (fabs(sum) > 0.02 || fabs(sumSqr - 1.0) > 0.02)
+		hasPassed = false;
+
+	rng_del(&rngSeed);
+	rng_del(&rngOther);
+	rng_del(&rng);
+
+#ifdef XMEM_TRACK_MEM
+	if (allocatedBytes != global_allocated_bytes)
+		hasPassed = false;
+#endif
+
+	return hasPassed ? true : false;
+}
+
+extern bool
+rng_fillGaussUnit_test(void)
+{
+	bool   hasPassed = true;
+	int    rank      = 0;
+	int    size      = 1;
+	rng_t  rng;
+	fpv_t  *data;
+#ifdef XMEM_TRACK_MEM
+	size_t allocatedBytes = global_allocated_bytes;
+#endif
+#ifdef WITH_MPI
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+	MPI_Comm_size(MPI_COMM_WORLD, &size);
+#endif
+
+	if (rank == 0)
+		printf("Testing %s... ", __func__);
+
+	rng  = rng_new(RNG_GENERATOR_PHILOX, 2 * size, 42);
+	data = xmalloc(sizeof(fpv_t) * LOCAL_NUM_FILL);
+
+	// Start at an odd position within the stream and fill twice to
+	// check that the stream continues properly.
+	(void)rng_getGaussUnit(rng, 1);
+	rng_fillGaussUnit(rng, 1, data, 500);
+	rng_fillGaussUnit(rng, 1, data + 500, LOCAL_NUM_FILL - 500);
+	rng_reset(rng);
+	(void)rng_getGaussUnit(rng, 1);
+	for (int i = 0; i < LOCAL_NUM_FILL; i++) {
+		if (data[i] != (fpv_t)rng_getGaussUnit(rng, 1))
+			hasPassed = false;
+	}
+	rng_fillGaussUnit(rng, 1, data, 0);
+
+	xfree(data);
+	rng_del(&rng);
+
+#ifdef XMEM_TRACK_MEM
+	if (allocatedBytes != global_allocated_bytes)
+		hasPassed = false;
+#endif
+
+	return hasPassed ? true : false;
+}
+
+extern bool
+rng_fillGaussUnitAt_test(void)
+{
+	bool   hasPassed = true;
+	int    rank      = 0;
+	int    size      = 1;
+	rng_t  rng;
+	fpv_t  *data;
+#ifdef XMEM_TRACK_MEM
+	size_t allocatedBytes = global_allocated_bytes;
+#endif
+#ifdef WITH_MPI
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+	MPI_Comm_size(MPI_COMM_WORLD, &size);
+#endif
+
+	if (rank == 0)
+		printf("Testing %s... ", __func__);
+
+	rng  = rng_new(RNG_GENERATOR_PHILOX, size, 42);
+	data = xmalloc(sizeof(fpv_t) * LOCAL_NUM_FILL);
+
+	for (uint64_t start = 0; start < 4; start++) {
+		for (uint64_t n = 0; n < 6; n++) {
+			rng_fillGaussUnitAt(rng, start + 1000, data, n);
+			for (uint64_t i = 0; i < n; i++) {
+				fpv_t ref = (fpv_t)rng_getGaussUnitAt(rng, start + 1000 + i);
+				if (data[i] != ref)
+					hasPassed = false;
+			}
+		}
+	}
+	rng_fillGaussUnitAt(rng, 77, data, LOCAL_NUM_FILL);
+	for (uint64_t i = 0; i < LOCAL_NUM_FILL; i++) {
+		if (data[i] != (fpv_t)rng_getGaussUnitAt(rng, 77 + i))
+			hasPassed = false;
+	}
+
+	xfree(data);
+	rng_del(&rng);
+
+#ifdef XMEM_TRACK_MEM
+	if (allocatedBytes != global_allocated_bytes)
+		hasPassed = false;
+#endif
+
+	return hasPassed ? true : false;
+}
+
+extern bool
+rng_philox4x32_test(void)
+{
+	bool           hasPassed = true;
+	int            rank      = 0;
+	uint32_t       out[4];
+	// Known answers of the Random123 distribution (kat_vectors).
+	const uint32_t ctr[3][4] = {
+		{ UINT32_C(0x00000000), UINT32_C(0x00000000),
+		  UINT32_C(0x00000000), UINT32_C(0x00000000) },
+		{ UINT32_C(0xffffffff), UINT32_C(0xffffffff),
+		  UINT32_C(0xffffffff), UINT32_C(0xffffffff) },
+		{ UINT32_C(0x243f6a88), UINT32_C(0x85a308d3),
+		  UINT32_C(0x13198a2e), UINT32_C(0x03707344) }
+	};
+	const uint32_t key[3][2] = {
+		{ UINT32_C(0x00000000), UINT32_C(0x00000000) },
+		{ UINT32_C(0xffffffff), UINT32_C(0xffffffff) },
+		{ UINT32_C(0xa4093822), UINT32_C(0x299f31d0) }
+	};
+	const uint32_t expected[3][4] = {
+		{ UINT32_C(0x6627e8d5), UINT32_C(0xe169c58d),
+		  UINT32_C(0xbc57ac4c), UINT32_C(0x9b00dbd8) },
+		{ UINT32_C(0x408f276d), UINT32_C(0x41c83b0e),
+		  UINT32_C(0xa20bc7c6), UINT32_C(0x6d5451fd) },
+		{ UINT32_C(0xd16cfe09), UINT32_C(0x94fdcceb),
+		  UINT32_C(0x5001e420), UINT32_C(0x24126ea1) }
+	};
+#ifdef WITH_MPI
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+#endif
+
+	if (rank == 0)
+		printf("Testing %s... ", __func__);
+
+	for (int i = 0; i < 3; i++) {
+		rng_philox4x32(ctr[i], key[i], out);
+		for (int j = 0; j < 4; j++) {
+			if (out[j] != expected[i][j])
+				hasPassed = false;
+		}
+	}
+
+	return hasPassed ? true : false;
+}
@@ -0,0 +1,82 @@
+// Copyright (C) 2010, 2011, Steffen Knollmann
+// Released under the terms of the GNU General Public License version 3.
+// This file is part of `ginnungagap'.
+
+#ifndef RNG_TESTS_H
+#define RNG_TESTS_H
+
+
+/*--- Doxygen file description ------------------------------------------*/
+
+/**
+ * @file  libutil/rng_tests.h
+ * @ingroup  libutilMiscRNG
+ * @brief  This provides the prototypes of the test functions for
+ *         rng.c
+ */
+
+
+/*--- Includes ----------------------------------------------------------*/
+#include "util_config.h"
+#include <stdbool.h>
+
+
+/*--- Prototypes of exported functions ----------------------------------*/
+
+/**
+ * @brief  This will test rng_new().
+ *
+ * @return  Returns true if the test succeeds, false otherwise.
+ */
+extern bool
+rng_new_test(void);
+
+/**
+ * @brief  This will test rng_reset().
+ *
+ * @return  Returns true if the test succeeds, false otherwise.
+ */
+extern bool
+rng_reset_test(void);
+
+/**
+ * @brief  This will test rng_isCounterBased().
+ *
+ * @return  Returns true if the test succeeds, false otherwise.
+ */
+extern bool
+rng_isCounterBased_test(void);
+
+/**
+ * @brief  This will test rng_getGaussUnitAt().
+ *
+ * @return  Returns true if the test succeeds, false otherwise.
+ */
+extern bool
+rng_getGaussUnitAt_test(void);
+
+/**
+ * @brief  This will test rng_fillGaussUnit().
+ *
+ * @return  Returns true if the test succeeds, false otherwise.
+ */
+extern bool
+rng_fillGaussUnit_test(void);
+
+/**
+ * @brief  This will test rng_fillGaussUnitAt().
+ *
+ * @return  Returns true if the test succeeds, false otherwise.
+ */
+extern bool
+rng_fillGaussUnitAt_test(void);
+
+/**
+ * @brief  This will test rng_philox4x32().
+ *
+ * @return  Returns true if the test succeeds, false otherwise.
+ */
+extern bool
+rng_philox4x32_test(void);
+
+#endif
@@ -119,6 +119,12 @@ stai_setElementsMulti(const stai_t stai,
 	assert(stai != NULL || numElements == UINT64_C(0));
 	assert(elements != NULL || numElements == UINT64_C(0));
 
+	if ((numElements > UINT64_C(0)) && stai_isLinear(stai)) {
+		memcpy((char *)(stai->base) + pos * stai->strideInBytes, elements,
+		       numElements * stai->sizeOfElementInBytes);
+		return;
+	}
+
 	for (uint64_t i = 0; i < numElements; i++)
 		stai_setElement(stai, pos + i, ((const char *)elements
 		                                + stai->sizeOfElementInBytes * i));
@@ -144,6 +150,12 @@ stai_getElementsMulti(const stai_t stai,
 	assert(stai != NULL || numElements == UINT64_C(0));
 	assert(elements != NULL || numElements == UINT64_C(0));
 
+	if ((numElements > UINT64_C(0)) && stai_isLinear(stai)) {
+		memcpy(elements, (char *)(stai->base) + pos * stai->strideInBytes,
+		       numElements * stai->sizeOfElementInBytes);
+		return;
+	}
+
 	for (uint64_t i = UINT64_C(0); i < numElements; i++)
 		stai_getElement(stai, pos + i,
 		                ((char *)elements + stai->sizeOfElementInBytes * i));
@@ -13,6 +13,10 @@
 
 
 /*--- Includes ----------------------------------------------------------*/
+#if (!defined _POSIX_C_SOURCE || _POSIX_C_SOURCE < 199309L)
+#  undef _POSIX_C_SOURCE
+#  define _POSIX_C_SOURCE 199309L
+#endif
 #include "util_config.h"
 #include "timer.h"
 #include <stdio.h>
@@ -26,16 +30,6 @@
 #endif
 
 
-/*--- Local variables ---------------------------------------------------*/
-#if (!defined WITH_MPI && !defined _OPENMP)
-
-/**
- * @brief  The conversion factor from the result of clock() to seconds.
- */
-static double CPS_INV = 1. / ((double)CLOCKS_PER_SEC);
-#endif
-
-
 /*--- Local defines -----------------------------------------------------*/
 
 
@@ -44,18 +38,29 @@ static double CPS_INV = 1. / ((double)CLOCKS_PER_SEC);
 
 /*--- Implementations of exported functios ------------------------------*/
 extern double
-timer_start(void)
+timer_getWallTime(void)
 {
 #if (defined WITH_MPI)
-	MPI_Barrier(MPI_COMM_WORLD);
-	return -MPI_Wtime();
+	return MPI_Wtime();
 #elif (defined _OPENMP)
-	return -omp_get_wtime();
+	return omp_get_wtime();
 #else
-	return -clock() * CPS_INV;
+	// clock() would sum the CPU time of all threads.
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (double)ts.tv_sec + 1e-9 * (double)ts.tv_nsec;
 #endif
 }
 
+extern double
+timer_start(void)
+{
+#if (defined WITH_MPI)
+	MPI_Barrier(MPI_COMM_WORLD);
+#endif
+	return -timer_getWallTime();
+}
+
 extern double
 timer_start_text(const char *text)
 {
@@ -76,10 +81,8 @@ timer_start_text(const char *text)
 extern double
 timer_stop(double timing)
 {
+	timing += timer_getWallTime();
 #if (defined WITH_MPI)
-	int rank = 0;
-	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
-	timing += MPI_Wtime();
 	{
 		double timingMax;
 		MPI_Allreduce(&timing, &timingMax, 1, MPI_DOUBLE, MPI_MAX,
@@ -87,10 +90,6 @@ timer_stop(double timing)
 		timing = timingMax;
 	}
 	MPI_Barrier(MPI_COMM_WORLD);
-#elif (defined _OPENMP)
-	timing += omp_get_wtime();
-#else
-	timing += clock() * CPS_INV;
 #endif
 
 	return timing;
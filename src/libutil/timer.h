@@ -21,6 +21,19 @@
 
 /*--- Prototypes of exported functions ----------------------------------*/
 
+/**
+ * @brief  Returns the current wall clock time.
+ *
+ * The clock is monotonic and measures elapsed real time, independent of
+ * the number of threads that are running.  Contrary to timer_start(),
+ * this does not synchronise the MPI processes.
+ *
+ * @return  Returns the time in seconds since an arbitrary, but fixed,
+ *          point in the past.
+ */
+extern double
+timer_getWallTime(void);
+
 /**
  * @brief  This start a timer.
  *
@@ -0,0 +1,297 @@
+// Copyright (C) 2012, Steffen Knollmann
+// Released under the terms of the GNU General Public License version 3.
+// This file is part of `ginnungagap'.
+
+
+/*--- Doxygen file description ------------------------------------------*/
+
+/**
+ * @file  tools/fileTools/lare_convertToBinary.c
+ * @ingroup  fileToolsLare
+ * @brief  Converts a Lagrangian region to the binary lare format.
+ */
+
+
+/*--- Includes ----------------------------------------------------------*/
+#include "../../config.h"
+#include "../../version.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <inttypes.h>
+#include <string.h>
+#include <errno.h>
+#include "../../src/libutil/xmem.h"
+#include "../../src/libutil/cmdline.h"
+#include "../../src/libutil/parse_ini.h"
+#include "../../src/liblare/lare.h"
+#include "../../src/liblare/lareIO.h"
+#include "../../src/liblare/lareReader.h"
+
+
+/*--- Local variables ---------------------------------------------------*/
+
+/** @brief  The name of the ini file describing the input region. */
+char *localIniFileName = NULL;
+
+/** @brief  The section of the ini file holding the reader setup. */
+char *localSectionName = NULL;
+
+/** @brief  The name of the binary output file. */
+char *localOutFileName = NULL;
+
+/** @brief  Stores the name of the program. */
+static const char *localProgramName = "lare_convertToBinary";
+
+
+/*--- Prototypes of local functions -------------------------------------*/
+
+/**
+ * @brief  This will initialize the environment.
+ *
+ * @param[in,out]  *argc
+ *                    Pointer to the external variable holding the
+ *                    number of command line arguments.  This number
+ *                    might be changed.
+ * @param[in,out]  ***argv
+ *                    Pointer to the external variable holding the list
+ *                    of command line argument.  This list might be
+ *                    reordered.
+ *
+ * @return  Returns nothing.
+ */
+static void
+local_initEnvironment(int *argc, char ***argv);
+
+
+/**
+ * @brief  Makes sure that a set of functions is executed if exit() is
+ *         called from somewhere in the code.
+ *
+ * @return  Returns nothing.
+ */
+static void
+local_registerCleanUpFunctions(void);
+
+
+/**
+ * @brief  This configures the command line parameters expected by the
+ *         code.
+ *
+ * @return  Returns an object that can be used to parse the command line
+ *          parameters.
+ */
+static cmdline_t
+local_cmdlineSetup(void);
+
+
+/**
+ * @brief  Checks to command line for switches that would stop the
+ *         execution of the code.
+ *
+ * @return  Returns nothing.
+ */
+static void
+local_checkForPrematureTermination(cmdline_t cmdline);
+
+
+/**
+ * @brief  Frees the memory of the local variables.
+ */
+static void
+local_freeParameterMemory(void);
+
+
+/**
+ * @brief  Prints the last words to stdout before the code returns to
+ *         the system.
+ */
+static void
+local_finalMessage(void);
+
+
+/**
+ * @brief  This will make sure that stdout could be closed.
+ *
+ * This is a sanity check.  If closing of stdout failed, this might
+ * indicate very amusing errors, e.g. if the output of the code is
+ * redirected to a file and the device the file is stored on runs out of
+ * memory, then output will not be stored.  This functions provides a
+ * way to notify the user of this problem.
+ */
+static void
+local_verifyCloseOfStdout(void);
+
+
+/*--- M A I N -----------------------------------------------------------*/
+
+/**
+ * @brief  The main function.
+ *
+ * The function will set-up the environment, read the Lagrangian region
+ * with the reader described in the ini file and write it in the binary
+ * lare format.
+ *
+ * @param[in]  argc
+ *               The number of command line arguments.
+ * @param[in]  **argv
+ *               Array of command line arguments.
+ *
+ * @return  The function will return EXIT_SUCCESS if everything went
+ *          fine or EXIT_FAILURE in the case of errors (which should be
+ *          cleanly announced on stderr).
+ */
+int
+main(int argc, char **argv)
+{
+	parse_ini_t  ini;
+	lareReader_t reader;
+	lare_t       lare;
+
+	local_registerCleanUpFunctions();
+	local_initEnvironment(&argc, &argv);
+
+	ini = parse_ini_open(localIniFileName);
+	if (ini == NULL) {
+		fprintf(stderr, "FATAL:  Could not open %s for reading.\n",
+		        localIniFileName);
+		exit(EXIT_FAILURE);
+	}
+	reader = lareReader_newFromIni(ini, localSectionName);
+	parse_ini_close(&ini);
+
+	lare = lareReader_read(reader);
+	lareReader_del(&reader);
+	printf("Read %" PRIu32 " elements, ", lare_getNumElements(lare));
+
+	lareIO_writeBinary(lare, localOutFileName);
+	printf("wrote %" PRIu32 " unique elements to %s\n",
+	       lare_getNumElements(lare), localOutFileName);
+	lare_del(&lare);
+
+	return EXIT_SUCCESS;
+}
+
+/*--- Implementations of local functions --------------------------------*/
+static void
+local_initEnvironment(int *argc, char ***argv)
+{
+	cmdline_t cmdline;
+
+	cmdline = local_cmdlineSetup();
+	cmdline_parse(cmdline, *argc, *argv);
+	local_checkForPrematureTermination(cmdline);
+	cmdline_getArgValueByNum(cmdline, 0, &localIniFileName);
+	cmdline_getArgValueByNum(cmdline, 1, &localSectionName);
+	cmdline_getArgValueByNum(cmdline, 2, &localOutFileName);
+	cmdline_del(&cmdline);
+}
+
+static void
+local_registerCleanUpFunctions(void)
+{
+	if (atexit(&local_verifyCloseOfStdout) != 0) {
+		fprintf(stderr, "cannot register `%s' as exit function\n",
+		        "local_verifyCloseOfStdout");
+		exit(EXIT_FAILURE);
+	}
+	if (atexit(&local_finalMessage) != 0) {
+		fprintf(stderr, "cannot register `%s' as exit function\n",
+		        "local_finalMessage");
+		exit(EXIT_FAILURE);
+	}
+	if (atexit(&local_freeParameterMemory) != 0) {
+		fprintf(stderr, "cannot register `%s' as exit function\n",
+		        "&local_freeParameterMemory");
+		exit(EXIT_FAILURE);
+	}
+}
+
+static void
+local_freeParameterMemory(void)
+{
+	if (localIniFileName != NULL)
+		xfree(localIniFileName);
+	if (localSectionName != NULL)
+		xfree(localSectionName);
+	if (localOutFileName != NULL)
+		xfree(localOutFileName);
+}
+
+static void
+local_finalMessage(void)
+{
+#ifdef ENABLE_XMEM_TRACK_MEM
+	printf("\n");
+	xmem_info(stdout);
+	printf("\n");
+#endif
+	printf("\nAll done.\nThank you for using `%s'!\n"
+	       "Vertu sæl/sæll...\n",
+	       localProgramName);
+}
+
+static void
+local_verifyCloseOfStdout(void)
+{
+	if (fclose(stdout) != 0) {
+		int errnum = errno;
+		fprintf(stderr, "%s", strerror(errnum));
+		_Exit(EXIT_FAILURE);
+	}
+}
+
+static cmdline_t
+local_cmdlineSetup(void)
+{
+	cmdline_t cmdline;
+
+	cmdline = cmdline_new(3, 2, localProgramName);
+	(void)cmdline_addOpt(cmdline, "version",
+	                     "This will output a version information.",
+	                     false, CMDLINE_TYPE_NONE);
+	(void)cmdline_addOpt(cmdline, "help",
+	                     "This will print this help text.",
+	                     false, CMDLINE_TYPE_NONE);
+	(void)cmdline_addArg(cmdline,
+	                     "The ini file describing the Lagrangian region.",
+	                     CMDLINE_TYPE_STRING);
+	(void)cmdline_addArg(cmdline,
+	                     "The section holding readerType and readerSection.",
+	                     CMDLINE_TYPE_STRING);
+	(void)cmdline_addArg(cmdline,
+	                     "The name of the binary output file.",
+	                     CMDLINE_TYPE_STRING);
+
+	return cmdline;
+}
+
+static void
+local_checkForPrematureTermination(cmdline_t cmdline)
+{
+	// This relies on the knowledge of which number is which option!
+	// Not nice style, but the respective calls are directly above.
+	if (cmdline_checkOptSetByNum(cmdline, 0)) {
+		PRINT_VERSION_INFO2(stdout, localProgramName);
+		printf("%s", CONFIG_SUMMARY_STRING);
+		cmdline_del(&cmdline);
+		exit(EXIT_SUCCESS);
+	}
+	if (cmdline_checkOptSetByNum(cmdline, 1)) {
+		cmdline_printHelp(cmdline, stdout);
+		cmdline_del(&cmdline);
+		exit(EXIT_SUCCESS);
+	}
+	if (!cmdline_verify(cmdline)) {
+		cmdline_printHelp(cmdline, stderr);
+		cmdline_del(&cmdline);
+		exit(EXIT_FAILURE);
+	}
+}
+
+/*--- Doxygen group definitions -----------------------------------------*/
+
+/**
+ * @defgroup  fileToolsLare  Tools for Lagrangian region files
+ * @ingroup fileTools
+ * @brief  Provides tools to work with Lagrangian region files.
+ */
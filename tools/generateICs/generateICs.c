@@ -38,6 +38,7 @@
 #include "../../src/libutil/gadgetHeader.h"
 #include "../../src/libutil/gadgetTOC.h"
 #include "../../src/libg9p/g9pICMap.h"
+#include "../../src/libg9p/g9pIDGenerator.h"
 #include "../../src/libgrid/gridPatch.h"
 #include "../../src/libpart/partBunch.h"
 
@@ -70,14 +71,17 @@ local_alloc(void);
 inline static void
 local_init(generateICs_t genics);
 
-static void
-local_setupCore(generateICsCore_t   core,
-                const generateICs_t genics);
-
-
 /**
  * @brief  Helper function for generateICs_run().
  *
+ * The work is split into tiles and levels and distributed over the
+ * available OpenMP threads.  The particles of each tile and level are
+ * written straight to their precomputed position in the file and freed
+ * afterwards, hence only one tile per thread is kept in memory and the
+ * result does not depend on the number of threads.  Reading the
+ * velocities and writing the particles is serialised, as the readers and
+ * the output file are shared.
+ *
  * @param[in,out]  genics
  *                    The application to work with.
  * @param[in]      map
@@ -86,15 +90,137 @@ local_setupCore(generateICsCore_t   core,
  * @param[in]      file
  *                    The file number to work on.
  *
+ * @return  Returns the number of particles written to the file.
+ */
+static uint64_t
+local_doFile(generateICs_t genics, const g9pICMap_t map, int file);
+
+
+/**
+ * @brief  Generates and writes the particles of one tile on one level.
+ *
+ * @param[in,out]  genics
+ *                    The application to work with.
+ * @param[in]      tile
+ *                    The tile to work on.
+ * @param[in]      level
+ *                    The level to work on.
+ * @param[in]      numParticles
+ *                    The number of dark matter particles of the tile on
+ *                    this level.
+ * @param[in]      pSkip
+ *                    The position of the first dark matter particle in the
+ *                    file.
+ * @param[in]      pSkipGas
+ *                    The position of the first gas particle in the file,
+ *                    only used if gas particles are generated for this
+ *                    level.
+ *
  * @return  Returns nothing.
  */
 static void
-local_doFile(generateICs_t genics, const g9pICMap_t map, int file);
+local_doTileOnLevel(generateICs_t genics,
+                    uint32_t      tile,
+                    uint8_t       level,
+                    uint64_t      numParticles,
+                    uint64_t      pSkip,
+                    uint64_t      pSkipGas);
+
+
+/**
+ * @brief  Degrades (or refines) the mask of a tile to the resolution of a
+ *         given level.
+ *
+ * Every cell of the patch gets the level of the mask cell it lies in, or,
+ * for levels coarser than the mask, of the first mask cell it covers.
+ *
+ * @param[in]   genics
+ *                 The application to work with.
+ * @param[in]   tile
+ *                 The tile to work on.
+ * @param[in]   level
+ *                 The level of the patch.
+ * @param[in]   patch
+ *                 The patch of the tile on this level.
+ * @param[out]  numCells
+ *                 Receives the number of cells of the patch that are on
+ *                 @c level.
+ *
+ * @return  Returns a new array holding the level of each cell of the
+ *          patch, or @c NULL if the tile is uniform.
+ */
+static int8_t *
+local_getLevelsOfPatch(const generateICs_t genics,
+                       uint32_t            tile,
+                       uint8_t             level,
+                       const gridPatch_t   patch,
+                       uint64_t            *numCells);
+
+
+/**
+ * @brief  Checks that the files written by all processes hold the
+ *         expected number of particles.
+ *
+ * This is a collective operation.  The program is terminated if the
+ * numbers do not match.  The expectation is taken from the IC map, so the
+ * gas particles are counted on the level they were actually placed on.
+ *
+ * @param[in]  genics
+ *                The application to work with.
+ * @param[in]  map
+ *                The IC map the files were written from.
+ * @param[in]  npLocal
+ *                The number of particles written by the calling process.
+ *
+ * @return  Returns nothing.
+ */
+static void
+local_checkNumParticles(const generateICs_t genics,
+                        const g9pICMap_t    map,
+                        uint64_t            npLocal);
+
+static partBunch_t
+local_getParticleStorage(uint64_t numParticles, bool useLongIDs);
+
+
+/**
+ * @brief  Creates a Gadget file and writes its header.
+ *
+ * @param[in,out]  genics
+ *                    The application to work with.
+ * @param[in]      file
+ *                    The number of the file to create.
+ * @param[in]      np
+ *                    The number of particles of each type in the file.
+ *
+ * @return  Returns nothing, the file is left open for writing.
+ */
+static void
+local_openGadgetFile(generateICs_t genics, int file, const uint32_t np[6]);
 
+
+/**
+ * @brief  Writes particles to the currently open Gadget file.
+ *
+ * @param[in,out]  genics
+ *                    The application to work with.
+ * @param[in]      particles
+ *                    The particles to write from.
+ * @param[in]      first
+ *                    The first particle to write.
+ * @param[in]      num
+ *                    The number of particles to write.
+ * @param[in]      pSkip
+ *                    The position of the first particle in the file.
+ *
+ * @return  Returns nothing.
+ */
 static void
-local_writeGadgetFile(generateICs_t     genics,
-                      int               file,
-                      const partBunch_t particles);
+local_writeParticles(generateICs_t     genics,
+                     const partBunch_t particles,
+                     uint64_t          first,
+                     uint64_t          num,
+                     uint64_t          pSkip);
 
 
 /*--- Exported functions: Creating and deleting -------------------------*/
@@ -129,6 +255,8 @@ generateICs_del(generateICs_t *genics)
 		g9pDataStore_del(&(*genics)->datastore);
 	if ( (*genics)->mask != NULL )
 		g9pMask_del(&(*genics)->mask);
+	if ( (*genics)->idGen != NULL )
+		g9pIDGenerator_del(&(*genics)->idGen);
 
 	xfree(*genics);
 
@@ -161,27 +289,85 @@ generateICs_run(generateICs_t genics)
 {
 	assert(genics != NULL);
 
-	g9pICMap_t map = g9pICMap_new( genics->out->numFiles, 0, NULL,
-	                               g9pMask_getRef(genics->mask) );
+	const uint8_t  minLevel  = g9pMask_getMinLevel(genics->mask);
+	const uint8_t  maxLevel  = g9pMask_getMaxLevel(genics->mask);
+	const int      numLevels = g9pMask_getNumLevel(genics->mask);
+	int8_t         gasLevel;
+	uint32_t       dim1Ds[5];
+	uint64_t       npTotal[5];
+	uint64_t       *numCells;
+
+	// Only the levels that actually hold cells become particle types,
+	// those need velocities and there must not be more than Gadget has
+	// types for.
+	numCells              = g9pMask_getNumCellsTotal(genics->mask, NULL);
+	genics->numUsedLevels = 0;
+	for (int k = 0; k < numLevels; k++) {
+		const uint8_t level = maxLevel - k;
+
+		if (numCells[level - minLevel] == UINT64_C(0))
+			continue;
+
+		if (genics->in->velx[level - genics->in->minLevel] == NULL) {
+			fprintf(stderr, "FATAL:  The mask holds %" PRIu64 " cells on "
+			        "level %i, but there are no velocities for it.  Use "
+			        "a datastoreSection to provide them.\n",
+			        numCells[level - minLevel], (int)level);
+			diediedie(EXIT_FAILURE);
+		}
+		if (genics->numUsedLevels == 5) {
+			fprintf(stderr, "FATAL:  The mask holds cells on more than 5 "
+			        "levels, at most 5 can be stored in Gadget files.\n");
+			diediedie(EXIT_FAILURE);
+		}
+		dim1Ds[genics->numUsedLevels]  =
+		    g9pHierarchy_getDim1DAtLevel(genics->hierarchy, level);
+		npTotal[genics->numUsedLevels] = numCells[level - minLevel];
+		genics->usedLevels[genics->numUsedLevels++] = level;
+	}
+	xfree(numCells);
+	gasLevel = (int8_t)genics->usedLevels[0];
 
-	if (genics->rank == 0)
-		generateICs_printSummary(genics, stdout);
+	g9pICMap_t map = g9pICMap_new( genics->out->numFiles,
+	                               genics->mode->doGas ? 1 : 0,
+	                               genics->mode->doGas ? &gasLevel : NULL,
+	                               g9pMask_getRef(genics->mask) );
 
-	const uint32_t    tmp      = g9pMask_getDim1D(genics->mask);
-	gridPointUint32_t fullDims = {tmp, tmp, tmp};
-	generateICsOut_initBaseHeader(genics->out, genics->data, fullDims,
-	                              genics->mode);
+	genics->idGen = g9pIDGenerator_new(g9pHierarchy_getRef(genics->hierarchy),
+	                                   maxLevel);
 
-	for (uint32_t i = 0; i < genics->out->numFiles; i++) {
-		printf(" * Working on file %i\n", i);
-		double timing = timer_start();
+	if (genics->rank == 0) {
+		generateICs_printSummary(genics, stdout);
+		for (int i = 0; i < genics->numUsedLevels; i++)
+			printf("Level %2i       : %" PRIu64 " particles (type %i)\n",
+			       genics->usedLevels[i], npTotal[i], i + 1);
+	}
 
-		local_doFile(genics, map, i);
+	generateICsOut_initBaseHeader(genics->out, genics->data,
+	                              genics->numUsedLevels,
+	                              dim1Ds, npTotal, genics->mode);
+
+	// The files are dealt out round-robin over the processes; all of
+	// them take part in every round as timer_stop() is collective.
+	uint64_t npLocal = UINT64_C(0);
+	for (uint32_t round = 0; round < genics->out->numFiles;
+	     round += genics->size) {
+		uint32_t i      = round + genics->rank;
+		double   timing = timer_start();
+
+		if (i < genics->out->numFiles) {
+			printf(" * Working on file %i (rank %i)\n", i, genics->rank);
+			npLocal += local_doFile(genics, map, i);
+		}
 
 		timing = timer_stop(timing);
-		printf("      File processed in in %.2fs\n", timing);
+		if (genics->rank == 0)
+			printf("      Files processed in %.2fs\n", timing);
 	}
 
+	local_checkNumParticles(genics, map, npLocal);
+
+	g9pIDGenerator_del(&(genics->idGen));
 	g9pICMap_del(&map);
 } // generateICs_run
 
@@ -218,50 +404,265 @@ local_init(generateICs_t genics)
 	genics->hierarchy = NULL;
 	genics->datastore = NULL;
 	genics->mask      = NULL;
+	genics->idGen     = NULL;
+
+	genics->numUsedLevels = 0;
 } // local_init
 
 static uint64_t
-local_computeNumParts(const generateICs_t genics, uint32_t tile)
+local_doFile(generateICs_t genics, const g9pICMap_t map, int file)
 {
-	uint64_t np;
+	const uint8_t  minLevel  = g9pMask_getMinLevel(genics->mask);
+	const uint8_t  *levels   = genics->usedLevels;
+	const int      numLevels = genics->numUsedLevels;
+	const uint32_t firstTile = g9pICMap_getFirstTileInFile(map, file);
+	const uint32_t lastTile  = g9pICMap_getLastTileInFile(map, file);
+	const uint32_t numTiles  = lastTile - firstTile + 1;
+	const uint64_t *npLevel  = g9pICMap_getNumCellsPerLevelInFile(map, file);
+	uint32_t       np[6]     = {0, 0, 0, 0, 0, 0};
+	uint64_t       pSkip[6];
+	uint64_t       *offsets;
+	uint64_t       npFile    = UINT64_C(0);
+
+	// The header stores the number of particles per type in 32bit, the
+	// blocks themselves may exceed 4GB.
+	for (int k = 0; k < numLevels; k++) {
+		if (npLevel[levels[k] - minLevel] > UINT32_MAX) {
+			fprintf(stderr, "FATAL:  File %i would hold %" PRIu64
+			        " particles on level %i, Gadget headers can only "
+			        "describe %" PRIu32 ".  Use more files.\n",
+			        file, npLevel[levels[k] - minLevel], (int)levels[k],
+			        UINT32_MAX);
+			diediedie(EXIT_FAILURE);
+		}
+	}
 
-	np = g9pMask_getNumCellsInTileForLevel( genics->mask, tile,
-	                                        g9pMask_getMinLevel(genics->mask) );
+	// Gas comes first, then the dark matter levels from fine to coarse,
+	// the offsets are relative to the first particle of the level.
+	if (genics->mode->doGas)
+		np[0] = (uint32_t)npLevel[levels[0] - minLevel];
+	for (int k = 0; k < numLevels; k++)
+		np[k + 1] = (uint32_t)npLevel[levels[k] - minLevel];
+	pSkip[0] = UINT64_C(0);
+	for (int i = 1; i < 6; i++)
+		pSkip[i] = pSkip[i - 1] + np[i - 1];
+	npFile   = pSkip[5] + np[5];
+
+	offsets = xmalloc( sizeof(uint64_t) * numLevels * (numTiles + 1) );
+	for (int k = 0; k < numLevels; k++) {
+		uint64_t *off = offsets + k * (numTiles + 1);
+		off[0] = UINT64_C(0);
+		for (uint32_t t = 0; t < numTiles; t++)
+			off[t + 1] = off[t]
+			             + g9pMask_getNumCellsInTileForLevel(genics->mask,
+			                                                 firstTile + t,
+			                                                 levels[k]);
+		assert(off[numTiles] == np[k + 1]);
+	}
 
-	return np;
-}
+	local_openGadgetFile(genics, file, np);
+
+#ifdef WITH_OPENMP
+#  pragma omp parallel for shared(genics, offsets, pSkip) schedule(dynamic)
+#endif
+	for (uint64_t w = 0; w < (uint64_t)numTiles * numLevels; w++) {
+		const uint32_t t    = (uint32_t)(w / numLevels);
+		const int      k    = (int)(w % numLevels);
+		const uint64_t *off = offsets + k * (numTiles + 1);
+
+		if (off[t + 1] == off[t])
+			continue;
+
+		local_doTileOnLevel(genics, firstTile + t, levels[k],
+		                    off[t + 1] - off[t], pSkip[k + 1] + off[t],
+		                    pSkip[0] + off[t]);
+	}
+	xfree(offsets);
+
+	gadget_close(genics->out->gadget);
+
+	for (int k = 0; k < numLevels; k++)
+		printf("   Level %2i particles: %" PRIu32 "\n", levels[k], np[k + 1]);
+	if (genics->mode->doGas)
+		printf("   Gas particles: %" PRIu32 "\n", np[0]);
+
+	return npFile;
+} // local_doFile
 
 static void
-local_setupCore(generateICsCore_t   core,
-                const generateICs_t genics)
+local_doTileOnLevel(generateICs_t genics,
+                    uint32_t      tile,
+                    uint8_t       level,
+                    uint64_t      numParticles,
+                    uint64_t      pSkip,
+                    uint64_t      pSkipGas)
 {
-	core->fullDims[0] = g9pMask_getDim1D(genics->mask);
-	core->fullDims[1] = core->fullDims[0];
-	core->fullDims[2] = core->fullDims[0];
+	const bool        withGas = genics->mode->doGas
+	                            && (level == genics->usedLevels[0]);
+	const uint8_t     idx     = level - genics->in->minLevel;
+	int8_t            *levels;
+	uint64_t          numCells;
+	partBunch_t       particles;
+	generateICsCore_s core    = GENICSCORE_INIT_STRUCT(genics->data,
+	                                                   genics->mode);
+
+	core.patch = g9pMask_getEmptyPatchForTileOnLevel(genics->mask, tile,
+	                                                 level);
+	levels     = local_getLevelsOfPatch(genics, tile, level, core.patch,
+	                                    &numCells);
+	if (numCells != numParticles) {
+		fprintf(stderr, "FATAL:  Tile %" PRIu32 " has %" PRIu64 " cells on "
+		        "level %i, but the mask claims %" PRIu64 ".  The coarse "
+		        "regions of the mask are not aligned to their level.\n",
+		        tile, numCells, (int)level, numParticles);
+		diediedie(EXIT_FAILURE);
+	}
 
-	printf("   fullDims = (%u, %u, %u)\n", core->fullDims[0],
-	       core->fullDims[1], core->fullDims[2]);
-}
+	particles = local_getParticleStorage(withGas ? 2 * numParticles
+	                                     : numParticles,
+	                                     genics->mode->useLongIDs);
+
+	core.fullDims[0]  = g9pHierarchy_getDim1DAtLevel(genics->hierarchy,
+	                                                 level);
+	core.fullDims[1]  = core.fullDims[0];
+	core.fullDims[2]  = core.fullDims[0];
+	core.numParticles = numParticles;
+	core.pos          = partBunch_at(particles, 0, 0);
+	core.vel          = partBunch_at(particles, 1, 0);
+	core.id           = partBunch_at(particles, 2, 0);
+	core.levels       = levels;
+	core.level        = (int8_t)level;
+	core.idGen        = genics->idGen;
 
-static partBunch_t
-local_getParticleStorage(const generateICs_t genics,
-                         const uint32_t      firstTile,
-                         const uint32_t      lastTile)
+#ifdef WITH_OPENMP
+#  pragma omp critical (generateICs_read)
+#endif
+	{
+		(void)gridPatch_attachVar(core.patch, genics->in->varVelx);
+		(void)gridPatch_attachVar(core.patch, genics->in->varVely);
+		(void)gridPatch_attachVar(core.patch, genics->in->varVelz);
+
+		gridReader_readIntoPatchForVar(genics->in->velx[idx], core.patch, 0);
+		gridReader_readIntoPatchForVar(genics->in->vely[idx], core.patch, 1);
+		gridReader_readIntoPatchForVar(genics->in->velz[idx], core.patch, 2);
+	}
+
+	generateICsCore_toParticles(&core);
+
+#ifdef WITH_OPENMP
+#  pragma omp critical (generateICs_read)
+#endif
+	gridPatch_del( &(core.patch) );
+	if (levels != NULL)
+		xfree(levels);
+
+	if (withGas) {
+		core.numParticles = partBunch_getNumParticles(particles);
+		generateICsCode_dm2Gas(&core, 0.25,
+		                       g9pIDGenerator_getMaxID(genics->idGen));
+	}
+
+#ifdef WITH_OPENMP
+#  pragma omp critical (generateICs_write)
+#endif
+	{
+		if (withGas) {
+			local_writeParticles(genics, particles, 0, numParticles,
+			                     pSkipGas);
+			local_writeParticles(genics, particles, numParticles,
+			                     numParticles, pSkip);
+		} else {
+			local_writeParticles(genics, particles, 0, numParticles, pSkip);
+		}
+	}
+
+	partBunch_del(&particles);
+} // local_doTileOnLevel
+
+static int8_t *
+local_getLevelsOfPatch(const generateICs_t genics,
+                       uint32_t            tile,
+                       uint8_t             level,
+                       const gridPatch_t   patch,
+                       uint64_t            *numCells)
 {
-	uint64_t numParticles = UINT64_C(0);
-	for (uint32_t i = firstTile; i <= lastTile; i++) {
-		numParticles += local_computeNumParts(genics, i);
+	const uint8_t     maskLevel = g9pMask_getMaskLevel(genics->mask);
+	const uint32_t    fac       = g9pHierarchy_getFactorBetweenLevel(
+	    genics->hierarchy, level, maskLevel);
+	gridPointUint32_t dims, dimsMask;
+	int8_t            *maskData, *levels;
+
+	gridPatch_getDims(patch, dims);
+	*numCells = gridPatch_getNumCells(patch);
+
+	if (g9pMask_getUniformLevelOfTile(genics->mask, tile)
+	    != G9PMASK_TILE_IS_MIXED) {
+		if (g9pMask_getUniformLevelOfTile(genics->mask, tile) != level)
+			*numCells = UINT64_C(0);
+		return NULL;
 	}
-	if (genics->mode->doGas)
-		numParticles *= 2;
 
+	for (int i = 0; i < NDIM; i++)
+		dimsMask[i] = (level >= maskLevel) ? dims[i] / fac : dims[i] * fac;
+	maskData  = g9pMask_getTileData(genics->mask, tile, NULL);
+	levels    = xmalloc(sizeof(int8_t) * *numCells);
+	*numCells = UINT64_C(0);
+
+	for (uint32_t k = 0; k < dims[2]; k++) {
+		for (uint32_t j = 0; j < dims[1]; j++) {
+			for (uint32_t i = 0; i < dims[0]; i++) {
+				gridPointUint32_t m = {i, j, k};
+				uint64_t          c;
+
+				for (int d = 0; d < NDIM; d++)
+					m[d] = (level >= maskLevel) ? m[d] / fac : m[d] * fac;
+				c         = i + (j + (uint64_t)k * dims[1]) * dims[0];
+				levels[c] = maskData[lIdx_fromCoord3d(m, dimsMask)];
+				if (levels[c] == (int8_t)level)
+					(*numCells)++;
+			}
+		}
+	}
+	xfree(maskData);
+
+	return levels;
+} // local_getLevelsOfPatch
+
+static void
+local_checkNumParticles(const generateICs_t genics,
+                        const g9pICMap_t    map,
+                        uint64_t            npLocal)
+{
+	uint64_t npTotal    = npLocal;
+	uint64_t npExpected = UINT64_C(0);
+
+	for (uint32_t i = 0; i < genics->out->numFiles; i++)
+		npExpected += g9pICMap_getNumParticlesInFile(map, i);
+
+#ifdef WITH_MPI
+	MPI_Allreduce(&npLocal, &npTotal, 1, MPI_UINT64_T, MPI_SUM,
+	              MPI_COMM_WORLD);
+#endif
+
+	if (npTotal != npExpected) {
+		fprintf(stderr, "FATAL:  Wrote %" PRIu64 " particles, expected %"
+		        PRIu64 ".\n", npTotal, npExpected);
+		diediedie(EXIT_FAILURE);
+	}
+	if (genics->rank == 0)
+		printf(" * Wrote %" PRIu64 " particles in total\n", npTotal);
+}
+
+static partBunch_t
+local_getParticleStorage(uint64_t numParticles, bool useLongIDs)
+{
 	dataVar_t      var;
 	dataParticle_t desc = dataParticle_new("Standard", 0, 3);
 	var = dataVar_new("Position", DATAVARTYPE_FPV, NDIM);
 	(void)dataParticle_addVar(desc, var);
 	var = dataVar_new("Velocity", DATAVARTYPE_FPV, NDIM);
 	(void)dataParticle_addVar(desc, var);
-	if (genics->mode->useLongIDs)
+	if (useLongIDs)
 		var = dataVar_new("ID", DATAVARTYPE_INT64, 1);
 	else
 		var = dataVar_new("ID", DATAVARTYPE_INT32, 1);
@@ -275,72 +676,14 @@ local_getParticleStorage(const generateICs_t genics,
 } // local_getParticleStorage
 
 static void
-local_doFile(generateICs_t genics, g9pICMap_t map, int file)
+local_openGadgetFile(generateICs_t genics, int file, const uint32_t np[6])
 {
-	uint32_t    firstTile = g9pICMap_getFirstTileInFile(map, file);
-	uint32_t    lastTile  = g9pICMap_getLastTileInFile(map, file);
-	uint64_t    partsRead = UINT64_C(0);
-
-	partBunch_t particles = local_getParticleStorage(genics,
-	                                                 firstTile, lastTile);
-
-	generateICsCore_s core = GENICSCORE_INIT_STRUCT(genics->data,
-	                                                genics->mode);
-	local_setupCore(&core, genics);
-
-	for (uint32_t i = firstTile; i <= lastTile; i++) {
-		core.numParticles = local_computeNumParts(genics, i);
-		core.pos          = partBunch_at(particles, 0, partsRead);
-		core.vel          = partBunch_at(particles, 1, partsRead);
-		core.id           = partBunch_at(particles, 2, partsRead);
-		core.patch        = g9pMask_getEmptyPatchForTile(genics->mask, i);
-		(void)gridPatch_attachVar(core.patch, genics->in->varVelx);
-		(void)gridPatch_attachVar(core.patch, genics->in->varVely);
-		(void)gridPatch_attachVar(core.patch, genics->in->varVelz);
-
-		gridReader_readIntoPatchForVar(genics->in->velx, core.patch, 0);
-		gridReader_readIntoPatchForVar(genics->in->vely, core.patch, 1);
-		gridReader_readIntoPatchForVar(genics->in->velz, core.patch, 2);
-
-		generateICsCore_toParticles(&core);
-
-		gridPatch_del( &(core.patch) );
-		partsRead += core.numParticles;
-	}
-	printf("   Particles read: %lu\n", partsRead);
-	if (genics->mode->doGas) {
-		uint64_t npGasTotal = core.fullDims[0];
-		npGasTotal *= core.fullDims[1];
-		npGasTotal *= core.fullDims[2];
-		core.numParticles = partBunch_getNumParticles(particles);
-		core.pos          = partBunch_at(particles, 0, 0);
-		core.vel          = partBunch_at(particles, 1, 0);
-		core.id           = partBunch_at(particles, 2, 0);
-		generateICsCode_dm2Gas(&core, 0.25, npGasTotal);
-	}
-
-	local_writeGadgetFile(genics, file, particles);
-
-	partBunch_del(&particles);
-} // local_doFile
-
-static void
-local_writeGadgetFile(generateICs_t     genics,
-                      int               file,
-                      const partBunch_t particles)
-{
-	uint32_t       npLocal[6] = {0, 0, 0, 0, 0, 0};
+	uint32_t       npLocal[6];
 	double         massArr[6] = {0., 0., 0., 0., 0., 0.};
 	gadgetHeader_t myHeader;
 
-	const uint64_t               np = partBunch_getNumParticles(particles);
-	if (genics->mode->doGas) {
-		assert(np % 2 == 0);
-		npLocal[0] = np / 2;
-		npLocal[1] = npLocal[0];
-	} else {
-		npLocal[1] = (uint32_t)np;
-	}
+	for (int i = 0; i < 6; i++)
+		npLocal[i] = np[i];
 
 	myHeader   = gadgetHeader_clone(genics->out->baseHeader);
 	gadgetHeader_getMassArr(myHeader, massArr);
@@ -353,28 +696,31 @@ local_writeGadgetFile(generateICs_t     genics,
 	                     gadgetTOC_clone(genics->out->toc) );
 	gadget_open(genics->out->gadget, GADGET_MODE_WRITE_CREATE, file);
 	gadget_writeHeaderToCurrentFile(genics->out->gadget);
-	{
-		stai_t stai;
-		stai = stai_new( partBunch_at(particles, 0, 0),
-		                 3 * sizeof(fpv_t), 3 * sizeof(fpv_t) );
-		gadget_writeBlockToCurrentFile(genics->out->gadget, GADGETBLOCK_POS_,
-		                               0, np, stai);
-		stai_del(&stai);
-		stai = stai_new( partBunch_at(particles, 1, 0),
-		                 3 * sizeof(fpv_t), 3 * sizeof(fpv_t) );
-		gadget_writeBlockToCurrentFile(genics->out->gadget, GADGETBLOCK_VEL_,
-		                               0, np, stai);
-		stai_del(&stai);
-		if (genics->mode->useLongIDs) {
-			stai = stai_new( partBunch_at(particles, 2, 0),
-			                 sizeof(uint64_t), sizeof(uint64_t) );
-		} else {
-			stai = stai_new( partBunch_at(particles, 2, 0),
-			                 sizeof(uint32_t), sizeof(uint32_t) );
-		}
-		gadget_writeBlockToCurrentFile(genics->out->gadget, GADGETBLOCK_ID__,
-		                               0, np, stai);
-		stai_del(&stai);
-	}
-	gadget_close(genics->out->gadget);
-} // local_writeGadgetFile
+}
+
+static void
+local_writeParticles(generateICs_t     genics,
+                     const partBunch_t particles,
+                     uint64_t          first,
+                     uint64_t          num,
+                     uint64_t          pSkip)
+{
+	const size_t sizeOfID = genics->mode->useLongIDs ? sizeof(uint64_t)
+	                        : sizeof(uint32_t);
+	stai_t       stai;
+
+	stai = stai_new( partBunch_at(particles, 0, first),
+	                 3 * sizeof(fpv_t), 3 * sizeof(fpv_t) );
+	gadget_writeBlockToCurrentFile(genics->out->gadget, GADGETBLOCK_POS_,
+	                               pSkip, num, stai);
+	stai_del(&stai);
+	stai = stai_new( partBunch_at(particles, 1, first),
+	                 3 * sizeof(fpv_t), 3 * sizeof(fpv_t) );
+	gadget_writeBlockToCurrentFile(genics->out->gadget, GADGETBLOCK_VEL_,
+	                               pSkip, num, stai);
+	stai_del(&stai);
+	stai = stai_new(partBunch_at(particles, 2, first), sizeOfID, sizeOfID);
+	gadget_writeBlockToCurrentFile(genics->out->gadget, GADGETBLOCK_ID__,
+	                               pSkip, num, stai);
+	stai_del(&stai);
+} // local_writeParticles
@@ -27,15 +27,153 @@
 
 /*--- Prototypes of local functions -------------------------------------*/
 
+/**
+ * @brief  Tabulates the unperturbed positions of the cells of the patch
+ *         along one dimension.
+ *
+ * The positions are already shifted by one box length, the values are
+ * identical to the ones generateICsCore_initPosID() and
+ * generateICsCore_vel2pos() produce before applying the displacement.
+ *
+ * @param[in]  d
+ *                The core data.
+ * @param[in]  idxLo
+ *                The lower index of the patch along the dimension.
+ * @param[in]  dim
+ *                The extent of the patch along the dimension.
+ *
+ * @return  Returns a new array of @c dim values.
+ */
+static fpv_t *
+local_getPosTable(generateICsCore_const_t d, uint32_t idxLo, uint32_t dim);
+
+
+/**
+ * @brief  Counts the used cells in each row of the patch.
+ *
+ * @param[in]  d
+ *                The core data, @c d->levels must not be @c NULL.
+ * @param[in]  dims
+ *                The dimensions of the patch.
+ *
+ * @return  Returns a new array holding for each row the index of the first
+ *          particle of the row, the last element holds the total number of
+ *          particles.
+ */
+static uint64_t *
+local_getRowStarts(generateICsCore_const_t d, const gridPointUint32_t dims);
+
+
+/**
+ * @brief  Fills in the IDs of one row of cells.
+ *
+ * @param[in]   d
+ *                 The core data.
+ * @param[in]   first
+ *                 The index of the first particle of the row.
+ * @param[in]   num
+ *                 The number of cells in the row.
+ * @param[in]   levels
+ *                 The levels of the cells in the row, or @c NULL if all
+ *                 cells are used.
+ * @param[in]   firstID
+ *                 The ID of the first cell of the row.
+ * @param[in]   stepID
+ *                 The difference between the IDs of neighbouring cells.
+ *
+ * @return  Returns nothing.
+ */
+inline static void
+local_fillIDsOfRow(generateICsCore_const_t d,
+                   uint64_t                first,
+                   uint32_t                num,
+                   const int8_t            *levels,
+                   uint64_t                firstID,
+                   uint64_t                stepID);
+
 
 /*--- Implementations of exported functions -----------------------------*/
 extern void
 generateICsCore_toParticles(generateICsCore_const_t d)
 {
-	generateICsCore_initPosID(d);
-	generateICsCore_vel2pos(d);
-	generateICsCore_convertVel(d);
-}
+	gridPointUint32_t  dims, idxLo, origin = {0, 0, 0}, unitX = {1, 0, 0};
+	const fpv_t        *velxP     = gridPatch_getVarDataHandle(d->patch, 0);
+	const fpv_t        *velyP     = gridPatch_getVarDataHandle(d->patch, 1);
+	const fpv_t        *velzP     = gridPatch_getVarDataHandle(d->patch, 2);
+	fpv_t *restrict    pos        = d->pos;
+	fpv_t *restrict    vel        = d->vel;
+	const int8_t       *levels    = d->levels;
+	const int8_t       level      = d->level;
+	const double       vFact      = d->data->vFact;
+	const double       posFactor  = d->data->posFactor;
+	const fpv_t        boxLen     = (fpv_t)(d->data->boxsizeInMpch
+	                                        * posFactor);
+	const fpv_t        fac        = d->data->velFactor / sqrt(d->data->aInit);
+	fpv_t              *posTable[NDIM];
+	uint64_t           *rowStarts = NULL;
+	uint64_t           stepID;
+
+	assert(d->idGen != NULL);
+
+	gridPatch_getIdxLo(d->patch, idxLo);
+	gridPatch_getDims(d->patch, dims);
+	for (int i = 0; i < NDIM; i++)
+		posTable[i] = local_getPosTable(d, idxLo[i], dims[i]);
+	stepID = g9pIDGenerator_calcID(d->idGen, unitX, level)
+	         - g9pIDGenerator_calcID(d->idGen, origin, level);
+	if (levels != NULL) {
+		rowStarts = local_getRowStarts(d, dims);
+		assert(rowStarts[(uint64_t)dims[1] * dims[2]] == d->numParticles);
+	}
+
+	// Single pass over the patch: the positions along y and z and the
+	// ID of the first cell are computed once per row, everything else
+	// is streamed.  This runs serially, the caller distributes the tiles
+	// over the threads.
+	for (uint32_t k = 0; k < dims[2]; k++) {
+		for (uint32_t j = 0; j < dims[1]; j++) {
+			const uint64_t    row   = (j + (uint64_t)k * dims[1]) * dims[0];
+			const uint64_t    first = (levels == NULL) ? row
+			                          : rowStarts[j + (uint64_t)k * dims[1]];
+			const fpv_t       y     = posTable[1][j];
+			const fpv_t       z     = posTable[2][k];
+			gridPointUint32_t coord = {idxLo[0], idxLo[1] + j, idxLo[2] + k};
+			uint64_t          p     = first;
+
+			for (uint32_t i = 0; i < dims[0]; i++) {
+				const uint64_t c = row + i;
+
+				if ( (levels != NULL) && (levels[c] != level) )
+					continue;
+
+				const fpv_t vx = velxP[c];
+				const fpv_t vy = velyP[c];
+				const fpv_t vz = velzP[c];
+
+				pos[p * 3]     = fmod( (fpv_t)( (posTable[0][i] + vFact * vx)
+				                                * posFactor ), boxLen );
+				pos[p * 3 + 1] = fmod( (fpv_t)( (y + vFact * vy)
+				                                * posFactor ), boxLen );
+				pos[p * 3 + 2] = fmod( (fpv_t)( (z + vFact * vz)
+				                                * posFactor ), boxLen );
+				vel[p * 3]     = vx * fac;
+				vel[p * 3 + 1] = vy * fac;
+				vel[p * 3 + 2] = vz * fac;
+				p++;
+			}
+
+			local_fillIDsOfRow(d, first, dims[0],
+			                   (levels == NULL) ? NULL : levels + row,
+			                   g9pIDGenerator_calcID(d->idGen, coord, level),
+			                   stepID);
+		}
+	}
+
+	if (rowStarts != NULL)
+		xfree(rowStarts);
+	for (int i = 0; i < NDIM; i++)
+		xfree(posTable[i]);
+} // generateICsCore_toParticles
 
 extern void
 generateICsCore_initPosID(generateICsCore_const_t d)
@@ -122,10 +260,6 @@ generateICsCode_dm2Gas(generateICsCore_const_t d,
 	                         * gasOffset;
 	uint64_t     npGasOrDM = d->numParticles / 2;
 
-	printf("   Gas offset: %lf\n", shift);
-	printf("   Local gas particles: %lu\n", npGasOrDM);
-	printf("   Total gas particles: %lu\n", npGasTotal);
-
 	memcpy(d->pos + 3 * npGasOrDM, d->pos, sizeof(fpv_t) * 3 * npGasOrDM);
 	memcpy(d->vel + 3 * npGasOrDM, d->vel, sizeof(fpv_t) * 3 * npGasOrDM);
 	if (d->mode->useLongIDs) {
@@ -157,3 +291,64 @@ generateICsCode_dm2Gas(generateICsCore_const_t d,
 } // generateICsCode_dm2Gas
 
 /*--- Implementations of local functions --------------------------------*/
+static fpv_t *
+local_getPosTable(generateICsCore_const_t d, uint32_t idxLo, uint32_t dim)
+{
+	const double dx     = d->data->boxsizeInMpch / d->fullDims[0];
+	fpv_t        *table = xmalloc(sizeof(fpv_t) * dim);
+
+	for (uint32_t i = 0; i < dim; i++) {
+		table[i]  = (fpv_t)( (idxLo + i + .5) * dx );
+		table[i] += (fpv_t)(d->data->boxsizeInMpch);
+	}
+
+	return table;
+}
+
+static uint64_t *
+local_getRowStarts(generateICsCore_const_t d, const gridPointUint32_t dims)
+{
+	const uint64_t numRows   = (uint64_t)dims[1] * dims[2];
+	uint64_t       *rowStart = xmalloc(sizeof(uint64_t) * (numRows + 1));
+
+	for (uint64_t r = 0; r < numRows; r++) {
+		const int8_t *levels = d->levels + r * dims[0];
+		uint64_t     num     = 0;
+		for (uint32_t i = 0; i < dims[0]; i++)
+			num += (levels[i] == d->level) ? 1 : 0;
+		rowStart[r + 1] = num;
+	}
+
+	rowStart[0] = UINT64_C(0);
+	for (uint64_t r = 0; r < numRows; r++)
+		rowStart[r + 1] += rowStart[r];
+
+	return rowStart;
+}
+
+inline static void
+local_fillIDsOfRow(generateICsCore_const_t d,
+                   uint64_t                first,
+                   uint32_t                num,
+                   const int8_t            *levels,
+                   uint64_t                firstID,
+                   uint64_t                stepID)
+{
+	uint64_t p = first;
+
+	if (d->mode->useLongIDs) {
+		uint64_t *id = d->id;
+		for (uint32_t i = 0; i < num; i++) {
+			if ( (levels != NULL) && (levels[i] != d->level) )
+				continue;
+			id[p++] = firstID + i * stepID;
+		}
+	} else {
+		uint32_t *id = d->id;
+		for (uint32_t i = 0; i < num; i++) {
+			if ( (levels != NULL) && (levels[i] != d->level) )
+				continue;
+			id[p++] = (uint32_t)(firstID + i * stepID);
+		}
+	}
+}
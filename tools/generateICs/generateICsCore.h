@@ -20,6 +20,7 @@
 #include "generateICsData.h"
 #include "generateICsMode.h"
 #include "../../src/libgrid/gridPatch.h"
+#include "../../src/libg9p/g9pIDGenerator.h"
 
 
 /*--- Simple structure easing the data passing --------------------------*/
@@ -30,6 +31,12 @@ struct generateICsCore_struct {
 	fpv_t                   *pos;
 	fpv_t                   *vel;
 	void                    *id;
+	/** @brief  The level of each cell, @c NULL to use all cells. */
+	const int8_t            *levels;
+	/** @brief  The level on which the patch lives. */
+	int8_t                  level;
+	/** @brief  The ID generator. */
+	g9pIDGenerator_t        idGen;
 	const generateICsData_t data;
 	const generateICsMode_t mode;
 };
@@ -42,16 +49,34 @@ typedef struct generateICsCore_struct *const generateICsCore_const_t;
 /*--- Exported defines --------------------------------------------------*/
 #define GENICSCORE_INIT_STRUCT(d, m) \
 	{                                \
-		.patch = NULL,               \
-		.pos   = NULL,               \
-		.vel   = NULL,               \
-		.id    = NULL,               \
-		.data  = (d),                \
-		.mode  = (m),                \
+		.patch  = NULL,              \
+		.pos    = NULL,              \
+		.vel    = NULL,              \
+		.id     = NULL,              \
+		.levels = NULL,              \
+		.level  = 0,                 \
+		.idGen  = NULL,              \
+		.data   = (d),               \
+		.mode   = (m),               \
 	}
 
 
 /*--- Prototypes of exported functions ----------------------------------*/
+
+/**
+ * @brief  Converts the velocities in a patch to particles.
+ *
+ * If @c d->levels is given, only the cells whose level equals
+ * @c d->level are converted and the particles are stored contiguously.
+ * The number of such cells must equal @c d->numParticles.  The IDs are
+ * provided by @c d->idGen.  The conversion itself is serial, threads
+ * are meant to work on different patches concurrently.
+ *
+ * @param[in]  d
+ *                The core data.
+ *
+ * @return  Returns nothing.
+ */
 extern void
 generateICsCore_toParticles(generateICsCore_const_t d);
 
@@ -37,6 +37,7 @@
 #include "../../src/libg9p/g9pDataStore.h"
 #include "../../src/libg9p/g9pMask.h"
 #include "../../src/libg9p/g9pMaskIO.h"
+#include "../../src/libg9p/g9pFieldID.h"
 #include "../../src/libutil/parse_ini.h"
 #include "../../src/libutil/xmem.h"
 #include "../../src/libutil/xstring.h"
@@ -69,6 +70,8 @@ struct generateICs_IniData_struct {
 	char   *datastoreSection;
 	/** @brief  Stores key @c maskSection. */
 	char   *maskSection;
+	/** @brief  Stores key @c maskReaderSection. */
+	char   *maskReaderSection;
 };
 
 /** @brief  Short name for a reference to the helper structure.  */
@@ -175,11 +178,18 @@ local_iniDataNewFromIni_section(generateICs_iniData_t iniData,
  * @brief  Helper function for generateICsFactory_newFromIni() dealing with
  *         the input.
  *
+ * If a data store section is given, the velocities of all levels of the
+ * mask are read from the data store, otherwise the input section provides
+ * the velocities of the minimum level of the mask, which then must be the
+ * only level holding cells.
+ *
  * @param[in,out]  ini
  *                    The ini file to work with.
- * @param[in]      *levelSection
+ * @param[in]      *secName
  *                    The name of the section from which to construct the
  *                    input details.
+ * @param[in]      *dsSecName
+ *                    The name of the data store section, may be @c NULL.
  * @param[in,out]  genics
  *                    The object to work with.
  *
@@ -188,9 +198,55 @@ local_iniDataNewFromIni_section(generateICs_iniData_t iniData,
 inline static void
 local_newFromIni_input(parse_ini_t   ini,
                        const char    *secName,
+                       const char    *dsSecName,
                        generateICs_t genics);
 
 
+/**
+ * @brief  Helper function for generateICsFactory_newFromIni() dealing with
+ *         the data store.
+ *
+ * @param[in,out]  ini
+ *                    The ini file to work with.
+ * @param[in]      *secName
+ *                    The name of the data store section, may be @c NULL in
+ *                    which case no data store is used.
+ * @param[in]      hierarchy
+ *                    The hierarchy the data store is organized by.
+ *
+ * @return  Returns a new data store or @c NULL if @c secName is @c NULL.
+ */
+inline static g9pDataStore_t
+local_newFromIni_datastore(parse_ini_t    ini,
+                           const char     *secName,
+                           g9pHierarchy_t hierarchy);
+
+
+/**
+ * @brief  Creates a reader for one field of one level of the data store.
+ *
+ * @param[in,out]  ini
+ *                    The ini file to work with.
+ * @param[in]      *dsSecName
+ *                    The name of the data store section, it provides the
+ *                    reader type and optionally further reader details.
+ * @param[in]      datastore
+ *                    The data store to use.
+ * @param[in]      level
+ *                    The level for which to create the reader.
+ * @param[in]      fid
+ *                    The field for which to create the reader.
+ *
+ * @return  Returns a new reader.
+ */
+inline static gridReader_t
+local_newReaderForDataStore(parse_ini_t          ini,
+                            const char           *dsSecName,
+                            const g9pDataStore_t datastore,
+                            uint8_t              level,
+                            g9pFieldID_t         fid);
+
+
 /**
  * @brief  Helper function for generateICsFactory_newFromIni() dealing with
  *         the output.
@@ -242,15 +298,25 @@ generateICsFactory_newFromIni(parse_ini_t ini, const char *sectionName)
 	hierarchy = g9pHierarchyIO_newFromIni(ini, iniData->hierarchySection);
 	generateICs_setHierarchy(genics, hierarchy);
 
-	g9pDataStore_t datastore = NULL;
+	g9pDataStore_t datastore;
+	datastore = local_newFromIni_datastore(ini, iniData->datastoreSection,
+	                                       hierarchy);
 	generateICs_setDataStore(genics, datastore);
 
 	g9pMask_t mask;
 	mask = g9pMaskIO_newFromIni( ini, iniData->maskSection,
 	                             g9pHierarchy_getRef(hierarchy) );
+	if (iniData->maskReaderSection != NULL) {
+		gridReader_t reader;
+		reader = gridReaderFactory_newReaderFromIni(ini,
+		                                            iniData->maskReaderSection);
+		g9pMaskIO_read(mask, reader);
+		gridReader_del(&reader);
+	}
 	generateICs_setMask(genics, mask);
 
-	local_newFromIni_input(ini, iniData->inputSection, genics);
+	local_newFromIni_input(ini, iniData->inputSection,
+	                       iniData->datastoreSection, genics);
 	local_newFromIni_output(ini, iniData->outputSection, genics);
 
 	local_iniDataDel(&iniData);
@@ -292,7 +358,8 @@ local_iniDataInit(generateICs_iniData_t iniData)
 	iniData->cosmologySection = NULL;
 	iniData->hierarchySection = NULL;
 	iniData->datastoreSection = NULL;
-	iniData->maskSection      = NULL;
+	iniData->maskSection       = NULL;
+	iniData->maskReaderSection = NULL;
 }
 
 static void
@@ -315,6 +382,8 @@ local_iniDataDel(generateICs_iniData_t *iniData)
 		xfree( (*iniData)->datastoreSection );
 	if ( (*iniData)->maskSection != NULL )
 		xfree( (*iniData)->maskSection );
+	if ( (*iniData)->maskReaderSection != NULL )
+		xfree( (*iniData)->maskReaderSection );
 
 	xfree(*iniData);
 }
@@ -414,30 +483,99 @@ local_iniDataNewFromIni_section(generateICs_iniData_t iniData,
 		iniData->maskSection = xstrdup(
 		    GENERATEICSCONFIG_DEFAULT_MASKSECTION);
 	}
+	// The remaining sections are optional and stay NULL if not given.
+	(void)parse_ini_get_string( ini, "datastoreSection", secName,
+	                            &(iniData->datastoreSection) );
+	(void)parse_ini_get_string( ini, "maskReaderSection", secName,
+	                            &(iniData->maskReaderSection) );
 } // local_iniDataNewFromIni_section
 
 inline static void
 local_newFromIni_input(parse_ini_t   ini,
                        const char    *secName,
+                       const char    *dsSecName,
                        generateICs_t genics)
 {
-	char         *name;
-	gridReader_t reader[3];
+	const g9pMask_t mask     = generateICs_getMask(genics);
+	const uint8_t   minLevel = g9pMask_getMinLevel(mask);
+	const uint8_t   maxLevel = g9pMask_getMaxLevel(mask);
+	generateICsIn_t in;
+
+	in = generateICsIn_new(minLevel, maxLevel - minLevel + 1);
+
+	if (dsSecName != NULL) {
+		g9pDataStore_t ds = generateICs_getDataStore(genics);
+		for (int l = minLevel; l <= maxLevel; l++) {
+			generateICsIn_setReaders(
+			    in, (uint8_t)l,
+			    local_newReaderForDataStore(ini, dsSecName, ds, l,
+			                                G9PFIELDID_VX),
+			    local_newReaderForDataStore(ini, dsSecName, ds, l,
+			                                G9PFIELDID_VY),
+			    local_newReaderForDataStore(ini, dsSecName, ds, l,
+			                                G9PFIELDID_VZ));
+		}
+	} else {
+		char         *name;
+		gridReader_t reader[3];
 
-	getFromIni(&name, parse_ini_get_string, ini, "velxSection", secName);
-	reader[0] = gridReaderFactory_newReaderFromIni(ini, name);
-	xfree(name);
+		// Without a data store only the minimum level has velocities,
+		// generateICs_run() checks that no other level holds cells.
+		getFromIni(&name, parse_ini_get_string, ini, "velxSection", secName);
+		reader[0] = gridReaderFactory_newReaderFromIni(ini, name);
+		xfree(name);
 
-	getFromIni(&name, parse_ini_get_string, ini, "velySection", secName);
-	reader[1] = gridReaderFactory_newReaderFromIni(ini, name);
-	xfree(name);
+		getFromIni(&name, parse_ini_get_string, ini, "velySection", secName);
+		reader[1] = gridReaderFactory_newReaderFromIni(ini, name);
+		xfree(name);
+
+		getFromIni(&name, parse_ini_get_string, ini, "velzSection", secName);
+		reader[2] = gridReaderFactory_newReaderFromIni(ini, name);
+		xfree(name);
+
+		generateICsIn_setReaders(in, minLevel, reader[0], reader[1],
+		                         reader[2]);
+	}
+
+	generateICs_setIn(genics, in);
+} // local_newFromIni_input
 
-	getFromIni(&name, parse_ini_get_string, ini, "velzSection", secName);
-	reader[2] = gridReaderFactory_newReaderFromIni(ini, name);
+inline static g9pDataStore_t
+local_newFromIni_datastore(parse_ini_t    ini,
+                           const char     *secName,
+                           g9pHierarchy_t hierarchy)
+{
+	g9pDataStore_t ds;
+	char           *name;
+	char           *basePath = NULL;
+
+	if (secName == NULL)
+		return NULL;
+
+	getFromIni(&name, parse_ini_get_string, ini, "name", secName);
+	(void)parse_ini_get_string(ini, "basePath", secName, &basePath);
+
+	ds = g9pDataStore_new(g9pHierarchy_getRef(hierarchy), name, basePath);
+
+	if (basePath != NULL)
+		xfree(basePath);
 	xfree(name);
 
-	generateICs_setIn( genics,
-	                   generateICsIn_new(reader[0], reader[1], reader[2]) );
+	return ds;
+}
+
+inline static gridReader_t
+local_newReaderForDataStore(parse_ini_t          ini,
+                            const char           *dsSecName,
+                            const g9pDataStore_t datastore,
+                            uint8_t              level,
+                            g9pFieldID_t         fid)
+{
+	filename_t fn = g9pDataStore_getFileName(datastore, level, fid);
+
+	// The section provides the reader type and optionally more details,
+	// e.g. a suffix.
+	return gridReaderFactory_newReaderFromIniWithFileName(ini, dsSecName, fn);
 }
 
 inline static void
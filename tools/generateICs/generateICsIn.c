@@ -27,14 +27,20 @@
 
 /*--- Implementations of exported functions -----------------------------*/
 extern generateICsIn_t
-generateICsIn_new(gridReader_t velx, gridReader_t vely, gridReader_t velz)
+generateICsIn_new(uint8_t minLevel, uint8_t numLevels)
 {
 	generateICsIn_t in;
 
-	in          = xmalloc( sizeof(struct generateICsIn_struct) );
-	in->velx    = velx;
-	in->vely    = vely;
-	in->velz    = velz;
+	assert(numLevels > 0);
+
+	in            = xmalloc( sizeof(struct generateICsIn_struct) );
+	in->minLevel  = minLevel;
+	in->numLevels = numLevels;
+	in->velx      = xmalloc(sizeof(gridReader_t) * numLevels * 3);
+	in->vely      = in->velx + numLevels;
+	in->velz      = in->vely + numLevels;
+	for (uint8_t i = 0; i < numLevels * 3; i++)
+		in->velx[i] = NULL;
 
 	in->varVelx = dataVar_new("velx", DATAVARTYPE_FPV, 1);
 	in->varVely = dataVar_new("vely", DATAVARTYPE_FPV, 1);
@@ -43,6 +49,28 @@ generateICsIn_new(gridReader_t velx, gridReader_t vely, gridReader_t velz)
 	return in;
 }
 
+extern void
+generateICsIn_setReaders(generateICsIn_t in,
+                         uint8_t         level,
+                         gridReader_t    velx,
+                         gridReader_t    vely,
+                         gridReader_t    velz)
+{
+	assert(in != NULL);
+	assert(level >= in->minLevel && level - in->minLevel < in->numLevels);
+
+	const uint8_t i = level - in->minLevel;
+
+	if (in->velx[i] != NULL) {
+		gridReader_del(in->velx + i);
+		gridReader_del(in->vely + i);
+		gridReader_del(in->velz + i);
+	}
+	in->velx[i] = velx;
+	in->vely[i] = vely;
+	in->velz[i] = velz;
+}
+
 extern void
 generateICsIn_del(generateICsIn_t *in)
 {
@@ -52,9 +80,14 @@ generateICsIn_del(generateICsIn_t *in)
 	dataVar_del( &( (*in)->varVely ) );
 	dataVar_del( &( (*in)->varVelz ) );
 
-	gridReader_del( &( (*in)->velx ) );
-	gridReader_del( &( (*in)->vely ) );
-	gridReader_del( &( (*in)->velz ) );
+	for (uint8_t i = 0; i < (*in)->numLevels; i++) {
+		if ( (*in)->velx[i] != NULL ) {
+			gridReader_del( (*in)->velx + i );
+			gridReader_del( (*in)->vely + i );
+			gridReader_del( (*in)->velz + i );
+		}
+	}
+	xfree( (*in)->velx );
 	xfree(*in);
 
 	*in = NULL;
@@ -27,9 +27,12 @@ typedef struct generateICsIn_struct *generateICsIn_t;
 
 /*--- Structure definition ----------------------------------------------*/
 struct generateICsIn_struct {
-	gridReader_t velx;
-	gridReader_t vely;
-	gridReader_t velz;
+	uint8_t      minLevel;
+	uint8_t      numLevels;
+	// One reader per level, starting at minLevel
+	gridReader_t *velx;
+	gridReader_t *vely;
+	gridReader_t *velz;
 	// Auto generated
 	dataVar_t    varVelx;
 	dataVar_t    varVely;
@@ -39,7 +42,14 @@ struct generateICsIn_struct {
 
 /*--- Prototypes of exported functions ----------------------------------*/
 extern generateICsIn_t
-generateICsIn_new(gridReader_t velx, gridReader_t vely, gridReader_t velz);
+generateICsIn_new(uint8_t minLevel, uint8_t numLevels);
+
+extern void
+generateICsIn_setReaders(generateICsIn_t in,
+                         uint8_t         level,
+                         gridReader_t    velx,
+                         gridReader_t    vely,
+                         gridReader_t    velz);
 
 extern void
 generateICsIn_del(generateICsIn_t *generateICsIn);
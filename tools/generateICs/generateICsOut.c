@@ -71,7 +71,9 @@ generateICsOut_del(generateICsOut_t *genicsOut)
 extern void
 generateICsOut_initBaseHeader(generateICsOut_t        genicsOut,
                               const generateICsData_t data,
-                              const uint32_t          np[3],
+                              int                     numLevels,
+                              const uint32_t          *dim1Ds,
+                              const uint64_t          *npTotal,
                               const generateICsMode_t mode)
 {
 	uint64_t       npall[6];
@@ -82,14 +84,20 @@ generateICsOut_initBaseHeader(generateICsOut_t        genicsOut,
 
 	gadgetHeader_t header       = gadgetHeader_new();
 
+	assert(numLevels > 0 && numLevels < 6);
+
 	for (int i = 0; i < 6; i++) {
 		npall[i]   = 0;
 		massarr[i] = 0;
 	}
 
-	npall[1]    = (uint64_t)(np[0]) * (uint64_t)(np[1]) * (uint64_t)(np[2]);
-	massarr[1]  = boxsize * boxsize * boxsize * omegaMatter0 / (npall[1]);
-	massarr[1] *= COSMO_RHO_CRIT0 * 1e-10;
+	for (int i = 0; i < numLevels; i++) {
+		uint64_t numCells = POW_NDIM( (uint64_t)(dim1Ds[i]) );
+		npall[i + 1]    = npTotal[i];
+		massarr[i + 1]  = boxsize * boxsize * boxsize * omegaMatter0
+		                  / (numCells);
+		massarr[i + 1] *= COSMO_RHO_CRIT0 * 1e-10;
+	}
 
 	if (mode->doGas) {
 		const double omegaBaryon0 = cosmoModel_getOmegaBaryon0(data->model);
@@ -44,10 +44,35 @@ generateICsOut_new(const char *prefix, int outputFiles, gadgetVersion_t v);
 extern void
 generateICsOut_del(generateICsOut_t *genicsOut);
 
+/**
+ * @brief  Sets up the header common to all files.
+ *
+ * The dark matter particles of each level are stored as a separate
+ * particle type, starting with the finest level as type 1.  Gas particles
+ * (type 0) are only generated for the finest level.
+ *
+ * @param[in,out]  genicsOut
+ *                    The output object to work with.
+ * @param[in]      data
+ *                    The resolution independent data.
+ * @param[in]      numLevels
+ *                    The number of levels, at most 5.
+ * @param[in]      dim1Ds
+ *                    The 1D grid size of each level, finest level first.
+ * @param[in]      npTotal
+ *                    The total number of particles on each level, finest
+ *                    level first.
+ * @param[in]      mode
+ *                    The operational mode.
+ *
+ * @return  Returns nothing.
+ */
 extern void
 generateICsOut_initBaseHeader(generateICsOut_t        genicsOut,
                               const generateICsData_t data,
-                              const uint32_t          np[3],
+                              int                     numLevels,
+                              const uint32_t          *dim1Ds,
+                              const uint64_t          *npTotal,
                               const generateICsMode_t mode);
 
 
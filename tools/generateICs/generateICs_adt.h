@@ -29,6 +29,7 @@
 #include "../../src/libg9p/g9pHierarchy.h"
 #include "../../src/libg9p/g9pDataStore.h"
 #include "../../src/libg9p/g9pMask.h"
+#include "../../src/libg9p/g9pIDGenerator.h"
 
 
 /*--- Implemention of main structure ------------------------------------*/
@@ -53,6 +54,15 @@ struct generateICs_struct {
 	g9pDataStore_t datastore;
 	/** @brief  Stores the mask. */
 	g9pMask_t      mask;
+	/** @brief  Stores the ID generator, only valid while running. */
+	g9pIDGenerator_t idGen;
+	/**
+	 * @brief  Stores the levels that hold particles, from fine to coarse,
+	 *         only valid while running.
+	 */
+	uint8_t          usedLevels[5];
+	/** @brief  Stores the number of used levels. */
+	int              numUsedLevels;
 
 	/** @brief  Stores the input information. */
 	generateICsIn_t in;
@@ -133,16 +133,23 @@ local_registerCleanUpFunctions(void)
 static void
 local_finalMessage(void)
 {
+	int rank = 0;
+#ifdef WITH_MPI
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+	MPI_Finalize();
+#endif
 	if (local_iniFileName != NULL)
 		xfree(local_iniFileName);
 	if (local_sectionName != NULL)
 		xfree(local_sectionName);
+	if (rank == 0) {
 #ifdef XMEM_TRACK_MEM
-	printf("\n");
-	xmem_info(stdout);
-	printf("\n");
+		printf("\n");
+		xmem_info(stdout);
+		printf("\n");
 #endif
-	printf("\nVertu sæl/sæll...\n");
+		printf("\nVertu sæl/sæll...\n");
+	}
 }
 
 static void
@@ -13,6 +13,9 @@
 #include <inttypes.h>
 #include <string.h>
 #include <stdbool.h>
+#ifdef WITH_MPI
+#  include <mpi.h>
+#endif
 #include "../../src/libcosmo/cosmo.h"
 #include "../../src/libcosmo/cosmoModel.h"
 #include "../../src/libutil/xmem.h"
@@ -60,33 +63,39 @@ local_getSlabNumbers(int i,
                      int *numSlabs);
 
 static void
-local_initposid(float    *pos,
-                uint32_t *id,
-                uint64_t np[3],
-                int      zStart,
-                int      zEnd,
-                double   dx,
-                bool     doGas);
+local_writeFile(grafic2gadget_t g2g,
+                gadget_t        gadget,
+                int             fileNum,
+                int             numSlabStart,
+                int             numSlabEnd);
 
 static void
-local_initposidLong(float    *pos,
-                    uint64_t *id,
-                    uint64_t np[3],
-                    int      zStart,
-                    int      zEnd,
-                    double   dx,
-                    bool     doGas);
+local_readSlab(const grafic2gadget_t g2g, float *velIn, int slabNum);
 
 static void
-local_vel2pos(float    *vel,
-              float    *pos,
-              uint64_t num,
-              double   boxsize,
-              double   vFact,
-              double   posFactor);
+local_convertSlab(const grafic2gadget_t g2g,
+                  const float *restrict velIn,
+                  float *restrict       pos,
+                  float *restrict       vel,
+                  void *restrict        id,
+                  int                   slabNum);
+
+static inline void
+local_convertParticle(const grafic2gadget_t g2g,
+                      const float           posInit[3],
+                      const float           velIn[3],
+                      float                 velFac,
+                      float *restrict       pos,
+                      float *restrict       vel);
 
 static void
-local_convertVel(float *vel, uint64_t num, double aInit, double velFactor);
+local_writeSlab(const grafic2gadget_t g2g,
+                gadget_t              gadget,
+                float                 *pos,
+                float                 *vel,
+                void                  *id,
+                uint64_t              pSkip,
+                uint64_t              numLocal);
 
 static void
 local_checkForIDOverflow(uint64_t np[3], bool useLongIDs, bool doGas);
@@ -146,130 +155,73 @@ grafic2gadget_del(grafic2gadget_t *g2g)
 extern void
 grafic2gadget_run(grafic2gadget_t g2g)
 {
-	grafic_t       gvx, gvy, gvz;
-	uint64_t       np[3];
 	uint64_t       numPlane;
-	double         dx, boxsize, vFact, aInit;
 	cosmoModel_t   model;
 	gadget_t       gadget;
 	gadgetHeader_t baseHeader;
 	gadgetTOC_t    toc;
+	int            rank = 0;
+	int            size = 1;
 
 	assert(g2g != NULL);
 
-	gvx    = grafic_newFromFile(g2g->graficFileNameVx);
-	gvy    = grafic_newFromFile(g2g->graficFileNameVy);
-	gvz    = grafic_newFromFile(g2g->graficFileNameVz);
+#ifdef WITH_MPI
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+	MPI_Comm_size(MPI_COMM_WORLD, &size);
+#endif
+
+	g2g->gv[0] = grafic_newFromFile(g2g->graficFileNameVx);
+	g2g->gv[1] = grafic_newFromFile(g2g->graficFileNameVy);
+	g2g->gv[2] = grafic_newFromFile(g2g->graficFileNameVz);
 
-	gadget = gadget_newSimple(g2g->gadgetFileStem, g2g->numGadgetFiles);
+	gadget     = gadget_newSimple(g2g->gadgetFileStem, g2g->numGadgetFiles);
 	gadget_setFileVersion(gadget, GADGETVERSION_ONE);
 
-	local_getFactors(gvx, np, &dx, &boxsize, &vFact, &aInit, &model,
-	                 g2g->omegaBaryon0);
-	if (np[2] < g2g->numGadgetFiles) {
+	local_getFactors(g2g->gv[0], g2g->np, &(g2g->dx), &(g2g->boxsize),
+	                 &(g2g->vFact), &(g2g->aInit), &model, g2g->omegaBaryon0);
+	if (g2g->np[2] < g2g->numGadgetFiles) {
 		fprintf(stderr,
 		        "Cannot write more files than planes, reduce the number "
 		        "of Gadget files.\n");
 		diediedie(EXIT_FAILURE);
 	}
-	local_checkForIDOverflow(np, g2g->useLongIDs, g2g->doGas);
-	baseHeader = local_getBaseHeader(gadget, boxsize, aInit, model, np,
-	                                 g2g->doGas, g2g->useLongIDs,
+	local_checkForIDOverflow(g2g->np, g2g->useLongIDs, g2g->doGas);
+	baseHeader = local_getBaseHeader(gadget, g2g->boxsize, g2g->aInit, model,
+	                                 g2g->np, g2g->doGas, g2g->useLongIDs,
 	                                 g2g->posFactor);
 	toc        = local_getTOC();
 
-	numPlane   = np[0] * np[1];
-	for (int i = 0; i < g2g->numGadgetFiles; i++) {
+	numPlane   = g2g->np[0] * g2g->np[1];
+	for (int i = rank; i < g2g->numGadgetFiles; i += size) {
 		int            numSlabStart, numSlabEnd, numSlabs;
 		int64_t        numLocal;
-		uint64_t       numLocalParticles;
-		float          *vel, *pos;
-		void           *id;
 		uint32_t       npLocal[6] = {0, 0, 0, 0, 0, 0};
 		double         massArr[6] = {0., 0., 0., 0., 0., 0.};
 		gadgetHeader_t myHeader;
 
-		local_getSlabNumbers(i, g2g->numGadgetFiles, np[2],
+		local_getSlabNumbers(i, g2g->numGadgetFiles, g2g->np[2],
 		                     &numSlabStart, &numSlabEnd, &numSlabs);
 		myHeader   = gadgetHeader_clone(baseHeader);
 		numLocal   = numSlabs * numPlane;
 		npLocal[1] = numLocal;
 		if (g2g->doGas)
 			npLocal[0] = numLocal;
-		numLocalParticles = npLocal[0] + npLocal[1];
 		gadgetHeader_setNp(myHeader, npLocal);
 		gadgetTOC_calcSizes(toc, npLocal, massArr, false, g2g->useLongIDs);
 		gadgetTOC_calcOffset(toc);
 		gadget_setHeaderOfFile(gadget, i, myHeader);
 		gadget_setTOCOfFile(gadget, i, gadgetTOC_clone(toc));
 
-		vel = xmalloc(sizeof(float) * numLocalParticles * 3);
-		pos = xmalloc(sizeof(float) * numLocalParticles * 3);
-		if (g2g->useLongIDs)
-			id = xmalloc(sizeof(uint64_t) * numLocalParticles);
-		else
-			id = xmalloc(sizeof(uint32_t) * numLocalParticles);
-
-		for (int j = numSlabStart; j <= numSlabEnd; j++) {
-			grafic_readSlab(gvx,
-			                vel + 3 * (j - numSlabStart) * numPlane,
-			                GRAFIC_FORMAT_FLOAT, 3, j);
-			grafic_readSlab(gvy,
-			                vel + 3 * (j - numSlabStart) * numPlane + 1,
-			                GRAFIC_FORMAT_FLOAT, 3, j);
-			grafic_readSlab(gvz,
-			                vel + 3 * (j - numSlabStart) * numPlane + 2,
-			                GRAFIC_FORMAT_FLOAT, 3, j);
-		}
-		if (g2g->doGas)
-			memcpy(vel + 3 * numLocal, vel, 3 * numLocal * sizeof(float));
-		if (g2g->useLongIDs) {
-			local_initposidLong(pos, (uint64_t *)id, np,
-			                    numSlabStart, numSlabEnd, dx,
-			                    g2g->doGas);
-		} else {
-			local_initposid(pos, (uint32_t *)id, np,
-			                numSlabStart, numSlabEnd, dx,
-			                g2g->doGas);
-		}
-		local_vel2pos(vel, pos, numLocalParticles, boxsize, vFact,
-		              g2g->posFactor);
-		local_convertVel(vel, numLocalParticles, aInit, g2g->velFactor);
-
-		gadget_open(gadget, GADGET_MODE_WRITE_CREATE, i);
-		gadget_writeHeaderToCurrentFile(gadget);
-		{
-			stai_t stai;
-			stai = stai_new(pos, 3 * sizeof(float), 3 * sizeof(float));
-			gadget_writeBlockToCurrentFile(gadget, GADGETBLOCK_POS_,
-			                               0, numLocalParticles, stai);
-			stai_del(&stai);
-			stai = stai_new(vel, 3 * sizeof(float), 3 * sizeof(float));
-			gadget_writeBlockToCurrentFile(gadget, GADGETBLOCK_VEL_,
-			                               0, numLocalParticles, stai);
-			stai_del(&stai);
-			if (g2g->useLongIDs)
-				stai = stai_new(id, sizeof(uint64_t), sizeof(uint64_t));
-			else
-				stai = stai_new(id, sizeof(uint32_t), sizeof(uint32_t));
-			gadget_writeBlockToCurrentFile(gadget, GADGETBLOCK_ID__,
-			                               0, numLocalParticles, stai);
-			stai_del(&stai);
-		}
-		gadget_close(gadget);
-
-		xfree(id);
-		xfree(pos);
-		xfree(vel);
+		local_writeFile(g2g, gadget, i, numSlabStart, numSlabEnd);
 	}
 
 	gadgetTOC_del(&toc);
 	gadgetHeader_del(&baseHeader);
 	gadget_del(&gadget);
 	cosmoModel_del(&model);
-	grafic_del(&gvz);
-	grafic_del(&gvy);
-	grafic_del(&gvx);
+	grafic_del(&(g2g->gv[2]));
+	grafic_del(&(g2g->gv[1]));
+	grafic_del(&(g2g->gv[0]));
 } /* grafic2gadget_run */
 
 /*--- Implementations of local functions --------------------------------*/
@@ -394,119 +346,190 @@ local_getSlabNumbers(int i,
 }
 
 static void
-local_initposid(float    *pos,
-                uint32_t *id,
-                uint64_t np[3],
-                int      zStart,
-                int      zEnd,
-                double   dx,
-                bool     doGas)
+local_writeFile(grafic2gadget_t g2g,
+                gadget_t        gadget,
+                int             fileNum,
+                int             numSlabStart,
+                int             numSlabEnd)
 {
-	const uint64_t numTotal  = np[0] * np[1] * np[2];
-	const uint64_t numOffset = np[0] * np[1] * (zEnd - zStart + 1);
+	const uint64_t numPlane  = g2g->np[0] * g2g->np[1];
+	const uint64_t numLocal  = numPlane * (numSlabEnd - numSlabStart + 1);
+	const uint64_t numInSlab = g2g->doGas ? 2 * numPlane : numPlane;
+	const size_t   sizeOfID  = g2g->useLongIDs ? sizeof(uint64_t)
+	                           : sizeof(uint32_t);
+	float          *velIn[2], *pos[2], *vel[2];
+	void           *id[2];
+
+	for (int b = 0; b < 2; b++) {
+		velIn[b] = xmalloc(sizeof(float) * numPlane * 3);
+		pos[b]   = xmalloc(sizeof(float) * numInSlab * 3);
+		vel[b]   = xmalloc(sizeof(float) * numInSlab * 3);
+		id[b]    = xmalloc(sizeOfID * numInSlab);
+	}
 
+	gadget_open(gadget, GADGET_MODE_WRITE_CREATE, fileNum);
+	gadget_writeHeaderToCurrentFile(gadget);
+
+	// Three stage pipeline: While slab j is converted, slab j+1 is read
+	// from the grafic files and slab j-1 is written to the Gadget file.
+	local_readSlab(g2g, velIn[0], numSlabStart);
+	for (int j = numSlabStart; j <= numSlabEnd + 1; j++) {
+		const int cur  = (j - numSlabStart) % 2;
+		const int prev = 1 - cur;
+#ifdef _OPENMP
+#  pragma omp parallel
+#endif
+		{
 #ifdef _OPENMP
-#  pragma omp parallel for
+#  pragma omp sections nowait
 #endif
-	for (int64_t k = zStart; k <= zEnd; k++) {
-		for (uint64_t j = 0; j < np[1]; j++) {
-			for (uint64_t i = 0; i < np[0]; i++) {
-				size_t idx = i + j * np[0] + (k - zStart) * np[1] * np[0];
-				id[idx]          = 1 + i + j * np[0] + k * np[1] * np[0];
-				pos[idx * 3]     = (float)((i + .5) * dx);
-				pos[idx * 3 + 1] = (float)((j + .5) * dx);
-				pos[idx * 3 + 2] = (float)((k + .5) * dx);
-				if (doGas) {
-					const double gasPosOffset = .25 * dx;
-					id[idx + numOffset]              = id[idx] + (uint32_t)numTotal;
-					pos[numOffset * 3 + idx * 3]     = pos[idx * 3];
-					pos[numOffset * 3 + idx * 3 + 1] = pos[idx * 3 + 1];
-					pos[numOffset * 3 + idx * 3 + 2] = pos[idx * 3 + 2];
-					pos[idx * 3]                    += gasPosOffset;
-					pos[idx * 3 + 1]                += gasPosOffset;
-					pos[idx * 3 + 2]                += gasPosOffset;
-				}
+			{
+#ifdef _OPENMP
+#  pragma omp section
+#endif
+				if (j < numSlabEnd)
+					local_readSlab(g2g, velIn[prev], j + 1);
+#ifdef _OPENMP
+#  pragma omp section
+#endif
+				if (j > numSlabStart)
+					local_writeSlab(g2g, gadget, pos[prev], vel[prev],
+					                id[prev],
+					                (j - 1 - numSlabStart) * numPlane,
+					                numLocal);
 			}
+			if (j <= numSlabEnd)
+				local_convertSlab(g2g, velIn[cur], pos[cur], vel[cur],
+				                  id[cur], j);
 		}
 	}
+
+	gadget_close(gadget);
+
+	for (int b = 0; b < 2; b++) {
+		xfree(id[b]);
+		xfree(vel[b]);
+		xfree(pos[b]);
+		xfree(velIn[b]);
+	}
+} /* local_writeFile */
+
+static void
+local_readSlab(const grafic2gadget_t g2g, float *velIn, int slabNum)
+{
+	const uint64_t numPlane = g2g->np[0] * g2g->np[1];
+
+	for (int c = 0; c < 3; c++)
+		grafic_readSlab(g2g->gv[c], velIn + c * numPlane,
+		                GRAFIC_FORMAT_FLOAT, 1, slabNum);
 }
 
 static void
-local_initposidLong(float    *pos,
-                    uint64_t *id,
-                    uint64_t np[3],
-                    int      zStart,
-                    int      zEnd,
-                    double   dx,
-                    bool     doGas)
+local_convertSlab(const grafic2gadget_t g2g,
+                  const float *restrict velIn,
+                  float *restrict       pos,
+                  float *restrict       vel,
+                  void *restrict        id,
+                  int                   slabNum)
 {
-	const uint64_t numTotal  = np[0] * np[1] * np[2];
-	const uint64_t numOffset = np[0] * np[1] * (zEnd - zStart + 1);
+	const uint64_t numPlane     = g2g->np[0] * g2g->np[1];
+	const uint64_t numTotal     = numPlane * g2g->np[2];
+	const uint64_t offsetDM     = g2g->doGas ? numPlane : 0;
+	const double   gasPosOffset = .25 * g2g->dx;
+	const float    velFac       = (float)(1. / (sqrt(g2g->aInit))
+	                                      * g2g->velFactor);
 
 #ifdef _OPENMP
-#  pragma omp parallel for
+#  pragma omp for schedule(dynamic)
 #endif
-	for (int64_t k = zStart; k <= zEnd; k++) {
-		for (uint64_t j = 0; j < np[1]; j++) {
-			for (uint64_t i = 0; i < np[0]; i++) {
-				size_t idx = i + j * np[0] + (k - zStart) * np[1] * np[0];
-				id[idx]          = 1 + i + j * np[0] + k * np[1] * np[0];
-				pos[idx * 3]     = (float)((i + .5) * dx);
-				pos[idx * 3 + 1] = (float)((j + .5) * dx);
-				pos[idx * 3 + 2] = (float)((k + .5) * dx);
-				if (doGas) {
-					const double gasPosOffset = .25 * dx;
-					id[idx + numOffset]              = id[idx] + numTotal;
-					pos[numOffset * 3 + idx * 3]     = pos[idx * 3];
-					pos[numOffset * 3 + idx * 3 + 1] = pos[idx * 3 + 1];
-					pos[numOffset * 3 + idx * 3 + 2] = pos[idx * 3 + 2];
-					pos[idx * 3]                    += gasPosOffset;
-					pos[idx * 3 + 1]                += gasPosOffset;
-					pos[idx * 3 + 2]                += gasPosOffset;
-				}
+	for (uint64_t j = 0; j < g2g->np[1]; j++) {
+		for (uint64_t i = 0; i < g2g->np[0]; i++) {
+			const uint64_t idx = i + j * g2g->np[0];
+			const uint64_t idG = 1 + idx + slabNum * numPlane;
+			const uint64_t idM = idx + offsetDM;
+			float          posInit[3], v[3];
+
+			posInit[0] = (float)((i + .5) * g2g->dx);
+			posInit[1] = (float)((j + .5) * g2g->dx);
+			posInit[2] = (float)((slabNum + .5) * g2g->dx);
+			for (int c = 0; c < 3; c++)
+				v[c] = velIn[c * numPlane + idx];
+
+			local_convertParticle(g2g, posInit, v, velFac,
+			                      pos + idM * 3, vel + idM * 3);
+			if (g2g->useLongIDs)
+				((uint64_t *)id)[idM] = idG + (g2g->doGas ? numTotal : 0);
+			else
+				((uint32_t *)id)[idM] = (uint32_t)idG
+				                        + (g2g->doGas ? (uint32_t)numTotal : 0);
+
+			if (g2g->doGas) {
+				for (int c = 0; c < 3; c++)
+					posInit[c] = (float)(posInit[c] + gasPosOffset);
+				local_convertParticle(g2g, posInit, v, velFac,
+				                      pos + idx * 3, vel + idx * 3);
+				if (g2g->useLongIDs)
+					((uint64_t *)id)[idx] = idG;
+				else
+					((uint32_t *)id)[idx] = (uint32_t)idG;
 			}
 		}
 	}
-}
-
-static void
-local_vel2pos(float    *vel,
-              float    *pos,
-              uint64_t num,
-              double   boxsize,
-              double   vFact,
-              double   posFactor)
+} /* local_convertSlab */
+
+static inline void
+local_convertParticle(const grafic2gadget_t g2g,
+                      const float           posInit[3],
+                      const float           velIn[3],
+                      float                 velFac,
+                      float *restrict       pos,
+                      float *restrict       vel)
 {
-#ifdef _OPENMP
-#  pragma omp parallel for
-#endif
-	for (uint64_t i = 0; i < num; i++) {
-		pos[i * 3]     += (float)boxsize;
-		pos[i * 3 + 1] += (float)boxsize;
-		pos[i * 3 + 2] += (float)boxsize;
-		pos[i * 3]      = (float)(fmod(pos[i * 3] + vFact * vel[i * 3],
-		                               boxsize) * posFactor);
-		pos[i * 3 + 1]  = (float)(fmod(pos[i * 3 + 1] + vFact * vel[i * 3 + 1],
-		                               boxsize) * posFactor);
-		pos[i * 3 + 2]  = (float)(fmod(pos[i * 3 + 2] + vFact * vel[i * 3 + 2],
-		                               boxsize) * posFactor);
+	for (int c = 0; c < 3; c++) {
+		float p = posInit[c] + (float)(g2g->boxsize);
+		pos[c] = (float)(fmod(p + g2g->vFact * velIn[c], g2g->boxsize)
+		                 * g2g->posFactor);
+		vel[c] = velIn[c] * velFac;
 	}
 }
 
 static void
-local_convertVel(float *vel, uint64_t num, double aInit, double velFactor)
+local_writeSlab(const grafic2gadget_t g2g,
+                gadget_t              gadget,
+                float                 *pos,
+                float                 *vel,
+                void                  *id,
+                uint64_t              pSkip,
+                uint64_t              numLocal)
 {
-	double fac = 1. / (sqrt(aInit)) * velFactor;
-
-#ifdef _OPENMP
-#  pragma omp parallel for
-#endif
-	for (uint64_t i = 0; i < num; i++) {
-		vel[i * 3]     *= (float)fac;
-		vel[i * 3 + 1] *= (float)fac;
-		vel[i * 3 + 2] *= (float)fac;
+	const uint64_t numPlane = g2g->np[0] * g2g->np[1];
+	const size_t   sizeOfID = g2g->useLongIDs ? sizeof(uint64_t)
+	                          : sizeof(uint32_t);
+	const int      numTypes = g2g->doGas ? 2 : 1;
+
+	// With gas, the gas particles make up the first half of the
+	// particles in the slab as well as in the file.
+	for (int t = 0; t < numTypes; t++) {
+		uint64_t pSkipFile = pSkip + t * numLocal;
+		stai_t   stai;
+
+		stai = stai_new(pos + t * numPlane * 3,
+		                3 * sizeof(float), 3 * sizeof(float));
+		gadget_writeBlockToCurrentFile(gadget, GADGETBLOCK_POS_,
+		                               pSkipFile, numPlane, stai);
+		stai_del(&stai);
+		stai = stai_new(vel + t * numPlane * 3,
+		                3 * sizeof(float), 3 * sizeof(float));
+		gadget_writeBlockToCurrentFile(gadget, GADGETBLOCK_VEL_,
+		                               pSkipFile, numPlane, stai);
+		stai_del(&stai);
+		stai = stai_new((char *)id + t * numPlane * sizeOfID,
+		                sizeOfID, sizeOfID);
+		gadget_writeBlockToCurrentFile(gadget, GADGETBLOCK_ID__,
+		                               pSkipFile, numPlane, stai);
+		stai_del(&stai);
 	}
-}
+} /* local_writeSlab */
 
 static void
 local_checkForIDOverflow(uint64_t np[3], bool useLongIDs, bool doGas)
@@ -9,6 +9,8 @@
 /*--- Includes ----------------------------------------------------------*/
 #include "grafic2gadgetConfig.h"
 #include <stdbool.h>
+#include <stdint.h>
+#include "../../src/libutil/grafic.h"
 
 
 /*--- Implemention of main structure ------------------------------------*/
@@ -24,6 +26,13 @@ struct grafic2gadget_struct {
 	bool   doGas;
 	double posFactor; // Scales from Mpc/h to whatever (for kpc/h: 1000.)
 	double velFactor; // Sacles from km/s to whatever (for m/s: 1000.)
+	// The following are set up in grafic2gadget_run()
+	grafic_t gv[3];
+	uint64_t np[3];
+	double   dx;
+	double   boxsize;
+	double   vFact;
+	double   aInit;
 };
 
 
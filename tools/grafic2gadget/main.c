@@ -21,6 +21,9 @@
 #include <stdbool.h>
 #include <string.h>
 #include <errno.h>
+#ifdef WITH_MPI
+#  include <mpi.h>
+#endif
 #include "../../src/libutil/xmem.h"
 #include "../../src/libutil/xstring.h"
 #include "../../src/libutil/cmdline.h"
@@ -88,6 +91,9 @@ local_initEnvironment(int *argc, char ***argv)
 {
 	cmdline_t cmdline;
 
+#ifdef WITH_MPI
+	MPI_Init(argc, argv);
+#endif
 	cmdline = local_cmdlineSetup();
 	cmdline_parse(cmdline, *argc, *argv);
 	local_checkForPrematureTermination(cmdline);
@@ -129,16 +135,24 @@ local_registerCleanUpFunctions(void)
 static void
 local_finalMessage(void)
 {
+	int rank = 0;
+
 	xfree(localGraficFileNameVx);
 	xfree(localGraficFileNameVy);
 	xfree(localGraficFileNameVz);
 	xfree(localOutputFileStem);
+#ifdef WITH_MPI
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+	MPI_Finalize();
+#endif
+	if (rank == 0) {
 #ifdef XMEM_TRACK_MEM
-	printf("\n");
-	xmem_info(stdout);
-	printf("\n");
+		printf("\n");
+		xmem_info(stdout);
+		printf("\n");
 #endif
-	printf("\nVertu sæl/sæll...\n");
+		printf("\nVertu sæl/sæll...\n");
+	}
 }
 
 static void
@@ -7,6 +7,7 @@
 #include "makeMaskConfig.h"
 #include "makeMask.h"
 #include <stdlib.h>
+#include <stdio.h>
 #include <assert.h>
 #include <inttypes.h>
 #include <math.h>
@@ -25,12 +26,18 @@
 #include "../../src/libgrid/gridHistogram.h"
 #include "../../src/libutil/xmem.h"
 #include "../../src/libutil/timer.h"
+#include "../../src/libutil/diediedie.h"
 
 
 /*--- Implemention of main structure ------------------------------------*/
 #include "makeMask_adt.h"
 
 
+/*--- Local defines -----------------------------------------------------*/
+#define LOCAL_PLANES_PER_HALO 8
+#define LOCAL_MIN_PLANES      64
+
+
 /*--- Prototypes of local functions -------------------------------------*/
 
 /**
@@ -76,6 +83,16 @@ local_createEmptyMask(makeMask_t mama);
  * @brief  Helper function to tag the level at which each cell of the mask
  *         should be generated.
  *
+ * The patch is worked on in slabs along the last dimension, each slab is
+ * handled by local_markSlab().  A slab is at least #LOCAL_MIN_PLANES and
+ * #LOCAL_PLANES_PER_HALO times the halo thick, such that recomputing the
+ * halo of the slabs stays cheap.  Only one slab is worked on at a time,
+ * hence the extra memory is bounded by that of a single slab and not
+ * proportional to the patch.  The elements are binned by their plane once
+ * (local_binElementsToPlanes()), so that each slab only visits the
+ * elements in its own planes and the halo.  With debugging enabled, the
+ * result is compared against local_checkMarking().
+ *
  * @param[in,out]  mama
  *                    The makeMask object to work with.
  *
@@ -85,6 +102,100 @@ inline static void
 local_markRegions(makeMask_t mama);
 
 
+/**
+ * @brief  Sorts the elements of the Lagrangian region into buckets, one
+ *         for every plane along the last dimension of the grid.
+ *
+ * This is a counting sort: the elements are counted per plane, the counts
+ * are turned into offsets and then the element indices are placed, hence
+ * the order within a bucket is the input order.
+ *
+ * @param[in]   lare
+ *                 The Lagrangian region to bin.
+ * @param[in]   numPlanes
+ *                 The number of planes of the grid along the last
+ *                 dimension.
+ * @param[out]  **planeStart
+ *                 Will receive a new array of length numPlanes + 1, the
+ *                 indices of the elements in plane @c k are stored in
+ *                 @c planeStart[k] to @c planeStart[k + 1] - 1 of
+ *                 @c elementIdxs.
+ * @param[out]  **elementIdxs
+ *                 Will receive a new array holding the indices of the
+ *                 elements, sorted by plane.
+ *
+ * @return  Returns nothing.
+ */
+inline static void
+local_binElementsToPlanes(const lare_t lare,
+                          uint32_t     numPlanes,
+                          uint32_t     **planeStart,
+                          uint32_t     **elementIdxs);
+
+
+/**
+ * @brief  Tags the cells of one slab of the mask with their level.
+ *
+ * The distance transform works on an occupancy grid of uint16_t values
+ * that covers the slab plus a halo of @c halo cells on either side.  For
+ * a slab of extent d0 x d1 x d2 this takes
+ * 2 (d0 + 2 halo) (d1 + 2 halo) (d2 + 2 halo) bytes, i.e. more than twice
+ * the memory of the slab in the (int8_t) mask.
+ *
+ * @param[in]      lare
+ *                    The Lagrangian region to mark.
+ * @param[in]      *planeStart
+ *                    The start of the buckets of elements per plane, see
+ *                    local_binElementsToPlanes().
+ * @param[in]      *elementIdxs
+ *                    The indices of the elements sorted by plane.
+ * @param[in,out]  *maskData
+ *                    The first cell of the slab in the mask.
+ * @param[in]      idxLo
+ *                    The starting index of the slab in grid coordinates.
+ * @param[in]      dimsSlab
+ *                    The extent of the slab.
+ * @param[in]      dimsGrid
+ *                    The extent of the full grid.
+ * @param[in]      halo
+ *                    The distance up to which cells are marked.
+ *
+ * @return  Returns nothing.
+ */
+inline static void
+local_markSlab(const lare_t            lare,
+               const uint32_t          *planeStart,
+               const uint32_t          *elementIdxs,
+               int8_t                  *maskData,
+               const gridPointUint32_t idxLo,
+               const gridPointUint32_t dimsSlab,
+               const gridPointUint32_t dimsGrid,
+               uint32_t                halo);
+
+
+#ifdef ENABLE_DEBUG
+/**
+ * @brief  Checks the marked mask against stamping a sphere of radius
+ *         @c halo around every element, which is what the distance
+ *         transform replaces.
+ *
+ * This is expensive (its cost scales with the number of elements times
+ * the volume of the sphere) and thus only done in debug builds.  The
+ * program is aborted if a cell differs.
+ *
+ * @param[in]  mama
+ *                The makeMask object to work with.
+ * @param[in]  halo
+ *                The distance up to which cells are marked.
+ *
+ * @return  Returns nothing.
+ */
+inline static void
+local_checkMarking(const makeMask_t mama, uint32_t halo);
+
+#endif
+
+
 /**
  * @brief  Helper function to write the mask to disk.
  *
@@ -111,65 +222,103 @@ local_doHistogram(makeMask_t mama);
 
 
 /**
- * @brief  Generates the shape that is used to generate the transition from
- *         high-resolution to low-resolution.
+ * @brief  Helper function to set up the occupancy grid for the distance
+ *         transform.
  *
- * The idea is to create a cubic shapelet that has in its center the highest
- * resolution and the surrounding cells are tagged according to their
- * distance to the center.  I.e. the outer shell will be the coarsest
- * resolution.
+ * The occupancy grid covers a slab of the local patch plus a halo of
+ * @c halo cells on either side.  All cells hosting a (periodic image of a) Lagrangian
+ * region element are set to 0, all others to @c cap.  Only the elements
+ * binned to the planes covered by the occupancy grid are looked at.
  *
- * As a side-effect, the function will write the shapelet in as binary data
- * into the file @c shape.dat.
+ * @param[in]  lare
+ *                The Lagrangian region to mark.
+ * @param[in]  *planeStart
+ *                The start of the buckets of elements per plane.
+ * @param[in]  *elementIdxs
+ *                The indices of the elements sorted by plane.
+ * @param[in]  idxLo
+ *                The starting index of the slab in grid coordinates.
+ * @param[in]  dimsBox
+ *                The extent of the occupancy grid, i.e. the extent of the
+ *                slab plus two times the halo.
+ * @param[in]  dimsGrid
+ *                The extent of the full grid.
+ * @param[in]  halo
+ *                The size of the halo.
+ * @param[in]  cap
+ *                The value to use for unoccupied cells.
  *
- * @param[in]  shapeDim1D
- *                The size of the shaplet, the actual shape will be
- *                (shapeDim1D / 2)+1, i.e. there will be shapeDim1D/2 cells
- *                on either side of the central cell.
+ * @return  Returns a new array of size dimsBox[0]*dimsBox[1]*dimsBox[2].
+ */
+inline static uint16_t *
+local_getOccupancy(const lare_t            lare,
+                   const uint32_t          *planeStart,
+                   const uint32_t          *elementIdxs,
+                   const gridPointUint32_t idxLo,
+                   const gridPointUint32_t dimsBox,
+                   const gridPointUint32_t dimsGrid,
+                   uint32_t                halo,
+                   uint16_t                cap);
+
+
+/**
+ * @brief  Performs one pass of the separable squared Euclidean distance
+ *         transform.
+ *
+ * All lines along dimension @c dim are transformed by computing the lower
+ * envelope of the parabolas rooted at the cells that are closer than
+ * @c cap (Felzenszwalb & Huttenlocher 2004).  Cells further away are
+ * clamped to @c cap.
  *
- * @return  Returns an array of size (shapeDim1D / 2 + 1)^NDIM holding the
- *          shapelet.
+ * @param[in,out]  dist2
+ *                    The squared distances to update.
+ * @param[in]      dimsBox
+ *                    The extent of @c dist2.
+ * @param[in]      dim
+ *                    The dimension along which to work.
+ * @param[in]      cap
+ *                    The squared distance beyond which distances are not
+ *                    tracked.
+ *
+ * @return  Returns nothing.
  */
-inline static uint8_t *
-local_createDegradeShape(uint32_t shapeDim1D);
+inline static void
+local_distanceTransformDim(uint16_t                *dist2,
+                           const gridPointUint32_t dimsBox,
+                           int                     dim,
+                           uint16_t                cap);
 
 
 /**
- * @brief  Helper function that performs the heavy-lifting in creating the
- *         mask.
+ * @brief  Transforms a single line, helper for
+ *         local_distanceTransformDim().
  *
- * @param[in,out]  *maskData
- *                    The mask data attached to the patch of the grid of the
- *                    calling function.  This data must be correctly
- *                    described by @c idxLo and @dimsPatch.
- * @param[in]      hiResCellIdxG
- *                    The index of the cell the function should work on in
- *                    grid coordinates (*not* patch coordinate).
- * @param[in]      *shape
- *                    The shapelet as returned by
- *                    local_createDegradeShape().
- * @param[in]      shapeDim1D
- *                    The size of the shapelet, this must be consistent with
- *                    the value used to generate the shapelet.
- * @param[in]      idxLo
- *                    The starting index of the patch of the calling
- *                    function, this is required to be able to convert patch
- *                    coordinates to grid coordinates.
- * @param[in]      dimsPatch
- *                    The extent of the patch.
- * @param[in]      dimsGrid
- *                    The extent of the grid.
+ * @param[in,out]  line
+ *                    The first element of the line.
+ * @param[in]      len
+ *                    The number of elements in the line.
+ * @param[in]      stride
+ *                    The distance between two elements of the line.
+ * @param[in]      cap
+ *                    The squared distance beyond which distances are not
+ *                    tracked.
+ * @param[in,out]  *f
+ *                    Scratch space for @c len values.
+ * @param[in,out]  *v
+ *                    Scratch space for @c len values.
+ * @param[in,out]  *z
+ *                    Scratch space for @c len + 1 values.
  *
  * @return  Returns nothing.
  */
 inline static void
-local_throwShapeOnMask(int8_t                  *restrict maskData,
-                       const gridPointUint32_t hiResCellIdxG,
-                       const uint8_t           *restrict shape,
-                       uint32_t                shapeDim1D,
-                       const gridPointUint32_t idxLo,
-                       const gridPointUint32_t dimsPatch,
-                       const gridPointUint32_t dimsGrid);
+local_distanceTransformLine(uint16_t *restrict line,
+                            uint32_t           len,
+                            uint64_t           stride,
+                            uint16_t           cap,
+                            uint32_t *restrict f,
+                            uint32_t *restrict v,
+                            double *restrict   z);
 
 
 /*--- Implementations of exported functios ------------------------------*/
@@ -296,25 +445,211 @@ local_markRegions(makeMask_t mama)
 	gridPointUint32_t dimsGrid, dimsPatch, idxLo;
 	gridPatch_t       patch;
 	int8_t            *maskData;
-	uint32_t          shapeDim1D;
-	uint8_t           *shape;
+	uint32_t          halo;
+	uint32_t          numPlanes;
+	uint64_t          numCellsPlane;
+	uint32_t          *planeStart, *elementIdxs;
+
+	if (mama->setup->numLevels < 2)
+		return;
 
 	gridRegular_getDims(mama->grid, dimsGrid);
 	patch = gridRegular_getPatchHandle(mama->grid, 0);
 	gridPatch_getDims(patch, dimsPatch);
 	gridPatch_getIdxLo(patch, idxLo);
-	maskData   = gridPatch_getVarDataHandle(patch, 0);
+	maskData = gridPatch_getVarDataHandle(patch, 0);
+
+	// A cell at distance d from the closest element is marked with
+	// halo - floor(d), cells with d >= halo are left untouched.
+	halo          = mama->setup->numLevels - 1;
+	numPlanes     = LOCAL_PLANES_PER_HALO * halo;
+	if (numPlanes < LOCAL_MIN_PLANES)
+		numPlanes = LOCAL_MIN_PLANES;
+	numCellsPlane = (uint64_t)dimsPatch[0] * dimsPatch[1];
 
-	shapeDim1D = 2 * (mama->setup->numLevels - 2) + 1;
-	shape      = local_createDegradeShape(shapeDim1D);
+	local_binElementsToPlanes(mama->setup->lare, dimsGrid[2], &planeStart,
+	                          &elementIdxs);
 
-	for (uint32_t i = 0; i < lare_getNumElements(mama->setup->lare); i++) {
+	for (uint32_t k = 0; k < dimsPatch[2]; k += numPlanes) {
+		gridPointUint32_t idxLoSlab, dimsSlab;
+
+		for (int i = 0; i < NDIM; i++) {
+			idxLoSlab[i] = idxLo[i];
+			dimsSlab[i]  = dimsPatch[i];
+		}
+		idxLoSlab[2] += k;
+		dimsSlab[2]   = (dimsPatch[2] - k < numPlanes) ? dimsPatch[2] - k
+		                : numPlanes;
+		local_markSlab(mama->setup->lare, planeStart, elementIdxs,
+		               maskData + k * numCellsPlane, idxLoSlab, dimsSlab,
+		               dimsGrid, halo);
+	}
+
+	xfree(elementIdxs);
+	xfree(planeStart);
+
+#ifdef ENABLE_DEBUG
+	local_checkMarking(mama, halo);
+#endif
+} /* local_markRegions */
+
+inline static void
+local_binElementsToPlanes(const lare_t lare,
+                          uint32_t     numPlanes,
+                          uint32_t     **planeStart,
+                          uint32_t     **elementIdxs)
+{
+	uint32_t numElements = lare_getNumElements(lare);
+	uint32_t *counts     = xmalloc(sizeof(uint32_t) * numPlanes);
+	uint32_t numEntries  = 0;
+
+	*planeStart  = xmalloc(sizeof(uint32_t) * (numPlanes + 1));
+	*elementIdxs = xmalloc(sizeof(uint32_t) * (numElements + 1));
+
+	for (uint32_t k = 0; k < numPlanes; k++)
+		counts[k] = 0;
+	for (uint32_t e = 0; e < numElements; e++) {
 		gridPointUint32_t element;
-		lare_getElement(mama->setup->lare, element, i);
-		local_throwShapeOnMask(maskData, element, shape, shapeDim1D,
-		                       idxLo, dimsPatch, dimsGrid);
+		lare_getElement(lare, element, e);
+		counts[element[2] % numPlanes]++;
+	}
+
+	// Turn the counts into write offsets.
+	for (uint32_t k = 0; k < numPlanes; k++) {
+		uint32_t num = counts[k];
+		(*planeStart)[k] = numEntries;
+		counts[k]        = numEntries;
+		numEntries      += num;
+	}
+	(*planeStart)[numPlanes] = numEntries;
+
+	for (uint32_t e = 0; e < numElements; e++) {
+		gridPointUint32_t element;
+		lare_getElement(lare, element, e);
+		(*elementIdxs)[counts[element[2] % numPlanes]++] = e;
 	}
-}
+
+	xfree(counts);
+} /* local_binElementsToPlanes */
+
+inline static void
+local_markSlab(const lare_t            lare,
+               const uint32_t          *planeStart,
+               const uint32_t          *elementIdxs,
+               int8_t                  *maskData,
+               const gridPointUint32_t idxLo,
+               const gridPointUint32_t dimsSlab,
+               const gridPointUint32_t dimsGrid,
+               uint32_t                halo)
+{
+	gridPointUint32_t dimsBox;
+	uint16_t          cap;
+	uint16_t          *dist2;
+
+	assert(halo * halo < UINT16_MAX);
+	cap = (uint16_t)(halo * halo);
+	for (int i = 0; i < NDIM; i++)
+		dimsBox[i] = dimsSlab[i] + 2 * halo;
+
+	dist2 = local_getOccupancy(lare, planeStart, elementIdxs, idxLo,
+	                           dimsBox, dimsGrid, halo, cap);
+	for (int i = 0; i < NDIM; i++)
+		local_distanceTransformDim(dist2, dimsBox, i, cap);
+
+#ifdef WITH_OPENMP
+#  pragma omp parallel for shared(maskData, dist2, dimsSlab, dimsBox) \
+	schedule(static)
+#endif
+	for (uint32_t k = 0; k < dimsSlab[2]; k++) {
+		for (uint32_t j = 0; j < dimsSlab[1]; j++) {
+			uint64_t idxM = (j + (uint64_t)k * dimsSlab[1]) * dimsSlab[0];
+			uint64_t idxB = halo + ((j + halo)
+			                        + (uint64_t)(k + halo) * dimsBox[1])
+			                * dimsBox[0];
+			for (uint32_t i = 0; i < dimsSlab[0]; i++) {
+				int8_t level;
+				if (dist2[idxB + i] >= cap)
+					continue;
+				level = (int8_t)(halo
+				                 - (uint32_t)floor(sqrt(dist2[idxB + i])));
+				if (maskData[idxM + i] < level)
+					maskData[idxM + i] = level;
+			}
+		}
+	}
+
+	xfree(dist2);
+} /* local_markSlab */
+
+#ifdef ENABLE_DEBUG
+inline static void
+local_checkMarking(const makeMask_t mama, uint32_t halo)
+{
+	gridPointUint32_t dimsGrid, dimsPatch, idxLo;
+	gridPatch_t       patch;
+	int8_t            *maskData, *expected;
+	uint64_t          numCells;
+	int32_t           extent = (int32_t)halo - 1;
+
+	gridRegular_getDims(mama->grid, dimsGrid);
+	patch = gridRegular_getPatchHandle(mama->grid, 0);
+	gridPatch_getDims(patch, dimsPatch);
+	gridPatch_getIdxLo(patch, idxLo);
+	maskData = gridPatch_getVarDataHandle(patch, 0);
+	numCells = gridPatch_getNumCells(patch);
+
+	expected = xmalloc(sizeof(int8_t) * numCells);
+	for (uint64_t i = 0; i < numCells; i++)
+		expected[i] = (int8_t)(mama->setup->baseRefinementLevel);
+
+	for (uint32_t e = 0; e < lare_getNumElements(mama->setup->lare); e++) {
+		gridPointUint32_t element;
+
+		lare_getElement(mama->setup->lare, element, e);
+		for (int32_t k = -extent; k <= extent; k++) {
+			int64_t kM = ((int64_t)element[2] + k + dimsGrid[2])
+			             % dimsGrid[2] - idxLo[2];
+			if ((kM < 0) || (kM >= dimsPatch[2]))
+				continue;
+			for (int32_t j = -extent; j <= extent; j++) {
+				int64_t jM = ((int64_t)element[1] + j + dimsGrid[1])
+				             % dimsGrid[1] - idxLo[1];
+				if ((jM < 0) || (jM >= dimsPatch[1]))
+					continue;
+				for (int32_t i = -extent; i <= extent; i++) {
+					int64_t iM = ((int64_t)element[0] + i + dimsGrid[0])
+					             % dimsGrid[0] - idxLo[0];
+					uint64_t idxM;
+					int      dist;
+					int8_t   level;
+					if ((iM < 0) || (iM >= dimsPatch[0]))
+						continue;
+					dist = (int)floor(sqrt(k * k + j * j + i * i));
+					if (dist > extent)
+						continue;
+					level = (int8_t)(extent + 1 - dist);
+					idxM  = iM + (jM + kM * dimsPatch[1]) * dimsPatch[0];
+					if (expected[idxM] < level)
+						expected[idxM] = level;
+				}
+			}
+		}
+	}
+
+	for (uint64_t i = 0; i < numCells; i++) {
+		if (maskData[i] != expected[i]) {
+			fprintf(stderr,
+			        "FATAL:  Mask differs from stamping at cell %" PRIu64
+			        " (%i instead of %i).\n",
+			        i, (int)maskData[i], (int)expected[i]);
+			diediedie(EXIT_FAILURE);
+		}
+	}
+
+	xfree(expected);
+} /* local_checkMarking */
+
+#endif
 
 inline static void
 local_writeMask(makeMask_t mama)
@@ -364,70 +699,151 @@ local_doHistogram(makeMask_t mama)
 	gridHistogram_del(&histo);
 }
 
-inline static uint8_t *
-local_createDegradeShape(uint32_t shapeDim1D)
+inline static uint16_t *
+local_getOccupancy(const lare_t            lare,
+                   const uint32_t          *planeStart,
+                   const uint32_t          *elementIdxs,
+                   const gridPointUint32_t idxLo,
+                   const gridPointUint32_t dimsBox,
+                   const gridPointUint32_t dimsGrid,
+                   uint32_t                halo,
+                   uint16_t                cap)
 {
-	uint8_t *shape;
-	int     extent = shapeDim1D / 2;
-	int     idx    = 0;
-	FILE    *f;
-
-	shape = xmalloc(sizeof(uint8_t) * (POW_NDIM(extent * 2 + 1)));
-
-	for (int k = -extent; k <= extent; k++) {
-		for (int j = -extent; j <= extent; j++) {
-			for (int i = -extent; i <= extent; i++) {
-				int dist = (int)floor(sqrt(k * k + j * j + i * i));
-				shape[idx++] = (uint8_t)(dist < extent + 1
-				                         ? extent + 1 - dist : 0);
+	uint16_t *dist2;
+	uint64_t numCells = 1;
+	int64_t  planeLo;
+	uint32_t numPlanes;
+
+	for (int i = 0; i < NDIM; i++)
+		numCells *= dimsBox[i];
+	dist2 = xmalloc(sizeof(uint16_t) * numCells);
+#ifdef WITH_OPENMP
+#  pragma omp parallel for shared(dist2, numCells, cap) schedule(static)
+#endif
+	for (uint64_t i = 0; i < numCells; i++)
+		dist2[i] = cap;
+
+	// Every plane of the grid is visited at most once, its periodic images
+	// in the box are dealt with per element.
+	planeLo   = (int64_t)idxLo[2] - (int64_t)halo;
+	numPlanes = (dimsBox[2] < dimsGrid[2]) ? dimsBox[2] : dimsGrid[2];
+	for (uint32_t p = 0; p < numPlanes; p++) {
+		int64_t  n     = (int64_t)dimsGrid[2];
+		uint32_t plane = (uint32_t)(((planeLo + p) % n + n) % n);
+
+		for (uint32_t b = planeStart[plane]; b < planeStart[plane + 1];
+		     b++) {
+			gridPointUint32_t element;
+			int64_t           first[NDIM];
+			bool              isInBox = true;
+
+			lare_getElement(lare, element, elementIdxs[b]);
+			for (int i = 0; i < NDIM && isInBox; i++) {
+				int64_t boxLo = (int64_t)idxLo[i] - (int64_t)halo;
+				int64_t m     = (int64_t)dimsGrid[i];
+				first[i] = (((int64_t)element[i] - boxLo) % m + m) % m;
+				isInBox  = (first[i] < (int64_t)dimsBox[i]);
+			}
+			if (!isInBox)
+				continue;
+
+			for (int64_t k = first[2]; k < dimsBox[2]; k += dimsGrid[2]) {
+				for (int64_t j = first[1]; j < dimsBox[1];
+				     j += dimsGrid[1]) {
+					for (int64_t i = first[0]; i < dimsBox[0];
+					     i += dimsGrid[0]) {
+						dist2[i + (j + k * dimsBox[1]) * dimsBox[0]] = 0;
+					}
+				}
 			}
 		}
 	}
 
-	f = fopen("shape.dat", "wb");
-	fwrite(shape, sizeof(int8_t), (POW_NDIM(extent * 2 + 1)), f);
-	fclose(f);
+	return dist2;
+} /* local_getOccupancy */
 
-	return shape;
-}
+inline static void
+local_distanceTransformDim(uint16_t                *dist2,
+                           const gridPointUint32_t dimsBox,
+                           int                     dim,
+                           uint16_t                cap)
+{
+	uint64_t stride   = 1;
+	uint64_t numLines = 1;
+	uint32_t len      = dimsBox[dim];
+
+	for (int i = 0; i < NDIM; i++) {
+		if (i < dim)
+			stride *= dimsBox[i];
+		if (i != dim)
+			numLines *= dimsBox[i];
+	}
+
+#ifdef WITH_OPENMP
+#  pragma omp parallel shared(dist2, stride, numLines, len, cap)
+#endif
+	{
+		uint32_t *f = xmalloc(sizeof(uint32_t) * len);
+		uint32_t *v = xmalloc(sizeof(uint32_t) * len);
+		double   *z = xmalloc(sizeof(double) * (len + 1));
+
+#ifdef WITH_OPENMP
+#  pragma omp for schedule(static)
+#endif
+		for (uint64_t l = 0; l < numLines; l++) {
+			uint64_t base = (l % stride) + (l / stride) * stride * len;
+			local_distanceTransformLine(dist2 + base, len, stride, cap,
+			                            f, v, z);
+		}
+
+		xfree(z);
+		xfree(v);
+		xfree(f);
+	}
+} /* local_distanceTransformDim */
 
 inline static void
-local_throwShapeOnMask(int8_t                  *restrict maskData,
-                       const gridPointUint32_t hiResCellIdxG,
-                       const uint8_t           *restrict shape,
-                       uint32_t                shapeDim1D,
-                       const gridPointUint32_t idxLo,
-                       const gridPointUint32_t dimsPatch,
-                       const gridPointUint32_t dimsGrid)
+local_distanceTransformLine(uint16_t *restrict line,
+                            uint32_t           len,
+                            uint64_t           stride,
+                            uint16_t           cap,
+                            uint32_t *restrict f,
+                            uint32_t *restrict v,
+                            double *restrict   z)
 {
-	uint32_t iSG, jSG, kSG; // position of shape (S) in grid coordinates (G)
-	int32_t  iSM, jSM, kSM; // position of shape (S) in map coordinates (M)
-	int32_t  shapeExtent = shapeDim1D / 2;
-	uint64_t idxS, idxM;
-
-	for (int32_t k = -shapeExtent; k <= shapeExtent; k++) {
-		kSG = (hiResCellIdxG[2] + k + dimsGrid[2]) % dimsGrid[2];
-		kSM = kSG - idxLo[2];
-		if ((kSM < 0) || (kSM >= dimsPatch[2]))
+	int64_t k = -1;
+
+	for (uint32_t q = 0; q < len; q++) {
+		double s = -HUGE_VAL;
+
+		f[q] = line[q * stride];
+		if (f[q] >= cap)
 			continue;
-		for (int32_t j = -shapeExtent; j <= shapeExtent; j++) {
-			jSG = (hiResCellIdxG[1] + j + dimsGrid[1]) % dimsGrid[1];
-			jSM = jSG - idxLo[1];
-			if ((jSM < 0) || (jSM >= dimsPatch[1]))
-				continue;
-			for (int32_t i = -shapeExtent; i <= shapeExtent; i++) {
-				iSG = (hiResCellIdxG[0] + i + dimsGrid[0]) % dimsGrid[0];
-				iSM = iSG - idxLo[0];
-				if ((iSM < 0) || (iSM >= dimsPatch[0]))
-					continue;
-				idxS = (i + shapeExtent)
-				       + (j + shapeExtent) * shapeDim1D
-				       + (k + shapeExtent) * shapeDim1D * shapeDim1D;
-				idxM = iSM + (jSM + kSM * dimsPatch[1]) * dimsPatch[0];
-				if (maskData[idxM] < shape[idxS]) {
-					maskData[idxM] = shape[idxS];
-				}
-			}
+		while (k >= 0) {
+			s = ((double)f[q] + (double)q * q
+			     - (double)f[v[k]] - (double)v[k] * v[k])
+			    / (2.0 * ((double)q - (double)v[k]));
+			if (s > z[k])
+				break;
+			k--;
 		}
+		k++;
+		v[k]     = q;
+		z[k]     = (k == 0) ? -HUGE_VAL : s;
+		z[k + 1] = HUGE_VAL;
+	}
+
+	if (k < 0)
+		return;
+
+	k = 0;
+	for (uint32_t q = 0; q < len; q++) {
+		int64_t  dq;
+		uint64_t d;
+		while (z[k + 1] < (double)q)
+			k++;
+		dq               = (int64_t)q - (int64_t)v[k];
+		d                = (uint64_t)(dq * dq) + f[v[k]];
+		line[q * stride] = (uint16_t)(d < cap ? d : cap);
 	}
 }
@@ -32,6 +32,7 @@
 #include "../../src/libutil/xmem.h"
 #include "../../src/libutil/timer.h"
 #include "../../src/libutil/rng.h"
+#include "../../src/libutil/lIdx.h"
 #include "../../src/libutil/tile.h"
 
 
@@ -148,22 +149,31 @@ local_fillOutputGrid(gridRegular_t       gridOut,
 
 
 /**
- * @brief  This will simply fill a patch with white noise.
+ * @brief  This will simply fill the patch of a grid with white noise.
  *
- * @param[in,out]  patch
- *                    The patch to be filled.
+ * Every cell draws the number of a counter-based generator belonging to
+ * its global index, hence the field does not depend on the number of
+ * processes or threads.
+ *
+ * @param[in,out]  grid
+ *                    The grid whose (first) patch is to be filled.
  * @param[in]      seed
  *                    The seed that should be used for the RNG.
  *
  * @return  Returns nothing.
  */
 static void
-local_fillPatchWithWhiteNoise(gridPatch_t patch, int seed);
+local_fillPatchWithWhiteNoise(gridRegular_t grid, int seed);
 
 
 /**
  * @brief  Does the heavy lifting for degrading a data cube.
  *
+ * The output is processed row by row.  For each row of supervoxels the
+ * corresponding rows of the input are streamed once (see
+ * local_sumSVsOfRow()), hence every input value is read exactly once and
+ * the partial sums of a row stay in cache.  Any integer factor between
+ * the resolutions is supported.
  *
  * General conversion from @f$(i,j,k)@f$ to linear array index (assuming
  * array has the dimensions@f$(d_0, d_1, d_2)@f$):
@@ -193,75 +203,109 @@ local_fillPatchWithWhiteNoise(gridPatch_t patch, int seed);
  *                 The dimensions of the output data cube.
  * @param[in]   dimsIn
  *                 The dimensions of the input data cube.
+ * @param[in]   dimsSV
+ *                 The dimensions of a supervoxel, i.e. the factor between
+ *                 the resolutions of the full grids.
  *
  * @return  Returns nothing.
  */
 static void
-local_degrade(fpv_t             *dataOut,
-              const fpv_t       *dataIn,
-              gridPointUint32_t dimsOut,
-              gridPointUint32_t dimsIn);
+local_degrade(fpv_t                   *dataOut,
+              const fpv_t             *dataIn,
+              const gridPointUint32_t dimsOut,
+              const gridPointUint32_t dimsIn,
+              const gridPointUint32_t dimsSV);
 
 
 /**
  * @brief  Will enforce constraints of a lowRes grid onto a highRes grid.
  *
- * @param[out]  *dataOut
- *                 The output data cube.
- * @param[in]   *dataIn
- *                 The input data cube.
- * @param[in]   dimsOut
- *                 The dimensions of the output data cube.
- * @param[in]   dimsIn
- *                 The dimensions of the input data cube.
+ * Works on one row of supervoxels at a time: the first pass computes the
+ * means of the supervoxels, the second one replaces them with the
+ * constraints.  The rows of the supervoxels are small enough to stay in
+ * cache between the two passes.
+ *
+ * @param[in,out]  *dataOut
+ *                    The output data cube.
+ * @param[in]      *dataIn
+ *                    The input data cube.
+ * @param[in]      dimsOut
+ *                    The dimensions of the output data cube.
+ * @param[in]      dimsIn
+ *                    The dimensions of the input data cube.
+ * @param[in]      dimsSV
+ *                    The dimensions of a supervoxel, i.e. the factor
+ *                    between the resolutions of the full grids.
  *
  * @return  Returns nothing.
  */
 static void
-local_enforceConstraints(fpv_t             *dataOut,
-                         const fpv_t       *dataIn,
-                         gridPointUint32_t dimsOut,
-                         gridPointUint32_t dimsIn);
+local_enforceConstraints(fpv_t                   *dataOut,
+                         const fpv_t             *dataIn,
+                         const gridPointUint32_t dimsOut,
+                         const gridPointUint32_t dimsIn,
+                         const gridPointUint32_t dimsSV);
 
 
 /**
- * @brief  This will sum over a subvolume.
+ * @brief  Sums over a row of supervoxels.
+ *
+ * The rows of the fine grid covered by the supervoxels are read once and
+ * in order.  Each row is first reduced to per-supervoxel partial sums,
+ * which are then accumulated with Kahan summation.  Both loops are free of
+ * dependencies between the supervoxels and can be vectorized.
  *
- * @param[in]  *data
- *                The data.  Must point to the beginning of the subvolume.
- * @param[in]  dimsIn
- *                The dimension of the input grid.
- * @param[in]  dimsSV
- *                The dimension of the subvolume.
+ * @param[out]     *sum
+ *                    Receives the sums of the @c numSV supervoxels.
+ * @param[in,out]  *comp
+ *                    Scratch space for @c numSV values.
+ * @param[in,out]  *part
+ *                    Scratch space for @c numSV values.
+ * @param[in]      *data
+ *                    The data.  Must point to the beginning of the first
+ *                    supervoxel.
+ * @param[in]      numSV
+ *                    The number of supervoxels in the row.
+ * @param[in]      dimsFine
+ *                    The dimension of the fine grid.
+ * @param[in]      dimsSV
+ *                    The dimension of the supervoxels.
  *
- * @return  Returns the sum of all values in the subvolume.
+ * @return  Returns nothing.
  */
-inline static long double
-local_sumSV(const fpv_t       *data,
-            gridPointUint32_t dimsIn,
-            gridPointUint32_t dimsSV);
+inline static void
+local_sumSVsOfRow(double *restrict        sum,
+                  double *restrict        comp,
+                  double *restrict        part,
+                  const fpv_t *restrict   data,
+                  uint32_t                numSV,
+                  const gridPointUint32_t dimsFine,
+                  const gridPointUint32_t dimsSV);
 
 
 /**
- * @brief  Adds a scalar value to a subvolume.
+ * @brief  Adds a value per supervoxel to a row of supervoxels.
  *
  * @param[in,out]  *data
- *                    The data, must point to the beginning of the
- *                    subvolume.
- * @param[in]      dimsIn
- *                    The dimensions of the input data.
+ *                    The data, must point to the beginning of the first
+ *                    supervoxel.
+ * @param[in]      *value
+ *                    The values that should be added to the supervoxels.
+ * @param[in]      numSV
+ *                    The number of supervoxels in the row.
+ * @param[in]      dimsFine
+ *                    The dimensions of the fine grid.
  * @param[in]      dimsSV
- *                    The dimensions of the subvolume.
- * @param[in]      value
- *                    The value that should be added to the subvolume.
+ *                    The dimensions of the supervoxels.
  *
  * @return  Returns nothing.
  */
 inline static void
-local_addToSV(fpv_t             *data,
-              gridPointUint32_t dimsIn,
-              gridPointUint32_t dimsSV,
-              double            value);
+local_addToSVsOfRow(fpv_t *restrict         data,
+                    const double *restrict  value,
+                    uint32_t                numSV,
+                    const gridPointUint32_t dimsFine,
+                    const gridPointUint32_t dimsSV);
 
 
 /*--- Implementations of exported functios ------------------------------*/
@@ -471,14 +515,12 @@ local_getGrid(double         boxsizeInMpch,
 static void
 local_fillInputGrid(gridRegular_t grid, gridReader_t reader, int seed)
 {
-	gridPatch_t patch;
-
-	patch = gridRegular_getPatchHandle(grid, 0);
-
 	if (reader == NULL) {
-		local_fillPatchWithWhiteNoise(patch, seed);
+		local_fillPatchWithWhiteNoise(grid, seed);
 	} else {
-		gridReader_readIntoPatchForVar(reader, patch, 0);
+		gridReader_readIntoPatchForVar(reader,
+		                               gridRegular_getPatchHandle(grid, 0),
+		                               0);
 	}
 }
 
@@ -490,7 +532,7 @@ local_fillOutputGrid(gridRegular_t       gridOut,
 	gridPatch_t       patchIn, patchOut;
 	fpv_t             *dataIn, *dataOut;
 	gridPointUint32_t dimsIn, dimsOut;
-//	gridPointUint32_t factors;
+	gridPointUint32_t dimsGridIn, dimsGridOut, factors;
 
 	patchIn = gridRegular_getPatchHandle(gridIn, 0);
 	dataIn  = (fpv_t *)gridPatch_getVarDataHandle(patchIn, 0);
@@ -500,175 +542,231 @@ local_fillOutputGrid(gridRegular_t       gridOut,
 	dataOut  = (fpv_t *)gridPatch_getVarDataHandle(patchOut, 0);
 	gridPatch_getDims(patchOut, dimsOut);
 
-	if ((dimsIn[0] < dimsOut[0]) && (dimsIn[1] < dimsOut[1])
-	    && (dimsIn[2] < dimsOut[2])) {
-		local_fillPatchWithWhiteNoise(patchOut, seedOut);
-		local_enforceConstraints(dataOut, dataIn, dimsOut, dimsIn);
-	} else if ((dimsIn[0] > dimsOut[0]) && (dimsIn[1] > dimsOut[1])
-	           && (dimsIn[2] > dimsOut[2])) {
-		local_degrade(dataOut, dataIn, dimsOut, dimsIn);
+	// The factors are taken from the full grids, the slabs of the patches
+	// are aligned to the supervoxels by local_getLastDimLimitsInput() and
+	// local_getLastDimLimitsOutput().
+	gridRegular_getDims(gridIn, dimsGridIn);
+	gridRegular_getDims(gridOut, dimsGridOut);
+
+	if ((dimsGridIn[0] < dimsGridOut[0]) && (dimsGridIn[1] < dimsGridOut[1])
+	    && (dimsGridIn[2] < dimsGridOut[2])) {
+		for (int i = 0; i < NDIM; i++)
+			factors[i] = dimsGridOut[i] / dimsGridIn[i];
+		local_fillPatchWithWhiteNoise(gridOut, seedOut);
+		local_enforceConstraints(dataOut, dataIn, dimsOut, dimsIn, factors);
+	} else if ((dimsGridIn[0] > dimsGridOut[0])
+	           && (dimsGridIn[1] > dimsGridOut[1])
+	           && (dimsGridIn[2] > dimsGridOut[2])) {
+		for (int i = 0; i < NDIM; i++)
+			factors[i] = dimsGridIn[i] / dimsGridOut[i];
+		local_degrade(dataOut, dataIn, dimsOut, dimsIn, factors);
 	} else {
 		fprintf(stdout, "doing nothing");
 	}
 }
 
 static void
-local_fillPatchWithWhiteNoise(gridPatch_t patch, int seed)
+local_fillPatchWithWhiteNoise(gridRegular_t grid, int seed)
 {
-	fpv_t    *data;
-	uint64_t numCells;
-	rng_t    rng;
-	int      size       = 1;
-	int      numThreads = 1;
-	int      numStreams = 1;
-#ifdef WITH_OPENMP
-	numThreads = omp_get_max_threads();
-#endif
+	gridPatch_t       patch;
+	fpv_t             *data;
+	uint64_t          numRows;
+	gridPointUint32_t dims, dimsGlobal, idxLo;
+	rng_t             rng;
+	int               size = 1;
 #ifdef WITH_MPI
 	MPI_Comm_size(MPI_COMM_WORLD, &size);
 #endif
-	numStreams = numThreads * size;
 
-	data       = (fpv_t *)gridPatch_getVarDataHandle(patch, 0);
-	numCells   = gridPatch_getNumCells(patch);
-	rng        = rng_new(4, numStreams, seed);
+	patch   = gridRegular_getPatchHandle(grid, 0);
+	data    = (fpv_t *)gridPatch_getVarDataHandle(patch, 0);
+	gridPatch_getDims(patch, dims);
+	gridPatch_getIdxLo(patch, idxLo);
+	gridRegular_getDims(grid, dimsGlobal);
+	numRows = gridPatch_getNumCells(patch) / dims[0];
+	rng     = rng_new(RNG_GENERATOR_PHILOX, size, seed);
 
+	// The cells of a row along the first dimension have consecutive
+	// global indices and are filled in one go.
 #ifdef WITH_OPENMP
-#  pragma omp parallel shared(numCells, rng) num_threads(numThreads)
+#  pragma omp parallel for shared(data, numRows, dims, dimsGlobal, idxLo, \
+	rng) schedule(static)
 #endif
-	for (uint64_t i = 0; i < numCells; i++) {
-		int threadID = 0;
-#ifdef WITH_OPENMP
-		threadID = omp_get_thread_num();
-#endif
-		data[i]  = (fpv_t)rng_getGaussUnit(rng, threadID);
+	for (uint64_t i = 0; i < numRows; i++) {
+		uint32_t coords[NDIM];
+		lIdx_toCoordNd(i * dims[0], dims, NDIM, coords);
+		for (int j = 0; j < NDIM; j++)
+			coords[j] += idxLo[j];
+		rng_fillGaussUnitAt(rng, lIdx_fromCoordNd(coords, dimsGlobal, NDIM),
+		                    data + i * dims[0], dims[0]);
 	}
 
 	rng_del(&rng);
 }
 
 static void
-local_degrade(fpv_t             *dataOut,
-              const fpv_t       *dataIn,
-              gridPointUint32_t dimsOut,
-              gridPointUint32_t dimsIn)
+local_degrade(fpv_t                   *dataOut,
+              const fpv_t             *dataIn,
+              const gridPointUint32_t dimsOut,
+              const gridPointUint32_t dimsIn,
+              const gridPointUint32_t dimsSV)
 {
-	gridPointUint32_t dimsSV;
-	double            numCellsSVInv      = 1.;
-	double            varianceAdjustment = 1;
+	double   numCellsSVInv      = 1.;
+	double   varianceAdjustment = 1;
+	uint64_t numRows            = 1;
 
 	for (int i = 0; i < NDIM; i++) {
-		assert(dimsIn[i] % dimsOut[i] == 0);
-		dimsSV[i]           = dimsIn[i] / dimsOut[i];
+		assert(dimsIn[i] == dimsOut[i] * dimsSV[i]);
 		numCellsSVInv      /= (double)(dimsSV[i]);
-		varianceAdjustment *= dimsIn[i] / ((double)(dimsOut[i]));
+		varianceAdjustment *= (double)(dimsSV[i]);
+		if (i > 0)
+			numRows *= dimsOut[i];
 	}
 	varianceAdjustment = sqrt(varianceAdjustment);
 
-#if (NDIM > 2)
-#  ifdef WITH_OPENMP
-#    pragma omp parallel for
-#  endif
-	for (uint64_t k = 0; k < dimsOut[2]; k++)
+#ifdef WITH_OPENMP
+#  pragma omp parallel shared(dataOut, dataIn, numCellsSVInv, \
+	varianceAdjustment, numRows)
 #endif
 	{
-		for (uint64_t j = 0; j < dimsOut[1]; j++) {
-			for (uint64_t i = 0; i < dimsOut[0]; i++) {
-				long double sum;
-				uint64_t    idxOut = i + (j + k * dimsOut[1]) * dimsOut[0];
-				uint64_t    idxIn  = i * dimsSV[0]
-				                     + (j * dimsSV[1]
-				                        + k * dimsSV[2]
-				                        * dimsIn[1]) * dimsIn[0];
-				sum = local_sumSV(dataIn + idxIn,
-				                  dimsIn,
-				                  dimsSV);
-				dataOut[idxOut] = (fpv_t)(sum * numCellsSVInv
-				                          * varianceAdjustment);
-			}
+		double *sum  = xmalloc(sizeof(double) * dimsOut[0]);
+		double *comp = xmalloc(sizeof(double) * dimsOut[0]);
+		double *part = xmalloc(sizeof(double) * dimsOut[0]);
+
+#ifdef WITH_OPENMP
+#  pragma omp for schedule(static)
+#endif
+		for (uint64_t r = 0; r < numRows; r++) {
+			uint64_t j      = r % dimsOut[1];
+			uint64_t k      = r / dimsOut[1];
+			fpv_t    *out   = dataOut + r * dimsOut[0];
+			uint64_t idxIn  = (j * dimsSV[1]
+			                   + k * dimsSV[2] * dimsIn[1]) * dimsIn[0];
+
+			local_sumSVsOfRow(sum, comp, part, dataIn + idxIn,
+			                  dimsOut[0], dimsIn, dimsSV);
+			for (uint32_t i = 0; i < dimsOut[0]; i++)
+				out[i] = (fpv_t)(sum[i] * numCellsSVInv
+				                 * varianceAdjustment);
 		}
+
+		xfree(part);
+		xfree(comp);
+		xfree(sum);
 	}
 } /* local_degrade */
 
 static void
-local_enforceConstraints(fpv_t             *dataOut,
-                         const fpv_t       *dataIn,
-                         gridPointUint32_t dimsOut,
-                         gridPointUint32_t dimsIn)
+local_enforceConstraints(fpv_t                   *dataOut,
+                         const fpv_t             *dataIn,
+                         const gridPointUint32_t dimsOut,
+                         const gridPointUint32_t dimsIn,
+                         const gridPointUint32_t dimsSV)
 {
-	gridPointUint32_t dimsSV;
-	double            numCellsSVInv      = 1.;
-	double            varianceAdjustment = 1;
+	double   numCellsSVInv      = 1.;
+	double   varianceAdjustment = 1;
+	uint64_t numRows            = 1;
 
 	for (int i = 0; i < NDIM; i++) {
-		assert(dimsOut[i] % dimsIn[i] == 0);
-		dimsSV[i]           = dimsOut[i] / dimsIn[i];
+		assert(dimsOut[i] == dimsIn[i] * dimsSV[i]);
 		numCellsSVInv      /= (double)(dimsSV[i]);
-		varianceAdjustment *= dimsIn[i] / ((double)(dimsOut[i]));
+		varianceAdjustment /= (double)(dimsSV[i]);
+		if (i > 0)
+			numRows *= dimsIn[i];
 	}
 	varianceAdjustment = sqrt(varianceAdjustment);
 
-#if (NDIM > 2)
-#  ifdef WITH_OPENMP
-#    pragma omp parallel for
-#  endif
-	for (uint64_t k = 0; k < dimsIn[2]; k++)
+#ifdef WITH_OPENMP
+#  pragma omp parallel shared(dataOut, dataIn, numCellsSVInv, \
+	varianceAdjustment, numRows)
 #endif
 	{
-		for (uint64_t j = 0; j < dimsIn[1]; j++) {
-			for (uint64_t i = 0; i < dimsIn[0]; i++) {
-				long double mean;
-				uint64_t    idxIn  = i + (j + k * dimsIn[1]) * dimsIn[0];
-				uint64_t    idxOut = i * dimsSV[0]
-				                     + (j * dimsSV[1]
-				                        + k * dimsSV[2]
-				                        * dimsOut[1]) * dimsOut[0];
-				mean  = local_sumSV(dataOut + idxOut, dimsOut, dimsSV);
-				mean *= numCellsSVInv;
-				local_addToSV(dataOut + idxOut, dimsOut, dimsSV,
-				              (double)(-mean));
-				local_addToSV(dataOut + idxOut, dimsOut, dimsSV,
-				              dataIn[idxIn] * varianceAdjustment);
-			}
+		double *sum  = xmalloc(sizeof(double) * dimsIn[0]);
+		double *comp = xmalloc(sizeof(double) * dimsIn[0]);
+		double *part = xmalloc(sizeof(double) * dimsIn[0]);
+
+#ifdef WITH_OPENMP
+#  pragma omp for schedule(static)
+#endif
+		for (uint64_t r = 0; r < numRows; r++) {
+			uint64_t    j      = r % dimsIn[1];
+			uint64_t    k      = r / dimsIn[1];
+			const fpv_t *in    = dataIn + r * dimsIn[0];
+			uint64_t    idxOut = (j * dimsSV[1]
+			                      + k * dimsSV[2] * dimsOut[1]) * dimsOut[0];
+
+			local_sumSVsOfRow(sum, comp, part, dataOut + idxOut,
+			                  dimsIn[0], dimsOut, dimsSV);
+			// Reuse sum for the shift that replaces the mean of the
+			// supervoxel with the constraint.
+			for (uint32_t i = 0; i < dimsIn[0]; i++)
+				sum[i] = in[i] * varianceAdjustment
+				         - sum[i] * numCellsSVInv;
+			local_addToSVsOfRow(dataOut + idxOut, sum, dimsIn[0],
+			                    dimsOut, dimsSV);
 		}
+
+		xfree(part);
+		xfree(comp);
+		xfree(sum);
 	}
 } /* local_enforceConstraints */
 
-inline static long double
-local_sumSV(const fpv_t       *data,
-            gridPointUint32_t dimsIn,
-            gridPointUint32_t dimsSV)
+inline static void
+local_sumSVsOfRow(double *restrict        sum,
+                  double *restrict        comp,
+                  double *restrict        part,
+                  const fpv_t *restrict   data,
+                  uint32_t                numSV,
+                  const gridPointUint32_t dimsFine,
+                  const gridPointUint32_t dimsSV)
 {
-	long double sum = 0.0L;
+	for (uint32_t i = 0; i < numSV; i++) {
+		sum[i]  = 0.0;
+		comp[i] = 0.0;
+	}
 
 #if (NDIM > 2)
 	for (uint64_t k = 0; k < dimsSV[2]; k++)
 #endif
 	{
 		for (uint64_t j = 0; j < dimsSV[1]; j++) {
-			for (uint64_t i = 0; i < dimsSV[0]; i++) {
-				sum += data[i + (j + k * dimsIn[1]) * dimsIn[0]];
+			const fpv_t *row = data + (j + k * dimsFine[1]) * dimsFine[0];
+
+			for (uint32_t i = 0; i < numSV; i++)
+				part[i] = 0.0;
+			for (uint32_t s = 0; s < dimsSV[0]; s++) {
+				for (uint32_t i = 0; i < numSV; i++)
+					part[i] += row[(uint64_t)i * dimsSV[0] + s];
+			}
+
+			for (uint32_t i = 0; i < numSV; i++) {
+				double y = part[i] - comp[i];
+				double t = sum[i] + y;
+				comp[i] = (t - sum[i]) - y;
+				sum[i]  = t;
 			}
 		}
 	}
-
-
-	return sum;
 }
 
 inline static void
-local_addToSV(fpv_t             *data,
-              gridPointUint32_t dimsIn,
-              gridPointUint32_t dimsSV,
-              double            value)
+local_addToSVsOfRow(fpv_t *restrict         data,
+                    const double *restrict  value,
+                    uint32_t                numSV,
+                    const gridPointUint32_t dimsFine,
+                    const gridPointUint32_t dimsSV)
 {
 #if (NDIM > 2)
 	for (uint64_t k = 0; k < dimsSV[2]; k++)
 #endif
 	{
 		for (uint64_t j = 0; j < dimsSV[1]; j++) {
-			for (uint64_t i = 0; i < dimsSV[0]; i++) {
-				data[i + (j + k * dimsIn[1]) * dimsIn[0]] += (fpv_t)value;
+			fpv_t *row = data + (j + k * dimsFine[1]) * dimsFine[0];
+
+			for (uint32_t s = 0; s < dimsSV[0]; s++) {
+				for (uint32_t i = 0; i < numSV; i++)
+					row[(uint64_t)i * dimsSV[0] + s] += (fpv_t)value[i];
 			}
 		}
 	}